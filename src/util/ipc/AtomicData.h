@@ -9,53 +9,148 @@
  */
 
 #include <util/system/Platform.h>
+#include <util/system/SysConfig.h>     // for CACHE_LINE_ALIGN
+#include <util/ipc/Mutex.h>            // for pause
+#include <util/ipc/SharedMemory.h>     // for SharedContainer
+#include <util/numeric/Intrinsics.h>   // for constAlign
 
 #include <atomic>           // For atomic
+#include <cstring>          // For memcpy
+#include <type_traits>      // For is_trivially_copyable
 
 namespace alt{
-template <typename T>
+
+/**
+ * \class AtomicData
+ * \ingroup IPC
+ * \brief Publishes a value of any trivially copyable type from a single writer to
+ * multiple readers with a sequence lock. Readers never block the writer and do no
+ * atomic read-modify-write; a reader copies the value and retries if the copy is
+ * torn by a concurrent write.
+ * \tparam T the type of the data. Must be trivially copyable as it may be placed in
+ * shared memory and is copied while the writer may be changing it.
+ * \tparam DoubleBuffered when true, the writer writes into the buffer not being
+ * published and then flips the published buffer, so a reader is only disturbed if
+ * the writer completes two writes during a single read.
+ * \note The instance can be placed in shared memory (see SharedAtomicData)
+ */
+template <typename T, bool DoubleBuffered=false>
 class AtomicData
 {
-    alignas(8) std::atomic<int64_t>     count_{0};
-    CACHE_LINE_ALIGN T                  data_;
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "AtomicData type must be trivially copyable");
+
+    static constexpr size_t BUFFER_NUM = DoubleBuffered ? 2 : 1;
+
+    struct Buffer
+    {
+        // odd when the buffer is being written
+        CACHE_LINE_ALIGN std::atomic<uint64_t>  sequence_ {0};
+        T                                       data_ {};
+    };
+
+    // number of writes completed, the last one is in buffers_[update_count_%BUFFER_NUM]
+    CACHE_LINE_ALIGN std::atomic<uint64_t>      update_count_ {0};
+    Buffer                                      buffers_[BUFFER_NUM];
 
   public:
 
+    AtomicData() = default;
+    AtomicData(const T& data) { buffers_[0].data_ = data; }
+
+    AtomicData(const AtomicData&) = delete;
+    AtomicData& operator=(const AtomicData&) = delete;
+
+    static size_t requiredSize()
+    {
+        return constAlign(sizeof(AtomicData), SysConfig::instance().cache_line_size_);
+    }
+
+    /// \brief Create an instance in an allocated memory
+    /// \note if attrs.is_new_ is true, a new instance is constructed in addr.
+    /// Otherwise, addr contains an instance already created by other process.
+    static AtomicData* create (char* addr, const MemoryAttrs& attrs)
+    {
+        return attrs.is_new_ ? new (addr) AtomicData() : reinterpret_cast<AtomicData*>(addr);
+    }
+
+    static SM_Mode getOpenMode(bool is_master)
+    { return is_master ? SM_Mode::SM_OpenOrCreate : SM_Mode::SM_OpenOnly; }
+
+    static SM_Access getAccessRequest(bool is_master)
+    { return is_master ? SM_Access::SM_ReadWrite : SM_Access::SM_ReadOnly; }
+
     // -------------------------------------------------------------------------
     // Called by reader
     // -------------------------------------------------------------------------
-    void read(T& data)
+
+    /// \brief read the latest value. Spins until a consistent copy is made
+    void read(T& data) const
+    {
+        while (!tryRead(data)) { pause(); }
+    }
+
+    /// \brief make one attempt to read the latest value
+    /// \return true if data receives a consistent copy; false if the copy is torn
+    /// by a concurrent write and data is undefined
+    bool tryRead(T& data) const
     {
-        while (isLocked()) { pause(); }
-        int64_t upd_count_before=getUpdateCount();
-        while (true)
+        const Buffer& buffer = buffers_[
+            DoubleBuffered ? update_count_.load(std::memory_order_acquire) % BUFFER_NUM : 0];
+        uint64_t sequence = buffer.sequence_.load(std::memory_order_acquire);
+        if (sequence & 1)
         {
-            data = getData();
-            int64_t upd_count_after=getUpdateCount();
-            if (upd_count_after==upd_count_before)
-            {
-                break;
-            }
-            upd_count_before = upd_count_afte;r
+            return false;
         }
+        std::memcpy(&data, &buffer.data_, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return buffer.sequence_.load(std::memory_order_relaxed)==sequence;
+    }
+
+    /// \brief returns the number of writes done
+    uint64_t getUpdateCount() const { return update_count_.load(std::memory_order_acquire); }
+
+    /// \brief returns true if the writer is writing into the buffer readers read
+    bool isLocked() const
+    {
+        return !DoubleBuffered && (buffers_[0].sequence_.load(std::memory_order_acquire) & 1);
     }
-    const T& getData() const { return data_; };
-    int64_t isLocked() { return count_.load(std::memory_order_acquire) < 0; }
-    int64_t getUpdateCount() { return count_.load(std::memory_order_acquire); }
 
     // -------------------------------------------------------------------------
     // Called by writer
     // -------------------------------------------------------------------------
-    void write(T& data)
+
+    /// \brief publish a new value
+    void write(const T& data)
+    {
+        update([&data](T& buffer) { std::memcpy(&buffer, &data, sizeof(T)); });
+    }
+
+    /// \brief publish a new value modified in place by func
+    /// \param func a callable taking T& to modify the value. For double buffering, the
+    /// value passed in has the content published in the previous write.
+    template <typename Func>
+    void update(Func&& func)
     {
-        lockWrite();
-        data_ = data;
-        unlockWrite();
+        uint64_t count = update_count_.load(std::memory_order_relaxed);
+        Buffer& buffer = buffers_[(count+1) % BUFFER_NUM];
+        uint64_t sequence = buffer.sequence_.load(std::memory_order_relaxed);
+        buffer.sequence_.store(sequence+1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        if (DoubleBuffered)
+        {
+            std::memcpy(&buffer.data_, &buffers_[count % BUFFER_NUM].data_, sizeof(T));
+        }
+        func(buffer.data_);
+        buffer.sequence_.store(sequence+2, std::memory_order_release);
+        update_count_.store(count+1, std::memory_order_release);
     }
 
-    T& getData() { return data_; };
-    int64_t lockWrite() { return count_.store(~count_, std::memory_order_release); }
-    int64_t unlockWrite() { return count_.store(-count_, std::memory_order_release); }
+    /// \brief returns the value last written. Only the writer can call this
+    const T& getData() const { return buffers_[getUpdateCount() % BUFFER_NUM].data_; }
 };
 
-}
\ No newline at end of file
+template<typename T, bool DoubleBuffered=false> using SharedAtomicData
+    = SharedContainer<SharedMemory, AtomicData<T, DoubleBuffered>>;
+
+}
@@ -0,0 +1,119 @@
+#include "Rcu.h"
+#include "Mutex.h"          // for pause
+#include <stdexcept>        // for runtime_error
+#include <string>
+#include <thread>           // for yield
+
+namespace alt
+{
+
+/**
+ * \brief The reader slot of a thread, given back when the thread exits
+ */
+struct RcuThreadReader
+{
+    constexpr static size_t NO_SLOT = size_t(-1);
+
+    size_t      ix_ {NO_SLOT};
+    uint32_t    nesting_ {0};
+
+    ~RcuThreadReader()
+    {
+        if (ix_ != NO_SLOT)
+        {
+            RcuDomain::instance().releaseReader(ix_);
+        }
+    }
+};
+
+namespace
+{
+    thread_local RcuThreadReader    thread_reader_;
+}
+
+RcuDomain& RcuDomain::instance()
+{
+    static RcuDomain domain;
+    return domain;
+}
+
+size_t RcuDomain::claimReader()
+{
+    for (size_t ix = 0; ix < MAX_READERS; ++ix)
+    {
+        bool claimed = false;
+        if (!readers_[ix].claimed_.load(std::memory_order_relaxed) &&
+            readers_[ix].claimed_.compare_exchange_strong(claimed, true))
+        {
+            return ix;
+        }
+    }
+    throw std::runtime_error(std::string("RcuDomain: too many reader threads, max=") +
+                             std::to_string(MAX_READERS));
+}
+
+void RcuDomain::releaseReader(size_t ix)
+{
+    readers_[ix].epoch_.store(0, std::memory_order_release);
+    readers_[ix].claimed_.store(false, std::memory_order_release);
+}
+
+void RcuDomain::readLock()
+{
+    RcuThreadReader& reader = thread_reader_;
+    if (reader.nesting_++ > 0)
+    {
+        return;
+    }
+    if (ALT_UNLIKELY(reader.ix_ == RcuThreadReader::NO_SLOT))
+    {
+        reader.ix_ = claimReader();
+    }
+    // The acquire load pairs with advance: a reader seeing the new epoch also
+    // sees everything published before it. The fence orders the epoch store
+    // before the loads of published pointers, against the writer scanning the
+    // epochs after publishing (see isQuiescent)
+    readers_[reader.ix_].epoch_.store(epoch_.load(std::memory_order_acquire),
+                                      std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void RcuDomain::readUnlock()
+{
+    RcuThreadReader& reader = thread_reader_;
+    if (--reader.nesting_ == 0)
+    {
+        readers_[reader.ix_].epoch_.store(0, std::memory_order_release);
+    }
+}
+
+bool RcuDomain::isQuiescent(uint64_t epoch) const
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    for (const Reader& reader: readers_)
+    {
+        uint64_t reader_epoch = reader.epoch_.load(std::memory_order_acquire);
+        if (reader_epoch != 0 && reader_epoch <= epoch)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void RcuDomain::synchronize(uint64_t epoch) const
+{
+    for (size_t spin = 0; !isQuiescent(epoch); ++spin)
+    {
+        if (spin < 64)
+        {
+            pause();
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+}
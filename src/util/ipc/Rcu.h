@@ -0,0 +1,98 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file Rcu.h
+ * @library alt_util
+ * @brief Defines an epoch based read-copy-update domain. Readers mark the epoch
+ * in which they start reading. A writer that unpublishes an object advances the
+ * epoch and frees the object only after no reader started at or before that
+ * epoch is still reading.
+ */
+
+#include <util/Defs.h>                  // for ALT_UTIL_PUBLIC
+#include <util/system/SysConfig.h>      // for CACHE_LINE_ALIGN
+#include <atomic>                       // for atomic
+#include <stdint.h>
+
+namespace alt
+{
+
+/**
+ * \class RcuDomain
+ * \ingroup IPC
+ * \brief The process-wide epoch domain shared by all RCU containers.
+ * A thread takes a reader slot at its first readLock and gives it back when the
+ * thread exits. After that, readLock and readUnlock are wait-free: one load, one
+ * store and one fence, with no read-modify-write on shared cache lines.
+ */
+class ALT_UTIL_PUBLIC RcuDomain
+{
+  public:
+    /// maximum number of threads that can be reading at the same time
+    constexpr static size_t MAX_READERS = 256;
+
+    static RcuDomain& instance();
+
+    RcuDomain(const RcuDomain&) = delete;
+    RcuDomain& operator=(const RcuDomain&) = delete;
+
+    /// \brief enters a read-side critical section for the calling thread. Objects
+    /// loaded after this call are not freed until the matching readUnlock.
+    /// Sections can be nested.
+    /// \throw std::runtime_error if more than MAX_READERS threads read
+    void readLock();
+
+    /// \brief leaves the read-side critical section
+    void readUnlock();
+
+    /// \brief called by a writer after unpublishing objects
+    /// \return the epoch to be passed to isQuiescent to know when the objects
+    /// unpublished before this call can be freed
+    uint64_t advance() { return epoch_.fetch_add(1, std::memory_order_seq_cst); }
+
+    /// \brief returns true if no reader started at or before the given epoch is
+    /// still in its read-side critical section
+    bool isQuiescent(uint64_t epoch) const;
+
+    /// \brief waits until isQuiescent(epoch) is true
+    void synchronize(uint64_t epoch) const;
+
+  private:
+    friend struct RcuThreadReader;
+
+    RcuDomain() = default;
+
+    size_t claimReader();
+    void releaseReader(size_t ix);
+
+    struct Reader
+    {
+        // the epoch when the reader started reading, 0 if not reading
+        CACHE_LINE_ALIGN std::atomic<uint64_t>  epoch_ {0};
+        std::atomic<bool>                       claimed_ {false};
+    };
+
+    CACHE_LINE_ALIGN std::atomic<uint64_t>      epoch_ {1};
+    Reader                                      readers_[MAX_READERS];
+};
+
+/**
+ * \class RcuReadGuard
+ * \ingroup IPC
+ * \brief Holds a read-side critical section in a scope
+ */
+class RcuReadGuard
+{
+  public:
+    RcuReadGuard() { RcuDomain::instance().readLock(); }
+    ~RcuReadGuard() { RcuDomain::instance().readUnlock(); }
+    RcuReadGuard(const RcuReadGuard&) = delete;
+    RcuReadGuard& operator=(const RcuReadGuard&) = delete;
+};
+
+}
@@ -75,8 +75,8 @@ public:
 
 	//void swap(SharedMemory& other);
 
-	char* ptr() const { return payload_; }
-	const char* ptr() { return payload_; }
+	char* ptr() { return payload_; }
+	const char* ptr() const { return payload_; }
 	size_t size() const { return payload_size_; }
 	const SM_Header* getHeader() const { return header_; }
     bool isNew() const { return is_new_; }
@@ -162,7 +162,7 @@ class ALT_UTIL_PUBLIC SharedContainer
         bool is_master = storage_.isMaster();
         size_t size = ContainerT::requiredSize(std::forward<Args>(args)...);
         SM_Mode mode = ContainerT::getOpenMode(is_master);
-        SM_Access access = ContainerT::getAccessRequeust(is_master);
+        SM_Access access = ContainerT::getAccessRequest(is_master);
         if (storage_.acquire(mode, access, size) < 0)
         {
             return -1;
@@ -0,0 +1,277 @@
+#include "DatagramConnection.h"         // for DatagramConnection, this class
+
+#include <util/system/SysError.h>       // for SYS_ERR_THROW
+#include <util/string/StrPrint.h>       // for StrPrinter
+
+#include <sys/socket.h>                 // for recvmmsg, sendmmsg
+#include <algorithm>                    // for min, rotate
+#include <cstring>                      // for memcpy, memset
+#include <errno.h>
+
+namespace alt {
+
+DatagramConnection::DatagramConnection(
+    DatagramListener* listener,
+    const Config& config,
+    FDEventPoller* poll)
+    : listener_(listener)
+    , config_(config)
+    , poll_(poll)
+{
+    if (config_.batch_size_ == 0)
+    {
+        config_.batch_size_ = 1;
+    }
+    const size_t batch = config_.batch_size_;
+    const size_t slot = config_.max_datagram_size_;
+    if (listener_)
+    {
+        recv_slab_.reset(new char[batch * slot]);
+        recv_msgs_.reset(new mmsghdr[batch]);
+        recv_iovs_.reset(new iovec[batch]);
+        senders_.reset(new sockaddr_storage[batch]);
+        datagrams_.resize(batch);
+        // the headers point to fixed slots, so they are set once
+        ::memset(recv_msgs_.get(), 0, sizeof(mmsghdr) * batch);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            recv_iovs_[i].iov_base = recv_slab_.get() + i * slot;
+            recv_iovs_[i].iov_len = slot;
+            recv_msgs_[i].msg_hdr.msg_iov = &recv_iovs_[i];
+            recv_msgs_[i].msg_hdr.msg_iovlen = 1;
+            recv_msgs_[i].msg_hdr.msg_name = &senders_[i];
+            datagrams_[i].data_ = recv_slab_.get() + i * slot;
+            datagrams_[i].sender_ = &senders_[i];
+        }
+    }
+    send_slab_.reset(new char[batch * slot]);
+    send_msgs_.reset(new mmsghdr[batch]);
+    send_iovs_.reset(new iovec[batch]);
+    ::memset(send_msgs_.get(), 0, sizeof(mmsghdr) * batch);
+    for (size_t i = 0; i < batch; ++i)
+    {
+        send_iovs_[i].iov_base = send_slab_.get() + i * slot;
+        send_msgs_[i].msg_hdr.msg_iov = &send_iovs_[i];
+        send_msgs_[i].msg_hdr.msg_iovlen = 1;
+    }
+}
+
+DatagramConnection::~DatagramConnection()
+{
+    close();
+}
+
+void DatagramConnection::open(int af)
+{
+    if (socket_.initilized())
+    {
+        return;
+    }
+    socket_.open(af, SOCK_DGRAM);
+    socket_.setOption(SocketFlag::NonBlock, true);
+    if (config_.reuse_address_)
+    {
+        socket_.setOption(SocketFlag::ReuseAddr, true);
+    }
+    if (config_.recv_buffer_size_ > 0)
+    {
+        socket_.setReceiveBufferSize(config_.recv_buffer_size_);
+    }
+    if (config_.send_buffer_size_ > 0)
+    {
+        socket_.setSendBufferSize(config_.send_buffer_size_);
+    }
+#if defined(SO_BUSY_POLL)
+    if (config_.busy_poll_usecs_ > 0)
+    {
+        socket_.setOption(SOL_SOCKET, SO_BUSY_POLL, config_.busy_poll_usecs_);
+    }
+#endif
+}
+
+void DatagramConnection::bind(const SocketAddress& address)
+{
+    open(address.af());
+    socket_.bind(address);
+    if (listener_ && poll_ && !booked_)
+    {
+        poll_->book(this, FDEventId::EVENT_IN);
+        booked_ = true;
+    }
+}
+
+void DatagramConnection::setDestination(const SocketAddress& address)
+{
+    open(address.af());
+    destination_ = address;
+    for (size_t i = 0; i < config_.batch_size_; ++i)
+    {
+        send_msgs_[i].msg_hdr.msg_name = const_cast<sockaddr*>(destination_.addr());
+        send_msgs_[i].msg_hdr.msg_namelen = destination_.addrLength();
+    }
+}
+
+void DatagramConnection::close()
+{
+    if (booked_)
+    {
+        // remove from the poller before the fd is closed and can be reused
+        poll_->remove(this);
+        booked_ = false;
+    }
+    socket_.close();
+    post_num_ = 0;
+}
+
+bool DatagramConnection::send(const void* data, size_t length)
+{
+    ssize_t res = ::sendto(socket_.socketId(), data, length, 0,
+                    destination_.addr(), destination_.addrLength());
+    if (res < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            return false;
+        }
+        StrPrinter<128> err_msg;
+        err_msg << "Send to " << destination_.toString() << " failed";
+        SYS_ERR_THROW(NetException, err_msg.c_str());
+    }
+    return true;
+}
+
+size_t DatagramConnection::send(const struct iovec* datagrams, size_t num)
+{
+    mmsghdr msgs[64];
+    size_t sent = 0;
+    while (sent < num)
+    {
+        size_t batch = std::min(num - sent, sizeof(msgs) / sizeof(msgs[0]));
+        ::memset(msgs, 0, sizeof(mmsghdr) * batch);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            msgs[i].msg_hdr.msg_name = const_cast<sockaddr*>(destination_.addr());
+            msgs[i].msg_hdr.msg_namelen = destination_.addrLength();
+            msgs[i].msg_hdr.msg_iov = const_cast<iovec*>(&datagrams[sent + i]);
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int res = ::sendmmsg(socket_.socketId(), msgs, unsigned(batch), 0);
+        if (res < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            StrPrinter<128> err_msg;
+            err_msg << "Send to " << destination_.toString() << " failed";
+            SYS_ERR_THROW(NetException, err_msg.c_str());
+        }
+        sent += size_t(res);
+        if (size_t(res) < batch)
+        {
+            break;
+        }
+    }
+    return sent;
+}
+
+bool DatagramConnection::post(const void* data, size_t length)
+{
+    if (length > config_.max_datagram_size_)
+    {
+        SYS_ERR_THROW(NetException, "DatagramConnection post failed. Datagram too long", false);
+    }
+    if (post_num_ == config_.batch_size_)
+    {
+        // the batch was left full by a full socket buffer
+        flush();
+        if (post_num_ == config_.batch_size_)
+        {
+            return false;
+        }
+    }
+    ::memcpy(send_iovs_[post_num_].iov_base, data, length);
+    send_iovs_[post_num_].iov_len = length;
+    if (++post_num_ == config_.batch_size_)
+    {
+        flush();
+    }
+    return true;
+}
+
+size_t DatagramConnection::flush()
+{
+    size_t sent = 0;
+    while (sent < post_num_)
+    {
+        int res = ::sendmmsg(socket_.socketId(), &send_msgs_[sent], unsigned(post_num_ - sent), 0);
+        if (res < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                break;
+            }
+            post_num_ = 0;
+            StrPrinter<128> err_msg;
+            err_msg << "Send to " << destination_.toString() << " failed";
+            SYS_ERR_THROW(NetException, err_msg.c_str());
+        }
+        sent += size_t(res);
+    }
+    if (sent > 0 && sent < post_num_)
+    {
+        // keep the datagrams not sent at the front of the batch. The slots are
+        // rotated with them, so no data is copied
+        std::rotate(&send_iovs_[0], &send_iovs_[sent], &send_iovs_[post_num_]);
+    }
+    post_num_ -= sent;
+    return sent;
+}
+
+size_t DatagramConnection::receiveBatch(Clock::tick_type tick_realtime)
+{
+    const size_t batch = config_.batch_size_;
+    for (size_t i = 0; i < batch; ++i)
+    {
+        // recvmmsg updates the name length and flags of each header
+        recv_msgs_[i].msg_hdr.msg_namelen = sizeof(sockaddr_storage);
+        recv_msgs_[i].msg_hdr.msg_flags = 0;
+    }
+    int res = ::recvmmsg(socket_.socketId(), recv_msgs_.get(), unsigned(batch), MSG_DONTWAIT, nullptr);
+    if (res < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        {
+            return 0;
+        }
+        SYS_ERR_THROW(NetException, "DatagramConnection receive failed");
+    }
+    for (int i = 0; i < res; ++i)
+    {
+        datagrams_[i].length_ = recv_msgs_[i].msg_len;
+        datagrams_[i].truncated_ = (recv_msgs_[i].msg_hdr.msg_flags & MSG_TRUNC) != 0;
+    }
+    if (res > 0)
+    {
+        listener_->onDatagrams(tick_realtime, datagrams_.data(), size_t(res));
+    }
+    return size_t(res);
+}
+
+FDEventIdSet DatagramConnection::onEvent(Clock::tick_type tick_realtime, FDEventIdSet event_ids)
+{
+    if (listener_ && event_ids.has(FDEventId::EVENT_IN))
+    {
+        // a batch short of batch_size_ has drained the socket
+        for (size_t n = 0; n < config_.max_batches_; ++n)
+        {
+            if (receiveBatch(tick_realtime) < config_.batch_size_ || !booked_)
+            {
+                break;
+            }
+        }
+    }
+    return FDEventIdSet();
+}
+
+} // namespace alt
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Socket.h"                         // for Socket
+#include <util/system/EventPoller.h>        // for FDEventHandler
+#include <util/types/TemplateHelper.h>      // for NONCOPYABLE
+#include <memory>                           // for unique_ptr
+#include <vector>                           // for vector
+
+struct mmsghdr;
+
+namespace alt {
+
+/**
+ * \struct Datagram
+ * \ingroup NetUtil
+ * \brief A datagram received by a DatagramConnection. The data are valid only
+ * in the DatagramListener::onDatagrams call.
+ */
+struct Datagram
+{
+    const char*                     data_;
+    size_t                          length_;
+    const struct sockaddr_storage*  sender_;        ///< the address of the sender
+    bool                            truncated_;     ///< longer than max_datagram_size_
+
+    SocketAddress sender() const { return SocketAddress(*sender_); }
+};
+
+/**
+ * \class DatagramListener
+ * \ingroup NetUtil
+ * \brief Listens to the datagrams received by a DatagramConnection
+ */
+class DatagramListener
+{
+  public:
+    /// \brief called with the datagrams received in one batch
+    virtual void onDatagrams(Clock::tick_type tick_realtime, const Datagram* datagrams, size_t num) = 0;
+
+    virtual ~DatagramListener() {}
+};
+
+/**
+ * \class DatagramConnection
+ * \ingroup NetUtil
+ * \brief A UDP socket polled by FDEventPoller for unicast and multicast data.
+ *
+ * Datagrams are received with recvmmsg, a batch in one system call, into a slab
+ * of batch_size_ slots of max_datagram_size_ bytes allocated once, and handed to
+ * the listener as a batch without copying. The slab is reused by the next batch.
+ * A readable socket is drained up to max_batches_ batches per poll, so that one
+ * busy feed does not starve the other handlers of the poller. Datagrams are sent
+ * one at a time by send, or batched by post and sent with sendmmsg by flush.
+ *
+ * Example:
+ * @code
+ *   DatagramConnection feed(&handler, DatagramConnection::Config(), &poller);
+ *   feed.bind(SocketAddress(IPAddress(IPFamily::IPv4), 30001));
+ *   feed.joinSrcGroup(IPAddress("233.54.12.1"), IPAddress("10.1.1.5"));
+ * @endcode
+ */
+class ALT_UTIL_PUBLIC DatagramConnection: public FDEventHandler
+{
+  public:
+    struct Config
+    {
+        size_t  batch_size_ {64};           ///< datagrams per recvmmsg or sendmmsg
+        size_t  max_datagram_size_ {2048};  ///< longer datagrams are truncated
+        size_t  max_batches_ {16};          ///< batches received per poll
+        int     recv_buffer_size_ {0};      ///< SO_RCVBUF, the system default if 0
+        int     send_buffer_size_ {0};      ///< SO_SNDBUF, the system default if 0
+        int     busy_poll_usecs_ {0};       ///< SO_BUSY_POLL, disabled if 0
+        bool    reuse_address_ {true};      ///< lets receivers share a multicast port
+    };
+
+    NONCOPYABLE(DatagramConnection);
+
+    /// \brief constructs a connection
+    /// \param listener the listener of the datagrams received, null for a
+    /// connection that only sends
+    /// \param config the batch sizes and socket options
+    /// \param poll the poller to book the socket in when it is bound
+    DatagramConnection(DatagramListener* listener, const Config& config, FDEventPoller* poll);
+
+    virtual ~DatagramConnection();
+
+    /// \brief opens the socket bound to the local address and starts receiving
+    void bind(const SocketAddress& address);
+
+    /// \brief sets the destination of send, post and flush. Opens the socket if
+    /// it is not bound
+    void setDestination(const SocketAddress& address);
+
+    /// \brief closes the socket. Posted datagrams not flushed are discarded
+    void close();
+
+    /// \brief joins a multicast group on the bound socket, see Socket::joinGroup
+    void joinGroup(const IPAddress& group, const IPAddress& iface = IPAddress())
+    { socket_.joinGroup(group, iface); }
+
+    void leaveGroup(const IPAddress& group, const IPAddress& iface = IPAddress())
+    { socket_.leaveGroup(group, iface); }
+
+    /// \brief joins a multicast group for the datagrams of one source
+    void joinSrcGroup(const IPAddress& group, const IPAddress& source, const IPAddress& iface = IPAddress())
+    { socket_.joinSrcGroup(group, source, iface); }
+
+    void leaveSrcGroup(const IPAddress& group, const IPAddress& source, const IPAddress& iface = IPAddress())
+    { socket_.leaveSrcGroup(group, source, iface); }
+
+    /// \brief sends a datagram to the destination
+    /// \return false if the socket buffer is full and the datagram is dropped
+    bool send(const void* data, size_t length);
+
+    /// \brief sends datagrams to the destination, each in an iovec, by sendmmsg
+    /// \return the number of datagrams sent. The rest are not sent if the socket
+    /// buffer is full
+    size_t send(const struct iovec* datagrams, size_t num);
+
+    /// \brief copies a datagram into the send batch, which is flushed when full
+    /// \return false if the batch is full and the socket buffer is still full,
+    /// and the datagram is not posted
+    /// \note throws NetException if the datagram is longer than max_datagram_size_
+    bool post(const void* data, size_t length);
+
+    /// \brief sends the datagrams posted by sendmmsg
+    /// \return the number of datagrams sent. Datagrams not sent for a full socket
+    /// buffer stay in the batch for the next flush, see pending
+    size_t flush();
+
+    /// \return the number of datagrams posted and not flushed
+    size_t pending() const { return post_num_; }
+
+    Socket& socket() { return socket_; }
+
+    FdId fd() const override { return socket_.socketId(); }
+
+    FDEventIdSet onEvent(Clock::tick_type tick_realtime, FDEventIdSet event_ids) override;
+
+  private:
+    void open(int af);
+
+    /// \brief receives a batch
+    /// \return the number of datagrams received
+    size_t receiveBatch(Clock::tick_type tick_realtime);
+
+    DatagramListener*                       listener_;
+    Config                                  config_;
+    FDEventPoller*                          poll_;
+    Socket                                  socket_;
+    bool                                    booked_ {false};
+    SocketAddress                           destination_;
+
+    // receive slab: slot i is recv_slab_[i * max_datagram_size_]
+    std::unique_ptr<char[]>                 recv_slab_;
+    std::unique_ptr<struct mmsghdr[]>       recv_msgs_;
+    std::unique_ptr<struct iovec[]>         recv_iovs_;
+    std::unique_ptr<struct sockaddr_storage[]> senders_;
+    std::vector<Datagram>                   datagrams_;
+
+    // send batch of post and flush
+    std::unique_ptr<char[]>                 send_slab_;
+    std::unique_ptr<struct mmsghdr[]>       send_msgs_;
+    std::unique_ptr<struct iovec[]>         send_iovs_;
+    size_t                                  post_num_ {0};
+};
+
+} // namespace alt
@@ -18,6 +18,13 @@
 
 namespace alt {
 
+namespace
+{
+    /// \brief tells if the last call failed only because a non-blocking socket
+    /// is not ready
+    inline bool wouldBlock() { return errno == EAGAIN || errno == EWOULDBLOCK; }
+}
+
 using TimeSpan  = std::chrono::duration<int, std::nano>;
 using TimePoint = std::chrono::duration<int, std::nano>;
 
@@ -101,7 +108,7 @@ void Socket::close ()
 void Socket::setOption(int level, int option, const void* optval, socklen_t optlen)
 {
     // Note: cast option_alue to char* to accommodate Windows interface
-    if (::setsockopt(fd_, SOL_SOCKET, option, (const char*)optval, optlen) < 0)
+    if (::setsockopt(fd_, level, option, (const char*)optval, optlen) < 0)
     {
        SYS_ERR_THROW(NetException);
     }
@@ -166,11 +173,11 @@ void Socket::setOption(SocketFlag flag,  bool enable)
                 }
                 if (enable)
                 {
-                    setBits(fh_flags, O_NONBLOCK);
+                    fh_flags = setBits(fh_flags, O_NONBLOCK);
                 }
                 else
                 {
-                    clearBits(fh_flags, O_NONBLOCK);
+                    fh_flags = clearBits(fh_flags, O_NONBLOCK);
                 }
                 if (::fcntl(fd_, F_SETFL,fh_flags) < 0)
                 {   
@@ -201,7 +208,7 @@ void Socket::setOption(SocketFlag flag,  bool enable)
 
 void Socket::getOption (int level, int option, void *optval, socklen_t& optlen) const
 {
-    if (::getsockopt(fd_, SOL_SOCKET, option, (char*)optval, &optlen) < 0)
+    if (::getsockopt(fd_, level, option, (char*)optval, &optlen) < 0)
     {
        SYS_ERR_THROW(NetException);
     }
@@ -486,6 +493,55 @@ Socket* Socket::accept()
 	return new Socket(accept_fd);
 }
 
+SocketId Socket::acceptId(int flags)
+{
+	if (fd_ == INVALID_SOCK_ID)
+    {
+        SYS_ERR_THROW(NetException, "accept from an invalid socket", false);
+    }
+
+	SocketId accept_fd;
+	do
+	{
+#if defined(SOCK_NONBLOCK)
+		accept_fd = ::accept4(fd_, nullptr, nullptr, flags);
+#else
+		accept_fd = ::accept(fd_, nullptr, nullptr);
+#endif
+	}
+	while (accept_fd == INVALID_SOCK_ID && errno == EINTR);
+
+	if (accept_fd == INVALID_SOCK_ID)
+	{
+        switch (errno)
+        {
+            case EAGAIN:
+#if EWOULDBLOCK != EAGAIN
+            case EWOULDBLOCK:
+#endif
+            case ECONNABORTED:
+            case EPROTO:
+            case EPERM:
+            case EMFILE:
+            case ENFILE:
+            case ENOBUFS:
+            case ENOMEM:
+                // no connection pending, or the connection or the resources are
+                // gone. The listener stays usable
+                return INVALID_SOCK_ID;
+            default:
+                SYS_ERR_THROW(NetException, "accept failed");
+        }
+    }
+#if !defined(SOCK_NONBLOCK)
+    if (flags & O_NONBLOCK)
+    {
+        ::fcntl(accept_fd, F_SETFL, ::fcntl(accept_fd, F_GETFL) | O_NONBLOCK);
+    }
+#endif
+	return accept_fd;
+}
+
 int Socket::connect(const SocketAddress& addr)
 {
 	ensureOpen(addr.af(), SOCK_STREAM);
@@ -567,7 +623,7 @@ ssize_t Socket::send(const void* buffer, int length, int flags)
 
     ssize_t res = ::send(fd_, reinterpret_cast<const char*>(buffer), length, flags);
     
-    if (res < 0)
+    if (res < 0 && !wouldBlock())
     {
         StrPrinter<128> err_msg;
         err_msg << "Send from " << address().toString() << " failed";
@@ -592,7 +648,7 @@ ssize_t Socket::send(const struct iovec *iov, int iovcnt, int flags)
     msgHdr.msg_controllen = 0;
     msgHdr.msg_flags = flags;
     ssize_t res = sendmsg(fd_, &msgHdr, flags);
-    if (res < 0)
+    if (res < 0 && !wouldBlock())
     {
         StrPrinter<128> err_msg;
         err_msg << "Send from " << address().toString() << " failed";
@@ -645,7 +701,7 @@ ssize_t Socket::receive(void* buffer, int length, int flags)
 
     ssize_t res = ::recv(fd_, reinterpret_cast<char*>(buffer), length, flags);
     
-    if (res < 0)
+    if (res < 0 && !wouldBlock())
     {
         StrPrinter<128> err_msg;
         err_msg << "Receve at " << address().toString() << " failed";
@@ -670,7 +726,7 @@ ssize_t Socket::receive(struct iovec *iov, int iovcnt, int flags)
     msgHdr.msg_controllen = 0;
     msgHdr.msg_flags = flags;
     ssize_t res = recvmsg(fd_, &msgHdr, flags);
-    if (res < 0)
+    if (res < 0 && !wouldBlock())
     {
         StrPrinter<128> err_msg;
         err_msg << "Receve at " << address().toString() << " failed";
@@ -716,6 +772,82 @@ ssize_t Socket::recvFrom(struct iovec *iov, int iovcnt, const SocketAddress& add
     return res;
 }
 
+void Socket::joinGroup(const IPAddress& group, const IPAddress& iface)
+{
+    changeMembership(true, group, nullptr, iface);
+}
+
+void Socket::leaveGroup(const IPAddress& group, const IPAddress& iface)
+{
+    changeMembership(false, group, nullptr, iface);
+}
+
+void Socket::joinSrcGroup(const IPAddress& group, const IPAddress& source, const IPAddress& iface)
+{
+    changeMembership(true, group, &source, iface);
+}
+
+void Socket::leaveSrcGroup(const IPAddress& group, const IPAddress& source, const IPAddress& iface)
+{
+    changeMembership(false, group, &source, iface);
+}
+
+void Socket::changeMembership(
+    bool join,
+    const IPAddress& group,
+    const IPAddress* source,
+    const IPAddress& iface)
+{
+    ensureOpen(group.af(), SOCK_DGRAM);
+    if (group.family() == IPFamily::IPv4)
+    {
+        struct in_addr if_addr;
+        if_addr.s_addr = iface.family() == IPFamily::IPv4
+            ? static_cast<const in_addr*>(iface.addr())->s_addr
+            : htonl(INADDR_ANY);
+        if (!source)
+        {
+            struct ip_mreq mreq;
+            mreq.imr_multiaddr = *static_cast<const in_addr*>(group.addr());
+            mreq.imr_interface = if_addr;
+            setOption(IPPROTO_IP, join ? IP_ADD_MEMBERSHIP : IP_DROP_MEMBERSHIP, mreq);
+        }
+        else
+        {
+            struct ip_mreq_source mreq;
+            mreq.imr_multiaddr = *static_cast<const in_addr*>(group.addr());
+            mreq.imr_sourceaddr = *static_cast<const in_addr*>(source->addr());
+            mreq.imr_interface = if_addr;
+            setOption(IPPROTO_IP, join ? IP_ADD_SOURCE_MEMBERSHIP : IP_DROP_SOURCE_MEMBERSHIP, mreq);
+        }
+        return;
+    }
+#if ALT_IPV6_AVAILABLE
+    if (group.family() == IPFamily::IPv6)
+    {
+        if (!source)
+        {
+            struct ipv6_mreq mreq;
+            mreq.ipv6mr_multiaddr = *static_cast<const in6_addr*>(group.addr());
+            mreq.ipv6mr_interface = 0;
+            setOption(IPPROTO_IPV6, join ? IPV6_JOIN_GROUP : IPV6_LEAVE_GROUP, mreq);
+        }
+        else
+        {
+            struct group_source_req req {};
+            req.gsr_interface = 0;
+            SocketAddress group_addr(group, WILDCARD_PORT_ID);
+            SocketAddress source_addr(*source, WILDCARD_PORT_ID);
+            ::memcpy(&req.gsr_group, group_addr.addr(), group_addr.addrLength());
+            ::memcpy(&req.gsr_source, source_addr.addr(), source_addr.addrLength());
+            setOption(IPPROTO_IPV6, join ? MCAST_JOIN_SOURCE_GROUP : MCAST_LEAVE_SOURCE_GROUP, req);
+        }
+        return;
+    }
+#endif
+    SYS_ERR_THROW(NetException, "Invalid multicast group address", false);
+}
+
 ssize_t Socket::available()
 {
 	int data_available = 0;
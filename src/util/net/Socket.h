@@ -197,9 +197,13 @@ class ALT_UTIL_PUBLIC Socket
     SocketAddress peerAddress();
 
     /// \brief sends the data in the given buffer
+    /// \return the number of bytes sent, or -1 if the socket is non-blocking and
+    /// not ready to send
     ssize_t send(const void *buffer, int length, int flags);
 
     /// \brief sends the data in the given iovec
+    /// \return the number of bytes sent, or -1 if the socket is non-blocking and
+    /// not ready to send
     ssize_t send(const struct iovec *iov, int iovcnt, int flags);
 
     /// \brief sends message data in T
@@ -228,6 +232,9 @@ class ALT_UTIL_PUBLIC Socket
         return send(&msg, sizeof(msg), flags);
     }
 
+    /// \brief receives data into the given buffer
+    /// \return the number of bytes received, 0 if the peer has closed the
+    /// connection, or -1 if the socket is non-blocking and has no data
     ssize_t receive(void* buffer, int length, int flags=0);
     ssize_t receive(struct iovec *iov, int iovcnt, int flags=0);
 
@@ -252,15 +259,17 @@ class ALT_UTIL_PUBLIC Socket
     /// \brief disable further transimission and data receiving
     void shutdown ();
 
-    /*
-    int joinGroup(uint32_t grpaddr, uint32_t iaddr);
-    int leaveGroup(uint32_t grpaddr, uint32_t iaddr);
+    /// \brief joins a multicast group to receive the datagrams sent to it
+    /// \param group the multicast group address
+    /// \param iface the address of the local interface to join on. The system
+    /// chooses the interface if it is not given, and always for IPv6
+    void joinGroup(const IPAddress& group, const IPAddress& iface = IPAddress());
+    void leaveGroup(const IPAddress& group, const IPAddress& iface = IPAddress());
 
-    // Join a multicast group and allow receiving data only from a
-    // specified source.
-    int joinSrcGroup(uint32_t grpaddr, uint32_t srcaddr, uint32_t iaddr);
-    int leaveSrcGroup(uint32_t grpaddr, uint32_t srcaddr, uint32_t iaddr);
-    */
+    /// \brief joins a multicast group and allows receiving data only from a
+    /// specified source (source-specific multicast)
+    void joinSrcGroup(const IPAddress& group, const IPAddress& source, const IPAddress& iface = IPAddress());
+    void leaveSrcGroup(const IPAddress& group, const IPAddress& source, const IPAddress& iface = IPAddress());
 
     SocketId socketId() const { return fd_; }
     bool initilized () const { return fd_!=INVALID_SOCK_ID; }
@@ -306,6 +315,13 @@ class ALT_UTIL_PUBLIC Socket
     /// \return a new TCP socket with the connection
     Socket* accept();
 
+    /// \brief accepts the connection from a TCP client without creating a Socket
+    /// \param flags SOCK_NONBLOCK and SOCK_CLOEXEC to set on the new socket, as
+    /// accept4 takes them
+    /// \return the socket id of the connection, or INVALID_SOCK_ID if there is no
+    /// pending connection or the connection is aborted
+    SocketId acceptId(int flags);
+
     /// \brief assigns the local end's address to the socket.
     /// \note This is typically for a server socket. For a client socket, however,
     /// the local address and port is normally not of importance unless the server restricts
@@ -319,7 +335,16 @@ class ALT_UTIL_PUBLIC Socket
     /// for this socket may grow.
     void listen(int backlog);
 
+    /// \brief adds or drops a membership of a multicast group, of a source if
+    /// source is not null
+    void changeMembership(
+        bool join,
+        const IPAddress& group,
+        const IPAddress* source,
+        const IPAddress& iface);
+
     friend class StreamConnection;
+    friend class DatagramConnection;
     Socket(SocketId fd);
 
 	SocketId         fd_ {INVALID_SOCK_ID};
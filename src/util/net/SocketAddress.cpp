@@ -27,13 +27,24 @@ SocketAddress::SocketAddress(
 #if ALT_IPV6_AVAILABLE
     if (addr.family()==IPFamily::IPv6)
     {
-        memcpy(&storage_, addr.addr(), sizeof(sockaddr_in6));
+        // addr() is the in6_addr only, so build the sockaddr around it
+        sockaddr_in6* sa = reinterpret_cast<sockaddr_in6*>(&storage_);
+        memset(sa, 0, sizeof(sockaddr_in6));
+        sa->sin6_family = AF_INET6;
+        memcpy(&sa->sin6_addr, addr.addr(), sizeof(sa->sin6_addr));
+        sa->sin6_port = htobe(port);
+        sa->sin6_flowinfo = htobe(flowinfo);
+        sa->sin6_scope_id = htobe(scope);
         return;
     }
 #endif
     if (addr.family()==IPFamily::IPv4)
     {
-        memcpy(&storage_, addr.addr(), sizeof(sockaddr_in));
+        sockaddr_in* sa = reinterpret_cast<sockaddr_in*>(&storage_);
+        memset(sa, 0, sizeof(sockaddr_in));
+        sa->sin_family = AF_INET;
+        memcpy(&sa->sin_addr, addr.addr(), sizeof(sa->sin_addr));
+        sa->sin_port = htobe(port);
         return;
     }
     storage_.ss_family = 0;
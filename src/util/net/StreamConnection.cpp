@@ -11,7 +11,7 @@ StreamConnection::StreamConnection(
     size_t send_buffer_size,
     size_t recv_buffer_size,
     FDEventPoller * poll)
-    : listener_(listener)
+    : listener_(&listener)
     , send_buffer_(send_buffer_size)
     , recv_buffer_(recv_buffer_size)
     , poll_(poll)
@@ -24,7 +24,7 @@ StreamConnection::StreamConnection(
     size_t send_buffer_size,
     size_t recv_buffer_size,
     FDEventPoller * poll)
-    : listener_(listener)
+    : listener_(&listener)
     , send_buffer_(send_buffer_size)
     , recv_buffer_(recv_buffer_size)
     , socket_(fd)
@@ -43,20 +43,49 @@ void StreamConnection::connect(const SocketAddress& address)
     int res = socket_.connect(address);
     if (res==0)
     {
+        socket_.setOption(SocketFlag::NonBlock, true);
         poll_->book(this, FDEventId::EVENT_IN);
         connected_ = true;
     }
     if (res==EAGAIN)
     {
         // try again later
-    }   
+    }
 }
 
+void StreamConnection::open(FdId fd, StreamListener& listener)
+{
+    if (connected_)
+    {
+        SYS_ERR_THROW(NetException, "Already connected", false);
+    }
+    // discard what is left from the last socket
+    std::array<iovec,2> iov;
+    if (send_buffer_.fetchAll(iov))
+    {
+        send_buffer_.commitRead(0);
+    }
+    if (recv_buffer_.fetchAll(iov))
+    {
+        recv_buffer_.commitRead(0);
+    }
+
+    listener_ = &listener;
+    Socket socket(fd);
+    socket_.swap(socket);
+    poll_->book(this, FDEventId::EVENT_IN);
+    connected_ = true;
+}
 
 void StreamConnection::disconnect()
 {
     if (connected_)
     {
+        // remove from the poller before the fd is closed and can be reused
+        if (poll_)
+        {
+            poll_->remove(this);
+        }
         socket_.close();
         connected_ = false;
     }
@@ -64,10 +93,7 @@ void StreamConnection::disconnect()
 
 StreamConnection::~StreamConnection()
 {
-    if (poll_)
-    {
-        poll_->remove(this);
-    }    
+    disconnect();
 }
 
 inline void StreamConnection::bufferSendData(const char *buffer, ssize_t length)
@@ -80,13 +106,18 @@ inline void StreamConnection::bufferSendData(const char *buffer, ssize_t length)
     if (poll_ && !send_buffer_.empty() && buffer_empty_before)
     {
         // book EVENT_OUT in poll so we'll get notified when we can send again
-        poll_->book(this, FDEventId::EVENT_OUT);
+        poll_->book(this, {FDEventId::EVENT_IN, FDEventId::EVENT_OUT});
     }
 }
 
 inline void StreamConnection::sendDirect(const char *buffer, ssize_t length)
 {
-    ssize_t bytes_sent = socket_.send(buffer, length);
+    ssize_t bytes_sent = socket_.send(buffer, int(length), MSG_NOSIGNAL);
+    if (bytes_sent < 0)
+    {
+        // the socket is not ready to send
+        bytes_sent = 0;
+    }
     if (bytes_sent < length)
     {
         bufferSendData(buffer + bytes_sent, length - bytes_sent);
@@ -99,8 +130,12 @@ void StreamConnection::flushSendBuffer()
     size_t data_size = send_buffer_.fetchAll(iov);   // zero copy fetch
     if (data_size)
     {
-        ssize_t bytes_sent = socket_.send(iov, iov[1].iov_len ? 2 : 1);
-        assert(data_size >= bytes_sent);
+        ssize_t bytes_sent = socket_.send(iov.data(), iov[1].iov_len ? 2 : 1, MSG_NOSIGNAL);
+        if (bytes_sent < 0)
+        {
+            bytes_sent = 0;
+        }
+        assert(data_size >= size_t(bytes_sent));
         send_buffer_.commitRead(data_size - bytes_sent /* uncommitted */);
     }
 }
@@ -127,48 +162,111 @@ void StreamConnection::send(const char *buffer, ssize_t length)
     }
 }
 
+void StreamConnection::send(const struct iovec *iov, int iovcnt)
+{
+    if (!send_buffer_.empty())
+    {
+        flushSendBuffer();
+    }
+    ssize_t bytes_sent = 0;
+    if (send_buffer_.empty())
+    {
+        // send all vectors in one call if nothing is pending
+        bytes_sent = socket_.send(iov, iovcnt, MSG_NOSIGNAL);
+        if (bytes_sent < 0)
+        {
+            bytes_sent = 0;
+        }
+    }
+    for (int i = 0; i < iovcnt; ++i)
+    {
+        if (size_t(bytes_sent) >= iov[i].iov_len)
+        {
+            bytes_sent -= iov[i].iov_len;
+            continue;
+        }
+        bufferSendData(static_cast<const char*>(iov[i].iov_base) + bytes_sent,
+            ssize_t(iov[i].iov_len) - bytes_sent);
+        bytes_sent = 0;
+    }
+}
+
 void StreamConnection::receive(Clock::tick_type tick_realtime)
 {
     std::array<iovec,2> iov;
     ssize_t bytes_got;
+    size_t buffer_size;
     do
     {
-        size_t buffer_size = recv_buffer_.fetchFreeSpace(iov);
+        buffer_size = recv_buffer_.fetchFreeSpace(iov);
         if (buffer_size == 0)
         {
             SYS_ERR_THROW(NetException, "StreamConnection receive failed. Buffer is full", false);
         }
-        
+
         if (iov[1].iov_len==0)
         {
-            bytes_got = socket_.receive(iov[0].iov_base, (iov[0].iov_len));
+            bytes_got = socket_.receive(iov[0].iov_base, int(iov[0].iov_len));
         }
         else
         {
-            bytes_got = socket_.receive(&iov[0], 2);
+            bytes_got = socket_.receive(iov.data(), 2);
+        }
+        if (bytes_got == 0)
+        {
+            // the peer has closed the connection
+            listener_->onStreamClosed(tick_realtime, *this);
+            onClosed(tick_realtime);
+            return;
+        }
+        if (bytes_got < 0)
+        {
+            // no more data on a non-blocking socket
+            return;
         }
         recv_buffer_.commitWrite(bytes_got);
-        listener_.onStreamData(tick_realtime, recv_buffer_);
+        listener_->onStreamData(tick_realtime, recv_buffer_);
     }
-    while (bytes_got > 0);
+    // a read short of the free space has drained the socket
+    while (connected_ && size_t(bytes_got) == buffer_size);
 }
 
+void StreamConnection::onClosed(Clock::tick_type)
+{
+    disconnect();
+}
 
 FDEventIdSet StreamConnection::onEvent(Clock::tick_type tick_realtime, FDEventIdSet event_ids)
 {
     FDEventIdSet done_set;
-    if (event_ids.has(FDEventId::EVENT_OUT))
+    if (!connected_)
     {
-        flushSendBuffer();
-        if (send_buffer_.empty())
+        return done_set;
+    }
+    try
+    {
+        if (event_ids.has(FDEventId::EVENT_OUT))
+        {
+            flushSendBuffer();
+            if (send_buffer_.empty())
+            {
+                // no longer interested in EVENT_OUT
+                done_set += FDEventId::EVENT_OUT;
+            }
+        }
+        if (event_ids.has(FDEventId::EVENT_IN) || event_ids.has(FDEventId::EVENT_ERROR))
         {
-            // no longer interested in EVENT_OUT
-            done_set += FDEventId::EVENT_OUT;
+            receive(tick_realtime);
         }
     }
-    else if (event_ids.has(FDEventId::EVENT_IN))
+    catch (NetException&)
     {
-        receive(tick_realtime);
+        // a reset connection fails in receive or send
+        if (connected_)
+        {
+            listener_->onStreamClosed(tick_realtime, *this);
+            onClosed(tick_realtime);
+        }
     }
     return done_set;
 }
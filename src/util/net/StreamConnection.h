@@ -6,10 +6,24 @@
 
 namespace alt {
 
+class StreamConnection;
+
+/**
+ * \class StreamListener
+ * \ingroup NetUtil
+ * \brief Listens to the data received by a StreamConnection
+ */
 class StreamListener
 {
   public:
-    virtual void onStreamData(Clock::tick_type, RingBuffer& data);
+    /// \brief called when data are received. The listener takes the data it
+    /// handles by data.commitRead
+    virtual void onStreamData(Clock::tick_type, RingBuffer& data) = 0;
+
+    /// \brief called when the peer has closed the connection
+    virtual void onStreamClosed(Clock::tick_type, StreamConnection&) {}
+
+    virtual ~StreamListener() {}
 };
 
 /**
@@ -39,6 +53,17 @@ class ALT_UTIL_PUBLIC StreamConnection: public FDEventHandler
     void connect(const SocketAddress& address);
     void disconnect();
 
+    /// \brief opens a disconnected connection on an accepted socket, so that
+    /// a connection and its buffers can be reused for another socket
+    /// \param fd the accepted socket, which should be non-blocking
+    /// \param listener the listener of the new data stream
+    void open(FdId fd, StreamListener& listener);
+
+    bool connected() const { return connected_; }
+
+    /// \brief sets the listener of the data stream
+    void setListener(StreamListener& listener) { listener_ = &listener; }
+
     /// \brief sends the data in the given buffer
     void send(const char *buffer, ssize_t length);
 
@@ -49,13 +74,19 @@ class ALT_UTIL_PUBLIC StreamConnection: public FDEventHandler
     template <typename T>
     void send(const T& msg)
     {
-        return send(&msg, sizeof(msg));
+        return send(reinterpret_cast<const char*>(&msg), sizeof(msg));
     }
 
     FdId fd() const override { return socket_.socketId(); }
 
     FDEventIdSet onEvent(Clock::tick_type tick_realtime, FDEventIdSet event_ids) override;
 
+  protected:
+
+    /// \brief called when the peer has closed the connection or the connection
+    /// failed, after the listener is notified. The default disconnects
+    virtual void onClosed(Clock::tick_type tick_realtime);
+
   private:
 
     void receive(Clock::tick_type tick_realtime);
@@ -64,7 +95,7 @@ class ALT_UTIL_PUBLIC StreamConnection: public FDEventHandler
     void bufferSendData(const char *buffer, ssize_t length);
     void flushSendBuffer();
 
-    StreamListener&   listener_;
+    StreamListener*   listener_;
     RingBuffer        send_buffer_;
     RingBuffer        recv_buffer_;
     Socket            socket_;
@@ -0,0 +1,352 @@
+#include "StreamServer.h"               // for StreamServer, this class
+
+#include <util/ipc/Thread.h>            // for Thread
+#include <util/system/SysError.h>       // for SYS_ERR_THROW
+
+#include <atomic>                       // for atomic
+#include <errno.h>                      // for EMFILE, ENFILE
+#include <fcntl.h>                      // for open
+#include <netinet/tcp.h>                // for TCP_NODELAY
+#include <unistd.h>                     // for close
+
+namespace alt {
+
+namespace
+{
+    /// \brief the message handing an accepted socket to a worker
+    struct AcceptedMsg: CoQueueMsg
+    {
+        static constexpr uint32_t MSG_TYPE = 1;
+        explicit AcceptedMsg(FdId fd) : CoQueueMsg(MSG_TYPE), fd_(fd) {}
+        FdId    fd_;
+    };
+}
+
+//-----------------------------------------------------------------------------------------
+// StreamServer::ServerConnection
+//-----------------------------------------------------------------------------------------
+class StreamServer::ServerConnection: public StreamConnection
+{
+  public:
+    ServerConnection(Worker& worker, const Config& config, FDEventPoller* poller, StreamListener& idle)
+        : StreamConnection(idle, config.send_buffer_size_, config.recv_buffer_size_, poller)
+        , worker_(worker)
+    {}
+
+  protected:
+    void onClosed(Clock::tick_type tick_realtime) override;
+
+  private:
+    Worker&     worker_;
+};
+
+//-----------------------------------------------------------------------------------------
+// StreamServer::Acceptor
+//-----------------------------------------------------------------------------------------
+class StreamServer::Acceptor: public FDEventHandler, private Socket
+{
+  public:
+    Acceptor(StreamServer& server, Worker& worker)
+        : server_(server)
+        , worker_(worker)
+        , spare_fd_(openSpare())
+    {}
+
+    ~Acceptor()
+    {
+        if (spare_fd_ >= 0)
+        {
+            ::close(spare_fd_);
+        }
+    }
+
+    /// \brief binds and listens on the address. SO_REUSEPORT lets the listeners
+    /// of all workers bind the same address
+    void listen(const SocketAddress& address);
+
+    PortId port() { return address().port(); }
+
+    FdId fd() const override { return socketId(); }
+
+    FDEventIdSet onEvent(Clock::tick_type tick_realtime, FDEventIdSet event_ids) override;
+
+  private:
+    static FdId openSpare() { return ::open("/dev/null", O_RDONLY | O_CLOEXEC); }
+
+    /// \brief accepts and closes the next connection on the spare descriptor
+    void shedConnection();
+
+    StreamServer&   server_;
+    Worker&         worker_;
+    size_t          next_worker_ {0};   ///< the worker to hand the next socket to
+    FdId            spare_fd_;          ///< reserved for shedConnection
+};
+
+//-----------------------------------------------------------------------------------------
+// StreamServer::Worker
+//-----------------------------------------------------------------------------------------
+class StreamServer::Worker: public CoQueueMsgHandler, private StreamListener
+{
+  public:
+    explicit Worker(StreamServer& server);
+    ~Worker();
+
+    /// \brief opens a pooled connection on an accepted socket. Called in the
+    /// worker thread
+    void open(Clock::tick_type tick_realtime, FdId fd);
+
+    /// \brief puts a closed connection back to the pool
+    void recycle(ServerConnection* connection);
+
+    void processMessage(Clock::tick_type tick_realtime, const CoQueueMsg* msg) override;
+
+    void start();
+    void stop();
+
+    StreamServer&                                   server_;
+    Thread                                          thread_;
+    FDEventPoller*                                  poller_;        ///< owned by the reactor
+    std::unique_ptr<Acceptor>                       acceptor_;
+    std::vector<std::unique_ptr<ServerConnection>>  connections_;
+    std::vector<ServerConnection*>                  free_connections_;
+    std::atomic<size_t>                             open_num_ {0};
+
+  private:
+    // the listener of idle connections in the pool, which receive nothing
+    void onStreamData(Clock::tick_type, RingBuffer&) override {}
+
+    ServerConnection* acquire();
+};
+
+void StreamServer::ServerConnection::onClosed(Clock::tick_type)
+{
+    worker_.server_.handler_.onDisconnect(*this);
+    disconnect();
+    worker_.recycle(this);
+}
+
+void StreamServer::Acceptor::listen(const SocketAddress& address)
+{
+    ensureOpen(address.af(), SOCK_STREAM);
+    setOption(SocketFlag::ReuseAddr, true);
+    setOption(SocketFlag::NonBlock, true);
+    if (server_.config_.reuse_port_)
+    {
+        setOption(SocketFlag::ReusePort, true);
+    }
+    bind(address);
+    Socket::listen(server_.config_.backlog_);
+}
+
+FDEventIdSet StreamServer::Acceptor::onEvent(Clock::tick_type tick_realtime, FDEventIdSet)
+{
+    auto& workers = server_.workers_;
+    // drain the backlog, the listener is level triggered
+    SocketId fd;
+    while ((fd = acceptId(SOCK_NONBLOCK | SOCK_CLOEXEC)) != INVALID_SOCK_ID)
+    {
+        if (server_.config_.reuse_port_ || workers.size() == 1)
+        {
+            worker_.open(tick_realtime, fd);
+            continue;
+        }
+        Worker& worker = *workers[next_worker_];
+        next_worker_ = next_worker_ + 1 == workers.size() ? 0 : next_worker_ + 1;
+        if (&worker == &worker_)
+        {
+            worker_.open(tick_realtime, fd);
+        }
+        else
+        {
+            worker.thread_.reactor().notify<AcceptedMsg>(fd);
+        }
+    }
+    if (errno == EMFILE || errno == ENFILE)
+    {
+        shedConnection();
+    }
+    return FDEventIdSet();
+}
+
+void StreamServer::Acceptor::shedConnection()
+{
+    // Out of descriptors, the connection stays in the backlog and the level
+    // triggered listener would be polled again at once. Free the spare descriptor
+    // to accept the connection and close it, so the client sees it closed
+    if (spare_fd_ >= 0)
+    {
+        ::close(spare_fd_);
+    }
+    SocketId fd = ::accept(socketId(), nullptr, nullptr);
+    if (fd != INVALID_SOCK_ID)
+    {
+        ::close(fd);
+    }
+    spare_fd_ = openSpare();
+}
+
+StreamServer::Worker::Worker(StreamServer& server)
+    : server_(server)
+    , poller_(new FDEventPoller())
+{
+    thread_.reactor().setEventPoller(poller_);
+    thread_.reactor().createThreadMsgPoller(*this, 64);
+    connections_.reserve(server.config_.pool_size_);
+    for (size_t i = 0; i < server.config_.pool_size_; ++i)
+    {
+        connections_.emplace_back(new ServerConnection(*this, server.config_, poller_, *this));
+        free_connections_.push_back(connections_.back().get());
+    }
+}
+
+StreamServer::Worker::~Worker()
+{
+    stop();
+}
+
+StreamServer::ServerConnection* StreamServer::Worker::acquire()
+{
+    if (free_connections_.empty())
+    {
+        connections_.emplace_back(new ServerConnection(*this, server_.config_, poller_, *this));
+        return connections_.back().get();
+    }
+    ServerConnection* connection = free_connections_.back();
+    free_connections_.pop_back();
+    return connection;
+}
+
+void StreamServer::Worker::open(Clock::tick_type, FdId fd)
+{
+    ServerConnection* connection = acquire();
+    connection->open(fd, *this);
+    if (server_.config_.no_delay_)
+    {
+        int value = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    open_num_.fetch_add(1, std::memory_order_relaxed);
+    connection->setListener(server_.handler_.onConnect(*connection));
+}
+
+void StreamServer::Worker::recycle(ServerConnection* connection)
+{
+    open_num_.fetch_sub(1, std::memory_order_relaxed);
+    free_connections_.push_back(connection);
+}
+
+void StreamServer::Worker::processMessage(Clock::tick_type tick_realtime, const CoQueueMsg* msg)
+{
+    if (msg->msg_type_ == AcceptedMsg::MSG_TYPE)
+    {
+        open(tick_realtime, static_cast<const AcceptedMsg*>(msg)->fd_);
+    }
+}
+
+void StreamServer::Worker::start()
+{
+    if (acceptor_)
+    {
+        poller_->book(acceptor_.get(), FDEventId::EVENT_IN);
+    }
+    thread_.start([this]() { thread_.reactor().run(); });
+}
+
+void StreamServer::Worker::stop()
+{
+    if (thread_.status() != Thread::e_Started)
+    {
+        return;
+    }
+    thread_.terminate();
+    // the thread is gone, close the connections here
+    for (auto& connection: connections_)
+    {
+        if (connection->connected())
+        {
+            connection->disconnect();
+        }
+    }
+    free_connections_.clear();
+    for (auto& connection: connections_)
+    {
+        free_connections_.push_back(connection.get());
+    }
+    open_num_.store(0, std::memory_order_relaxed);
+}
+
+//-----------------------------------------------------------------------------------------
+// StreamServer
+//-----------------------------------------------------------------------------------------
+StreamServer::StreamServer(const Config& config, StreamServerHandler& handler)
+    : config_(config)
+    , handler_(handler)
+{
+    if (config_.worker_num_ == 0)
+    {
+        config_.worker_num_ = 1;
+    }
+}
+
+StreamServer::~StreamServer()
+{
+    stop();
+}
+
+void StreamServer::start()
+{
+    if (!workers_.empty())
+    {
+        SYS_ERR_THROW(NetException, "StreamServer already started", false);
+    }
+    try
+    {
+        SocketAddress address = config_.address_;
+        for (size_t i = 0; i < config_.worker_num_; ++i)
+        {
+            workers_.emplace_back(new Worker(*this));
+            if (i == 0 || config_.reuse_port_)
+            {
+                Worker& worker = *workers_.back();
+                worker.acceptor_.reset(new Acceptor(*this, worker));
+                worker.acceptor_->listen(address);
+                if (i == 0)
+                {
+                    // later listeners bind the port picked for a zero port
+                    port_ = worker.acceptor_->port();
+                    address = SocketAddress(address.ipAddr(), port_);
+                }
+            }
+        }
+    }
+    catch (...)
+    {
+        workers_.clear();
+        throw;
+    }
+    for (auto& worker: workers_)
+    {
+        worker->start();
+    }
+}
+
+void StreamServer::stop()
+{
+    for (auto& worker: workers_)
+    {
+        worker->stop();
+    }
+    workers_.clear();
+}
+
+size_t StreamServer::connectionNum() const
+{
+    size_t num = 0;
+    for (auto& worker: workers_)
+    {
+        num += worker->open_num_.load(std::memory_order_relaxed);
+    }
+    return num;
+}
+
+} // namespace alt
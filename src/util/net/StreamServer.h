@@ -0,0 +1,106 @@
+#pragma once
+
+#include "StreamConnection.h"               // for StreamConnection
+#include "SocketAddress.h"                  // for SocketAddress
+#include <util/types/TemplateHelper.h>      // for NONCOPYABLE
+#include <memory>                           // for unique_ptr
+#include <vector>                           // for vector
+
+namespace alt {
+
+/**
+ * \class StreamServerHandler
+ * \ingroup NetUtil
+ * \brief Handles the connections accepted by a StreamServer. Both callbacks are
+ * called in the worker thread owning the connection.
+ */
+class StreamServerHandler
+{
+  public:
+    /// \brief called when a connection is accepted
+    /// \return the listener of the data received on the connection
+    virtual StreamListener& onConnect(StreamConnection& connection) = 0;
+
+    /// \brief called when the connection is closed by the peer or fails. The
+    /// connection is reused for another client after the call
+    virtual void onDisconnect(StreamConnection&) {}
+
+    virtual ~StreamServerHandler() {}
+};
+
+/**
+ * \class StreamServer
+ * \ingroup NetUtil
+ * \brief Accepts TCP connections on a number of worker threads, each running its
+ * own Reactor with an FDEventPoller, so that inbound connections are spread
+ * across cores.
+ *
+ * With reuse_port_ set, each worker listens on its own SO_REUSEPORT socket bound
+ * to the same address, and the kernel balances new connections between them.
+ * Otherwise the first worker listens alone and hands accepted sockets to the
+ * workers in turn through Reactor::notify. Either way sockets are accepted by
+ * accept4 as non-blocking, and opened on StreamConnections pooled by the worker,
+ * so accepting a connection allocates nothing once the pool is warm.
+ *
+ * Example:
+ * @code
+ *   StreamServer::Config config;
+ *   config.address_ = SocketAddress::fromString("0.0.0.0:9000");
+ *   config.worker_num_ = 4;
+ *   StreamServer server(config, handler);
+ *   server.start();
+ *   ...
+ *   server.stop();
+ * @endcode
+ */
+class ALT_UTIL_PUBLIC StreamServer
+{
+  public:
+    struct Config
+    {
+        SocketAddress   address_;                   ///< a zero port picks a free one
+        size_t          worker_num_ {1};
+        bool            reuse_port_ {true};         ///< a listener per worker if true
+        bool            no_delay_ {true};           ///< sets TCP_NODELAY on connections
+        int             backlog_ {128};
+        size_t          send_buffer_size_ {64*1024};
+        size_t          recv_buffer_size_ {64*1024};
+        size_t          pool_size_ {16};            ///< connections created per worker at start
+    };
+
+    NONCOPYABLE(StreamServer);
+
+    /// \brief constructs a server. The handler must outlive the server
+    StreamServer(const Config& config, StreamServerHandler& handler);
+
+    /// \brief stops the server if it is running
+    ~StreamServer();
+
+    /// \brief binds the listeners and starts the worker threads
+    /// \note throws NetException if the address cannot be bound
+    void start();
+
+    /// \brief stops the worker threads and closes all connections
+    void stop();
+
+    /// \return the port listened on, which is known after start if the
+    /// configured port is zero
+    PortId port() const { return port_; }
+
+    /// \return the number of connections open on all workers
+    size_t connectionNum() const;
+
+    const Config& config() const { return config_; }
+
+  private:
+    class Acceptor;
+    class Worker;
+    class ServerConnection;
+
+    Config                                  config_;
+    StreamServerHandler&                    handler_;
+    std::vector<std::unique_ptr<Worker>>    workers_;
+    PortId                                  port_ {WILDCARD_PORT_ID};
+};
+
+} // namespace alt
@@ -0,0 +1,87 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file FastFloat.h
+ * @library alt_util
+ * @brief Fast conversion between decimal text and numbers:
+ *    - isEightDigits/parseEightDigits: SWAR check and conversion of 8 digits
+ *      at a time
+ *    - decimalToDouble: correctly rounded conversion of w * 10^q, by Clinger's
+ *      fast path for exact cases and by the Eisel-Lemire algorithm otherwise
+ *    - parseDouble: a correctly rounded replacement of strtod for decimal text.
+ *      Only a number with more than 19 significant digits whose rounding depends
+ *      on the digits dropped falls back to strtod
+ *    - formatShortest: the shortest text that parses back to the same double,
+ *      by the Schubfach algorithm
+ *    - formatFixed: exactly rounded text with a fixed number of decimals as
+ *      printf "%.*f" prints
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <cstring>                      // for memcpy
+
+namespace alt
+{
+
+/// \brief tells if the 8 chars at p are all decimal digits
+inline bool isEightDigits(const char* p)
+{
+    uint64_t val;
+    ::memcpy(&val, p, sizeof(val));
+    return (((val & 0xF0F0F0F0F0F0F0F0) |
+             (((val + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+            0x3333333333333333);
+}
+
+/// \brief converts 8 decimal digits at p into a number
+/// \note the chars must be checked by isEightDigits
+inline uint32_t parseEightDigits(const char* p)
+{
+    uint64_t val;
+    ::memcpy(&val, p, sizeof(val));
+    val -= 0x3030303030303030;
+    // combine adjacent digits into 2 digits in a byte, then 4 digits in 16 bits,
+    // then 8 digits in 32 bits
+    val = (val * 10) + (val >> 8);
+    val = (((val & 0x000000FF000000FF) * 0x000F424000000064) +
+           (((val >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >> 32;
+    return uint32_t(val);
+}
+
+/// \brief converts mantissa * 10^exp10 into the nearest double. The result is
+/// correctly rounded as the mantissa is exact
+double decimalToDouble(uint64_t mantissa, int64_t exp10);
+
+/// \brief parses a decimal number in [begin, end) into the nearest double. The
+/// text is an optional sign, digits with an optional fraction, and an optional
+/// exponent, as in Json.
+/// \return the end of the number parsed, or begin with value set to 0 if there
+/// is no number
+const char* parseDouble(const char* begin, const char* end, double& value);
+
+/// \brief the buffer size formatShortest needs
+constexpr size_t SHORTEST_DOUBLE_CHARS = 25;
+
+/// \brief writes the shortest text that parses back to val. The text is laid out
+/// as Javascript and Json do: integers below 10^21 without a decimal point, fixed
+/// notation down to 0.000001 and an exponent such as 1.5e-7 or 1e+21 otherwise
+/// \param buffer of SHORTEST_DOUBLE_CHARS chars at least, not null terminated
+/// \return the length of the text
+size_t formatShortest(double val, char* buffer);
+size_t formatShortest(float val, char* buffer);
+
+/// \brief writes val with the given number of decimals, rounded half to even
+/// from the exact binary value as printf "%.*f" does
+/// \param buffer the buffer, not null terminated
+/// \param size size of the buffer
+/// \return the length of the text. The text does not fit and is not complete
+/// if the length is not less than size
+size_t formatFixed(double val, int precision, char* buffer, size_t size);
+
+} // namespace alt
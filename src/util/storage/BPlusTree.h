@@ -0,0 +1,680 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file BPlusTree.h
+ * @library alt_util
+ * @brief Defines a B+tree sorted set for large numbers of keys. Compared to
+ * SortedArray, an insert or erase moves at most one node of keys instead of half
+ * of the array. Compared to std::set, keys are packed in nodes of a few cache
+ * lines with no per-key allocation or pointers:
+ *    - nodes are allocated from a FixedMemPool in slots of whole cache lines
+ *    - keys in a node are searched with SortedSearch for arithmetic keys
+ *    - leaves are linked for range iteration in both directions
+ *    - a tree can be bulk loaded from sorted keys with full nodes
+ */
+
+#include "FixedMemPool.h"               // for FixedMemPool
+#include "SortedSearch.h"               // for SortedSearch, SortedCompareOrder
+#include <util/system/SysConfig.h>      // for EXPECTED_CACHE_LINE_SIZE
+#include <util/types/TemplateHelper.h>  // for NONCOPYABLE
+#include <functional>                   // for less
+#include <algorithm>                    // for lower_bound, upper_bound
+#include <type_traits>                  // for is_trivially_copyable
+#include <iterator>                     // for bidirectional_iterator_tag
+#include <cstring>                      // for memmove, memcpy
+#include <stdexcept>                    // for runtime_error
+#include <vector>                       // for vector
+#include <new>                          // for placement new
+#include <string>
+
+namespace alt {
+
+/**
+ * \class BPlusTree
+ * \ingroup StorageUtils
+ * \brief A B+tree sorted set. Equal keys are allowed unless inserted as unique,
+ * and are kept in the order of insertion.
+ * \tparam Key the key type, must be trivially copyable
+ * \tparam Compare the order of keys. Keys in a node are searched with SIMD compares
+ * when the order is std::less or std::greater on integral keys.
+ * \tparam NodeLines number of cache lines of a node, including the pool header
+ * \note Inserting and erasing invalidate iterators.
+ */
+template <typename Key, class Compare = std::less<Key>, size_t NodeLines = 4>
+class BPlusTree
+{
+    static_assert(std::is_trivially_copyable<Key>::value, "BPlusTree key must be trivially copyable");
+
+    constexpr static size_t NODE_SIZE =
+        NodeLines * EXPECTED_CACHE_LINE_SIZE - FixedMemPool::SLOT_HEADER_SIZE;
+
+    struct Leaf;
+    struct Inner;
+
+  public:
+    /// maximum number of keys in a leaf
+    constexpr static size_t LEAF_CAPACITY =
+        (NODE_SIZE - sizeof(uint32_t) - 2*sizeof(Leaf*)) / sizeof(Key);
+    /// maximum number of keys in an inner node, which has one more child
+    constexpr static size_t INNER_CAPACITY =
+        (NODE_SIZE - sizeof(uint32_t) - sizeof(void*)) / (sizeof(Key) + sizeof(void*));
+
+    static_assert(LEAF_CAPACITY >= 4 && INNER_CAPACITY >= 4, "BPlusTree node is too small for the key");
+
+  private:
+    constexpr static size_t LEAF_MIN = LEAF_CAPACITY / 2;
+    constexpr static size_t INNER_MIN = INNER_CAPACITY / 2;
+    // enough for more than 2^64 keys with the minimum fan-out of 3
+    constexpr static size_t MAX_HEIGHT = 48;
+
+    struct Leaf
+    {
+        uint32_t    num_ {0};
+        Key         keys_[LEAF_CAPACITY];
+        Leaf*       prev_ {nullptr};
+        Leaf*       next_ {nullptr};
+    };
+
+    // keys_[i] separates children_[i] and children_[i+1]: keys in children_[i] are
+    // not ordered after keys_[i], and keys in children_[i+1] are not ordered before
+    struct Inner
+    {
+        uint32_t    num_ {0};
+        Key         keys_[INNER_CAPACITY];
+        void*       children_[INNER_CAPACITY+1];
+    };
+
+    static_assert(sizeof(Leaf) <= NODE_SIZE && sizeof(Inner) <= NODE_SIZE);
+
+    struct PathEntry
+    {
+        Inner*      node_;
+        size_t      ix_;        ///< index of the child descended into
+    };
+
+    struct Path
+    {
+        PathEntry   entries_[MAX_HEIGHT];
+        Leaf*       leaf_;
+    };
+
+  public:
+    using value_type      = Key;
+    using key_compare     = Compare;
+    using size_type       = size_t;
+
+    /**
+     * \class const_iterator
+     * \brief Bidirectional iterator over keys in order
+     */
+    class const_iterator
+    {
+        const BPlusTree*    tree_ {nullptr};
+        const Leaf*         leaf_ {nullptr};
+        size_t              ix_ {0};
+        const_iterator(const BPlusTree* tree, const Leaf* leaf, size_t ix)
+            : tree_(tree), leaf_(leaf), ix_(ix)
+        {
+            if (leaf_ && ix_ >= leaf_->num_)
+            {
+                leaf_ = leaf_->next_;
+                ix_ = 0;
+            }
+        }
+        friend class BPlusTree;
+
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = Key;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const Key*;
+        using reference         = const Key&;
+
+        const_iterator() = default;
+        bool operator==(const const_iterator& oth) const { return leaf_==oth.leaf_ && ix_==oth.ix_; }
+        bool operator!=(const const_iterator& oth) const { return !(*this==oth); }
+        const Key& operator*() const { return leaf_->keys_[ix_]; }
+        const Key* operator->() const { return &leaf_->keys_[ix_]; }
+        const_iterator& operator++()
+        {
+            if (++ix_ >= leaf_->num_)
+            {
+                leaf_ = leaf_->next_;
+                ix_ = 0;
+            }
+            return *this;
+        }
+        const_iterator& operator--()
+        {
+            if (!leaf_)
+            {
+                leaf_ = tree_->last_leaf_;
+                ix_ = leaf_->num_ - 1;
+            }
+            else if (ix_ == 0)
+            {
+                leaf_ = leaf_->prev_;
+                ix_ = leaf_->num_ - 1;
+            }
+            else
+            {
+                --ix_;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) { const_iterator res = *this; ++*this; return res; }
+        const_iterator operator--(int) { const_iterator res = *this; --*this; return res; }
+    };
+
+    using iterator = const_iterator;
+
+    /// \brief constructor
+    /// \param nodes_per_slab number of nodes allocated together when the pool grows
+    explicit BPlusTree(size_t nodes_per_slab = 64)
+        : pool_(NODE_SIZE, nodes_per_slab)
+    {}
+
+    /// \brief constructs a tree by bulk loading keys sorted by Compare
+    template <typename InputIt>
+    BPlusTree(InputIt first, InputIt last, size_t nodes_per_slab = 64)
+        : pool_(NODE_SIZE, nodes_per_slab)
+    {
+        assign(first, last);
+    }
+
+    NONCOPYABLE(BPlusTree);
+
+    const_iterator begin() const { return const_iterator(this, first_leaf_, 0); }
+    const_iterator end() const { return const_iterator(this, nullptr, 0); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t height() const { return root_ ? height_ + 1 : 0; }
+
+    /// \brief returns the iterator to the first key not ordered before x
+    const_iterator lowBound(const Key& x) const
+    {
+        if (!root_) return end();
+        const Leaf* leaf = descend<false>(x, nullptr);
+        return const_iterator(this, leaf, countBefore<false>(leaf->keys_, leaf->num_, x));
+    }
+
+    /// \brief returns the iterator to the first key ordered after x
+    const_iterator upBound(const Key& x) const
+    {
+        if (!root_) return end();
+        const Leaf* leaf = descend<true>(x, nullptr);
+        return const_iterator(this, leaf, countBefore<true>(leaf->keys_, leaf->num_, x));
+    }
+
+    /// \brief returns the iterator to the first key equal to x, or end() if not found
+    const_iterator find(const Key& x) const
+    {
+        const_iterator iter = lowBound(x);
+        return iter != end() && !Compare()(x, *iter) ? iter : end();
+    }
+
+    bool contains(const Key& x) const { return find(x) != end(); }
+
+    /// \brief inserts a key after all keys equal to it
+    /// \param unique if true the key will not be inserted if it already exists
+    /// \return true if the key is inserted
+    bool insert(const Key& x, bool unique = false)
+    {
+        if (!root_)
+        {
+            Leaf* leaf = newLeaf();
+            root_ = first_leaf_ = last_leaf_ = leaf;
+            height_ = 0;
+        }
+        Path path;
+        Leaf* leaf = descend<true>(x, &path);
+        size_t pos = countBefore<true>(leaf->keys_, leaf->num_, x);
+        if (unique)
+        {
+            const Leaf* prev = pos > 0 ? leaf : leaf->prev_;
+            if (prev && !Compare()(prev->keys_[(pos > 0 ? pos : prev->num_) - 1], x))
+            {
+                return false;
+            }
+        }
+        ++size_;
+        if (leaf->num_ < LEAF_CAPACITY)
+        {
+            insertAt(leaf->keys_, leaf->num_, pos, x);
+            ++leaf->num_;
+            return true;
+        }
+        splitLeaf(path, pos, x);
+        return true;
+    }
+
+    /// \brief erases all keys equal to x
+    /// \return the number of keys erased
+    size_t erase(const Key& x)
+    {
+        size_t erased = 0;
+        while (eraseOne(x))
+        {
+            ++erased;
+        }
+        return erased;
+    }
+
+    /// \brief replaces the content with keys sorted by Compare. Leaves and inner
+    /// nodes are filled evenly and as full as possible
+    /// \throw std::runtime_error if the keys are not sorted
+    template <typename InputIt>
+    void assign(InputIt first, InputIt last)
+    {
+        clear();
+        std::vector<Key> keys(first, last);
+        for (size_t ix = 1; ix < keys.size(); ++ix)
+        {
+            if (Compare()(keys[ix], keys[ix-1]))
+            {
+                throw std::runtime_error(std::string("BPlusTree::assign: keys are not sorted"));
+            }
+        }
+        if (keys.empty())
+        {
+            return;
+        }
+        // build leaves, each child is given with its smallest key as the separator
+        std::vector<std::pair<Key, void*>> level;
+        size_t leaf_num = (keys.size() + LEAF_CAPACITY - 1) / LEAF_CAPACITY;
+        size_t pos = 0;
+        for (size_t ix = 0; ix < leaf_num; ++ix)
+        {
+            size_t num = evenShare(keys.size(), leaf_num, ix);
+            Leaf* leaf = newLeaf();
+            std::memcpy(leaf->keys_, &keys[pos], num*sizeof(Key));
+            leaf->num_ = uint32_t(num);
+            leaf->prev_ = last_leaf_;
+            if (last_leaf_) last_leaf_->next_ = leaf; else first_leaf_ = leaf;
+            last_leaf_ = leaf;
+            level.emplace_back(keys[pos], leaf);
+            pos += num;
+        }
+        size_ = keys.size();
+        height_ = 0;
+        // build inner levels until one node is left as the root
+        while (level.size() > 1)
+        {
+            std::vector<std::pair<Key, void*>> upper;
+            size_t node_num = (level.size() + INNER_CAPACITY) / (INNER_CAPACITY + 1);
+            size_t child = 0;
+            for (size_t ix = 0; ix < node_num; ++ix)
+            {
+                size_t num = evenShare(level.size(), node_num, ix);
+                Inner* node = newInner();
+                node->num_ = uint32_t(num - 1);
+                for (size_t c = 0; c < num; ++c)
+                {
+                    node->children_[c] = level[child+c].second;
+                    if (c > 0) node->keys_[c-1] = level[child+c].first;
+                }
+                upper.emplace_back(level[child].first, node);
+                child += num;
+            }
+            level.swap(upper);
+            ++height_;
+        }
+        root_ = level[0].second;
+    }
+
+    /// \brief removes all keys
+    void clear()
+    {
+        if (root_)
+        {
+            freeTree(root_, height_);
+        }
+        root_ = nullptr;
+        first_leaf_ = last_leaf_ = nullptr;
+        height_ = 0;
+        size_ = 0;
+    }
+
+  private:
+    /// \brief returns the number of the ix-th share when dividing total into num
+    static size_t evenShare(size_t total, size_t num, size_t ix)
+    {
+        return total / num + (ix < total % num ? 1 : 0);
+    }
+
+    /// \brief returns the number of keys ordered before x, or before or equal to
+    /// x if Inclusive
+    template <bool Inclusive>
+    static size_t countBefore(const Key* keys, size_t num, const Key& x)
+    {
+        using Order = SortedCompareOrder<Compare>;
+        if constexpr (Order::KNOWN && std::is_arithmetic<Key>::value)
+        {
+            return Inclusive ? SortedSearch<Key, Order::ASCENDING>::upBound(keys, num, x)
+                             : SortedSearch<Key, Order::ASCENDING>::lowBound(keys, num, x);
+        }
+        else
+        {
+            return Inclusive ? std::upper_bound(keys, keys + num, x, Compare()) - keys
+                             : std::lower_bound(keys, keys + num, x, Compare()) - keys;
+        }
+    }
+
+    /// \brief descends to the leaf where the first key not ordered before x (or
+    /// the first key ordered after x if Inclusive) is or should be
+    template <bool Inclusive>
+    Leaf* descend(const Key& x, Path* path) const
+    {
+        void* node = root_;
+        for (size_t level = 0; level < height_; ++level)
+        {
+            Inner* inner = static_cast<Inner*>(node);
+            size_t ix = countBefore<Inclusive>(inner->keys_, inner->num_, x);
+            if (path)
+            {
+                path->entries_[level] = PathEntry{inner, ix};
+            }
+            node = inner->children_[ix];
+        }
+        Leaf* leaf = static_cast<Leaf*>(node);
+        if (path)
+        {
+            path->leaf_ = leaf;
+        }
+        return leaf;
+    }
+
+    /// \brief moves the path to the next leaf
+    /// \return false if the leaf of the path is the last leaf
+    bool nextLeaf(Path& path) const
+    {
+        size_t level = height_;
+        while (level > 0 && path.entries_[level-1].ix_ == path.entries_[level-1].node_->num_)
+        {
+            --level;
+        }
+        if (level == 0)
+        {
+            return false;
+        }
+        PathEntry& entry = path.entries_[level-1];
+        void* node = entry.node_->children_[++entry.ix_];
+        for (; level < height_; ++level)
+        {
+            Inner* inner = static_cast<Inner*>(node);
+            path.entries_[level] = PathEntry{inner, 0};
+            node = inner->children_[0];
+        }
+        path.leaf_ = static_cast<Leaf*>(node);
+        return true;
+    }
+
+    static void insertAt(Key* keys, size_t num, size_t pos, const Key& x)
+    {
+        std::memmove(keys + pos + 1, keys + pos, (num - pos)*sizeof(Key));
+        keys[pos] = x;
+    }
+
+    static void removeAt(Key* keys, size_t num, size_t pos)
+    {
+        std::memmove(keys + pos, keys + pos + 1, (num - pos - 1)*sizeof(Key));
+    }
+
+    void splitLeaf(Path& path, size_t pos, const Key& x)
+    {
+        Leaf* leaf = path.leaf_;
+        Key keys[LEAF_CAPACITY + 1];
+        std::memcpy(keys, leaf->keys_, pos*sizeof(Key));
+        keys[pos] = x;
+        std::memcpy(keys + pos + 1, leaf->keys_ + pos, (LEAF_CAPACITY - pos)*sizeof(Key));
+
+        Leaf* right = newLeaf();
+        size_t left_num = (LEAF_CAPACITY + 1) / 2;
+        size_t right_num = LEAF_CAPACITY + 1 - left_num;
+        std::memcpy(leaf->keys_, keys, left_num*sizeof(Key));
+        std::memcpy(right->keys_, keys + left_num, right_num*sizeof(Key));
+        leaf->num_ = uint32_t(left_num);
+        right->num_ = uint32_t(right_num);
+
+        right->next_ = leaf->next_;
+        right->prev_ = leaf;
+        if (leaf->next_) leaf->next_->prev_ = right; else last_leaf_ = right;
+        leaf->next_ = right;
+
+        insertChild(path, height_, right->keys_[0], right);
+    }
+
+    /// \brief inserts a separator and the child after it into the parent of the
+    /// node at the given level of the path, splitting parents as needed
+    void insertChild(Path& path, size_t level, const Key& separator, void* child)
+    {
+        if (level == 0)
+        {
+            Inner* root = newInner();
+            root->num_ = 1;
+            root->keys_[0] = separator;
+            root->children_[0] = root_;
+            root->children_[1] = child;
+            root_ = root;
+            ++height_;
+            return;
+        }
+        Inner* node = path.entries_[level-1].node_;
+        size_t pos = path.entries_[level-1].ix_;
+        if (node->num_ < INNER_CAPACITY)
+        {
+            insertAt(node->keys_, node->num_, pos, separator);
+            std::memmove(node->children_ + pos + 2, node->children_ + pos + 1,
+                         (node->num_ - pos)*sizeof(void*));
+            node->children_[pos+1] = child;
+            ++node->num_;
+            return;
+        }
+        Key keys[INNER_CAPACITY + 1];
+        void* children[INNER_CAPACITY + 2];
+        std::memcpy(keys, node->keys_, pos*sizeof(Key));
+        keys[pos] = separator;
+        std::memcpy(keys + pos + 1, node->keys_ + pos, (INNER_CAPACITY - pos)*sizeof(Key));
+        std::memcpy(children, node->children_, (pos + 1)*sizeof(void*));
+        children[pos+1] = child;
+        std::memcpy(children + pos + 2, node->children_ + pos + 1, (INNER_CAPACITY - pos)*sizeof(void*));
+
+        // the middle key moves up to the parent
+        size_t mid = (INNER_CAPACITY + 1) / 2;
+        Inner* right = newInner();
+        node->num_ = uint32_t(mid);
+        std::memcpy(node->keys_, keys, mid*sizeof(Key));
+        std::memcpy(node->children_, children, (mid + 1)*sizeof(void*));
+        right->num_ = uint32_t(INNER_CAPACITY - mid);
+        std::memcpy(right->keys_, keys + mid + 1, right->num_*sizeof(Key));
+        std::memcpy(right->children_, children + mid + 1, (right->num_ + 1)*sizeof(void*));
+
+        insertChild(path, level - 1, keys[mid], right);
+    }
+
+    bool eraseOne(const Key& x)
+    {
+        if (!root_)
+        {
+            return false;
+        }
+        Path path;
+        Leaf* leaf = descend<false>(x, &path);
+        size_t pos = countBefore<false>(leaf->keys_, leaf->num_, x);
+        if (pos == leaf->num_)
+        {
+            // the first key not before x is the first key of the next leaf
+            if (!nextLeaf(path))
+            {
+                return false;
+            }
+            leaf = path.leaf_;
+            pos = 0;
+        }
+        if (Compare()(x, leaf->keys_[pos]))
+        {
+            return false;
+        }
+        removeAt(leaf->keys_, leaf->num_, pos);
+        --leaf->num_;
+        --size_;
+        if (height_ == 0)
+        {
+            if (leaf->num_ == 0)
+            {
+                freeNode(leaf);
+                root_ = first_leaf_ = last_leaf_ = nullptr;
+            }
+        }
+        else if (leaf->num_ < LEAF_MIN)
+        {
+            rebalanceLeaf(path);
+        }
+        return true;
+    }
+
+    void rebalanceLeaf(Path& path)
+    {
+        Leaf* leaf = path.leaf_;
+        Inner* parent = path.entries_[height_-1].node_;
+        size_t ix = path.entries_[height_-1].ix_;
+        Leaf* left = ix > 0 ? static_cast<Leaf*>(parent->children_[ix-1]) : nullptr;
+        Leaf* right = ix < parent->num_ ? static_cast<Leaf*>(parent->children_[ix+1]) : nullptr;
+        if (left && left->num_ > LEAF_MIN)
+        {
+            insertAt(leaf->keys_, leaf->num_++, 0, left->keys_[--left->num_]);
+            parent->keys_[ix-1] = leaf->keys_[0];
+            return;
+        }
+        if (right && right->num_ > LEAF_MIN)
+        {
+            leaf->keys_[leaf->num_++] = right->keys_[0];
+            removeAt(right->keys_, right->num_--, 0);
+            parent->keys_[ix] = right->keys_[0];
+            return;
+        }
+        if (left)
+        {
+            mergeLeaf(left, leaf);
+            removeChild(path, height_ - 1, ix - 1);
+        }
+        else
+        {
+            mergeLeaf(leaf, right);
+            removeChild(path, height_ - 1, ix);
+        }
+    }
+
+    /// \brief moves all keys of right into left and frees right
+    void mergeLeaf(Leaf* left, Leaf* right)
+    {
+        std::memcpy(left->keys_ + left->num_, right->keys_, right->num_*sizeof(Key));
+        left->num_ += right->num_;
+        left->next_ = right->next_;
+        if (right->next_) right->next_->prev_ = left; else last_leaf_ = left;
+        freeNode(right);
+    }
+
+    /// \brief removes the key at key_ix and the child after it from the node at
+    /// the given level of the path, rebalancing the node if it underflows
+    void removeChild(Path& path, size_t level, size_t key_ix)
+    {
+        Inner* node = path.entries_[level].node_;
+        removeAt(node->keys_, node->num_, key_ix);
+        std::memmove(node->children_ + key_ix + 1, node->children_ + key_ix + 2,
+                     (node->num_ - key_ix - 1)*sizeof(void*));
+        --node->num_;
+        if (level == 0)
+        {
+            if (node->num_ == 0)
+            {
+                root_ = node->children_[0];
+                --height_;
+                freeNode(node);
+            }
+            return;
+        }
+        if (node->num_ >= INNER_MIN)
+        {
+            return;
+        }
+        Inner* parent = path.entries_[level-1].node_;
+        size_t ix = path.entries_[level-1].ix_;
+        Inner* left = ix > 0 ? static_cast<Inner*>(parent->children_[ix-1]) : nullptr;
+        Inner* right = ix < parent->num_ ? static_cast<Inner*>(parent->children_[ix+1]) : nullptr;
+        if (left && left->num_ > INNER_MIN)
+        {
+            // rotate the last child of left through the parent
+            insertAt(node->keys_, node->num_, 0, parent->keys_[ix-1]);
+            std::memmove(node->children_ + 1, node->children_, (node->num_ + 1)*sizeof(void*));
+            node->children_[0] = left->children_[left->num_];
+            ++node->num_;
+            parent->keys_[ix-1] = left->keys_[--left->num_];
+            return;
+        }
+        if (right && right->num_ > INNER_MIN)
+        {
+            // rotate the first child of right through the parent
+            node->keys_[node->num_] = parent->keys_[ix];
+            node->children_[++node->num_] = right->children_[0];
+            parent->keys_[ix] = right->keys_[0];
+            removeAt(right->keys_, right->num_, 0);
+            std::memmove(right->children_, right->children_ + 1, right->num_*sizeof(void*));
+            --right->num_;
+            return;
+        }
+        if (left)
+        {
+            mergeInner(left, parent->keys_[ix-1], node);
+            removeChild(path, level - 1, ix - 1);
+        }
+        else
+        {
+            mergeInner(node, parent->keys_[ix], right);
+            removeChild(path, level - 1, ix);
+        }
+    }
+
+    /// \brief moves the separator and all of right into left and frees right
+    void mergeInner(Inner* left, const Key& separator, Inner* right)
+    {
+        left->keys_[left->num_] = separator;
+        std::memcpy(left->keys_ + left->num_ + 1, right->keys_, right->num_*sizeof(Key));
+        std::memcpy(left->children_ + left->num_ + 1, right->children_, (right->num_ + 1)*sizeof(void*));
+        left->num_ += right->num_ + 1;
+        freeNode(right);
+    }
+
+    Leaf* newLeaf() { return new (pool_.allocate()) Leaf; }
+    Inner* newInner() { return new (pool_.allocate()) Inner; }
+    // nodes are trivially destructible
+    void freeNode(void* node) { pool_.deallocate(node); }
+
+    void freeTree(void* node, size_t height)
+    {
+        if (height > 0)
+        {
+            Inner* inner = static_cast<Inner*>(node);
+            for (size_t ix = 0; ix <= inner->num_; ++ix)
+            {
+                freeTree(inner->children_[ix], height - 1);
+            }
+        }
+        freeNode(node);
+    }
+
+    FixedMemPool        pool_;
+    void*               root_ {nullptr};
+    size_t              height_ {0};      ///< number of inner levels
+    size_t              size_ {0};
+    Leaf*               first_leaf_ {nullptr};
+    Leaf*               last_leaf_ {nullptr};
+};
+
+} // namespace alt
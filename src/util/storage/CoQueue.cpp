@@ -13,25 +13,26 @@ CoQueueBase::CoQueueBase(bool multiple_writers)
 
 CoQueueBase::~CoQueueBase()
 {
-    release(std::numeric_limits<int>::max());
+    clear();
 }
 
 void CoQueueBase::enqueue(EntryBase* node)
 {
-    // writers are responsible to to release nodes consumed. Try to free two notes
-    // before enqueue
-    release(2);
-
     if (multiple_writers_)
     {
         // If we have multiple writers, tail_->next_ and tail must be updated
-        // together
+        // together. Releasing is also serialized as the free lists are shared
+        // by the writers
         std::scoped_lock lock(writers_mutex_);
+        release(2);
         tail_.load(std::memory_order_relaxed)->next_ = node;
         tail_.store(node, std::memory_order_release);
     }
     else
     {
+        // writers are responsible to to release nodes consumed. Try to free two notes
+        // before enqueue
+        release(2);
         tail_.load(std::memory_order_relaxed)->next_ = node;
         tail_.store(node, std::memory_order_release);
     }
@@ -63,6 +64,36 @@ CoQueueBase::EntryBase* CoQueueBase::dequeue()
     return next_last_consumed;
 }
 
+CoQueueBase::EntryRange CoQueueBase::dequeueAll(size_t max_num)
+{
+    EntryBase * last_consumed;
+    EntryBase * first;
+    EntryBase * last;
+    size_t num;
+    do
+    {
+        last_consumed = last_consumed_.load(std::memory_order_relaxed);
+        first = last_consumed->next_.load(std::memory_order_acquire);
+        if (first == nullptr || max_num == 0)
+        {
+            return EntryRange();
+        }
+        last = first;
+        num = 1;
+        for (EntryBase* next; num < max_num &&
+                (next = last->next_.load(std::memory_order_acquire)) != nullptr; ++num)
+        {
+            last = next;
+        }
+    }
+    while (!last_consumed_.compare_exchange_weak(
+                last_consumed, last,
+                std::memory_order_release, std::memory_order_acquire)
+          );
+
+    return EntryRange(first, last, num);
+}
+
 CoQueueBase::EntryBase* CoQueueBase::blockingDequeue()
 {
     auto entry = dequeue();
@@ -80,23 +111,107 @@ void CoQueueBase::commit(EntryBase* entry)
     entry->consumed_.store(true, std::memory_order_release);
 }
 
+void CoQueueBase::commit(const EntryRange& range)
+{
+    if (range.empty())
+    {
+        return;
+    }
+    // The mark on the first entry covers the whole range
+    range.first()->batch_last_ = range.last() == range.first() ? nullptr : range.last();
+    range.first()->consumed_.store(true, std::memory_order_release);
+}
+
 void CoQueueBase::release(int trim_num)
 {
+    // The consumer reads next_ of the entry last consumed to dequeue further, so
+    // the release stops there. Entries before it are not accessed by the consumer
+    const EntryBase* cursor = last_consumed_.load(std::memory_order_acquire);
+    if (cursor == &empty_node_)
+    {
+        // nothing dequeued when the cursor is loaded
+        return;
+    }
     while (trim_num > 0)
     {
         auto n = empty_node_.next_.load(std::memory_order_relaxed);
-        if (!n || !n->consumed_.load(std::memory_order_acquire)) return;
+        if (!n || n == cursor || !n->consumed_.load(std::memory_order_acquire)) return;
 
-        auto next = n->next_.load(std::memory_order_relaxed);
-        if (empty_node_.next_.compare_exchange_strong(n, next,
-                std::memory_order_acq_rel, std::memory_order_relaxed))
+        auto last = n->batch_last_ ? n->batch_last_ : n;
+        bool last_released = false;
+        while (trim_num > 0 && n != cursor && !last_released)
         {
-            // n is successfully detached here, delete it 
-            del(n);
+            auto next = n->next_.load(std::memory_order_relaxed);
+            last_released = n == last;
+            empty_node_.next_.store(next, std::memory_order_relaxed);
+            if (n->size_class_ < SIZE_CLASS_NUM)
+            {
+                // keep the memory block in the free list for reuse
+                auto size_class = n->size_class_;
+                n->~EntryBase();
+                auto block = reinterpret_cast<FreeBlock*>(n);
+                block->next_ = free_lists_[size_class];
+                free_lists_[size_class] = block;
+            }
+            else
+            {
+                del(n);
+            }
             --trim_num;
+            n = next;
+        }
+        if (!last_released)
+        {
+            // Pass the consumed mark of the remaining range on to the new first entry
+            n->batch_last_ = n == last ? nullptr : last;
+            n->consumed_.store(true, std::memory_order_relaxed);
+            return;
+        }
+    }
+}
+
+void* CoQueueBase::reuse(uint8_t size_class)
+{
+    std::unique_lock<std::mutex> lock(writers_mutex_, std::defer_lock);
+    if (multiple_writers_)
+    {
+        lock.lock();
+    }
+    auto block = free_lists_[size_class];
+    if (!block)
+    {
+        // Free list is empty, release all entries consumed so far
+        release(std::numeric_limits<int>::max());
+        block = free_lists_[size_class];
+        if (!block)
+        {
+            return nullptr;
+        }
+    }
+    free_lists_[size_class] = block->next_;
+    return block;
+}
+
+void CoQueueBase::clear()
+{
+    auto n = empty_node_.next_.load(std::memory_order_relaxed);
+    empty_node_.next_.store(nullptr, std::memory_order_relaxed);
+    tail_.store(&empty_node_, std::memory_order_relaxed);
+    last_consumed_.store(&empty_node_, std::memory_order_relaxed);
+    while (n)
+    {
+        auto next = n->next_.load(std::memory_order_relaxed);
+        del(n);
+        n = next;
+    }
+    for (auto& free_list: free_lists_)
+    {
+        while (free_list)
+        {
+            auto next = free_list->next_;
+            deallocate(free_list);
+            free_list = next;
         }
-        // someone else detached empty_node_.next_. Continue to try to release
-        // more until trim_num satisfied
     }
 }
 
@@ -20,6 +20,7 @@
 #include <util/Defs.h>               // for ALT_UTIL_PUBLIC
 #include "Allocator.h"               // for Allocator 
 #include <atomic>                    // for atomic
+#include <limits>                    // for numeric_limits
 #include <mutex>                     // for mutex
 #include  <condition_variable>       // for condition_variable
 
@@ -31,11 +32,19 @@ namespace alt {
  * \brief implements thread safe concurrent queue. Lock free for single reader/writer mode
  * @note  Dequeue is wait-free if blocking_ is false. Enqueue operation is always wait-free.
  * Elements in the queue are chained in a linklist which can be allocated a memory pool.
+ * Entries consumed are released by the producer into free lists of the producer, and
+ * entries acquired from the queue reuse the released memory blocks before going to the
+ * allocator.
  */
 class ALT_UTIL_PUBLIC CoQueueBase
 {
   public:
 
+    /// size class of entries not recycled through free lists
+    constexpr static uint8_t NO_SIZE_CLASS = 0xFF;
+    /// number of size classes recycled. The largest size class is 1024 bytes
+    constexpr static size_t SIZE_CLASS_NUM = 8;
+
     /**
      * \struct EntryBase
      * \brief Base type for all element types of queue entry.
@@ -44,10 +53,56 @@ class ALT_UTIL_PUBLIC CoQueueBase
     {
         std::atomic<EntryBase*> next_ {nullptr};
         std::atomic<bool>   consumed_ {false};
+        // size class of the memory block, set when the entry is acquired from a queue
+        uint8_t             size_class_ {NO_SIZE_CLASS};
+        // when consumed_ is set, the entries up to batch_last_ are consumed as well
+        EntryBase*          batch_last_ {nullptr};
 
         virtual ~EntryBase() {}
     };
 
+    /**
+     * \class EntryRange
+     * \brief A view of consecutive entries detached from the queue in one dequeueAll
+     */
+    class EntryRange
+    {
+      public:
+        class iterator
+        {
+          public:
+            iterator(EntryBase* entry, const EntryBase* last): entry_(entry), last_(last) {}
+            EntryBase* operator*() const { return entry_; }
+            iterator& operator++()
+            {
+                entry_ = entry_ == last_ ? nullptr : entry_->next_.load(std::memory_order_relaxed);
+                return *this;
+            }
+            bool operator==(const iterator& oth) const { return entry_ == oth.entry_; }
+            bool operator!=(const iterator& oth) const { return entry_ != oth.entry_; }
+
+          private:
+            EntryBase*          entry_;
+            const EntryBase*    last_;
+        };
+
+        EntryRange() = default;
+        EntryRange(EntryBase* first, EntryBase* last, size_t size)
+            : first_(first), last_(last), size_(size) {}
+
+        iterator begin() const { return iterator(first_, last_); }
+        iterator end() const { return iterator(nullptr, last_); }
+        EntryBase* first() const { return first_; }
+        EntryBase* last() const { return last_; }
+        size_t size() const { return size_; }
+        bool empty() const { return size_ == 0; }
+
+      private:
+        EntryBase*      first_ {nullptr};
+        EntryBase*      last_ {nullptr};
+        size_t          size_ {0};
+    };
+
     /// \brief Constructor
     /// unprocessed entries
     CoQueueBase(bool multiple_writers =false);
@@ -65,6 +120,9 @@ class ALT_UTIL_PUBLIC CoQueueBase
     /// \return pointer to the first unprocessed entry if any, otherwise nullptr
     static void commit(EntryBase* entry);
 
+    /// \brief commit all entries in the range with a single consumed mark
+    static void commit(const EntryRange& range);
+
     /// \brief detach the first unprocessed entry, called by the consumer thread
     /// \return pointer to the first unprocessed entry or nullptr if blocking_ is false and
     /// there is no unprocessed entry
@@ -73,19 +131,55 @@ class ALT_UTIL_PUBLIC CoQueueBase
     EntryBase* dequeue();
     EntryBase* blockingDequeue();
 
+    /// \brief detach all unprocessed entries currently visible, called by the consumer thread
+    /// \param max_num maximum number of entries to detach
+    /// \return range of the entries detached, empty if there is no unprocessed entry
+    /// \note The entries in the range should be committed together by commit(range)
+    EntryRange dequeueAll(size_t max_num = std::numeric_limits<size_t>::max());
+
+    /// \brief returns the size class of an entry in size of sz, or NO_SIZE_CLASS if the
+    /// entry is too big to be recycled
+    constexpr static uint8_t sizeClass(size_t sz)
+    {
+        return sz <= 8 ? 0 :
+               constLog2(sz-1)-2 < SIZE_CLASS_NUM ? uint8_t(constLog2(sz-1)-2) : NO_SIZE_CLASS;
+    }
+
+    /// \brief returns the size of memory blocks in the size class
+    constexpr static size_t blockSize(uint8_t size_class) { return size_t(1) << (size_class+3); }
+
   protected:
 
+    struct FreeBlock
+    {
+        FreeBlock*  next_;
+    };
+
     /// \brief delete the entry
     /// \param n pointer to the entry to be deleted.
     /// \note this function needs to be overriden in derived class when different allocator
     /// is used
     virtual void del(EntryBase* n) { delete n; }
 
+    /// \brief free a memory block of an entry already destroyed
+    /// \note this function needs to be overriden in derived class when different allocator
+    /// is used
+    virtual void deallocate(void* p) { ::operator delete(p); }
+
+    /// \brief take a memory block in the size class from the free list, called by the
+    /// producer thread
+    /// \return the memory block or nullptr if there is no free block in the size class
+    void* reuse(uint8_t size_class);
+
     /// \brief release processed entries
     /// \param trim_num maximum number of processed entries can be released
     /// \note this should be only called by the producer thread
     void release(int trim_num);
 
+    /// \brief delete all entries in the queue and all free blocks
+    /// \note this should be called in the destructor of the derived class
+    void clear();
+
     // when blocking_mode_used_ is true, blocking dequeue is called. We will need to notify
     // consumers after enqueue
     std::atomic<bool>            blocking_mode_used_ { false };
@@ -100,6 +194,7 @@ class ALT_UTIL_PUBLIC CoQueueBase
     // accessed by writers
     EntryBase                        empty_node_;
     const EntryBase*                 head_;
+    FreeBlock*                       free_lists_[SIZE_CLASS_NUM] { nullptr };
 
     alignas(64) std::atomic<EntryBase*>   tail_;
 
@@ -119,21 +214,30 @@ class CoQueueT: public CoQueueBase
 
     CoQueueT(Alloc& allocator): allocator_(allocator) {};
 
+    ~CoQueueT() { clear(); }
+
     template <typename... Args>
     T* acquire(Args&&... args)
     {
-        return alt_pnew(allocator_, T, std::forward<Args>(args)...);
+        constexpr uint8_t size_class = sizeClass(sizeof(T));
+        void* p = size_class == NO_SIZE_CLASS ? nullptr : reuse(size_class);
+        T* node = p ? new (p) T(std::forward<Args>(args)...)
+                    : alt_pnew(allocator_, T, std::forward<Args>(args)...);
+        node->size_class_ = size_class;
+        return node;
     }
 
     template <typename... Args>
     void enqueue(Args&&... args)
     {
-        T* node = alt_pnew(allocator_, T, std::forward<Args>(args)...);
-        enqueue(node);
+        CoQueueBase::enqueue(acquire(std::forward<Args>(args)...));
     }
 
+    void enqueue(T* node) { CoQueueBase::enqueue(node); }
+
   protected:
     void del(EntryBase* n) override {  alt_pdel(allocator_, T, reinterpret_cast<T*>(n)); }
+    void deallocate(void* p) override { alt_pfree(allocator_, p); }
     static_assert(std::is_base_of<CoQueueBase::EntryBase, T>::value);
 
     Alloc &    allocator_;
@@ -149,18 +253,33 @@ template <class T> using PooledCoQueueT = CoQueueT<T, FixedPool<T>>;
 /**
  * \class Queue
  * \brief implements a concurrent queue with entries of different types
+ * \note Entries are allocated in blocks rounded up to the size class so that a block
+ * released by an entry can be reused by any entry type in the same size class
  */
 template <class Alloc = Allocator>
 class CoQueue: public CoQueueBase
 {
   public:
 
+    using CoQueueBase::enqueue;
+
+    ~CoQueue() { clear(); }
+
     template <typename T,
               typename std::enable_if_t<std::is_base_of<CoQueueBase::EntryBase, T>::value>* = nullptr,
               typename... Args>
     T* acquire(Args&&... args)
     {
-        return alt_pnew(allocator_, T, std::forward<Args>(args)...);
+        constexpr uint8_t size_class = sizeClass(sizeof(T));
+        void* p = size_class == NO_SIZE_CLASS ? alt_palloc(allocator_, sizeof(T))
+                                              : reuse(size_class);
+        if (!p)
+        {
+            p = alt_palloc(allocator_, blockSize(size_class));
+        }
+        T* node = new (p) T(std::forward<Args>(args)...);
+        node->size_class_ = size_class;
+        return node;
     }
 
     template <typename T,
@@ -168,9 +287,7 @@ class CoQueue: public CoQueueBase
               typename... Args>
     void enqueue(Args&&... args)
     {
-
-        T* node = alt_pnew(allocator_, T, std::forward<Args>(args)...);
-        CoQueueBase::enqueue(node);
+        CoQueueBase::enqueue(acquire<T>(std::forward<Args>(args)...));
     }
 
   protected:
@@ -179,6 +296,8 @@ class CoQueue: public CoQueueBase
         alt_pdel(allocator_, EntryBase, n);
     }
 
+    void deallocate(void* p) override { alt_pfree(allocator_, p); }
+
     static Alloc& allocator_;
 };
 
@@ -0,0 +1,667 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file ColumnVector.h
+ * @library alt_util
+ * @brief Defines a structure-of-arrays vector. Fields of a row are declared once
+ * as template parameters and each field is stored in its own cache line aligned
+ * column array, so a scan over one field reads only that field. Like
+ * CollectableVector, a removed row keeps its index and its slot is reused by the
+ * next added row. Columns of arithmetic types have vectorized kernels:
+ *    - sum: removed rows are zeroed, so a column is summed with no mask
+ *    - min, max: blocks of 64 rows with no removed row are reduced with SIMD
+ *      min/max, other blocks are reduced row by row on the live bits
+ *    - filter: keys are compared with SIMD compares into a 64-bit match mask per
+ *      block, which is masked by the live bits of the block
+ */
+
+#include <util/numeric/Intrinsics.h>    // for ctz, constAlign
+#include <util/types/TemplateHelper.h>  // for NONCOPYABLE
+#include <tuple>                        // for tuple
+#include <vector>                       // for vector
+#include <limits>                       // for numeric_limits
+#include <type_traits>                  // for is_trivially_copyable
+#include <utility>                      // for index_sequence
+#include <algorithm>                    // for max, fill
+#include <stdexcept>                    // for bad_alloc
+#include <cstring>                      // for memcpy, memset
+#include <stdlib.h>                     // for aligned_alloc/free
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace alt
+{
+
+/**
+ * \enum ColumnCompare
+ * \brief Compare of a column value with the filter value
+ */
+enum class ColumnCompare : uint8_t
+{
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    Equal,
+    NotEqual
+};
+
+/**
+ * \struct ColumnKernel
+ * \ingroup StorageUtils
+ * \brief Scan kernels on a column. The live bits of rows are given as one 64-bit
+ * word per 64 rows. Columns of double and of 32 or 64-bit integers use SSE/AVX2
+ * where the instruction set has the needed compare or min/max, and scalar loops
+ * otherwise.
+ */
+template <typename T>
+struct ColumnKernel
+{
+    static_assert(std::is_arithmetic<T>::value, "column kernels require arithmetic values");
+
+    /// sums are in double for floating types, and in 64-bit integers otherwise
+    using SumType = std::conditional_t<std::is_floating_point<T>::value, double,
+                    std::conditional_t<std::is_signed<T>::value, int64_t, uint64_t>>;
+
+    /// \brief sums all values. Values of removed rows must be 0
+    static SumType sum(const T* values, size_t num)
+    {
+        size_t ix = 0;
+        SumType total = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same<T, double>::value)
+        {
+            __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+            for (; ix + 8 <= num; ix += 8)
+            {
+                acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(values + ix));
+                acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(values + ix + 4));
+            }
+            double lanes[4];
+            _mm256_storeu_pd(lanes, _mm256_add_pd(acc0, acc1));
+            total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+        }
+        else if constexpr (std::is_integral<T>::value && sizeof(T)==8)
+        {
+            __m256i acc = _mm256_setzero_si256();
+            for (; ix + 4 <= num; ix += 4)
+            {
+                acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + ix)));
+            }
+            uint64_t lanes[4];
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+            total = SumType(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+        }
+#elif defined(__SSE2__)
+        if constexpr (std::is_same<T, double>::value)
+        {
+            __m128d acc0 = _mm_setzero_pd(), acc1 = _mm_setzero_pd();
+            for (; ix + 4 <= num; ix += 4)
+            {
+                acc0 = _mm_add_pd(acc0, _mm_loadu_pd(values + ix));
+                acc1 = _mm_add_pd(acc1, _mm_loadu_pd(values + ix + 2));
+            }
+            double lanes[2];
+            _mm_storeu_pd(lanes, _mm_add_pd(acc0, acc1));
+            total = lanes[0] + lanes[1];
+        }
+        else if constexpr (std::is_integral<T>::value && sizeof(T)==8)
+        {
+            __m128i acc = _mm_setzero_si128();
+            for (; ix + 2 <= num; ix += 2)
+            {
+                acc = _mm_add_epi64(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + ix)));
+            }
+            uint64_t lanes[2];
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+            total = SumType(lanes[0] + lanes[1]);
+        }
+#endif
+        for (; ix < num; ++ix)
+        {
+            total += values[ix];
+        }
+        return total;
+    }
+
+    /// \brief finds the minimum (or the maximum if Max) value of live rows
+    /// \return false if there is no live row
+    template <bool Max>
+    static bool extreme(const T* values, const uint64_t* live, size_t num, T& result)
+    {
+        T best = Max ? std::numeric_limits<T>::lowest() : std::numeric_limits<T>::max();
+        bool found = false;
+        for (size_t base = 0; base < num; base += 64)
+        {
+            uint64_t bits = live[base/64];
+            if (bits == ~uint64_t(0) && base + 64 <= num)
+            {
+                best = better<Max>(best, blockExtreme<Max>(values + base));
+                found = true;
+                continue;
+            }
+            for (; bits; bits &= bits - 1)
+            {
+                best = better<Max>(best, values[base + ctz(bits)]);
+                found = true;
+            }
+        }
+        if (found)
+        {
+            result = best;
+        }
+        return found;
+    }
+
+    /// \brief appends indexes of live rows with values matching the compare with x
+    /// \return the number of rows appended
+    static size_t filter(const T* values, const uint64_t* live, size_t num,
+                         ColumnCompare cmp, T x, std::vector<size_t>& rows)
+    {
+        switch (cmp)
+        {
+            case ColumnCompare::Less:           return filter<ColumnCompare::Less>(values, live, num, x, rows);
+            case ColumnCompare::LessEqual:      return filter<ColumnCompare::LessEqual>(values, live, num, x, rows);
+            case ColumnCompare::Greater:        return filter<ColumnCompare::Greater>(values, live, num, x, rows);
+            case ColumnCompare::GreaterEqual:   return filter<ColumnCompare::GreaterEqual>(values, live, num, x, rows);
+            case ColumnCompare::Equal:          return filter<ColumnCompare::Equal>(values, live, num, x, rows);
+            case ColumnCompare::NotEqual:       return filter<ColumnCompare::NotEqual>(values, live, num, x, rows);
+        }
+        return 0;
+    }
+
+  private:
+    template <bool Max>
+    static T better(T x, T y) { return Max ? (y > x ? y : x) : (y < x ? y : x); }
+
+    template <ColumnCompare Cmp>
+    static bool match(T v, T x)
+    {
+        switch (Cmp)
+        {
+            case ColumnCompare::Less:           return v < x;
+            case ColumnCompare::LessEqual:      return v <= x;
+            case ColumnCompare::Greater:        return v > x;
+            case ColumnCompare::GreaterEqual:   return v >= x;
+            case ColumnCompare::Equal:          return v == x;
+            case ColumnCompare::NotEqual:       return v != x;
+        }
+        return false;
+    }
+
+    template <ColumnCompare Cmp>
+    static size_t filter(const T* values, const uint64_t* live, size_t num, T x, std::vector<size_t>& rows)
+    {
+        size_t found = 0;
+        for (size_t base = 0; base < num; base += 64)
+        {
+            uint64_t bits = live[base/64];
+            if (!bits)
+            {
+                continue;
+            }
+            bits &= base + 64 <= num ? blockMatch<Cmp>(values + base, x)
+                                     : tailMatch<Cmp>(values + base, num - base, x);
+            for (; bits; bits &= bits - 1)
+            {
+                rows.push_back(base + ctz(bits));
+                ++found;
+            }
+        }
+        return found;
+    }
+
+    template <ColumnCompare Cmp>
+    static uint64_t tailMatch(const T* values, size_t num, T x)
+    {
+        uint64_t bits = 0;
+        for (size_t ix = 0; ix < num; ++ix)
+        {
+            bits |= uint64_t(match<Cmp>(values[ix], x)) << ix;
+        }
+        return bits;
+    }
+
+    /// \brief returns the match bits of a block of 64 values
+    template <ColumnCompare Cmp>
+    static uint64_t blockMatch(const T* values, T x)
+    {
+        uint64_t bits = 0;
+#if defined(__AVX2__)
+        if constexpr (std::is_same<T, double>::value)
+        {
+            constexpr int PREDICATE =
+                Cmp==ColumnCompare::Less ? _CMP_LT_OQ : Cmp==ColumnCompare::LessEqual ? _CMP_LE_OQ :
+                Cmp==ColumnCompare::Greater ? _CMP_GT_OQ : Cmp==ColumnCompare::GreaterEqual ? _CMP_GE_OQ :
+                Cmp==ColumnCompare::Equal ? _CMP_EQ_OQ : _CMP_NEQ_UQ;
+            __m256d vx = _mm256_set1_pd(x);
+            for (size_t ix = 0; ix < 64; ix += 4)
+            {
+                __m256d v = _mm256_loadu_pd(values + ix);
+                bits |= uint64_t(_mm256_movemask_pd(_mm256_cmp_pd(v, vx, PREDICATE))) << ix;
+            }
+            return bits;
+        }
+        else if constexpr (std::is_same<T, int64_t>::value || std::is_same<T, int32_t>::value)
+        {
+            constexpr size_t WIDTH = 32 / sizeof(T);
+            __m256i vx = sizeof(T)==8 ? _mm256_set1_epi64x(x) : _mm256_set1_epi32(int32_t(x));
+            for (size_t ix = 0; ix < 64; ix += WIDTH)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + ix));
+                __m256i m = intMatch<Cmp>(v, vx);
+                uint64_t mask = sizeof(T)==8 ? uint64_t(_mm256_movemask_pd(_mm256_castsi256_pd(m)))
+                                             : uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+                bits |= mask << ix;
+            }
+            return bits;
+        }
+#elif defined(__SSE2__)
+        if constexpr (std::is_same<T, double>::value)
+        {
+            __m128d vx = _mm_set1_pd(x);
+            for (size_t ix = 0; ix < 64; ix += 2)
+            {
+                __m128d v = _mm_loadu_pd(values + ix);
+                __m128d m;
+                switch (Cmp)
+                {
+                    case ColumnCompare::Less:           m = _mm_cmplt_pd(v, vx); break;
+                    case ColumnCompare::LessEqual:      m = _mm_cmple_pd(v, vx); break;
+                    case ColumnCompare::Greater:        m = _mm_cmpgt_pd(v, vx); break;
+                    case ColumnCompare::GreaterEqual:   m = _mm_cmpge_pd(v, vx); break;
+                    case ColumnCompare::Equal:          m = _mm_cmpeq_pd(v, vx); break;
+                    default:                            m = _mm_cmpneq_pd(v, vx); break;
+                }
+                bits |= uint64_t(_mm_movemask_pd(m)) << ix;
+            }
+            return bits;
+        }
+        else if constexpr (std::is_same<T, int32_t>::value)
+        {
+            __m128i vx = _mm_set1_epi32(x);
+            for (size_t ix = 0; ix < 64; ix += 4)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + ix));
+                bits |= uint64_t(_mm_movemask_ps(_mm_castsi128_ps(intMatch<Cmp>(v, vx)))) << ix;
+            }
+            return bits;
+        }
+#endif
+        return tailMatch<Cmp>(values, 64, x);
+    }
+
+#if defined(__AVX2__)
+    template <ColumnCompare Cmp>
+    static __m256i intMatch(__m256i v, __m256i vx)
+    {
+        auto gt = [](__m256i a, __m256i b)
+            { return sizeof(T)==8 ? _mm256_cmpgt_epi64(a, b) : _mm256_cmpgt_epi32(a, b); };
+        auto eq = [](__m256i a, __m256i b)
+            { return sizeof(T)==8 ? _mm256_cmpeq_epi64(a, b) : _mm256_cmpeq_epi32(a, b); };
+        const __m256i ones = _mm256_set1_epi32(-1);
+        switch (Cmp)
+        {
+            case ColumnCompare::Less:           return gt(vx, v);
+            case ColumnCompare::LessEqual:      return _mm256_xor_si256(gt(v, vx), ones);
+            case ColumnCompare::Greater:        return gt(v, vx);
+            case ColumnCompare::GreaterEqual:   return _mm256_xor_si256(gt(vx, v), ones);
+            case ColumnCompare::Equal:          return eq(v, vx);
+            default:                            return _mm256_xor_si256(eq(v, vx), ones);
+        }
+    }
+#elif defined(__SSE2__)
+    template <ColumnCompare Cmp>
+    static __m128i intMatch(__m128i v, __m128i vx)
+    {
+        const __m128i ones = _mm_set1_epi32(-1);
+        switch (Cmp)
+        {
+            case ColumnCompare::Less:           return _mm_cmpgt_epi32(vx, v);
+            case ColumnCompare::LessEqual:      return _mm_xor_si128(_mm_cmpgt_epi32(v, vx), ones);
+            case ColumnCompare::Greater:        return _mm_cmpgt_epi32(v, vx);
+            case ColumnCompare::GreaterEqual:   return _mm_xor_si128(_mm_cmpgt_epi32(vx, v), ones);
+            case ColumnCompare::Equal:          return _mm_cmpeq_epi32(v, vx);
+            default:                            return _mm_xor_si128(_mm_cmpeq_epi32(v, vx), ones);
+        }
+    }
+#endif
+
+    /// \brief returns the minimum (or the maximum if Max) of a block of 64 values
+    template <bool Max>
+    static T blockExtreme(const T* values)
+    {
+#if defined(__AVX2__)
+        if constexpr (std::is_same<T, double>::value)
+        {
+            __m256d acc = _mm256_loadu_pd(values);
+            for (size_t ix = 4; ix < 64; ix += 4)
+            {
+                __m256d v = _mm256_loadu_pd(values + ix);
+                acc = Max ? _mm256_max_pd(acc, v) : _mm256_min_pd(acc, v);
+            }
+            return reduce<Max>(acc);
+        }
+        else if constexpr (std::is_same<T, int64_t>::value)
+        {
+            __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+            for (size_t ix = 4; ix < 64; ix += 4)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + ix));
+                __m256i gt = _mm256_cmpgt_epi64(acc, v);
+                // keep acc where acc>v for max, and v where acc>v for min
+                acc = Max ? _mm256_blendv_epi8(v, acc, gt) : _mm256_blendv_epi8(acc, v, gt);
+            }
+            return reduce<Max>(acc);
+        }
+        else if constexpr (std::is_integral<T>::value && sizeof(T)==4)
+        {
+            __m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+            for (size_t ix = 8; ix < 64; ix += 8)
+            {
+                __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + ix));
+                if constexpr (std::is_signed<T>::value)
+                    acc = Max ? _mm256_max_epi32(acc, v) : _mm256_min_epi32(acc, v);
+                else
+                    acc = Max ? _mm256_max_epu32(acc, v) : _mm256_min_epu32(acc, v);
+            }
+            return reduce<Max>(acc);
+        }
+#elif defined(__SSE2__)
+        if constexpr (std::is_same<T, double>::value)
+        {
+            __m128d acc = _mm_loadu_pd(values);
+            for (size_t ix = 2; ix < 64; ix += 2)
+            {
+                __m128d v = _mm_loadu_pd(values + ix);
+                acc = Max ? _mm_max_pd(acc, v) : _mm_min_pd(acc, v);
+            }
+            return reduce<Max>(acc);
+        }
+#if defined(__SSE4_1__)
+        else if constexpr (std::is_integral<T>::value && sizeof(T)==4)
+        {
+            __m128i acc = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values));
+            for (size_t ix = 4; ix < 64; ix += 4)
+            {
+                __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + ix));
+                if constexpr (std::is_signed<T>::value)
+                    acc = Max ? _mm_max_epi32(acc, v) : _mm_min_epi32(acc, v);
+                else
+                    acc = Max ? _mm_max_epu32(acc, v) : _mm_min_epu32(acc, v);
+            }
+            return reduce<Max>(acc);
+        }
+#endif
+#endif
+        T best = values[0];
+        for (size_t ix = 1; ix < 64; ++ix)
+        {
+            best = better<Max>(best, values[ix]);
+        }
+        return best;
+    }
+
+    /// \brief reduces the lanes of a SIMD register stored in memory
+    template <bool Max, typename Vec>
+    static T reduce(Vec vec)
+    {
+        constexpr size_t LANES = sizeof(Vec) / sizeof(T);
+        T lanes[LANES];
+        std::memcpy(lanes, &vec, sizeof(Vec));
+        T best = lanes[0];
+        for (size_t ix = 1; ix < LANES; ++ix)
+        {
+            best = better<Max>(best, lanes[ix]);
+        }
+        return best;
+    }
+};
+
+/**
+ * \class ColumnVector
+ * \ingroup StorageUtils
+ * \brief A vector of rows stored as one column array per field.
+ * \tparam Fields field types of a row, which must be trivially copyable. Fields
+ * are referred by index; define an enum of the indexes to name them.
+ * \note A row index stays valid until the row is removed. Adding rows may move
+ * columns, so pointers to column values are valid until the next add.
+ */
+template <typename... Fields>
+class ColumnVector
+{
+    static_assert(sizeof...(Fields) > 0);
+    static_assert((std::is_trivially_copyable<Fields>::value && ...),
+                  "ColumnVector fields must be trivially copyable");
+
+  public:
+    constexpr static size_t FIELD_NUM = sizeof...(Fields);
+
+    template <size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    /**
+     * \class RowRef
+     * \brief A proxy to access fields of a row
+     */
+    template <bool Const>
+    class RowRef
+    {
+        using Vector = std::conditional_t<Const, const ColumnVector, ColumnVector>;
+        Vector*     vector_;
+        size_t      row_;
+
+      public:
+        RowRef(Vector* vector, size_t row) : vector_(vector), row_(row) {}
+
+        size_t index() const { return row_; }
+
+        template <size_t I>
+        auto& get() const { return vector_->template column<I>()[row_]; }
+
+        template <size_t I>
+        void set(const field_type<I>& value) const
+        {
+            static_assert(!Const);
+            vector_->template column<I>()[row_] = value;
+        }
+    };
+
+    using Row = RowRef<false>;
+    using ConstRow = RowRef<true>;
+
+    /// \brief constructor
+    /// \param init_capacity initial number of rows allocated in each column
+    explicit ColumnVector(size_t init_capacity = 1024)
+    {
+        reserve(init_capacity);
+    }
+
+    ~ColumnVector()
+    {
+        std::apply([](auto*... columns) { (::free(columns), ...); }, columns_);
+    }
+
+    NONCOPYABLE(ColumnVector);
+
+    /// \brief adds a row, reusing the slot of a removed row if any
+    /// \return the index of the row
+    size_t add(const Fields&... values)
+    {
+        size_t row;
+        if (!collector_.empty())
+        {
+            row = collector_.back();
+            collector_.pop_back();
+        }
+        else
+        {
+            if (size_ == capacity_)
+            {
+                reserve(capacity_ * 2);
+            }
+            row = size_++;
+        }
+        setRow(row, std::index_sequence_for<Fields...>(), values...);
+        live_[row/64] |= uint64_t(1) << (row % 64);
+        ++live_num_;
+        return row;
+    }
+
+    /// \brief removes a row. Its fields are zeroed and its slot is reused by a
+    /// later add
+    /// \return false if the row is not live
+    bool erase(size_t row)
+    {
+        if (!isLive(row))
+        {
+            return false;
+        }
+        live_[row/64] &= ~(uint64_t(1) << (row % 64));
+        setRow(row, std::index_sequence_for<Fields...>(), Fields()...);
+        collector_.push_back(row);
+        --live_num_;
+        return true;
+    }
+
+    bool isLive(size_t row) const
+    {
+        return row < size_ && (live_[row/64] >> (row % 64)) & 1;
+    }
+
+    /// \brief returns the number of rows including removed rows, i.e. the upper
+    /// bound of row indexes
+    size_t size() const { return size_; }
+
+    /// \brief returns the number of live rows
+    size_t liveSize() const { return live_num_; }
+
+    Row row(size_t row) { return Row(this, row); }
+    ConstRow row(size_t row) const { return ConstRow(this, row); }
+
+    /// \brief returns the column array of field I, with size() values
+    template <size_t I>
+    field_type<I>* column() { return std::get<I>(columns_); }
+    template <size_t I>
+    const field_type<I>* column() const { return std::get<I>(columns_); }
+
+    /// \brief calls func(Row) on each live row in index order
+    template <typename Func>
+    void forEach(Func&& func)
+    {
+        for (size_t base = 0; base < size_; base += 64)
+        {
+            for (uint64_t bits = live_[base/64]; bits; bits &= bits - 1)
+            {
+                func(row(base + ctz(bits)));
+            }
+        }
+    }
+
+    /// \brief returns the sum of field I of live rows
+    template <size_t I>
+    auto sum() const
+    {
+        return ColumnKernel<field_type<I>>::sum(column<I>(), size_);
+    }
+
+    /// \brief finds the minimum of field I of live rows
+    /// \return false if there is no live row
+    template <size_t I>
+    bool min(field_type<I>& result) const
+    {
+        return ColumnKernel<field_type<I>>::template extreme<false>(column<I>(), live_.data(), size_, result);
+    }
+
+    /// \brief finds the maximum of field I of live rows
+    /// \return false if there is no live row
+    template <size_t I>
+    bool max(field_type<I>& result) const
+    {
+        return ColumnKernel<field_type<I>>::template extreme<true>(column<I>(), live_.data(), size_, result);
+    }
+
+    /// \brief appends to rows the indexes of live rows where field I compares
+    /// true with x, in index order
+    /// \return the number of rows appended
+    template <size_t I>
+    size_t filter(ColumnCompare cmp, field_type<I> x, std::vector<size_t>& rows) const
+    {
+        return ColumnKernel<field_type<I>>::filter(column<I>(), live_.data(), size_, cmp, x, rows);
+    }
+
+    /// \brief allocates columns for at least capacity rows
+    void reserve(size_t capacity)
+    {
+        capacity = constAlign(std::max(capacity, size_t(64)), 64);
+        if (capacity <= capacity_)
+        {
+            return;
+        }
+        reserveColumns(capacity, std::index_sequence_for<Fields...>());
+        live_.resize(capacity / 64, 0);
+        capacity_ = capacity;
+    }
+
+    /// \brief removes all rows. Columns are kept allocated
+    void clear()
+    {
+        std::apply([this](auto*... columns)
+        {
+            (::memset(columns, 0, size_ * sizeof(*columns)), ...);
+        }, columns_);
+        std::fill(live_.begin(), live_.end(), 0);
+        collector_.clear();
+        size_ = 0;
+        live_num_ = 0;
+    }
+
+  private:
+    template <size_t... Is, typename... Values>
+    void setRow(size_t row, std::index_sequence<Is...>, const Values&... values)
+    {
+        ((std::get<Is>(columns_)[row] = values), ...);
+    }
+
+    template <size_t... Is>
+    void reserveColumns(size_t capacity, std::index_sequence<Is...>)
+    {
+        (reserveColumn(std::get<Is>(columns_), capacity), ...);
+    }
+
+    template <typename T>
+    void reserveColumn(T*& column, size_t capacity)
+    {
+        // capacity is a multiple of 64, so the size is a multiple of the cache line
+        T* new_column = reinterpret_cast<T*>(::aligned_alloc(64, capacity * sizeof(T)));
+        if (!new_column)
+        {
+            throw std::bad_alloc();
+        }
+        if (column)
+        {
+            std::memcpy(new_column, column, size_ * sizeof(T));
+            ::free(column);
+        }
+        // zeroed values of unused rows let kernels scan whole blocks
+        std::memset(new_column + size_, 0, (capacity - size_) * sizeof(T));
+        column = new_column;
+    }
+
+    std::tuple<Fields*...>      columns_ {};
+    // one bit per row, set if the row is live
+    std::vector<uint64_t>       live_;
+    // indexes of removed rows to be reused
+    std::vector<size_t>         collector_;
+    size_t                      size_ {0};
+    size_t                      live_num_ {0};
+    size_t                      capacity_ {0};
+};
+
+}
@@ -8,17 +8,28 @@
 /**
  * @file DoubleHash.h
  * @library alt_util
- * @brief Implements an open-addressing hash table to resolve hash collisions
- * by using a secondary hash of the key as an offset when a collision occurs.
- * DoubleHash has a much faster search but may be slower in inserting. Therefore,
- * it is suitable to use in case we have a fixed number of things to hash during
- * initialization.  During inserting, if collision cannot be resolved, resize the
- * table and rehash the whole entries are required.
- * TODO: to be tested and more work required to make it a good hash table to use
+ * @brief Implements a static minimal perfect hash table for a fixed set of keys
+ * known during initialization. A key is hashed into a pair of 32 bit hash values
+ * (DoubleHashKey) by a double hasher. The first hash value selects a bucket, and
+ * a displacement pair stored per bucket maps each key of the bucket to a distinct
+ * slot (CHD, compress-hash-displace). Every key has exactly one slot, so a lookup
+ * reads one displacement and one slot without probing.
+ *   - DoubleHashBuilder: collects keys and values and builds the table into a flat
+ *     blob. The blob has no pointers and can be saved to a file.
+ *   - DoubleHash: a read-only view of the table over a blob, which can be in memory
+ *     mapped from a file. Attaching to a blob takes constant time.
  */
 
+#include <util/system/Platform.h>       // for ALT_UNLIKELY
 #include <util/numeric/Intrinsics.h>    // RJIntHash and TWIntHash
-#include <util/string/StrUtils.h>       // for StrHash
+#include <util/string/StrUtils.h>       // for strHash
+#include <algorithm>                    // for sort
+#include <cstring>                      // for memcpy, memcmp
+#include <stdexcept>                    // for runtime_error
+#include <string>                       // for string
+#include <string_view>                  // for string_view
+#include <type_traits>                  // for is_trivially_copyable
+#include <vector>                       // for vector
 
 namespace alt
 {
@@ -27,201 +38,453 @@ struct DoubleHashKey
 {
     uint32_t           key1_ {0};
     uint32_t           key2_ {0};
+
+    bool operator==(const DoubleHashKey& oth) const
+    { return key1_ == oth.key1_ && key2_ == oth.key2_; }
 };
 
-template <class KT, class T, class Hash>
-class DoubleHash
+struct UInt32DoubleHasher
 {
-  public:
-    typedef T   mapped_type;
-    typedef KT  key_type;
-
-    struct value_type
-    {
-        key_type           key_;
-        mapped_type        value_;
-        DoubleHashKey      dh_key_;
-        bool               replaced_ {false};
-        bool               empty_ {true};
-    };
+    using KeyType = uint32_t;
 
-    DoubleHash(uint32_t init_size) : value_buffer_ (NULL)
+    static inline void hash (KeyType key, DoubleHashKey& dh_key)
     {
-        initialize(init_size);
+        dh_key.key1_ = RJIntHash(key);
+        dh_key.key2_ = TWIntHash(key);
     }
+};
 
-    bool insert(key_type key, const T& val);
-    int32_t find(key_type key);
+/// \brief MurmurHash3 64 bit finalizer. It is a bijection, so the two halves of
+/// the result never collide for distinct keys
+inline uint64_t fmix64(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+struct UInt64DoubleHasher
+{
+    using KeyType = uint64_t;
 
-   private:
+    static inline void hash (KeyType key, DoubleHashKey& dh_index)
+    {
+        uint64_t h = fmix64(key);
+        dh_index.key1_ = uint32_t(h >> 32);
+        dh_index.key2_ = uint32_t(h);
+    }
+};
 
-      void initialize(uint32_t init_size);
-      bool replace(int32_t index, const T& new_val);
+struct AddressDoubleHasher
+{
+    using KeyType = const void*;
 
-      std::vector<value_type>          values_;
-      uint32_t                         index_mask_;
+    static inline void hash (KeyType key, DoubleHashKey& dh_index)
+    {
+        UInt64DoubleHasher::hash(reinterpret_cast<uint64_t>(key), dh_index);
+    }
 };
 
-template <class KT, class T, class Hash>
-void DoubleHash<KT,T,Hash>::initialize(uint32_t init_size)
+struct StringDoubleHasher
 {
-    uint32_t adjusted_size = 1 << bsr(init_size);
+    using KeyType = std::string_view;
 
-    if (adjusted_size < init_size)
+    static inline void hash (KeyType key, DoubleHashKey& dh_index)
     {
-        adjusted_size <<= 1;
+        dh_index.key1_ = strHash(key.data(), key.length(), 0x165667b1);
+        dh_index.key2_ = strHash(key.data(), key.length(), 0x27d4eb2d);
     }
+};
 
-    index_mask_ = adjusted_size - 1;
-    value_buffer_.resize(adjusted_size);
-}
+/**
+ * \struct DoubleHashStoredKey
+ * \brief The key stored in a slot of the table blob to verify the key looked up.
+ * Keys of trivially copyable types are stored in the slot.
+ */
+template <typename KeyType>
+struct DoubleHashStoredKey
+{
+    static_assert(std::is_trivially_copyable<KeyType>::value);
+    using OwnedKeyType = KeyType;
 
-template <class KT, class T, class Hash>
-int32_t DoubleHash<KT,T,Hash>::find(key_type key)
+    KeyType     key_;
+
+    bool equals(KeyType key, const char*) const { return key_ == key; }
+    void store(const OwnedKeyType& key, std::vector<char>&) { key_ = key; }
+};
+
+/**
+ * \brief String keys are stored in the string area of the blob, and the slot has
+ * the offset and the length of the string
+ */
+template <>
+struct DoubleHashStoredKey<std::string_view>
 {
-    DoubleHashKey dh_key;
-    Hash::hash (key, dh_key);
-    int32_t index1 = dh_key.key1_ & index_mask_;
-    int32_t index2 = dh_key.key2_ & index_mask_;
-    auto& val1 = values_[index1];
-    if (val1.dh_key_ == dh_key)
+    using OwnedKeyType = std::string;
+
+    uint32_t    offset_;
+    uint32_t    length_;
+
+    bool equals(std::string_view key, const char* strings) const
     {
-        return val1_.index_;
+        return key.length() == length_ && ::memcmp(strings + offset_, key.data(), length_) == 0;
     }
-    auto& val2 = values_[index2];
-    if (val1.dh_key_ == dh_key)
+
+    void store(const OwnedKeyType& key, std::vector<char>& strings)
     {
-        return val2.index_;
+        offset_ = uint32_t(strings.size());
+        length_ = uint32_t(key.length());
+        strings.insert(strings.end(), key.c_str(), key.c_str() + key.length() + 1);
     }
-    return -1;
-}
+};
 
-template <class KT, class T, class Hash>
-bool DoubleHash<KT,T,Hash>::replace(int32_t index, const T& new_val)
+/**
+ * \class DoubleHash
+ * \ingroup ContainerUtils
+ * \brief A read-only minimal perfect hash table over a blob built by DoubleHashBuilder
+ * \tparam Hasher the double hasher of the key, which provides KeyType and
+ * static void hash(KeyType, DoubleHashKey&)
+ * \tparam T the type of the value. Must be trivially copyable
+ * \note The blob must outlive the table unless it is moved into the table, and
+ * must be aligned to 8 bytes, which is the case for memory mapped files.
+ */
+template <class Hasher, typename T>
+class DoubleHash
 {
-    auto& val = values_[index];
-    if (val.replaced_)
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "DoubleHash value type must be trivially copyable");
+
+  public:
+
+    using key_type    = typename Hasher::KeyType;
+    using mapped_type = T;
+    using StoredKey   = DoubleHashStoredKey<key_type>;
+
+    constexpr static uint64_t MAGIC_WORD = 0x48534148454c4244;   // "DBLEHASH"
+
+    struct Header
     {
-        sdt::cerr << "Cyclic replacing position " << index << std::endl;
-        val.replaced_ = false;
-        return false;
-    }
-    const auto old_val = values_[index];
-    values_[index] = new_val;
-    if (old_val.empty_)
+        uint64_t    magic_word_;
+        uint32_t    key_num_;
+        uint32_t    bucket_num_;
+        uint32_t    slot_num_;
+        uint32_t    slot_size_;
+        uint64_t    displacement_offset_;
+        uint64_t    slot_offset_;
+        uint64_t    string_offset_;
+        uint64_t    blob_size_;
+    };
+
+    struct Displacement
     {
-        val.replaced_ = false;
-        return true;
-    }
-    val.replaced_ = true;
-    bool res {false};
-    if (index==old_val.dh_key_.key1_ & index_mask_)
+        uint32_t    d0_;
+        uint32_t    d1_;
+    };
+
+    struct Slot
     {
-        res = replace(old_val.dh_key_.key2_ & index_mask_, old_val);
-    }
-    else
+        StoredKey   key_;
+        T           value_;
+    };
+
+    /// \brief attaches to a blob built by DoubleHashBuilder
+    /// \throw runtime_error if the blob is not a table of this type
+    DoubleHash(const char* blob, size_t blob_size) { attach(blob, blob_size); }
+
+    /// \brief takes the ownership of a blob built by DoubleHashBuilder
+    DoubleHash(std::vector<char>&& blob) : owned_blob_(std::move(blob))
     {
-        res = replace(old_val.dh_key_.key1_ & index_mask_, old_val);
+        attach(owned_blob_.data(), owned_blob_.size());
     }
-    val_.replaced_ = false;
-    return res;
-}
 
-template <class KT, class T, class Hash>
-bool DoubleHash<KT,T,Hash>::insert(key_type key, const T& val)
-{
-    int32_t key1, key2;
-    DoubleHashKey dh_key;
-    Hash::hash (key, dh_key);
-    int32_t index1 = dh_key.key1_ & index_mask_;
-    int32_t index2 = dh_key.key2_ & index_mask_;
+    DoubleHash(const DoubleHash&) = delete;
+    DoubleHash& operator=(const DoubleHash&) = delete;
 
-    auto& val1 = values_[index1];
-    if (val1.key_ == key && !val1.empty_)
+    /// \brief returns the bucket of the double hash key
+    static uint32_t bucketIndex(const DoubleHashKey& dh_key, uint32_t bucket_num)
     {
-        // this entry is already inserted
-        return false;
+        return uint32_t((uint64_t(dh_key.key1_) * bucket_num) >> 32);
     }
 
-    auto& val2 = values_[index2];
-    if (val2.key_ == key && !val2.empty_)
+    /// \brief returns the slot of the double hash key with the displacement of
+    /// its bucket
+    static uint32_t slotIndex(const DoubleHashKey& dh_key, const Displacement& d, uint32_t slot_num)
     {
-        // this entry is already inserted
-        return false;
+        return uint32_t((dh_key.key2_ + uint64_t(d.d0_) * dh_key.key1_ + d.d1_) % slot_num);
     }
 
-    if (val1.empty_)
+    /// \brief find the value by the key
+    /// \return pointer to the value or nullptr if the key is not in the table
+    const T* find(key_type key) const
     {
-        val1.empty_ = false;
-        val1.replaced_ = false;
-        val1.key_   = key;
-        val1.key1_  = dh_key.key1_;
-        val1.key2_  = dh_key.key2_;
-        return true;
+        if (ALT_UNLIKELY(header_->key_num_ == 0))
+        {
+            return nullptr;
+        }
+        DoubleHashKey dh_key;
+        Hasher::hash(key, dh_key);
+        const Displacement& d = displacements_[bucketIndex(dh_key, header_->bucket_num_)];
+        const Slot& slot = slots_[slotIndex(dh_key, d, header_->slot_num_)];
+        return slot.key_.equals(key, strings_) ? &slot.value_ : nullptr;
     }
 
-    if (val2.empty_)
+    bool contains(key_type key) const { return find(key) != nullptr; }
+
+    /// \brief returns the number of keys
+    size_t size() const { return header_->key_num_; }
+
+    bool empty() const { return header_->key_num_ == 0; }
+
+    /// \brief returns the blob the table is on
+    const char* blob() const { return reinterpret_cast<const char*>(header_); }
+    size_t blobSize() const { return header_->blob_size_; }
+
+  private:
+
+    /// \brief returns true if size bytes at offset are in a blob of blob_size
+    static bool inBlob(uint64_t offset, uint64_t size, uint64_t blob_size)
     {
-        val2.empty_ = false;
-        val2.replaced_ = false;
-        val2.key_   = key;
-        val2.dh_key_  = dh_key;
-        return true;
+        return offset <= blob_size && size <= blob_size - offset;
     }
- 
-    if (!replace(index1, val))
+
+    void attach(const char* blob, size_t blob_size)
     {
-        return false;
+        header_ = reinterpret_cast<const Header*>(blob);
+        if (blob_size < sizeof(Header) || header_->magic_word_ != MAGIC_WORD ||
+            header_->slot_size_ != sizeof(Slot) || header_->blob_size_ > blob_size ||
+            header_->slot_num_ == 0 || header_->bucket_num_ == 0 ||
+            header_->key_num_ > header_->slot_num_)
+        {
+            throw std::runtime_error(std::string("Invalid DoubleHash blob"));
+        }
+        // a truncated or corrupt blob must not give tables out of the blob
+        const uint64_t size = header_->blob_size_;
+        if (header_->displacement_offset_ % alignof(Displacement) != 0 ||
+            header_->slot_offset_ % alignof(Slot) != 0 ||
+            !inBlob(header_->displacement_offset_,
+                    uint64_t(header_->bucket_num_) * sizeof(Displacement), size) ||
+            !inBlob(header_->slot_offset_, uint64_t(header_->slot_num_) * sizeof(Slot), size) ||
+            !inBlob(header_->string_offset_, 0, size))
+        {
+            throw std::runtime_error(std::string("Invalid DoubleHash blob"));
+        }
+        displacements_ = reinterpret_cast<const Displacement*>(blob + header_->displacement_offset_);
+        slots_ = reinterpret_cast<const Slot*>(blob + header_->slot_offset_);
+        strings_ = blob + header_->string_offset_;
     }
 
-    return true;
-}
+    std::vector<char>       owned_blob_;
+    const Header*           header_ {nullptr};
+    const Displacement*     displacements_ {nullptr};
+    const Slot*             slots_ {nullptr};
+    const char*             strings_ {nullptr};
+};
 
-class UInt32DoubleHasher
+/**
+ * \class DoubleHashBuilder
+ * \ingroup ContainerUtils
+ * \brief Builds the blob of a DoubleHash table from keys and values
+ * \details Keys are grouped in buckets by the first hash value, averaging
+ * AVG_BUCKET_SIZE keys in a bucket. Buckets are placed from the largest to the
+ * smallest. For a bucket, displacements (d0, d1) are searched until every key
+ * in the bucket lands in a distinct free slot at
+ * (key2 + d0 * key1 + d1) % slot_num. Buckets of one key take the next free slot
+ * directly. There are as many slots as keys.
+ */
+template <class Hasher, typename T>
+class DoubleHashBuilder
 {
-   typedef uint32_t        KeyType;
+  public:
 
-   static inline void hash (KeyType key, DoubleHashKey& dh_key)
-   {
-      dh_key.key1_ = RJIntHash(key);
-      dh_key.key2_ = TWIntHash(key);
-   }
-};
+    using Table        = DoubleHash<Hasher, T>;
+    using key_type     = typename Hasher::KeyType;
+    using StoredKey    = typename Table::StoredKey;
+    using OwnedKeyType = typename StoredKey::OwnedKeyType;
 
-class UInt64DoubleHasher
-{
-   typedef uint64_t        KeyType;
+    constexpr static uint32_t AVG_BUCKET_SIZE = 4;
+    constexpr static uint32_t MAX_D0 = 256;
 
-   static inline void hash (KeyType key, DoubleHashKey& dh_index)
-   {
-      dh_index.key1_ = RJIntHash(key & 0xFFFFFFFFU) ^ TWIntHash(key >> 32);
-      dh_index.key2_ = TWIntHash(key & 0xFFFFFFFFU) ^ RJIntHash(key >> 32);
-   }
-};
+    /// \brief adds a key and its value
+    void add(key_type key, const T& value)
+    {
+        keys_.emplace_back(key);
+        values_.push_back(value);
+    }
 
-class AddressDoubleHasher
-{
-   typedef void*        KeyType;
-
-   static inline void hash (KeyType key, DoubleHashKey& dh_index)
-   {
-      dh_index.key1_ = RJIntHash(reinterpret_cast<uint64_t>(key) & 0xFFFFFFFFU) ^
-                         TWIntHash(reinterpret_cast<uint64_t>(key) >> 32);
-      dh_index.key2_ = TWIntHash(reinterpret_cast<uint64_t>(key) & 0xFFFFFFFFU) ^
-                         RJIntHash(reinterpret_cast<uint64_t>(key) >> 32);
-   }
-};
+    size_t size() const { return keys_.size(); }
 
-class StringDoubleHasher
-{
-   typedef char*        KeyType;
+    /// \brief builds the blob of the table
+    /// \throw runtime_error if there are duplicate keys or distinct keys having the
+    /// same double hash key
+    std::vector<char> build() const
+    {
+        const uint32_t key_num = uint32_t(keys_.size());
+        const uint32_t slot_num = std::max(key_num, 1U);
+        const uint32_t bucket_num = std::max(key_num / AVG_BUCKET_SIZE, 1U);
+
+        std::vector<DoubleHashKey> dh_keys(key_num);
+        for (uint32_t ix=0; ix < key_num; ++ix)
+        {
+            Hasher::hash(key_type(keys_[ix]), dh_keys[ix]);
+        }
+
+        // group keys by bucket in a flat array
+        std::vector<uint32_t> bucket_start(bucket_num+1, 0);
+        for (auto& dh_key: dh_keys) ++bucket_start[Table::bucketIndex(dh_key, bucket_num)+1];
+        for (uint32_t b=0; b < bucket_num; ++b) bucket_start[b+1] += bucket_start[b];
+        std::vector<uint32_t> bucket_keys(key_num);
+        {
+            std::vector<uint32_t> fill(bucket_start.begin(), bucket_start.end()-1);
+            for (uint32_t ix=0; ix < key_num; ++ix)
+            {
+                bucket_keys[fill[Table::bucketIndex(dh_keys[ix], bucket_num)]++] = ix;
+            }
+        }
+        std::vector<uint32_t> bucket_order(bucket_num);
+        for (uint32_t b=0; b < bucket_num; ++b) bucket_order[b] = b;
+        std::stable_sort(bucket_order.begin(), bucket_order.end(), [&](uint32_t b1, uint32_t b2)
+        {
+            return bucket_start[b1+1]-bucket_start[b1] > bucket_start[b2+1]-bucket_start[b2];
+        });
+
+        std::vector<typename Table::Displacement> displacements(bucket_num, {0, 0});
+        std::vector<uint32_t> key_slots(key_num);
+        std::vector<bool> occupied(slot_num, false);
+        std::vector<uint32_t> bases;
+        uint32_t free_cursor = 0;
+        for (uint32_t b: bucket_order)
+        {
+            const uint32_t* keys = bucket_keys.data() + bucket_start[b];
+            const uint32_t bucket_size = bucket_start[b+1] - bucket_start[b];
+            if (bucket_size == 0)
+            {
+                break;
+            }
+            if (bucket_size == 1)
+            {
+                while (occupied[free_cursor]) ++free_cursor;
+                uint32_t base = uint32_t(dh_keys[keys[0]].key2_ % slot_num);
+                displacements[b] = {0, (free_cursor + slot_num - base) % slot_num};
+                occupied[free_cursor] = true;
+                key_slots[keys[0]] = free_cursor;
+                continue;
+            }
+            if (!placeBucket(keys, bucket_size, dh_keys, slot_num, occupied, bases,
+                             displacements[b], key_slots))
+            {
+                checkDuplicates(keys, bucket_size, dh_keys);
+                throw std::runtime_error(std::string("DoubleHashBuilder failed to place keys"));
+            }
+        }
+        return writeBlob(key_num, bucket_num, slot_num, displacements, key_slots);
+    }
+
+  private:
+
+    bool placeBucket(const uint32_t* keys, uint32_t bucket_size,
+                     const std::vector<DoubleHashKey>& dh_keys, uint32_t slot_num,
+                     std::vector<bool>& occupied, std::vector<uint32_t>& bases,
+                     typename Table::Displacement& displacement,
+                     std::vector<uint32_t>& key_slots) const
+    {
+        bases.resize(bucket_size);
+        for (uint32_t d0=0; d0 < MAX_D0; ++d0)
+        {
+            for (uint32_t i=0; i < bucket_size; ++i)
+            {
+                bases[i] = Table::slotIndex(dh_keys[keys[i]], {d0, 0}, slot_num);
+            }
+            // d1 shifts all keys together, so keys colliding at d1=0 always collide
+            std::vector<uint32_t> sorted_bases(bases);
+            std::sort(sorted_bases.begin(), sorted_bases.end());
+            if (std::adjacent_find(sorted_bases.begin(), sorted_bases.end()) != sorted_bases.end())
+            {
+                continue;
+            }
+            for (uint32_t d1=0; d1 < slot_num; ++d1)
+            {
+                uint32_t i = 0;
+                for (; i < bucket_size && !occupied[(bases[i] + uint64_t(d1)) % slot_num]; ++i);
+                if (i == bucket_size)
+                {
+                    displacement = {d0, d1};
+                    for (i=0; i < bucket_size; ++i)
+                    {
+                        uint32_t slot = uint32_t((bases[i] + uint64_t(d1)) % slot_num);
+                        occupied[slot] = true;
+                        key_slots[keys[i]] = slot;
+                    }
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    void checkDuplicates(const uint32_t* keys, uint32_t bucket_size,
+                         const std::vector<DoubleHashKey>& dh_keys) const
+    {
+        for (uint32_t i=0; i < bucket_size; ++i)
+        {
+            for (uint32_t j=i+1; j < bucket_size; ++j)
+            {
+                if (keys_[keys[i]] == keys_[keys[j]])
+                {
+                    throw std::runtime_error(std::string("DoubleHashBuilder duplicate key"));
+                }
+                if (dh_keys[keys[i]] == dh_keys[keys[j]])
+                {
+                    throw std::runtime_error(std::string("DoubleHashBuilder double hash collision"));
+                }
+            }
+        }
+    }
+
+    std::vector<char> writeBlob(uint32_t key_num, uint32_t bucket_num, uint32_t slot_num,
+                                const std::vector<typename Table::Displacement>& displacements,
+                                const std::vector<uint32_t>& key_slots) const
+    {
+        using Slot = typename Table::Slot;
+        std::vector<char> strings;
+        std::vector<Slot> slots(slot_num);
+        ::memset(static_cast<void*>(slots.data()), 0, slot_num*sizeof(Slot));
+        for (uint32_t ix=0; ix < key_num; ++ix)
+        {
+            Slot& slot = slots[key_slots[ix]];
+            slot.key_.store(keys_[ix], strings);
+            slot.value_ = values_[ix];
+        }
+
+        constexpr size_t ALIGN = std::max<size_t>(8, alignof(Slot));
+        typename Table::Header header;
+        header.magic_word_ = Table::MAGIC_WORD;
+        header.key_num_ = key_num;
+        header.bucket_num_ = bucket_num;
+        header.slot_num_ = slot_num;
+        header.slot_size_ = sizeof(Slot);
+        header.displacement_offset_ = constAlign(sizeof(header), ALIGN);
+        header.slot_offset_ = constAlign(header.displacement_offset_ +
+                                bucket_num*sizeof(typename Table::Displacement), ALIGN);
+        header.string_offset_ = header.slot_offset_ + slot_num*sizeof(Slot);
+        header.blob_size_ = constAlign(header.string_offset_ + strings.size(), ALIGN);
+
+        std::vector<char> blob(header.blob_size_, 0);
+        ::memcpy(blob.data(), &header, sizeof(header));
+        ::memcpy(blob.data() + header.displacement_offset_, displacements.data(),
+                 bucket_num*sizeof(typename Table::Displacement));
+        ::memcpy(blob.data() + header.slot_offset_, slots.data(), slot_num*sizeof(Slot));
+        if (!strings.empty())
+        {
+            ::memcpy(blob.data() + header.string_offset_, strings.data(), strings.size());
+        }
+        return blob;
+    }
 
-   static inline void hash (KeyType key, DoubleHashKey& dh_index)
-   {
-      dh_index.key1_ = strHash(key, 0x165667b1);
-      dh_index.key2_ = strHash(key, 0x27d4eb2d);
-   }
+    std::vector<OwnedKeyType>   keys_;
+    std::vector<T>              values_;
 };
 
 } // namespace alt
- 
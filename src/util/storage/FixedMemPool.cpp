@@ -4,6 +4,7 @@
 #include <cstdlib>                   // for malloc and free
 #include <stdexcept>                 // for runtime_error
 #include <string>                    // for string used by runtime_error
+#include <algorithm>                 // for max
 
 #define FIXED_POOL_DEBUG      0
 #if FIXED_POOL_DEBUG
@@ -86,6 +87,7 @@ FixedMemPool::FixedMemPool(size_t value_size, size_t slot_num_per_slab, bool laz
     , slot_num_per_slab_(slot_num_per_slab)
     , slab_size_(slot_size_*slot_num_per_slab_)
 { 
+    static_assert(sizeof(EntryHeader)==SLOT_HEADER_SIZE);
     FIXED_POOL_DBG((std::cout << "FixedMemPool(" << slot_size_ << ") Constructor lazy_alloc=" << lazy_alloc << std::endl));
     if (!lazy_alloc)
     {  
@@ -206,7 +208,8 @@ FixedMemPool::EntryHeader* FixedMemPool::newSlab()
               << slot_size_*slot_num_per_slab_
               << " slot_size="  << slot_size_
               << std::endl));
-    uint8_t* slab = reinterpret_cast<uint8_t*>(::malloc(slab_size_));
+    uint8_t* slab = reinterpret_cast<uint8_t*>(
+        ::aligned_alloc(EXPECTED_CACHE_LINE_SIZE, constAlign(slab_size_, EXPECTED_CACHE_LINE_SIZE)));
     if (!slab)
     {
         throw std::runtime_error(std::string("FixedMemPool::newSlab: memory full"));
@@ -220,98 +223,141 @@ FixedMemPool::EntryHeader* FixedMemPool::newSlab()
 // FixedMemPoolPrealloc
 //------------------------------------------------------------------------------------------
 
-FixedMemPoolPrealloc::PoolHeader::PoolHeader(char* addr, size_t slot_num, size_t value_size)
+FixedMemPoolPrealloc::PoolHeader::PoolHeader(char* addr, size_t value_size, size_t slot_num)
     : owns_buffer_(false)
     , value_size_(value_size)
-    , slot_size_ (constAlign(value_size,8))
+    , slot_size_ (constAlign(std::max(value_size, sizeof(uint64_t)),8))
     , slot_num_(slot_num)
-    , addr_ (addr)
 {
+    setAddr(addr);
     initialize();
 }
 
-FixedMemPoolPrealloc::PoolHeader::PoolHeader(size_t slot_num, size_t value_size)
+FixedMemPoolPrealloc::PoolHeader::PoolHeader(size_t value_size, size_t slot_num)
     : owns_buffer_(true)
     , value_size_(value_size)
-    , slot_size_ (constAlign(value_size,8))
+    , slot_size_ (constAlign(std::max(value_size, sizeof(uint64_t)),8))
     , slot_num_(slot_num)
-    , addr_ (reinterpret_cast<char*>(::malloc(slot_size_*slot_num_)))
 {
+    char* addr = reinterpret_cast<char*>(::malloc(slot_size_*slot_num_));
+    if (!addr)
+    {
+        throw std::runtime_error(std::string("FixedMemPoolPrealloc: memory full"));
+    }
+    setAddr(addr);
     initialize();
 }
 
+FixedMemPoolPrealloc::PoolHeader::~PoolHeader()
+{
+    if (owns_buffer_)
+    {
+        ::free(addr());
+    }
+}
+
 struct FixedMemPoolPrealloc::EntryHeader
 {
-    EntryHeader*  next_free_entry_;
+    // index+1 of the next free slot, 0 for the end of the list
+    uint64_t      next_free_entry_;
 };
 
 void FixedMemPoolPrealloc::PoolHeader::initialize()
 {
-    uint8_t* p = reinterpret_cast<uint8_t*>(addr_);
-    EntryHeader* entry=reinterpret_cast<EntryHeader*>(p);
-    for ( int i=0; i<slot_num_-1; ++i )
+    if (slot_num_ >= NULL_SLOT_INDEX)
     {
-        p+=slot_size_;
-        entry->next_free_entry_ = reinterpret_cast<EntryHeader*>(p);
-        entry=reinterpret_cast<EntryHeader*>(p);
+        throw std::runtime_error(std::string("FixedMemPoolPrealloc: too many slots"));
     }
-    entry->next_free_entry_ = nullptr;
+    char* p = addr();
+    for (size_t i=0; i<slot_num_; ++i, p+=slot_size_)
+    {
+        reinterpret_cast<EntryHeader*>(p)->next_free_entry_ = i+1 < slot_num_ ? i+2 : 0;
+    }
+    head_.store(slot_num_ > 0 ? 1 : 0, std::memory_order_release);
 }
 
-FixedMemPoolPrealloc::FixedMemPoolPrealloc(char* addr, size_t slot_num, size_t value_size)
-    : header_(addr, slot_num, value_size)
+FixedMemPoolPrealloc::FixedMemPoolPrealloc(char* addr, size_t value_size, size_t slot_num)
+    : header_(addr, value_size, slot_num)
 {}
 
-FixedMemPoolPrealloc::FixedMemPoolPrealloc(size_t slot_num, size_t value_size)
-    : header_(slot_num, value_size)
+FixedMemPoolPrealloc::FixedMemPoolPrealloc(size_t value_size, size_t slot_num)
+    : header_(value_size, slot_num)
 {}
 
 void FixedMemPoolPrealloc::setAddr(char* addr, size_t value_size, size_t slot_num)
 {
-    header_.addr_ = addr;
     header_.value_size_ = value_size;
-    header_.slot_size_ = constAlign(value_size,8);
+    header_.slot_size_ = constAlign(std::max(value_size, sizeof(uint64_t)),8);
     header_.slot_num_ = slot_num;
+    header_.setAddr(addr);
     header_.initialize();
 }
 
 FixedMemPoolPrealloc::~FixedMemPoolPrealloc()
 {
-    if (header_.owns_buffer_)
+}
+
+size_t FixedMemPoolPrealloc::requiredHeaderSize()
+{
+    return constAlign(sizeof(FixedMemPoolPrealloc), SysConfig::instance().cache_line_size_);
+}
+
+size_t FixedMemPoolPrealloc::requiredDataSize(size_t value_size, size_t slot_num)
+{
+    return constAlign(std::max(value_size, sizeof(uint64_t)),8) * slot_num;
+}
+
+size_t FixedMemPoolPrealloc::requiredSize(size_t value_size, size_t slot_num)
+{
+    return requiredHeaderSize() + requiredDataSize(value_size, slot_num);
+}
+
+FixedMemPoolPrealloc* FixedMemPoolPrealloc::create(
+    char* addr, const MemoryAttrs& attrs, size_t value_size, size_t slot_num)
+{
+    if (attrs.is_new_)
     {
-        ::free(header_.addr_);
+        return new (addr) FixedMemPoolPrealloc(addr + requiredHeaderSize(), value_size, slot_num);
     }
+    return reinterpret_cast<FixedMemPoolPrealloc*>(addr);
 }
 
 void* FixedMemPoolPrealloc::allocate()
 {
-    EntryHeader* expected_free_entry_head = header_.head_.load(std::memory_order_relaxed);
-    EntryHeader* next_free_entry;
+    uint64_t head = header_.head_.load(std::memory_order_acquire);
+    uint64_t new_head;
+    EntryHeader* entry;
     do
     {
-        if (!header_.head_)
+        uint64_t index = head & 0xFFFFFFFF;
+        if (index == 0)
         {
             return nullptr;
         }
-
-        next_free_entry = expected_free_entry_head->next_free_entry_;
+        entry = reinterpret_cast<EntryHeader*>(slotAddr(uint32_t(index-1)));
+        // The entry may have been taken by others so next_free_entry_ may be
+        // garbage, in which case the tag in head_ has been changed and CAS fails
+        new_head = ((head >> 32) + 1) << 32 | entry->next_free_entry_;
     }
-    while (!header_.head_.compare_exchange_weak(expected_free_entry_head, next_free_entry,
-                std::memory_order_release, std::memory_order_acquire));
+    while (!header_.head_.compare_exchange_weak(head, new_head,
+                std::memory_order_acq_rel, std::memory_order_acquire));
 
-    return expected_free_entry_head;
+    return entry;
 }
 
 void FixedMemPoolPrealloc::deallocate(void* p)
 {
-    EntryHeader* new_head = reinterpret_cast<EntryHeader*>(p);
-    EntryHeader* cur_head = header_.head_;
+    EntryHeader* entry = reinterpret_cast<EntryHeader*>(p);
+    uint64_t index = slotIndex(p) + 1;
+    uint64_t head = header_.head_.load(std::memory_order_acquire);
+    uint64_t new_head;
     do
     {
-        new_head->next_free_entry_ = cur_head;
+        entry->next_free_entry_ = head & 0xFFFFFFFF;
+        new_head = ((head >> 32) + 1) << 32 | index;
     }
-    while (!header_.head_.compare_exchange_weak(cur_head, new_head,
-            std::memory_order_release, std::memory_order_acquire));
+    while (!header_.head_.compare_exchange_weak(head, new_head,
+            std::memory_order_acq_rel, std::memory_order_acquire));
 }
 
 } // name space alt
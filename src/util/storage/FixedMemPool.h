@@ -45,6 +45,11 @@ class PooledAllocator;
 class ALT_UTIL_PUBLIC FixedMemPool
 {
   public:
+
+    /// size of the header before each slot. Slabs are aligned by the cache line
+    /// size, so slots are aligned by cache lines when value size plus the header
+    /// size is a multiple of the cache line size
+    constexpr static size_t SLOT_HEADER_SIZE = 8;
       
     /// \brief Constructor. This can only be safely done when all other threads using
     /// this pool have not started accessing to this.
@@ -204,20 +209,27 @@ class FixedPool: public FixedMemPool
  * slots are done only during initialization, this helps to simplify the allocation in
  * an atomic way so ths pool can be shared among threads and process (if in shared
  * memory)
+ * \note The pool holds no pointers. Free slots are linked by slot index and the
+ * slot area is located by an offset relative to the pool header, so the pool works
+ * when the shared memory is mapped at different addresses in different processes.
+ * The free list head is tagged with a counter to avoid the ABA problem.
  */
-// TODO: justify usage of this and then decide whether to keep it or remove it. Not
-// tested yet
 class ALT_UTIL_PUBLIC FixedMemPoolPrealloc
 {
   public:
-      
+
+    /// \brief Value returned by slotIndex for an address not in the pool
+    static constexpr uint32_t NULL_SLOT_INDEX = 0xFFFFFFFF;
+
     /// \brief Constructor
     /// \param addr  address for the preallocated memory pool
+    /// \param value_size the size of the value contained in each slot
     /// \param slot_num slot number in the preallocated memory
     /// \note Use this constructor to pass the memory allocated outside
     FixedMemPoolPrealloc(char* addr, size_t value_size, size_t slot_num);
 
     /// \brief Constructor
+    /// \param value_size the size of the value contained in each slot
     /// \param slot_num slot number in the preallocated memory
     /// \note Use this constructor to allocate the memory internally
     FixedMemPoolPrealloc(size_t value_size, size_t slot_num);
@@ -231,43 +243,92 @@ class ALT_UTIL_PUBLIC FixedMemPoolPrealloc
     /// \brief Get memory pool header size
     static size_t requiredHeaderSize();
 
+    /// \brief Get memory size required for the slots only
+    /// \param value_size the size of the value contained in each slot
+    /// \param slot_num slot number in the preallocated memory
+    static size_t requiredDataSize(size_t value_size, size_t slot_num);
+
     /// \brief Get required memory size for both the header and the memory pool
-    /// \param capacity the size of the memory pool
+    /// \param value_size the size of the value contained in each slot
+    /// \param slot_num slot number in the preallocated memory
     /// \note This function is required by SharedMemory template
     static size_t requiredSize(size_t value_size, size_t slot_num);
 
+    /// \brief Create a pool instance in an allocated memory
+    /// \param addr the address of the memory
+    /// \param attrs memory addtributes
+    /// \note if attrs.is_new_ is true, a new pool is constructed in addr. Otherwise,
+    /// addr contains a pool already created by other process and this function simply
+    /// returns the instance for sharing.
+    static FixedMemPoolPrealloc* create (
+        char* addr, const MemoryAttrs& attrs, size_t value_size, size_t slot_num);
+
+    static SM_Mode getOpenMode(bool is_master)
+    { return is_master ? SM_Mode::SM_OpenOrCreate : SM_Mode::SM_OpenOnly; }
+
+    /// every process sharing the pool allocates and deallocates in it
+    static SM_Access getAccessRequest(bool) { return SM_Access::SM_ReadWrite; }
+
     /// \brief Set the preallocated memory pool
     /// \param addr  address for the preallocated memory pool
-    /// \param pool_sz  size of the preallocated memory
+    /// \param value_size the size of the value contained in each slot
+    /// \param slot_num slot number in the preallocated memory
     /// \note This must be called if empty constructor is used
     void setAddr(char* addr, size_t value_size, size_t slot_num);
 
     /// \brief allocate a slot in the pool
-    /// \return the starting address of the slot
+    /// \return the starting address of the slot, or nullptr if the pool is full
     void* allocate() noexcept(false);
 
     /// \brief deallocate a slot in the pool
     /// \param p the starting address of the slot
     void deallocate(void* p) noexcept(false);
 
+    /// \brief returns the index of the slot starting at p. Slot index, instead of
+    /// the address, shall be kept in shared memory to refer to a slot
+    uint32_t slotIndex(const void* p) const
+    {
+        return p ? uint32_t((reinterpret_cast<const char*>(p) - header_.addr()) /
+                            header_.slot_size_)
+                 : NULL_SLOT_INDEX;
+    }
+
+    /// \brief returns the starting address of the slot at index
+    void* slotAddr(uint32_t index) const
+    {
+        return header_.addr() + size_t(index) * header_.slot_size_;
+    }
+
+    /// \brief returns the slot size
+    size_t slotSize() const { return header_.slot_size_; }
+
+    /// \brief returns the number of slots in the pool
+    size_t slotNum() const { return header_.slot_num_; }
+
   private:
 
     struct EntryHeader;
     struct PoolHeader
     {
-        const bool              owns_buffer_  {false};
+        bool                    owns_buffer_  {false};
         size_t                  value_size_   { 0 };
         size_t                  slot_size_    { 0 };
         size_t    			    slot_num_     {0};
-        char*       			addr_         {nullptr};
+        ptrdiff_t               addr_offset_  {0};  // slot area relative to this header
 
-        //EntryHeader*            head_ {nullptr};
-        CACHE_LINE_ALIGN std::atomic<EntryHeader*>  head_ {nullptr};
+        // Free list head: the lower 32 bits is the index+1 of the first free slot
+        // (0 for empty list) and the higher 32 bits is a tag to avoid ABA problem
+        CACHE_LINE_ALIGN std::atomic<uint64_t>  head_ {0};
 
-        PoolHeader(char* addr, size_t slot_num, size_t value_size);
-        PoolHeader(size_t slot_num_, size_t value_size_);
+        PoolHeader(char* addr, size_t value_size, size_t slot_num);
+        PoolHeader(size_t value_size, size_t slot_num);
         PoolHeader() = default;
+        ~PoolHeader();
         void initialize();
+        void setAddr(char* addr)
+        { addr_offset_ = addr - reinterpret_cast<char*>(this); }
+        char* addr() const
+        { return const_cast<char*>(reinterpret_cast<const char*>(this)) + addr_offset_; }
     }
     header_;
 };
@@ -280,7 +341,6 @@ class ALT_UTIL_PUBLIC FixedMemPoolPrealloc
  * \ingroup ContainerUtils
  * \brief An template for preallocated pool for a given type
  * \tparam T the type of the entry in each slot
- * \tparam SlotNum the number of entries preallocated
  */
 template <typename  T>
 class FixedPoolPrealloc: public FixedMemPoolPrealloc
@@ -297,19 +357,33 @@ class FixedPoolPrealloc: public FixedMemPoolPrealloc
         FixedMemPoolPrealloc::setAddr(addr, sizeof(T), slot_num);
     }
 
+    static size_t requiredDataSize(size_t slot_num)
+    {
+        return FixedMemPoolPrealloc::requiredDataSize(sizeof(T), slot_num);
+    }
+
     static size_t requiredSize(size_t slot_num)
     {
         return FixedMemPoolPrealloc::requiredSize(sizeof(T), slot_num);
     }
 
+    static FixedPoolPrealloc* create (char* addr, const MemoryAttrs& attrs, size_t slot_num)
+    {
+        if (attrs.is_new_)
+        {
+            return new (addr) FixedPoolPrealloc(addr + requiredHeaderSize(), slot_num);
+        }
+        return reinterpret_cast<FixedPoolPrealloc*>(addr);
+    }
+
     /// \brief create an instance of T in the pool
     /// \tparam Args argument list for T constructor
-    /// \return pointer to the instance
+    /// \return pointer to the instance, or nullptr if the pool is full
     template <typename... Args>
     T* acq(Args&&... args) noexcept(false)
     {
         void* p = FixedMemPoolPrealloc::allocate();
-        return new (p) T (std::forward<Args>(args)...);
+        return p ? new (p) T (std::forward<Args>(args)...) : nullptr;
     }
 
     /// \brief delete an instance of T in the pool
@@ -319,6 +393,9 @@ class FixedPoolPrealloc: public FixedMemPoolPrealloc
         v->~T();
         FixedMemPoolPrealloc::deallocate(v);
     }
+
+    /// \brief returns the instance stored in the slot at index
+    T* at(uint32_t index) const { return reinterpret_cast<T*>(slotAddr(index)); }
 };
 
 using SharedFixedMemPool = SharedContainer<SharedMemory, FixedMemPoolPrealloc>;
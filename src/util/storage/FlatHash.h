@@ -0,0 +1,553 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file FlatHash.h
+ * @library alt_util
+ * @brief Defines an open addressing hash table with SIMD probing in the style of
+ * Swiss table. Compared to PooledHash:
+ *    - no pointer chasing: a lookup reads one 16-byte group of control bytes and
+ *      normally one slot, both usually in the same or adjacent cache lines
+ *    - each control byte keeps 7 bits of the hash so that 16 slots are filtered
+ *      with one SSE2 comparison before any key is compared
+ *    - values are stored inline in slots, or in a fixed pool with only pointers in
+ *      slots when values must have stable addresses
+ * The table is keyed through the same interface as PooledHash, see
+ * MAKE_POOLED_HASH_ENTRY
+ */
+
+#include "PooledHash.h"                 // for MAKE_POOLED_HASH_ENTRY
+#include "FixedMemPool.h"               // for FixedPool
+#include <util/numeric/Intrinsics.h>    // for ctz, log2Ceil, constAlign
+#include <util/system/Platform.h>       // for ALT_LIKELY
+#include <util/types/TemplateHelper.h>  // for NONCOPYABLE
+#include <type_traits>                  // for conditional_t, aligned_storage_t
+#include <algorithm>                    // for max
+#include <utility>                      // for pair
+#include <stdlib.h>                     // for aligned_alloc/free
+#include <string.h>                     // for memset
+#include <new>                          // for bad_alloc
+#if defined(__SSE2__)
+#include <emmintrin.h>                  // for _mm_cmpeq_epi8, _mm_movemask_epi8
+#endif
+
+namespace alt {
+
+/**
+ * \struct FlatHashGroup
+ * \ingroup ContainerUtils
+ * \brief A group of 16 control bytes matched together. A control byte is EMPTY,
+ * DELETED, or the lower 7 bits of the hash of the value in a full slot.
+ */
+struct FlatHashGroup
+{
+    constexpr static size_t  WIDTH = 16;
+    constexpr static int8_t  EMPTY = -128;
+    constexpr static int8_t  DELETED = -2;
+
+#if defined(__SSE2__)
+    __m128i     ctrl_;
+
+    explicit FlatHashGroup(const int8_t* ctrl)
+        : ctrl_(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+    /// \brief returns the bitmask of the slots having the hash bits h2
+    uint32_t match(int8_t h2) const
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_));
+    }
+
+    /// \brief returns the bitmask of the empty or deleted slots
+    uint32_t matchEmptyOrDeleted() const { return _mm_movemask_epi8(ctrl_); }
+#else
+    const int8_t*   ctrl_;
+
+    explicit FlatHashGroup(const int8_t* ctrl) : ctrl_(ctrl) {}
+
+    uint32_t match(int8_t h2) const
+    {
+        uint32_t mask = 0;
+        for (size_t i=0; i < WIDTH; ++i) mask |= uint32_t(ctrl_[i]==h2) << i;
+        return mask;
+    }
+
+    uint32_t matchEmptyOrDeleted() const
+    {
+        uint32_t mask = 0;
+        for (size_t i=0; i < WIDTH; ++i) mask |= uint32_t(ctrl_[i] < 0) << i;
+        return mask;
+    }
+#endif
+
+    /// \brief returns the bitmask of the empty slots
+    uint32_t matchEmpty() const { return match(EMPTY); }
+
+    /// \brief returns the bitmask of the full slots
+    uint32_t matchFull() const { return ~matchEmptyOrDeleted() & 0xFFFF; }
+};
+
+/**
+ * \class FlatHash
+ * \ingroup ContainerUtils
+ * \brief Implements an open addressing hash table with unique keys. Slots are
+ * arranged in groups of 16 and probed group by group.
+ * \tparam ValueType the type of the value, which contains the key. The ValueType must
+ * provide the same interface as for PooledHash, see MAKE_POOLED_HASH_ENTRY
+ * \tparam StablePointer when false, values are stored in slots and move when the
+ * table grows. When true, values are allocated in a fixed pool and pointers to
+ * values stay valid until the values are erased
+ * \tparam BucketSize the size of the bucket of the fixed memory pool when
+ * StablePointer is true
+ * \note The table grows to double when 7/8 of the slots are used. Pointers and
+ * iterators are invalidated by insert unless StablePointer is true.
+ */
+template <typename ValueType, bool StablePointer=false, size_t BucketSize=1024>
+class FlatHash
+{
+    using SlotType = std::conditional_t<StablePointer, ValueType*,
+                        std::aligned_storage_t<sizeof(ValueType), alignof(ValueType)>>;
+    using KeyType  = typename ValueType::KeyType;
+
+  public:
+
+    using value_type     = ValueType;
+    using allocator_type = FixedPool<ValueType, BucketSize>;
+
+    /// minimum number of slots
+    constexpr static size_t MIN_CAPACITY = FlatHashGroup::WIDTH;
+
+    /**
+     * \struct InsertResult
+     * \brief The result returned by insert and emplace
+     */
+    struct InsertResult
+    {
+        ValueType*   value_;   ///< pointer to the value inserted or found
+        bool         is_new_;  ///< true if the value is newly inserted
+    };
+
+    NONCOPYABLE(FlatHash);
+
+    /// \brief constructor
+    /// \param capacity the initial number of slots. The table grows when needed
+    /// \param pool a fixed pool to hold all values when StablePointer is true.
+    /// If not given, a pool will be created internally.
+    FlatHash (size_t capacity=MIN_CAPACITY, allocator_type* pool=nullptr) : pool_(pool)
+    {
+        if (StablePointer && !pool_)
+        {
+            pool_ = new allocator_type();
+            owns_pool_ = true;
+        }
+        allocate(size_t(1) << log2Ceil(std::max(capacity, MIN_CAPACITY)));
+    }
+
+    /// \brief destructor
+    ~FlatHash()
+    {
+        destroyAll();
+        ::free(ctrl_);
+        if (owns_pool_)
+        {
+            delete pool_;
+        }
+    }
+
+    /// \brief Forward iterator over values, const_iterator when IsConst is true
+    template <bool IsConst>
+    class Iterator
+    {
+        using Value = std::conditional_t<IsConst, const ValueType, ValueType>;
+        const FlatHash*   table_;
+        size_t            ix_;
+        Iterator(const FlatHash* table, size_t ix) : table_(table), ix_(ix) { skipEmpty(); }
+        void skipEmpty() { while (ix_ < table_->capacity_ && table_->ctrl_[ix_] < 0) ++ix_; }
+        friend class FlatHash;
+      public:
+        /// an iterator converts to a const_iterator
+        template <bool C = IsConst, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& itr) : table_(itr.table_), ix_(itr.ix_) {}
+        bool operator!=(const Iterator& itr) const { return ix_ != itr.ix_; }
+        bool operator==(const Iterator& itr) const { return ix_ == itr.ix_; }
+        Value& operator*() const { return *table_->valuePtr(ix_); }
+        Value* operator->() const { return table_->valuePtr(ix_); }
+        Iterator& operator++() { ++ix_; skipEmpty(); return *this; }
+    };
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, capacity_); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, capacity_); }
+    const_iterator cbegin() const { return const_iterator(this, 0); }
+    const_iterator cend() const { return const_iterator(this, capacity_); }
+
+    /// \brief Returns the number of values in the table
+    size_t size() const { return size_; }
+
+    /// \brief Returns true if the table has no value
+    bool empty() const { return size_ == 0; }
+
+    /// \brief Returns the number of slots
+    size_t capacity() const { return capacity_; }
+
+    /// \brief find the value by its key value
+    /// \return the pointer to the value or nullptr if the key is not found
+    ValueType* findValue(const KeyType& key) const
+    {
+        size_t ix = findIndex(key, mix(ValueType::hash(key)));
+        return ix == NOT_FOUND ? nullptr : valuePtr(ix);
+    }
+
+    /// \brief find the value by its key value
+    /// \return the iterator to the value or end() if the key is not found
+    iterator find(const KeyType& key)
+    {
+        size_t ix = findIndex(key, mix(ValueType::hash(key)));
+        return iterator(this, ix == NOT_FOUND ? capacity_ : ix);
+    }
+
+    const_iterator find(const KeyType& key) const
+    {
+        size_t ix = findIndex(key, mix(ValueType::hash(key)));
+        return const_iterator(this, ix == NOT_FOUND ? capacity_ : ix);
+    }
+
+    /// \brief returns true if the key is in the table
+    bool contains(const KeyType& key) const
+    {
+        return findIndex(key, mix(ValueType::hash(key))) != NOT_FOUND;
+    }
+
+    /// \brief Inserts a value if there is no value with the same key
+    /// \return the InsertResult with a pointer to the value in the table and
+    /// a boolean value to indicate whether the value is newly inserted
+    InsertResult insert(const ValueType& value)
+    {
+        return emplaceValue(value);
+    }
+
+    InsertResult insert(ValueType&& value)
+    {
+        return emplaceValue(std::move(value));
+    }
+
+    /// \brief Inserts a value constructed with the given args if there is no
+    /// value with the same key
+    template <typename... Args>
+    InsertResult emplace(Args&&... args)
+    {
+        if constexpr (StablePointer)
+        {
+            ValueType* value = pool_->acq(std::forward<Args>(args)...);
+            size_t hash_value = mix(value->hashKey());
+            size_t ix = findIndex(value->key(), hash_value);
+            if (ix != NOT_FOUND)
+            {
+                pool_->del(value);
+                return {valuePtr(ix), false};
+            }
+            ix = prepareInsert(hash_value);
+            slots_[ix] = value;
+            return {value, true};
+        }
+        else
+        {
+            return emplaceValue(ValueType(std::forward<Args>(args)...));
+        }
+    }
+
+    /// \brief Inserts a value constructed with the key and the given args if the
+    /// key is not in the table. Unlike emplace, the table is probed by the key
+    /// before anything is constructed, and nothing is constructed if it is found
+    /// \return the iterator to the value and true if the value is newly inserted
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const KeyType& key, Args&&... args)
+    {
+        size_t hash_value = mix(ValueType::hash(key));
+        size_t ix = findIndex(key, hash_value);
+        if (ix != NOT_FOUND)
+        {
+            return std::make_pair(iterator(this, ix), false);
+        }
+        ix = prepareInsert(hash_value);
+        if constexpr (StablePointer)
+        {
+            slots_[ix] = pool_->acq(key, std::forward<Args>(args)...);
+        }
+        else
+        {
+            new (&slots_[ix]) ValueType(key, std::forward<Args>(args)...);
+        }
+        return std::make_pair(iterator(this, ix), true);
+    }
+
+    /// \brief Removes the value by its key
+    /// \return true if the value is removed, false if the value is not found
+    bool erase(const KeyType& key)
+    {
+        size_t ix = findIndex(key, mix(ValueType::hash(key)));
+        if (ix == NOT_FOUND)
+        {
+            return false;
+        }
+        eraseIndex(ix);
+        return true;
+    }
+
+    /// \brief Removes the value at the iterator
+    /// \return the iterator to the next value
+    iterator erase(const_iterator pos)
+    {
+        eraseIndex(pos.ix_);
+        return iterator(this, pos.ix_ + 1);
+    }
+
+    /// \brief Removes the values in [first, last)
+    /// \return the iterator to last
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        while (first != last)
+        {
+            size_t ix = first.ix_;
+            ++first;
+            eraseIndex(ix);
+        }
+        return iterator(this, last.ix_);
+    }
+
+    /// \brief Removes all values. The capacity is unchanged
+    void clear()
+    {
+        destroyAll();
+        ::memset(ctrl_, FlatHashGroup::EMPTY, capacity_);
+        size_ = 0;
+        growth_left_ = maxLoad(capacity_);
+    }
+
+    /// \brief Grows the table to hold num values without growing again
+    void reserve(size_t num)
+    {
+        if (num > maxLoad(capacity_))
+        {
+            rehash(size_t(1) << log2Ceil(num + num/7 + 1));
+        }
+    }
+
+  private:
+
+    constexpr static size_t NOT_FOUND = size_t(-1);
+
+    static size_t maxLoad(size_t capacity) { return capacity - capacity/8; }
+
+    void eraseIndex(size_t ix)
+    {
+        destroy(ix);
+        // A probe continues past a group only when the group is full. If the group
+        // still has an empty slot, no probe has passed it and the slot can be empty
+        size_t group_ix = ix & ~(FlatHashGroup::WIDTH-1);
+        if (FlatHashGroup(ctrl_ + group_ix).matchEmpty())
+        {
+            ctrl_[ix] = FlatHashGroup::EMPTY;
+            ++growth_left_;
+        }
+        else
+        {
+            ctrl_[ix] = FlatHashGroup::DELETED;
+        }
+        --size_;
+    }
+
+    /// \brief spreads the entropy of a weak hash value such as identity into
+    /// both the group index and the 7 hash bits kept in the control byte
+    static size_t mix(size_t hash_value)
+    {
+        hash_value *= 0x9E3779B97F4A7C15ULL;
+        return hash_value ^ (hash_value >> 32);
+    }
+
+    static int8_t h2(size_t hash_value) { return int8_t(hash_value & 0x7F); }
+    size_t firstGroup(size_t hash_value) const { return (hash_value >> 7) & group_mask_; }
+
+    ValueType* valuePtr(size_t ix) const
+    {
+        if constexpr (StablePointer)
+        {
+            return slots_[ix];
+        }
+        else
+        {
+            return reinterpret_cast<ValueType*>(&slots_[ix]);
+        }
+    }
+
+    /// \brief probes groups by triangular numbers, which visits every group when
+    /// the number of groups is a power of 2
+    size_t findIndex(const KeyType& key, size_t hash_value) const
+    {
+        size_t group = firstGroup(hash_value);
+        int8_t hash_bits = h2(hash_value);
+        for (size_t step=1; ; ++step)
+        {
+            const int8_t* ctrl = ctrl_ + group*FlatHashGroup::WIDTH;
+            FlatHashGroup g(ctrl);
+            for (uint32_t mask = g.match(hash_bits); mask; mask &= mask-1)
+            {
+                size_t ix = group*FlatHashGroup::WIDTH + ctz(mask);
+                if (ALT_LIKELY(valuePtr(ix)->key() == key))
+                {
+                    return ix;
+                }
+            }
+            if (ALT_LIKELY(g.matchEmpty()))
+            {
+                return NOT_FOUND;
+            }
+            group = (group + step) & group_mask_;
+        }
+    }
+
+    /// \brief finds an empty or deleted slot for a new value of the hash value,
+    /// growing the table if needed
+    size_t prepareInsert(size_t hash_value)
+    {
+        size_t ix = findFree(hash_value);
+        if (growth_left_ == 0 && ctrl_[ix] == FlatHashGroup::EMPTY)
+        {
+            // double the table unless it is mostly filled by deleted slots
+            rehash(size_ * 2 >= maxLoad(capacity_) ? capacity_ * 2 : capacity_);
+            ix = findFree(hash_value);
+        }
+        if (ctrl_[ix] == FlatHashGroup::EMPTY)
+        {
+            --growth_left_;
+        }
+        ctrl_[ix] = h2(hash_value);
+        ++size_;
+        return ix;
+    }
+
+    size_t findFree(size_t hash_value) const
+    {
+        size_t group = firstGroup(hash_value);
+        for (size_t step=1; ; ++step)
+        {
+            uint32_t mask = FlatHashGroup(ctrl_ + group*FlatHashGroup::WIDTH).matchEmptyOrDeleted();
+            if (mask)
+            {
+                return group*FlatHashGroup::WIDTH + ctz(mask);
+            }
+            group = (group + step) & group_mask_;
+        }
+    }
+
+    template <typename V>
+    InsertResult emplaceValue(V&& value)
+    {
+        size_t hash_value = mix(value.hashKey());
+        size_t ix = findIndex(value.key(), hash_value);
+        if (ix != NOT_FOUND)
+        {
+            return {valuePtr(ix), false};
+        }
+        ix = prepareInsert(hash_value);
+        if constexpr (StablePointer)
+        {
+            slots_[ix] = pool_->acq(std::forward<V>(value));
+        }
+        else
+        {
+            new (&slots_[ix]) ValueType(std::forward<V>(value));
+        }
+        return {valuePtr(ix), true};
+    }
+
+    void allocate(size_t capacity)
+    {
+        // control bytes and slots are in one block, control bytes first
+        size_t slots_offset = constAlign(capacity, alignof(SlotType));
+        size_t block_size = constAlign(slots_offset + capacity*sizeof(SlotType), 64);
+        ctrl_ = reinterpret_cast<int8_t*>(::aligned_alloc(64, block_size));
+        if (!ctrl_)
+        {
+            throw std::bad_alloc();
+        }
+        ::memset(ctrl_, FlatHashGroup::EMPTY, capacity);
+        slots_ = reinterpret_cast<SlotType*>(ctrl_ + slots_offset);
+        capacity_ = capacity;
+        group_mask_ = capacity/FlatHashGroup::WIDTH - 1;
+        growth_left_ = maxLoad(capacity);
+    }
+
+    void rehash(size_t new_capacity)
+    {
+        int8_t* old_ctrl = ctrl_;
+        SlotType* old_slots = slots_;
+        size_t old_capacity = capacity_;
+        allocate(new_capacity);
+        size_ = 0;
+        for (size_t ix=0; ix < old_capacity; ++ix)
+        {
+            if (old_ctrl[ix] < 0) continue;
+            ValueType* value = StablePointer ? *reinterpret_cast<ValueType**>(&old_slots[ix])
+                                             : reinterpret_cast<ValueType*>(&old_slots[ix]);
+            size_t new_ix = prepareInsert(mix(value->hashKey()));
+            if constexpr (StablePointer)
+            {
+                slots_[new_ix] = value;
+            }
+            else
+            {
+                new (&slots_[new_ix]) ValueType(std::move(*value));
+                value->~ValueType();
+            }
+        }
+        ::free(old_ctrl);
+    }
+
+    void destroy(size_t ix)
+    {
+        if constexpr (StablePointer)
+        {
+            pool_->del(slots_[ix]);
+        }
+        else
+        {
+            valuePtr(ix)->~ValueType();
+        }
+    }
+
+    void destroyAll()
+    {
+        if (StablePointer || !std::is_trivially_destructible<ValueType>::value)
+        {
+            for (size_t ix=0; ix < capacity_; ++ix)
+            {
+                if (ctrl_[ix] >= 0) destroy(ix);
+            }
+        }
+    }
+
+    int8_t*                             ctrl_ {nullptr};
+    SlotType*                           slots_ {nullptr};
+    size_t                              capacity_ {0};
+    size_t                              group_mask_ {0};
+    size_t                              size_ {0};
+    // number of empty slots can be filled before growing
+    size_t                              growth_left_ {0};
+    allocator_type *                    pool_ {nullptr};
+    bool                                owns_pool_ {false};
+};
+
+/**
+ * \brief FlatHash having values allocated in a fixed pool with stable addresses
+ */
+template <typename ValueType, size_t BucketSize=1024>
+using NodeFlatHash = FlatHash<ValueType, true, BucketSize>;
+
+}
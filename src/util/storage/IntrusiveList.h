@@ -0,0 +1,287 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file IntrusiveList.h
+ * @library alt_util
+ * @brief Implements an intrusive doubly linked list. Unlike LinkedList, the list
+ * never allocates: user objects embed an IntrusiveListHook member, and the list
+ * links the hooks. This differs to LinkedList in the following:
+ *    - an object may embed several hooks to be in several lists at once
+ *    - the hook member is selected at compile time, so no virtual call or cast
+ *      through a base class is needed to get the object from a hook
+ *    - the list is circular around a sentinel hook, so a node is unlinked in
+ *      O(1) without knowing which list it is in
+ * Classes defined in this file include:
+ *    - IntrusiveListHook: the doubly linked hook embedded in user objects
+ *    - IntrusiveHookTraits: converts between an object and its member hook
+ *    - IntrusiveList: a list of objects linked by a member hook
+ */
+
+#include <util/system/Platform.h>
+#include <iterator>                     // for bidirectional_iterator_tag
+#include <cstddef>                      // for size_t
+
+namespace alt
+{
+
+/**
+ * \struct IntrusiveListHook
+ * \ingroup ContainerUtils
+ * \brief A doubly linked hook to be embedded in an object. A hook is not copied
+ * when the object is copied, and is unlinked when the object is destroyed.
+ */
+struct IntrusiveListHook
+{
+    IntrusiveListHook*  next_ {nullptr};
+    IntrusiveListHook*  prev_ {nullptr};
+
+    IntrusiveListHook() = default;
+    IntrusiveListHook(const IntrusiveListHook&) {}
+    IntrusiveListHook& operator=(const IntrusiveListHook&) { return *this; }
+    ~IntrusiveListHook() { unlink(); }
+
+    /// \return true if the hook is in a list
+    bool isLinked() const { return next_ != nullptr; }
+
+    /// \brief removes the hook from the list it is in, if any
+    void unlink()
+    {
+        if (next_)
+        {
+            next_->prev_ = prev_;
+            prev_->next_ = next_;
+            next_ = prev_ = nullptr;
+        }
+    }
+
+    /// \brief links this unlinked hook before position
+    void linkBefore(IntrusiveListHook* position)
+    {
+        next_ = position;
+        prev_ = position->prev_;
+        prev_->next_ = this;
+        position->prev_ = this;
+    }
+
+    /// \brief links this unlinked hook after position
+    void linkAfter(IntrusiveListHook* position)
+    {
+        linkBefore(position->next_);
+    }
+
+    /// \brief makes this hook a sentinel of an empty circular list
+    void makeSentinel() { next_ = prev_ = this; }
+};
+
+/**
+ * \struct IntrusiveHookTraits
+ * \ingroup ContainerUtils
+ * \brief Converts between an object of type T and its hook member Member
+ */
+template <typename T, typename Hook, Hook T::*Member>
+struct IntrusiveHookTraits
+{
+    static Hook* toHook(T* value) { return &(value->*Member); }
+    static const Hook* toHook(const T* value) { return &(value->*Member); }
+
+    static T* toValue(Hook* hook)
+    {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(hook) - offset());
+    }
+    static const T* toValue(const Hook* hook)
+    {
+        return reinterpret_cast<const T*>(reinterpret_cast<const char*>(hook) - offset());
+    }
+
+  private:
+    static size_t offset()
+    {
+        // the member offset computed on a dummy address; T is never accessed
+        alignas(T) static char dummy[sizeof(T)];
+        T* value = reinterpret_cast<T*>(dummy);
+        return reinterpret_cast<char*>(&(value->*Member)) - dummy;
+    }
+};
+
+/**
+ * \class IntrusiveList
+ * \ingroup ContainerUtils
+ * \brief A doubly linked list of objects linked by their hook member.
+ * \tparam T the object type
+ * \tparam Member the IntrusiveListHook member of T used by this list
+ * \note The list does not own the objects. Destroying an object unlinks it from
+ * the list, and destroying or clearing the list unlinks all objects.
+ */
+template <typename T, IntrusiveListHook T::*Member>
+class IntrusiveList
+{
+    using Traits = IntrusiveHookTraits<T, IntrusiveListHook, Member>;
+
+  public:
+    template <typename ValueT, typename HookT>
+    class IteratorT
+    {
+        HookT*  hook_ {nullptr};
+        friend class IntrusiveList;
+
+      public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = ValueT*;
+        using reference         = ValueT&;
+
+        IteratorT() = default;
+        explicit IteratorT(HookT* hook) : hook_(hook) {}
+        operator IteratorT<const T, const IntrusiveListHook>() const
+        {
+            return IteratorT<const T, const IntrusiveListHook>(hook_);
+        }
+        bool operator==(const IteratorT& itr) const { return hook_ == itr.hook_; }
+        bool operator!=(const IteratorT& itr) const { return hook_ != itr.hook_; }
+        ValueT& operator*() const { return *Traits::toValue(hook_); }
+        ValueT* operator->() const { return Traits::toValue(hook_); }
+        IteratorT& operator++() { hook_ = hook_->next_; return *this; }
+        IteratorT& operator--() { hook_ = hook_->prev_; return *this; }
+        IteratorT operator++(int) { IteratorT temp = *this; hook_ = hook_->next_; return temp; }
+        IteratorT operator--(int) { IteratorT temp = *this; hook_ = hook_->prev_; return temp; }
+    };
+
+    using iterator = IteratorT<T, IntrusiveListHook>;
+    using const_iterator = IteratorT<const T, const IntrusiveListHook>;
+
+    IntrusiveList() { head_.makeSentinel(); }
+
+    /// \brief Move constructor, other will become empty
+    IntrusiveList(IntrusiveList&& other)
+    {
+        head_.makeSentinel();
+        swap(other);
+    }
+
+    /// \brief Copy constructor, disabled
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    ~IntrusiveList() { clear(); }
+
+    iterator begin() { return iterator(head_.next_); }
+    iterator end() { return iterator(&head_); }
+    const_iterator begin() const { return const_iterator(head_.next_); }
+    const_iterator end() const { return const_iterator(&head_); }
+
+    /// \return the iterator of an object in this list
+    static iterator iteratorTo(T& value) { return iterator(Traits::toHook(&value)); }
+
+    /// \return true if the list is empty
+    bool empty() const { return head_.next_ == &head_; }
+
+    /// \return the number of objects in the list, counted in O(n)
+    size_t size() const
+    {
+        size_t num = 0;
+        for (const IntrusiveListHook* hook = head_.next_; hook != &head_; hook = hook->next_)
+        {
+            ++num;
+        }
+        return num;
+    }
+
+    /// \return The first object of the list. The list must not be empty
+    T& front() { return *Traits::toValue(head_.next_); }
+    const T& front() const { return *Traits::toValue(head_.next_); }
+
+    /// \return The last object of the list. The list must not be empty
+    T& back() { return *Traits::toValue(head_.prev_); }
+    const T& back() const { return *Traits::toValue(head_.prev_); }
+
+    /// \brief append an object at the end of the list
+    /// \note The object must not be in a list by this hook.
+    void pushBack(T& value) { Traits::toHook(&value)->linkBefore(&head_); }
+
+    /// \brief put an object at the front of the list
+    /// \note The object must not be in a list by this hook.
+    void pushFront(T& value) { Traits::toHook(&value)->linkAfter(&head_); }
+
+    /// \brief insert an object before the position
+    /// \note The object must not be in a list by this hook.
+    void insert(iterator position, T& value) { Traits::toHook(&value)->linkBefore(position.hook_); }
+
+    /// \brief append an object after the position
+    /// \note The object must not be in a list by this hook.
+    void append(iterator position, T& value) { Traits::toHook(&value)->linkAfter(position.hook_); }
+
+    /// \brief extract an object from the list it is in. The list is not needed
+    /// to unlink an object, so this is static
+    static void extract(T& value) { Traits::toHook(&value)->unlink(); }
+
+    /// \brief extract the first object
+    /// \return the object, or nullptr if the list is empty
+    T* extractFront()
+    {
+        if (empty()) return nullptr;
+        T* value = Traits::toValue(head_.next_);
+        head_.next_->unlink();
+        return value;
+    }
+
+    /// \brief extract the last object
+    /// \return the object, or nullptr if the list is empty
+    T* extractBack()
+    {
+        if (empty()) return nullptr;
+        T* value = Traits::toValue(head_.prev_);
+        head_.prev_->unlink();
+        return value;
+    }
+
+    /// \return true if the object is linked by the hook of this list type, in
+    /// this or another list
+    static bool isLinked(const T& value) { return Traits::toHook(&value)->isLinked(); }
+
+    /// \brief transfer all objects in the other list to this list before the position
+    void splice(iterator position, IntrusiveList& other)
+    {
+        if (other.empty()) return;
+        IntrusiveListHook* first = other.head_.next_;
+        IntrusiveListHook* last = other.head_.prev_;
+        other.head_.makeSentinel();
+        IntrusiveListHook* pos = position.hook_;
+        first->prev_ = pos->prev_;
+        pos->prev_->next_ = first;
+        last->next_ = pos;
+        pos->prev_ = last;
+    }
+
+    /// \brief swap contents with other
+    void swap(IntrusiveList& other)
+    {
+        IntrusiveList temp_list;
+        temp_list.splice(temp_list.end(), other);
+        other.splice(other.end(), *this);
+        splice(end(), temp_list);
+    }
+
+    /// \brief unlink all objects
+    void clear()
+    {
+        IntrusiveListHook* hook = head_.next_;
+        while (hook != &head_)
+        {
+            IntrusiveListHook* next = hook->next_;
+            hook->next_ = hook->prev_ = nullptr;
+            hook = next;
+        }
+        head_.makeSentinel();
+    }
+
+  private:
+    IntrusiveListHook   head_;
+};
+
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file IntrusiveTree.h
+ * @library alt_util
+ * @brief Defines intrusive tree nodes to form a hierarchical tree structure. Unlike
+ * TreeNode, user objects embed an IntrusiveTreeHook member and nothing is
+ * allocated or virtual:
+ *    - IntrusiveTreeHook: the tree links embedded in user objects. Children of a
+ *      node are in a circular IntrusiveListHook list, so a node is detached from
+ *      its parent in O(1)
+ *    - IntrusiveTree: tree operations on objects linked by a member hook
+ */
+
+#include "IntrusiveList.h"              // for IntrusiveListHook, IntrusiveHookTraits
+#include <cstddef>                      // for offsetof
+#include <type_traits>                  // for is_standard_layout
+
+namespace alt
+{
+
+/**
+ * \struct IntrusiveTreeHook
+ * \ingroup ContainerUtils
+ * \brief Tree links to be embedded in an object. A hook is not copied when the
+ * object is copied. When the object is destroyed, it is detached from its parent
+ * and its children become roots.
+ */
+struct IntrusiveTreeHook
+{
+    IntrusiveTreeHook*  parent_ {nullptr};
+    IntrusiveListHook   sibling_;       ///< link in the children of the parent
+    IntrusiveListHook   children_;      ///< sentinel of the children
+
+    IntrusiveTreeHook() { children_.makeSentinel(); }
+    IntrusiveTreeHook(const IntrusiveTreeHook&) : IntrusiveTreeHook() {}
+    IntrusiveTreeHook& operator=(const IntrusiveTreeHook&) { return *this; }
+    ~IntrusiveTreeHook()
+    {
+        detach();
+        while (IntrusiveTreeHook* child = firstChild())
+        {
+            child->detach();
+        }
+        children_.next_ = children_.prev_ = nullptr;
+    }
+
+    static IntrusiveTreeHook* fromSibling(IntrusiveListHook* sibling)
+    {
+        return reinterpret_cast<IntrusiveTreeHook*>(
+            reinterpret_cast<char*>(sibling) - offsetof(IntrusiveTreeHook, sibling_));
+    }
+
+    IntrusiveTreeHook* firstChild() const
+    {
+        return children_.next_ != &children_ ? fromSibling(children_.next_) : nullptr;
+    }
+
+    IntrusiveTreeHook* lastChild() const
+    {
+        return children_.prev_ != &children_ ? fromSibling(children_.prev_) : nullptr;
+    }
+
+    IntrusiveTreeHook* nextSibling() const
+    {
+        return parent_ && sibling_.next_ != &parent_->children_ ? fromSibling(sibling_.next_) : nullptr;
+    }
+
+    IntrusiveTreeHook* prevSibling() const
+    {
+        return parent_ && sibling_.prev_ != &parent_->children_ ? fromSibling(sibling_.prev_) : nullptr;
+    }
+
+    /// \brief detaches this from its parent
+    void detach()
+    {
+        sibling_.unlink();
+        parent_ = nullptr;
+    }
+
+    /// \brief links a detached child before position, which is the children
+    /// sentinel or the sibling hook of a child
+    void linkChild(IntrusiveListHook* position, IntrusiveTreeHook* child)
+    {
+        child->parent_ = this;
+        child->sibling_.linkBefore(position);
+    }
+};
+
+static_assert(std::is_standard_layout<IntrusiveTreeHook>::value);
+
+/**
+ * \class IntrusiveTree
+ * \ingroup ContainerUtils
+ * \brief Tree operations on objects of type T linked by their hook member. All
+ * operations are static as the tree is formed by the hooks.
+ * \tparam T the object type
+ * \tparam Member the IntrusiveTreeHook member of T used by this tree
+ * \note Moving a node moves its subtree. A node must not be moved under its
+ * own offspring.
+ */
+template <typename T, IntrusiveTreeHook T::*Member>
+class IntrusiveTree
+{
+    using Traits = IntrusiveHookTraits<T, IntrusiveTreeHook, Member>;
+
+    static T* value(IntrusiveTreeHook* hook) { return hook ? Traits::toValue(hook) : nullptr; }
+    static IntrusiveTreeHook* hook(const T* node) { return const_cast<IntrusiveTreeHook*>(Traits::toHook(node)); }
+
+  public:
+    static T* parent(const T* node) { return value(hook(node)->parent_); }
+    static T* firstChild(const T* node) { return value(hook(node)->firstChild()); }
+    static T* lastChild(const T* node) { return value(hook(node)->lastChild()); }
+    static T* nextSibling(const T* node) { return value(hook(node)->nextSibling()); }
+    static T* prevSibling(const T* node) { return value(hook(node)->prevSibling()); }
+
+    /// \return the root of the tree containing the node
+    static T* root(T* node)
+    {
+        IntrusiveTreeHook* cur = hook(node);
+        while (cur->parent_)
+        {
+            cur = cur->parent_;
+        }
+        return value(cur);
+    }
+
+    static bool isLeaf(const T* node) { return !hook(node)->firstChild(); }
+    static bool isRoot(const T* node) { return !hook(node)->parent_; }
+
+    /// \return the number of children, counted in O(n)
+    static size_t childrenNum(const T* node)
+    {
+        size_t num = 0;
+        for (IntrusiveTreeHook* child = hook(node)->firstChild(); child; child = child->nextSibling())
+        {
+            ++num;
+        }
+        return num;
+    }
+
+    /// \return true if the node n is an offspring of the node
+    static bool isAncestorOf(const T* node, const T* n)
+    {
+        const IntrusiveTreeHook* ancestor = hook(node);
+        for (const IntrusiveTreeHook* cur = hook(n)->parent_; cur; cur = cur->parent_)
+        {
+            if (cur == ancestor) return true;
+        }
+        return false;
+    }
+
+    /// \brief appends a child as the last child of the parent. The child is
+    /// detached from its old parent first
+    static void appendChild(T* parent, T* child)
+    {
+        hook(child)->detach();
+        hook(parent)->linkChild(&hook(parent)->children_, hook(child));
+    }
+
+    /// \brief appends a child after the sibling, which must be a child of the parent
+    static void appendChild(T* parent, T* sibling, T* child)
+    {
+        hook(child)->detach();
+        hook(parent)->linkChild(hook(sibling)->sibling_.next_, hook(child));
+    }
+
+    /// \brief inserts a child as the first child of the parent
+    static void insertChild(T* parent, T* child)
+    {
+        hook(child)->detach();
+        hook(parent)->linkChild(hook(parent)->children_.next_, hook(child));
+    }
+
+    /// \brief inserts a child before the sibling, which must be a child of the parent
+    static void insertChild(T* parent, T* sibling, T* child)
+    {
+        hook(child)->detach();
+        hook(parent)->linkChild(&hook(sibling)->sibling_, hook(child));
+    }
+
+    /// \brief detaches the node with its subtree from its parent
+    static void detach(T* node) { hook(node)->detach(); }
+
+    /// \brief traverses the subtree at the node up down and front back
+    /// \param func a callable taking T* and returning int. The traversal stops
+    /// if it returns a negative value
+    /// \return -1 if the traversal is stopped, otherwise 0
+    template <typename Func>
+    static int upDown(T* node, Func&& func)
+    {
+        if (func(node) < 0)
+        {
+            return -1;
+        }
+        for (IntrusiveTreeHook* child = hook(node)->firstChild(); child; child = child->nextSibling())
+        {
+            if (upDown(value(child), func) < 0)
+            {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    /// \brief traverses the subtree at the node bottom up and front back
+    /// \param func a callable taking T* and returning int. The traversal stops
+    /// if it returns a negative value
+    /// \return -1 if the traversal is stopped, otherwise 0
+    template <typename Func>
+    static int bottomUp(T* node, Func&& func)
+    {
+        for (IntrusiveTreeHook* child = hook(node)->firstChild(); child; )
+        {
+            // func may detach the child
+            IntrusiveTreeHook* next = child->nextSibling();
+            if (bottomUp(value(child), func) < 0)
+            {
+                return -1;
+            }
+            child = next;
+        }
+        return func(node) < 0 ? -1 : 0;
+    }
+};
+
+}
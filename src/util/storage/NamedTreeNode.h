@@ -40,14 +40,7 @@ class ALT_UTIL_PUBLIC NamedTreeNode: public TreeNode<Alloc>
   public:
     typedef TreeNode<Alloc> base_t;
     typedef NamedTreeNode*  pointer_t;
-    using NamedTreeNodeHash =
-        typename std::conditional<
-            std::is_same<Alloc, PooledAllocator>::value,
-            StringHashMap<pointer_t,
-                          StdFixedPoolAllocator<std::pair<const StrRef, pointer_t>>>,
-            StringHashMap<pointer_t,
-                          std::allocator<std::pair<const StrRef, pointer_t>>>
-        >::type;
+    using NamedTreeNodeHash = StringHashMap<pointer_t>;
 
     static constexpr size_t MAX_NAME_LENGTH = 128;
     static constexpr size_t ID_LENGTH       = 6;
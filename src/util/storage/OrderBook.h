@@ -0,0 +1,419 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file OrderBook.h
+ * @library alt_util
+ * @brief Defines an order-by-order (L3) book. Price levels of each side are kept
+ * in SideBuckets, so levels near the top are found by index in O(1). Each level
+ * keeps its orders in a FIFO of intrusive linked nodes. Orders are allocated in
+ * the fixed pool of a FlatHash that also finds orders by id.
+ */
+
+#include "SideBuckets.h"                // for SideBuckets
+#include "LinkedList.h"                 // for LinkedNode
+#include "FlatHash.h"                   // for FlatHash
+#include <vector>                       // for vector
+#include <string>                       // for string
+#include <type_traits>                  // for is_trivially_copyable
+
+namespace alt {
+
+/**
+ * \struct BookOrder
+ * \ingroup ContainerUtils
+ * \brief An order in OrderBook, linked with other orders at the same price in
+ * time priority
+ */
+template <typename Price, typename Qty>
+struct BookOrder : public LinkedNode
+{
+    uint64_t        id_;
+    Price           price_;
+    Qty             qty_;
+    bool            is_bid_;
+
+    BookOrder(uint64_t id, bool is_bid, Price price, Qty qty)
+        : id_(id), price_(price), qty_(qty), is_bid_(is_bid)
+    {}
+
+    /// \brief returns the next order at the same price, nullptr if this is the last
+    const BookOrder* nextOrder() const { return static_cast<const BookOrder*>(next_); }
+
+    MAKE_POOLED_HASH_ENTRY(uint64_t, id_, size_t);
+};
+
+/**
+ * \struct BookLevel
+ * \ingroup ContainerUtils
+ * \brief A price level in OrderBook, which is the bucket value in SideBuckets.
+ * A level is trivially copyable as SideBuckets moves levels by memory copy. Orders
+ * do not point to their level, so the move does not break the FIFO.
+ */
+template <typename Price, typename Qty>
+struct BookLevel
+{
+    using Order = BookOrder<Price, Qty>;
+
+    Qty             qty_ {0};
+    int64_t         order_cnt_ {0};
+    LinkedNode*     head_ {nullptr};
+    LinkedNode*     tail_ {nullptr};
+
+    BookLevel() = default;
+    BookLevel(Qty qty, int64_t order_cnt) : qty_(qty), order_cnt_(order_cnt) {}
+
+    /// \brief returns the first order in time priority
+    const Order* front() const { return static_cast<const Order*>(head_); }
+
+    // -------------------------------------------------------------------------
+    // bucket value interface required by SideBuckets
+    // -------------------------------------------------------------------------
+    /// \brief adds an order count and quantity change. SideBuckets also adds a
+    /// whole level into an empty bucket when it moves levels between its front
+    /// and back buckets, in which case the orders are taken over
+    void add(const BookLevel& delta)
+    {
+        qty_ += delta.qty_;
+        order_cnt_ += delta.order_cnt_;
+        if (delta.head_)
+        {
+            if (tail_)
+            {
+                tail_->next_ = delta.head_;
+                delta.head_->prev_ = tail_;
+            }
+            else
+            {
+                head_ = delta.head_;
+            }
+            tail_ = delta.tail_;
+        }
+    }
+    void update(const BookLevel& upd)
+    {
+        qty_ = upd.qty_;
+        order_cnt_ = upd.order_cnt_;
+    }
+    bool reset()
+    {
+        *this = BookLevel();
+        return true;
+    }
+    bool empty() const { return order_cnt_ <= 0; }
+    bool isPositive() const { return order_cnt_ > 0; }
+    std::string toStr() const
+    {
+        return '(' + std::to_string(qty_) + ',' + std::to_string(order_cnt_) + ')';
+    }
+
+    void append(Order* order)
+    {
+        order->prev_ = tail_;
+        order->next_ = nullptr;
+        if (tail_)
+        {
+            tail_->next_ = order;
+        }
+        else
+        {
+            head_ = order;
+        }
+        tail_ = order;
+    }
+
+    void remove(Order* order)
+    {
+        if (head_ == order) head_ = order->next_;
+        if (tail_ == order) tail_ = order->prev_;
+        order->extract();
+    }
+};
+
+/**
+ * \struct BookLevelInfo
+ * \ingroup ContainerUtils
+ * \brief The aggregated state of a price level, used in snapshots and deltas.
+ * In a delta, order_cnt_ of 0 means the level is removed.
+ */
+template <typename Price, typename Qty>
+struct BookLevelInfo
+{
+    Price           price_;
+    Qty             qty_;
+    int64_t         order_cnt_;
+    bool            is_bid_;
+};
+
+/**
+ * \class OrderBook
+ * \ingroup ContainerUtils
+ * \brief An order-by-order book of the two sides of an instrument.
+ * \tparam Price the price type in number of ticks, must be integral
+ * \tparam Qty the quantity type
+ * \note Adding, cancelling and modifying an order at a level within the front
+ * bucket range from the top are O(1). Levels beyond the range are kept in sorted
+ * buckets with O(logN) search.
+ */
+template <typename Price = int64_t, typename Qty = int64_t>
+class OrderBook
+{
+  public:
+    using Order = BookOrder<Price, Qty>;
+    using Level = BookLevel<Price, Qty>;
+    using LevelInfo = BookLevelInfo<Price, Qty>;
+    using BidSide = SideBuckets<Price, Level, SortedBucketCompareDec<Price>>;
+    using AskSide = SideBuckets<Price, Level, SortedBucketCompareInc<Price>>;
+
+    static_assert(std::is_integral<Price>::value, "OrderBook price must be in ticks");
+    static_assert(std::is_trivially_copyable<Level>::value);
+
+    /// \brief constructor
+    /// \param front_levels number of price levels from the top indexed in O(1)
+    /// \param back_levels the initial capacity of levels beyond the front levels
+    /// \param order_capacity the initial capacity of the order id table
+    /// \param record_deltas if true, level changes are recorded, see takeDeltas
+    explicit OrderBook(size_t front_levels = 256,
+                       size_t back_levels = 256,
+                       size_t order_capacity = 1024,
+                       bool record_deltas = false)
+        : bids_(front_levels, back_levels)
+        , asks_(front_levels, back_levels)
+        , orders_(order_capacity)
+        , record_deltas_(record_deltas)
+    {}
+
+    NONCOPYABLE(OrderBook);
+
+    /// \brief adds an order at the end of the FIFO of its price level
+    /// \return the order, or nullptr if an order with the id already exists or
+    /// qty is not positive
+    const Order* add(uint64_t id, bool is_bid, Price price, Qty qty)
+    {
+        if (qty <= 0)
+        {
+            return nullptr;
+        }
+        auto [order, is_new] = orders_.emplace(id, is_bid, price, qty);
+        if (!is_new)
+        {
+            return nullptr;
+        }
+        Level* level = is_bid ? bids_.add(price, Level(qty, 1)) : asks_.add(price, Level(qty, 1));
+        level->append(order);
+        recordDelta(*order, level);
+        return order;
+    }
+
+    /// \brief removes an order
+    /// \return false if the order is not found
+    bool cancel(uint64_t id)
+    {
+        Order* order = orders_.findValue(id);
+        if (!order)
+        {
+            return false;
+        }
+        remove(order);
+        return true;
+    }
+
+    /// \brief changes the quantity of an order. The order keeps its time priority
+    /// if the quantity decreases and moves to the end of the FIFO if it increases.
+    /// The order is removed if qty is not positive
+    /// \return false if the order is not found
+    bool modify(uint64_t id, Qty qty)
+    {
+        Order* order = orders_.findValue(id);
+        if (!order)
+        {
+            return false;
+        }
+        if (qty <= 0)
+        {
+            remove(order);
+            return true;
+        }
+        Level* level = findLevel(order->is_bid_, order->price_);
+        level->qty_ += qty - order->qty_;
+        if (qty > order->qty_ && level->tail_ != order)
+        {
+            level->remove(order);
+            level->append(order);
+        }
+        order->qty_ = qty;
+        recordDelta(*order, level);
+        return true;
+    }
+
+    /// \brief changes the price and the quantity of an order, which loses its
+    /// time priority
+    /// \return the order, or nullptr if the order is not found
+    const Order* replace(uint64_t id, Price price, Qty qty)
+    {
+        Order* order = orders_.findValue(id);
+        if (!order)
+        {
+            return nullptr;
+        }
+        bool is_bid = order->is_bid_;
+        remove(order);
+        return add(id, is_bid, price, qty);
+    }
+
+    /// \brief reduces the quantity of an order by an executed quantity without
+    /// changing its time priority. The order is removed if fully executed
+    /// \return false if the order is not found
+    bool execute(uint64_t id, Qty qty)
+    {
+        Order* order = orders_.findValue(id);
+        if (!order)
+        {
+            return false;
+        }
+        if (qty >= order->qty_)
+        {
+            remove(order);
+            return true;
+        }
+        Level* level = findLevel(order->is_bid_, order->price_);
+        level->qty_ -= qty;
+        order->qty_ -= qty;
+        recordDelta(*order, level);
+        return true;
+    }
+
+    /// \brief finds an order by its id
+    const Order* find(uint64_t id) const { return orders_.findValue(id); }
+
+    /// \brief finds a level by its price
+    /// \return the level or nullptr if there is no order at the price
+    const Level* level(bool is_bid, Price price) { return findLevel(is_bid, price); }
+
+    /// \brief calls func(Price, const Level&) on up to depth levels from the top
+    /// of a side in price priority
+    template <typename Func>
+    void forEachLevel(bool is_bid, Func&& func, size_t depth = size_t(-1))
+    {
+        if (is_bid)
+        {
+            forEachLevel(bids_, std::forward<Func>(func), depth);
+        }
+        else
+        {
+            forEachLevel(asks_, std::forward<Func>(func), depth);
+        }
+    }
+
+    /// \brief returns the top level of a side, nullptr if the side is empty
+    const Level* top(bool is_bid, Price& price)
+    {
+        const Level* top_level = nullptr;
+        forEachLevel(is_bid, [&](Price level_price, const Level& level)
+        {
+            price = level_price;
+            top_level = &level;
+        }, 1);
+        return top_level;
+    }
+
+    /// \brief appends up to depth levels of each side from the top to snapshot,
+    /// bids first
+    void snapshot(std::vector<LevelInfo>& snapshot, size_t depth = size_t(-1))
+    {
+        for (bool is_bid: {true, false})
+        {
+            forEachLevel(is_bid, [&](Price price, const Level& level)
+            {
+                snapshot.push_back(LevelInfo{price, level.qty_, level.order_cnt_, is_bid});
+            }, depth);
+        }
+    }
+
+    /// \brief returns the level changes recorded since the last call in the order
+    /// they happen, and starts a new recording. Each change has the state of the
+    /// level after the change
+    std::vector<LevelInfo>& takeDeltas()
+    {
+        taken_deltas_.swap(deltas_);
+        deltas_.clear();
+        return taken_deltas_;
+    }
+
+    /// \brief returns the number of orders in the book
+    size_t orderNumber() const { return orders_.size(); }
+
+    /// \brief removes all orders
+    void clear()
+    {
+        bids_.reset();
+        asks_.reset();
+        orders_.clear();
+        deltas_.clear();
+    }
+
+  private:
+    Level* findLevel(bool is_bid, Price price)
+    {
+        return is_bid ? bids_.find(price) : asks_.find(price);
+    }
+
+    void remove(Order* order)
+    {
+        Level* level = findLevel(order->is_bid_, order->price_);
+        level->remove(order);
+        bool is_last = level->order_cnt_ == 1;
+        // the level is removed from the side if this is the last order
+        Level delta(-order->qty_, -1);
+        if (order->is_bid_)
+        {
+            bids_.add(order->price_, delta);
+        }
+        else
+        {
+            asks_.add(order->price_, delta);
+        }
+        recordDelta(*order, is_last ? nullptr : level);
+        orders_.erase(order->id_);
+    }
+
+    void recordDelta(const Order& order, const Level* level)
+    {
+        if (record_deltas_)
+        {
+            bool removed = !level || level->empty();
+            deltas_.push_back(LevelInfo{order.price_,
+                                        removed ? Qty(0) : level->qty_,
+                                        removed ? 0 : level->order_cnt_,
+                                        order.is_bid_});
+        }
+    }
+
+    template <typename Side, typename Func>
+    static void forEachLevel(Side& side, Func&& func, size_t depth)
+    {
+        for (auto iter = side.begin(); depth > 0 && iter != side.end(); ++iter)
+        {
+            const Level* level = iter.value();
+            if (!level->empty())
+            {
+                func((*iter).first, *level);
+                --depth;
+            }
+        }
+    }
+
+    BidSide                         bids_;
+    AskSide                         asks_;
+    // orders by id, allocated in the fixed pool of the table
+    FlatHash<Order, true>           orders_;
+    bool                            record_deltas_;
+    std::vector<LevelInfo>          deltas_;
+    std::vector<LevelInfo>          taken_deltas_;
+};
+
+} // namespace alt
@@ -25,13 +25,16 @@
 
 #include "LinkedList.h"                 // for LinkedList
 #include "FixedMemPool.h"               // for FixedPool
-#include <util/numeric/Intrinsics.h>    // for power2Next
+#include <util/numeric/Intrinsics.h>    // for log2Ceil
 #include <util/types/TemplateHelper.h>  // for NONCOPYABLE
 #include <type_traits>                  // for is_trivially_destructible
+#include <algorithm>                    // for max
+#include <stdlib.h>                     // for calloc/free
+#include <new>                          // for bad_alloc
 
 #define MAKE_POOLED_HASH_ENTRY(KT, KF, KFUNC) \
     using KeyType = KT; \
-    size_t hashKey() const { return KF; } \
+    size_t hashKey() const { return KFUNC(KF); } \
     const KeyType& key() const { return KF; } \
     void resetKey(KeyType new_key) { KF=new_key; } \
     static size_t hash(const KeyType& key) { return KFUNC(key); }
@@ -55,6 +58,11 @@ namespace alt {
  * leave Uniqueness false so the map will not check uniqueness for each insert and
  * this will make the map more efficient
  * \tparam BucketSize the size of the bucket of the fixed memory pool.
+ * \note The number of buckets doubles when the load factor exceeds the maximum load
+ * factor. Rehashing is incremental: entries in the old buckets are migrated to the
+ * new buckets a few buckets at a time on each insert and erase, and lookups check
+ * the old buckets not migrated yet. Like std::unordered_map, iterators are invalidated
+ * by insert. Erase invalidates only iterators to the erased entry.
  */
 template <typename ValueType, bool Uniqueness=false, size_t BucketSize=1024>
 class PooledHash
@@ -80,6 +88,11 @@ class PooledHash
     using entry_type     = EntryType;
     using allocator_type = FixedPool<EntryType, BucketSize>;
 
+    /// minimum number of buckets
+    constexpr static size_t MIN_BUCKET_NUMBER = 16;
+    /// number of old buckets migrated in each insert or erase during rehashing
+    constexpr static size_t REHASH_STEP = 4;
+
     /**
      * \struct InsertResult
      * \brief The result returned by insert and replaceKkey
@@ -96,18 +109,23 @@ class PooledHash
     /// \param pool a fixed pool to hold all elements inserted into the map
     /// if not given, a pool will be created internally. Provide a pool if
     /// you want share a pool among multiple maps tof the same value type.
-    /// \param bucket_number the number of the buckets. The larger, the less
-    /// chance of collision.
-    PooledHash (allocator_type* pool=nullptr, size_t bucket_number=1024) : pool_(pool)
+    /// \param bucket_number the initial number of the buckets. The number grows
+    /// when the load factor exceeds max_load_factor.
+    /// \param max_load_factor the maximum average number of entries per bucket
+    PooledHash (allocator_type* pool=nullptr, size_t bucket_number=1024,
+                double max_load_factor=1.0)
+        : pool_(pool)
+        , max_load_factor_(max_load_factor)
     {
         if (!pool_)
         {
             pool_ = new allocator_type();
             owns_pool_ = true;
         }
-        bucket_number_ = power2Next<size_t>(bucket_number);
+        bucket_number_ = size_t(1) << log2Ceil(std::max(bucket_number, MIN_BUCKET_NUMBER));
         bucket_ix_mask_ = bucket_number_-1;
-        buckets_.resize(bucket_number);
+        buckets_ = allocateBuckets(bucket_number_);
+        grow_threshold_ = size_t(bucket_number_ * max_load_factor_);
     }
 
     /// \brief destructor
@@ -115,8 +133,10 @@ class PooledHash
     {
         if (!std::is_trivially_destructible<ValueType>::value || !owns_pool_)
         {
-            for (auto entry : *this) pool_->del(entry);
+            delAll();
         }
+        ::free(buckets_);
+        ::free(old_buckets_);
         if (owns_pool_)
         {
             delete pool_;
@@ -129,50 +149,56 @@ class PooledHash
     class IteratorT
     {
         PtrT *       ptr_;
-        PooledHash & table_;
-        IteratorT(PooledHash & table, PtrT * ptr) : ptr_(ptr), table_(table) {}
+        const PooledHash * table_;
+        IteratorT(const PooledHash & table, PtrT * ptr) : ptr_(ptr), table_(&table) {}
         friend class PooledHash;
       public:
         bool operator!=(const IteratorT& itr) const { return ptr_ != itr.ptr_; } 
+        bool operator==(const IteratorT& itr) const { return ptr_ == itr.ptr_; } 
         //ValueType* operator*() const { return &((*ptr_)->value_); }
         EntryType* operator*() const { return *ptr_; }
         void reset (PtrT ptr_t) { *ptr_ = ptr_t; }
         EntryType* getEntry() const { return *ptr_; }
         const ValueType& getValue() const { return getEntry()->value_; }
         ValueType& getValue() { return getEntry()->value_; }
-        IteratorT operator++()
-        {
-            if (!ptr_ || !*ptr_) return IteratorT(table_, ptr_);
-            if ((*ptr_)->next_) return IteratorT(table_, &(*ptr_)->next_);
-            ptr_ = table_.nextPos(*ptr_);
-            return IteratorT(table_, ptr_);
-        }
-        IteratorT operator++(int)
+        IteratorT& operator++()
         {
-            auto temp = ptr_;
             if (ptr_ && *ptr_)
             {
                 ptr_ = ((*ptr_)->next_) ? &(*ptr_)->next_ : table_->nextPos(*ptr_);
             }
-            return IteratorT(table_, temp);
+            return *this;
+        }
+        IteratorT operator++(int)
+        {
+            auto temp = ptr_;
+            ++(*this);
+            return IteratorT(*table_, temp);
         }
     };
  
     /// \brief Forward iterator
     using iterator = IteratorT<EntryType*>;
 
-    /// \brief Const forward iterator
-    using const_iterator = IteratorT<EntryType const*>;
-
     /// \brief Returns an iterator to the first element or the iterator equal to
     /// end() if the nap is empty.
-    iterator begin() { return iterator(*this, firstPos()); };
-    const_iterator begin() const { return const_iterator(*this, firstPos()); };
+    iterator begin() const { return iterator(*this, firstPos()); };
 
     /// \brief Returns an iterator represents the position beyond the last
     /// element of the map.
-    iterator end() { return iterator(*this, nullptr); };
-    const_iterator end() const { return const_iterator(*this, nullptr); };
+    iterator end() const { return iterator(*this, nullptr); };
+
+    /// \brief Returns the number of elements in the map
+    size_t size() const { return size_; }
+
+    /// \brief Returns true if the map has no element
+    bool empty() const { return size_ == 0; }
+
+    /// \brief Returns the current number of buckets
+    size_t bucketNumber() const { return bucket_number_; }
+
+    /// \brief Returns true if entries are being migrated to grown buckets
+    bool isRehashing() const { return old_buckets_ != nullptr; }
 
     /// \brief Inserts an entry constructed outside
     /// \return the InsertResult with a pointer to the memory where the value
@@ -180,7 +206,8 @@ class PooledHash
     /// inserted.
     InsertResult insert(EntryType* entry)
     {
-        auto& header = buckets_[entry->value_.hashKey() & bucket_ix_mask_];
+        rehashStep();
+        auto& header = bucket(entry->value_.hashKey());
         if (Uniqueness && header)
         {
             for (auto n = header; n; n= n->next_)
@@ -194,6 +221,10 @@ class PooledHash
         }
         entry->next_ = header;
         header = entry;
+        if (++size_ > grow_threshold_)
+        {
+            grow();
+        }
         return {&entry->value_,true};
     }
 
@@ -222,8 +253,9 @@ class PooledHash
 
     bool erase(typename ValueType::KeyType const& key)
     {
-        auto& header = buckets_[ValueType::hash(key) & bucket_ix_mask_];
-        EntryType* n = reinterpret_cast<EntryType*>(header);
+        rehashStep();
+        auto& header = bucket(ValueType::hash(key));
+        EntryType* n = header;
         EntryType* prev_n {nullptr};
         for (; n; prev_n = n, n = n->next_)
         {
@@ -231,6 +263,7 @@ class PooledHash
             {
                 extract(n, prev_n, header);
                 pool_->del(n);
+                --size_;
                 return true;
             }
         }
@@ -242,7 +275,8 @@ class PooledHash
     /// \return true if the value is removed, false if the value is not found
     bool erase(EntryType* entry)
     {
-        auto& header = buckets_[entry->value_.hashKey() & bucket_ix_mask_];
+        rehashStep();
+        auto& header = bucket(entry->value_.hashKey());
         EntryType* n = header;
         EntryType* prev_n {nullptr};
         for (; n; prev_n = n, n = n->next_)
@@ -251,6 +285,7 @@ class PooledHash
             {
                 extract(n, prev_n, header);
                 pool_->del(entry);
+                --size_;
                 return true;
             }
         }
@@ -260,11 +295,18 @@ class PooledHash
     /// \brief Removes the element at pos. References to the erased elements
     /// are invalidated
     /// \return iterator to the next element
+    /// \note this does not migrate buckets so that iterators stay valid when
+    /// erasing in a loop
     iterator erase(iterator pos)
     {
         EntryType* entry = pos.getEntry();
-        pos.reset(reinterpret_cast<EntryType*>(entry->next_));
+        pos.reset(entry->next_);
+        if (!*pos.ptr_)
+        {
+            pos.ptr_ = nextPos(entry);
+        }
         pool_->del(entry);
+        --size_;
         return pos;
     }
 
@@ -275,34 +317,26 @@ class PooledHash
     /// the value position for erase operation, call findEntry to get the entry
     /// node, or for eras and position forwarding operation, call find to get
     /// the iterator
-    ValueType* findValue(typename ValueType::KeyType const& key)
+    ValueType* findValue(typename ValueType::KeyType const& key) const
     {
-        EntryType* n = reinterpret_cast<EntryType*>(buckets_[ValueType::hash(key) & bucket_ix_mask_]);
-        while (n)
-        {
-            if (key==n->value_.key()) 
-            {
-                return &n->value_;
-            }
-            n = reinterpret_cast<EntryType*>(n->next_);
-        }
-        return nullptr;
+        EntryType* n = findEntry(key);
+        return n ? &n->value_ : nullptr;
     }
 
     /// \brief find the first entry node by value's key value
     /// \return the pointer to the entry where the value is stored. If no such
     /// element is found, nullptr is returned.
     /// \note If you want to find the iterator position, call find
-    EntryType* findEntry(typename ValueType::KeyType const& key)
+    EntryType* findEntry(typename ValueType::KeyType const& key) const
     {
-        EntryType* n = reinterpret_cast<EntryType*>(buckets_[ValueType::hash(key) & bucket_ix_mask_]);
+        EntryType* n = bucket(ValueType::hash(key));
         while (n)
         {
             if (key==n->value_.key()) 
             {
                 return n;
             }
-            n = reinterpret_cast<EntryType*>(n->next_);
+            n = n->next_;
         }
         return nullptr;
     }
@@ -313,22 +347,17 @@ class PooledHash
     /// \note If values in the map contains the entries of the same leys, call
     /// this function to get the iterator so that you can check if the value at
     /// the next position have the same key
-    iterator find(typename ValueType::KeyType const& key)
+    iterator find(typename ValueType::KeyType const& key) const
     {
-        auto& header = buckets_[ValueType::hash(key) & bucket_ix_mask_];
-        EntryType* n = reinterpret_cast<EntryType*>(header);
-        EntryType* prev_n {nullptr};
-        for (; n; prev_n = n, n = reinterpret_cast<EntryType*>(n->next_))
+        EntryType** pos = &bucket(ValueType::hash(key));
+        for (; *pos; pos = &(*pos)->next_)
         {
-            if (key==n->value_.key())
+            if (key==(*pos)->value_.key())
             {
-                return iterator(*this, 
-                       prev_n ? reinterpret_cast<EntryType**>(&prev_n->next_)
-                              : reinterpret_cast<EntryType**>(&header));
+                return iterator(*this, pos);
             }
-            n = reinterpret_cast<EntryType*>(n->next_);
         }
-        return iterator(*this, nullptr);
+        return end();
     }
 
     /// \brief replace the element key value
@@ -340,14 +369,15 @@ class PooledHash
     InsertResult replaceKey(typename ValueType::KeyType const& key,
                   typename ValueType::KeyType const& new_key)
     {
-        auto& header = buckets_[ValueType::hash(key) & bucket_ix_mask_];
-        EntryType* n = reinterpret_cast<EntryType*>(header);
+        auto& header = bucket(ValueType::hash(key));
+        EntryType* n = header;
         EntryType* prev_n {nullptr};
-        for (; n; prev_n = n, n = reinterpret_cast<EntryType*>(n->next_))
+        for (; n; prev_n = n, n = n->next_)
         {
             if (key==n->value_.key())
             {
                 extract(n, prev_n, header);
+                --size_;
                 n->value_.resetKey(new_key);
                 n->next_ = nullptr;
                 return insert(n);
@@ -365,47 +395,129 @@ class PooledHash
     {
         if (std::is_trivially_destructible<ValueType>::value && owns_pool_)
         {
-            for (auto & b : buckets_) b=nullptr;
             pool_->clear();
         }
         else
         {
-            // Note: the content deleted in the pool is untouched so we can still
-            // have access to the next item. This assumption is based on single
-            // thread access assumption.
-            for (auto entry : *this) pool_->del(entry);
-            for (auto & b : buckets_) b=nullptr;
+            delAll();
         }
+        for (size_t ix=0; ix < bucket_number_; ++ix) buckets_[ix]=nullptr;
+        ::free(old_buckets_);
+        old_buckets_ = nullptr;
+        size_ = 0;
     }
 
   private:
 
-    EntryType const** firstPos() const
+    static EntryType** allocateBuckets(size_t bucket_number)
     {
-        for (size_t ix=0; ix < bucket_number_; ++ix)
+        // calloc hands out large zeroed blocks without touching every page so that
+        // growing does not stall on initializing the new buckets
+        auto buckets = reinterpret_cast<EntryType**>(::calloc(bucket_number, sizeof(EntryType*)));
+        if (!buckets)
         {
-            if (buckets_[ix]) return &buckets_[ix];
+            throw std::bad_alloc();
         }
-        return firstPos();
+        return buckets;
     }
 
-    EntryType** firstPos()
+    /// \brief returns the bucket header of the hash value. The entry is in the old
+    /// buckets if its old bucket has not been migrated yet
+    EntryType*& bucket(size_t hash_value) const
     {
-        return const_cast<EntryType**>(firstPos());
+        if (old_buckets_)
+        {
+            size_t old_ix = hash_value & old_bucket_ix_mask_;
+            if (old_ix >= rehash_ix_)
+            {
+                return old_buckets_[old_ix];
+            }
+        }
+        return buckets_[hash_value & bucket_ix_mask_];
+    }
+
+    /// \brief doubles the number of buckets and starts the incremental rehashing
+    void grow()
+    {
+        if (old_buckets_)
+        {
+            // the previous rehashing must complete before growing again
+            rehashStep(bucket_number_);
+        }
+        old_buckets_ = buckets_;
+        old_bucket_ix_mask_ = bucket_ix_mask_;
+        rehash_ix_ = 0;
+        bucket_number_ <<= 1;
+        bucket_ix_mask_ = bucket_number_-1;
+        buckets_ = allocateBuckets(bucket_number_);
+        grow_threshold_ = size_t(bucket_number_ * max_load_factor_);
     }
 
-    EntryType const** nextPos(EntryType* entry) const
+    /// \brief migrates step_num old buckets to the new buckets
+    void rehashStep(size_t step_num = REHASH_STEP)
     {
-        for (size_t ix=(entry->value_.hashKey() & bucket_ix_mask_)+1; ix < bucket_number_; ++ix)
+        if (!old_buckets_)
+        {
+            return;
+        }
+        size_t old_bucket_number = old_bucket_ix_mask_+1;
+        for (; step_num > 0 && rehash_ix_ < old_bucket_number; --step_num, ++rehash_ix_)
+        {
+            EntryType* n = old_buckets_[rehash_ix_];
+            while (n)
+            {
+                // Entries inserted into the new bucket are newer and stay in front.
+                // Append the old entries to keep their order
+                EntryType* next = n->next_;
+                EntryType** pos = &buckets_[n->value_.hashKey() & bucket_ix_mask_];
+                while (*pos) pos = &(*pos)->next_;
+                *pos = n;
+                n->next_ = nullptr;
+                n = next;
+            }
+        }
+        if (rehash_ix_ == old_bucket_number)
+        {
+            ::free(old_buckets_);
+            old_buckets_ = nullptr;
+        }
+    }
+
+    void delAll()
+    {
+        // Note: the content deleted in the pool is untouched so we can still
+        // have access to the next item. This assumption is based on single
+        // thread access assumption.
+        for (auto entry : *this) pool_->del(entry);
+    }
+
+    /// \brief returns the first non-empty bucket at or after ix, looking into the
+    /// old buckets not migrated followed by the new buckets
+    EntryType** firstPos(size_t ix=0, bool in_old_buckets=true) const
+    {
+        if (old_buckets_ && in_old_buckets)
+        {
+            for (ix = std::max(ix, rehash_ix_); ix <= old_bucket_ix_mask_; ++ix)
+            {
+                if (old_buckets_[ix]) return &old_buckets_[ix];
+            }
+            ix = 0;
+        }
+        for (; ix < bucket_number_; ++ix)
         {
             if (buckets_[ix]) return &buckets_[ix];
         }
         return nullptr;
     }
 
-    EntryType** nextPos(EntryType* entry)
+    EntryType** nextPos(EntryType* entry) const
     {
-        return const_cast<EntryType**>(nextPos(entry));
+        size_t hash_value = entry->value_.hashKey();
+        if (old_buckets_ && (hash_value & old_bucket_ix_mask_) >= rehash_ix_)
+        {
+            return firstPos((hash_value & old_bucket_ix_mask_)+1, true);
+        }
+        return firstPos((hash_value & bucket_ix_mask_)+1, false);
     }
 
     inline static void extract (
@@ -423,11 +535,19 @@ class PooledHash
         }
     }
 
-    std::vector<EntryType*>             buckets_;
+    EntryType**                         buckets_ {nullptr};
+    // buckets before growing, not null only during rehashing
+    EntryType**                         old_buckets_ {nullptr};
     allocator_type *                    pool_ {nullptr};
     bool                                owns_pool_ {false};
     size_t                              bucket_number_;
     size_t                              bucket_ix_mask_;
+    size_t                              old_bucket_ix_mask_ {0};
+    // old buckets below rehash_ix_ are migrated
+    size_t                              rehash_ix_ {0};
+    size_t                              size_ {0};
+    size_t                              grow_threshold_;
+    double                              max_load_factor_;
 };
 
 }
\ No newline at end of file
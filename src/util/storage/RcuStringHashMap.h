@@ -0,0 +1,309 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file RcuStringHashMap.h
+ * @library alt_util
+ * @brief Defines read-mostly string key hash maps for one writer thread and any
+ * number of reader threads. Readers never lock or wait; the writer copies the
+ * table, changes the copy and publishes it with one atomic pointer store. The old
+ * table is freed after all readers that may still see it have finished reading.
+ * Key strings are kept in a string pool and never freed or reused while the map
+ * exists, so key and translated string pointers stay valid without any locking.
+ */
+
+#include "StringHashMap.h"              // for StrHashKey, StringHashMapEntry
+#include "FlatHash.h"                   // for FlatHash
+#include <util/ipc/Rcu.h>               // for RcuDomain, RcuReadGuard
+#include <util/string/StrPool.h>        // for StrPool
+#include <atomic>                       // for atomic
+#include <vector>                       // for vector
+#include <utility>                      // for pair
+
+namespace alt
+{
+
+/**
+ * \class RcuStringHashMap
+ * \ingroup ContainerUtils
+ * \brief A string key hash map with RCU publication.
+ * \tparam T the mapped type. Must be copy constructible as the writer copies all
+ * entries into a new table for each update.
+ * \note An update costs a copy of the whole table. Batch changes with update()
+ * when more than a few keys change at once.
+ */
+template <typename T>
+class RcuStringHashMap
+{
+  public:
+    using value_type    = StringHashMapEntry<T>;
+    using table_type    = FlatHash<value_type>;
+
+    /**
+     * \class Updater
+     * \brief Changes a private copy of the table. Only usable by the writer in
+     * the function passed to update()
+     */
+    class Updater
+    {
+        RcuStringHashMap&   map_;
+        table_type&         table_;
+        Updater(RcuStringHashMap& map, table_type& table) : map_(map), table_(table) {}
+        friend class RcuStringHashMap;
+
+      public:
+        /// \brief adds an entry with the value constructed from args if the key is
+        /// not in the table
+        /// \return true if the entry is added
+        template <typename... Args>
+        bool add(const StrHashKey& key, Args&&... args)
+        {
+            if (table_.contains(key))
+            {
+                return false;
+            }
+            table_.emplace(map_.pooledKey(key), std::forward<Args>(args)...);
+            return true;
+        }
+
+        /// \brief sets the value of the key, adding the key if not in the table
+        void set(const StrHashKey& key, const T& value)
+        {
+            if (value_type* entry = table_.findValue(key))
+            {
+                entry->second = value;
+            }
+            else
+            {
+                table_.emplace(map_.pooledKey(key), value);
+            }
+        }
+
+        /// \brief removes the key from the table
+        /// \return true if the key is found and removed
+        bool erase(const StrHashKey& key) { return table_.erase(key); }
+
+        /// \brief removes all keys from the table
+        void clear() { table_.clear(); }
+
+        T* find(const StrHashKey& key)
+        {
+            value_type* entry = table_.findValue(key);
+            return entry ? &entry->second : nullptr;
+        }
+
+        size_t size() const { return table_.size(); }
+
+        StrPool& getStringPool() { return map_.string_pool_; }
+    };
+
+    /**
+     * \class Reader
+     * \brief Holds a read-side critical section to do any number of lookups on
+     * one consistent version of the table. Values found are valid until the
+     * Reader is destroyed
+     */
+    class Reader
+    {
+        RcuReadGuard        guard_;
+        const table_type*   table_;
+
+      public:
+        explicit Reader(const RcuStringHashMap& map)
+            : table_(map.table_.load(std::memory_order_acquire))
+        {}
+
+        const T* find(const StrHashKey& key) const
+        {
+            const value_type* entry = table_->findValue(key);
+            return entry ? &entry->second : nullptr;
+        }
+
+        bool contains(const StrHashKey& key) const { return table_->contains(key); }
+        size_t size() const { return table_->size(); }
+
+        /// \brief iterates over all entries of this version of the table
+        typename table_type::const_iterator begin() const { return table_->begin(); }
+        typename table_type::const_iterator end() const { return table_->end(); }
+    };
+
+    RcuStringHashMap() : table_(new table_type()) {}
+
+    RcuStringHashMap(const RcuStringHashMap&) = delete;
+    RcuStringHashMap& operator=(const RcuStringHashMap&) = delete;
+
+    /// \brief destructor. No reader can be reading the map at the time
+    ~RcuStringHashMap()
+    {
+        for (auto& retired: retired_)
+        {
+            RcuDomain::instance().synchronize(retired.first);
+            delete retired.second;
+        }
+        delete table_.load(std::memory_order_relaxed);
+    }
+
+    // -------------------------------------------------------------------------
+    // Called by readers
+    // -------------------------------------------------------------------------
+
+    /// \brief copies the value of the key
+    /// \return true if the key is found
+    bool find(const StrHashKey& key, T& value) const
+    {
+        Reader reader(*this);
+        const T* found = reader.find(key);
+        if (found)
+        {
+            value = *found;
+        }
+        return found != nullptr;
+    }
+
+    bool contains(const StrHashKey& key) const
+    {
+        return Reader(*this).contains(key);
+    }
+
+    size_t size() const { return Reader(*this).size(); }
+
+    // -------------------------------------------------------------------------
+    // Called by the writer
+    // -------------------------------------------------------------------------
+
+    /// \brief changes the table in a batch and publishes the changes at once
+    /// \param func a callable taking Updater& to change a copy of the table
+    template <typename Func>
+    void update(Func&& func)
+    {
+        const table_type* current = table_.load(std::memory_order_relaxed);
+        table_type* next = new table_type(current->capacity());
+        for (const value_type& entry: *current)
+        {
+            next->insert(entry);
+        }
+        Updater updater(*this, *next);
+        func(updater);
+        publish(next);
+    }
+
+    bool add(const StrHashKey& key, const T& value)
+    {
+        bool added = false;
+        update([&](Updater& updater) { added = updater.add(key, value); });
+        return added;
+    }
+
+    void set(const StrHashKey& key, const T& value)
+    {
+        update([&](Updater& updater) { updater.set(key, value); });
+    }
+
+    bool erase(const StrHashKey& key)
+    {
+        bool erased = false;
+        update([&](Updater& updater) { erased = updater.erase(key); });
+        return erased;
+    }
+
+    /// \brief removes all keys. Key strings are kept in the pool
+    void clear() { publish(new table_type()); }
+
+    /// \brief frees retired tables no longer read by any reader. Called by
+    /// update; the writer may also call it when idle
+    /// \return the number of tables still waiting for readers
+    size_t reclaim()
+    {
+        RcuDomain& domain = RcuDomain::instance();
+        size_t kept = 0;
+        for (auto& retired: retired_)
+        {
+            if (domain.isQuiescent(retired.first))
+            {
+                delete retired.second;
+            }
+            else
+            {
+                retired_[kept++] = retired;
+            }
+        }
+        retired_.resize(kept);
+        return kept;
+    }
+
+  protected:
+    StrHashKey pooledKey(const StrHashKey& key)
+    {
+        StrHashKey pooled_key = key;
+        pooled_key.str_ = string_pool_.push(key.str_, key.length_);
+        return pooled_key;
+    }
+
+    void publish(table_type* table)
+    {
+        table_type* old = table_.exchange(table, std::memory_order_seq_cst);
+        retired_.emplace_back(RcuDomain::instance().advance(), old);
+        reclaim();
+    }
+
+    std::atomic<table_type*>                            table_;
+    // tables unpublished and the epoch when they were unpublished
+    std::vector<std::pair<uint64_t, table_type*>>       retired_;
+    // only used by the writer. Strings are pushed and never erased for reuse
+    StrPool                                             string_pool_;
+};
+
+/**
+ * \class RcuTranslationMap
+ * \ingroup ContainerUtils
+ * \brief A string to string translation map with RCU publication. The translated
+ * strings are in the string pool of the map and stay valid until the map is
+ * destroyed, so translate returns a pointer usable outside any read section.
+ */
+class RcuTranslationMap : protected RcuStringHashMap<const char*>
+{
+    using Base = RcuStringHashMap<const char*>;
+
+  public:
+    using Base::Updater;
+    using Base::update;
+    using Base::erase;
+    using Base::clear;
+    using Base::reclaim;
+    using Base::size;
+
+    /// \brief adds a translation in an update batch
+    static void add(Updater& updater, const StrHashKey& source, std::string_view translated)
+    {
+        updater.add(source, updater.getStringPool().push(translated.data(), translated.length()));
+    }
+
+    /// \brief adds a translation. Called by the writer
+    bool add(const StrHashKey& source, std::string_view translated)
+    {
+        bool added = false;
+        update([&](Updater& updater)
+        {
+            if (!updater.find(source))
+            {
+                add(updater, source, translated);
+                added = true;
+            }
+        });
+        return added;
+    }
+
+    /// \brief returns the translated string or nullptr if source is not found
+    const char* translate(const StrHashKey& source) const
+    {
+        const char* translated = nullptr;
+        Base::find(source, translated);
+        return translated;
+    }
+};
+
+}
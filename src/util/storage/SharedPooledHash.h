@@ -6,213 +6,436 @@
 //**************************************************************************
 
 /**
- * @file SharedHash.h
+ * @file SharedPooledHash.h
  * @library alt_util
- * @brief definition of lock free pooled hash table in shared memory
- * TODO to be justified for its usage and tested
+ * @brief definition of a fixed capacity hash table that can be placed in shared
+ * memory and read by multiple processes:
+ *    - open addressing with linear probing, no pointers stored in the table
+ *    - entries are preallocated in a FixedPoolPrealloc and referred by slot index
+ *    - lock free readers: each index slot is guarded by a sequence lock (version)
+ *      so readers never block writers and retry on a torn read
+ *    - writers are serialized by a spin lock in the table header, which works
+ *      across processes
  */
 
-#include "LinkedList.h"
-#include "FixedMemPool.h"
+#include "FixedMemPool.h"               // for FixedPoolPrealloc
+#include "PooledHash.h"                 // for MAKE_POOLED_HASH_ENTRY
 #include <util/system/Platform.h>
-#include <util/ipc/Mutex.h>
-#include <vector>
-#include <atomic>
-#include <functional>
+#include <util/system/SysConfig.h>      // for CACHE_LINE_ALIGN
+#include <util/ipc/Mutex.h>             // for SpinMutex
+#include <util/numeric/Intrinsics.h>    // for constAlign
+#include <util/types/TemplateHelper.h>  // for NONCOPYABLE
+#include <atomic>                       // for atomic
+#include <cstring>                      // for memcpy
+#include <stdexcept>                    // for runtime_error
+#include <type_traits>                  // for is_trivially_copyable
 
 namespace alt {
 
-/**
- * \struct SharedHashEntryBase
- * \brief Base type for all element types of SharedHash entry.
- */
-struct  SharedHashEntryBase
-{
-    std::atomic<SharedHashEntryBase*> next_ {nullptr};
-    virtual ~SharedHashEntryBase() {}
-
-    // Derived class must provide:
-    // using KeyType=MyKeyType;
-    // size_t hashKey();
-    // const KeyType& key() const;
-    // static size_t hash(const KeyType& key);
-};
-
 /**
  * \class SharedHash
- * \brief Lock free pooled hash table for multiple processes
- * \note Erase function is not supported
+ * \ingroup ContainerUtils
+ * \brief Fixed capacity hash table for multiple threads and processes. Readers are
+ * lock free and never block writers.
+ * \tparam T the type of the value, which contains the key. T must be trivially
+ * copyable (no pointers, no virtual functions) and provide the following:
+ *    - using KeyType=MyKeyType;
+ *    - const KeyType& key() const;
+ *    - static size_t hash(const KeyType& key);
+ * In most cases, you can use macro MAKE_POOLED_HASH_ENTRY to provide the above functions.
+ * \note Values are returned by copy. A reader gets a consistent copy of the value even
+ * if a writer is updating or erasing the value at the same time.
  */
-template <typename T, typename std::enable_if<std::is_base_of<SharedHashEntryBase,T>::value>::type>
+template <typename T>
 class SharedHash
 {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SharedHash value type must be trivially copyable");
+
   public:
 
-    using EntryBase = SharedHashEntryBase;
+    using value_type = T;
+    using KeyType    = typename T::KeyType;
+    using PoolType   = FixedPoolPrealloc<T>;
 
-    SharedHash (char* buffer, size_t max_index_num, size_t max_bucket_num)
-        : header_(buffer, max_index_num, max_bucket_num)
+    NONCOPYABLE(SharedHash);
+
+    /// \brief Constructor
+    /// \param buffer buffer for the index slots and the entries, must have the size
+    /// of requiredDataSize(max_entry_num)
+    /// \param max_entry_num the maximum number of entries the table can hold
+    SharedHash (char* buffer, size_t max_entry_num)
+        : header_(max_entry_num)
+        , pool_(buffer + slotsSize(header_.slot_num_), max_entry_num)
     {
+        header_.setSlots(buffer);
     }
 
-    SharedHash (size_t max_index_num, size_t max_bucket_num)
-        : header_(max_index_num, max_bucket_num)
+    /// \brief Constructor. The buffer is allocated internally
+    /// \param max_entry_num the maximum number of entries the table can hold
+    SharedHash (size_t max_entry_num)
+        : header_(max_entry_num)
+        , pool_(max_entry_num)
     {
+        char* buffer = reinterpret_cast<char*>(::malloc(slotsSize(header_.slot_num_)));
+        if (!buffer)
+        {
+            throw std::runtime_error(std::string("SharedHash: memory full"));
+        }
+        header_.owns_buffer_ = true;
+        header_.setSlots(buffer);
     }
 
-    T* insert(T* entry)
+    /// \brief Destructor. This can only be safely done when all other threads using
+    /// this table no longer have access to this.
+    ~SharedHash()
     {
-        auto& list = header_.getBucketList(entry->hashKey());
-        T* expected_current_bucket = list.first_bucket_.load(std::memory_order_relaxed);
-        do
+        if (header_.owns_buffer_)
         {
-            entry->next_.store(expected_current_bucket, std::memory_order_relaxed);
+            ::free(header_.slots());
         }
-        while (!list.first_bucket_.compare_exchange_weak(expected_current_bucket, entry,
-                    std::memory_order_release, std::memory_order_acquire));
+    }
+
+    static size_t requiredHeaderSize()
+    {
+        return constAlign(sizeof(SharedHash), SysConfig::instance().cache_line_size_);
+    }
 
-        return entry;
+    static size_t requiredDataSize(size_t max_entry_num)
+    {
+        return slotsSize(slotNumber(max_entry_num)) + PoolType::requiredDataSize(max_entry_num);
     }
 
-    template <typename... Args>
-    T* emplace(Args&&... args)
+    static size_t requiredSize(size_t max_entry_num)
     {
-        void* p = header_.allocBucket();
-        if (!p)
+        return requiredHeaderSize() + requiredDataSize(max_entry_num);
+    }
+
+    /// \brief Create a table instance in an allocated memory
+    /// \param addr the address of the memory
+    /// \param attrs memory addtributes
+    /// \param max_entry_num the maximum number of entries the table can hold
+    /// \note if attrs.is_new_ is true, a new table is constructed in addr. Otherwise,
+    /// addr contains a table already created by other process and this function simply
+    /// returns the instance for sharing.
+    static SharedHash* create (char* addr, const MemoryAttrs& attrs, size_t max_entry_num)
+    {
+        if (attrs.is_new_)
         {
-            throw std::runtime_error(std::string("SharedPooledHash Full"));
+            return new (addr) SharedHash(addr + requiredHeaderSize(), max_entry_num);
         }
-        insert(new (p) T (std::forward<Args>(args)...));
+        return reinterpret_cast<SharedHash*>(addr);
     }
 
-    T* find(typename T::KeyType const & key)
+    static SM_Mode getOpenMode(bool is_master)
+    { return is_master ? SM_Mode::SM_OpenOrCreate : SM_Mode::SM_OpenOnly; }
+
+    /// a reader takes no lock, but any process sharing the table can be a writer
+    static SM_Access getAccessRequest(bool) { return SM_Access::SM_ReadWrite; }
+
+    // -------------------------------------------------------------------------
+    // Called by reader
+    // -------------------------------------------------------------------------
+
+    /// \brief find the value by its key
+    /// \param key the key of the value
+    /// \param value to receive the copy of the value found
+    /// \return true if the value is found; otherwise false and value is untouched
+    bool find(const KeyType& key, T& value) const
     {
-        size_t hash_key = T::hash(key);
-        auto & list = header_.getBucketList(hash_key);
-        T* entry = list.first_bucket_.load(std::memory_order_acquire);
-        while (entry)
+        const size_t hash = T::hash(key);
+        const uint64_t tag = hashTag(hash);
+        const Slot* slots = header_.slots();
+        size_t ix = hash & header_.slot_mask_;
+        for (size_t probe=0; probe < header_.slot_num_; ++probe, ix=(ix+1)&header_.slot_mask_)
         {
-            if (key==entry->key())
+            switch (readSlot(slots[ix], tag, key, value))
             {
-               return entry;
+                case ReadResult::Found: return true;
+                case ReadResult::Empty: return false;
+                default: break;
             }
-            entry= entry->next_;
         }
-        return nullptr;
+        return false;
     }
 
-    static size_t requiredHeaderSize()
+    /// \brief check if the table contains a value with the given key
+    bool contains(const KeyType& key) const
     {
-        return constAlign(sizeof(TableHeader), SysConfig::instance().cache_line_size_);
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type value;
+        return find(key, reinterpret_cast<T&>(value));
     }
 
-    static size_t bucketSize()
+    /// \brief returns the number of values in the table
+    size_t size() const { return header_.size_.load(std::memory_order_acquire); }
+
+    /// \brief returns the maximum number of values the table can hold
+    size_t capacity() const { return pool_.slotNum(); }
+
+    bool empty() const { return size()==0; }
+
+    // -------------------------------------------------------------------------
+    // Called by writer
+    // -------------------------------------------------------------------------
+
+    /// \brief insert a value if no value with the same key exists in the table
+    /// \return true if the value is inserted; false if the key already exists
+    /// \throw std::runtime_error if the table is full
+    bool insert(const T& value)
+    {
+        ScopedSpinLock lock(header_.write_lock_);
+        return insertLocked(value);
+    }
+
+    /// \brief update the value having the same key in the table
+    /// \return true if the value is updated; false if the key is not found
+    bool update(const T& value)
     {
-        return constAlign(sizeof(ValueType), SysConfig::instance().cache_line_size_);
+        ScopedSpinLock lock(header_.write_lock_);
+        Slot* slot = findSlot(value.key(), T::hash(value.key()));
+        if (!slot)
+        {
+            return false;
+        }
+        overwrite(*slot, value);
+        return true;
     }
 
-    static size_t requiredDataSize(size_t max_index_num, size_t max_bucket_num)
+    /// \brief insert the value or update the existing one with the same key
+    /// \return true if the value is newly inserted
+    /// \throw std::runtime_error if the table is full
+    bool upsert(const T& value)
     {
-        return power2Next(max_index_num) * sizeof(BucketLinkList*) +
-               max_bucket_num * bucketSize();
+        // find and insert under one lock, so that no other writer can insert
+        // the key in between
+        ScopedSpinLock lock(header_.write_lock_);
+        Slot* slot = findSlot(value.key(), T::hash(value.key()));
+        if (slot)
+        {
+            overwrite(*slot, value);
+            return false;
+        }
+        return insertLocked(value);
     }
 
-    static size_t requiredSize(size_t max_index_num, size_t max_bucket_num)
+    /// \brief remove the value with the given key
+    /// \return true if the value is removed, false if the value is not found
+    bool erase(const KeyType& key)
     {
-        return requiredHeaderSize() + requiredDataSize(max_index_num, max_bucket_num);
+        ScopedSpinLock lock(header_.write_lock_);
+        Slot* slot = findSlot(key, T::hash(key));
+        if (!slot)
+        {
+            return false;
+        }
+        T* value = entry(slot->link_.load(std::memory_order_relaxed));
+        Slot* slots = header_.slots();
+        size_t ix = slot - slots;
+        if (slots[(ix+1)&header_.slot_mask_].link_.load(std::memory_order_relaxed)==EMPTY_LINK)
+        {
+            // No probe sequence goes through this slot, so mark it empty and also
+            // reclaim the deleted slots right before it
+            writeSlot(slots[ix], EMPTY_LINK);
+            for (ix=(ix-1)&header_.slot_mask_;
+                 slots[ix].link_.load(std::memory_order_relaxed)==DELETED_LINK;
+                 ix=(ix-1)&header_.slot_mask_)
+            {
+                writeSlot(slots[ix], EMPTY_LINK);
+            }
+        }
+        else
+        {
+            writeSlot(*slot, DELETED_LINK);
+        }
+        // The version of the slot has been changed, a reader still copying the
+        // value will find the copy torn and retry
+        pool_.deallocate(value);
+        header_.size_.fetch_sub(1, std::memory_order_release);
+        return true;
     }
 
   private:
 
-    struct FreeEntryHeader
-    {
-        FreeEntryHeader*          next_free_entry_ { nullptr };
-    };
+    // The lower 32 bits of a link is the entry index+1 in the pool, and the
+    // higher 32 bits holds the higher 32 bits of the hash to filter out most of
+    // mismatches without touching the entry
+    static constexpr uint64_t EMPTY_LINK = 0;
+    static constexpr uint64_t DELETED_LINK = 0xFFFFFFFF;
 
-    struct BucketLinkList
+    struct Slot
     {
-        std::atomic<T*>           first_bucket_ { nullptr };
+        std::atomic<uint64_t>   version_ {0};   // odd when the slot is in change
+        std::atomic<uint64_t>   link_ {EMPTY_LINK};
     };
 
     struct TableHeader
     {
-
-        size_t                    bucket_size_ { 0 };
-        size_t                    max_entry_num_ { 0 };
-        size_t                    entry_ix_mask_ { 0 };
-        size_t                    max_bucket_num_ { 0 };
-        void*                     allocted_buffer { nullptr };
-        BucketLinkList*           bucket_index_;
-        char*                     bucket_data_;
-        alignas(64) std::atomic<FreeEntryHeader*>  free_entry_head_ { nullptr };
-
-        TableHeader(char* buffer, size_t max_index_num, size_t max_bucket_num)
-            : bucket_size_(bucketSize())
-            , max_entry_num_(power2Next(max_index_num))
-            , entry_ix_mask_ = max_entry_num_-1;
-            , max_bucket_num_(max_bucket_num)
+        size_t                  slot_num_ {0};
+        size_t                  slot_mask_ {0};
+        ptrdiff_t               slots_offset_ {0};  // slots relative to this header
+        bool                    owns_buffer_ {false};
+        std::atomic<size_t>     size_ {0};
+        CACHE_LINE_ALIGN SpinMutex write_lock_;
+
+        TableHeader(size_t max_entry_num)
+            : slot_num_(slotNumber(max_entry_num))
+            , slot_mask_(slot_num_-1)
+        {}
+
+        void setSlots(char* buffer)
         {
-            initialize(buffer)
+            slots_offset_ = buffer - reinterpret_cast<char*>(this);
+            new (buffer) Slot[slot_num_];
         }
 
-        void initialize(char* buffer)
+        Slot* slots() const
         {
-            std::memset(buffer, 0, max_entry_num_*sizeof(BucketLinkList*));
-            bucket_index_ = reinterpret_cast<BucketLinkList*>(buffer);
-
-            char* p = buffer + max_entry_num_*sizeof(BucketLinkList*);
-            FreeEntryHeader* entry =reinterpret_cast<FreeEntryHeader*>(p);
-            free_entry_head_ = entry;
-            for ( int i=0; i<max_bucket_num_-1; ++i )
-            {
-                p+=entry_size_;
-                entry->next_free_entry_ = reinterpret_cast<EntryHeader*>(p);
-                entry=reinterpret_cast<EntryHeader*>(p);
-            }
-            entry->next_free_entry_ = nullptr;
+            return reinterpret_cast<Slot*>(
+                const_cast<char*>(reinterpret_cast<const char*>(this)) + slots_offset_);
         }
+    };
 
-        TableHeader(size_t max_index_num, size_t max_bucket_num)
-        {
-            allocted_buffer_ = ::malloc(requiredDataSize());
-            initialize(reinterpret_cast<char*>(allocted_buffer_));
-        }
+    enum class ReadResult { Found, NotMatch, Empty };
+
+    /// keeps load factor no more than 0.5
+    static size_t slotNumber(size_t max_entry_num)
+    {
+        size_t slot_num = 16;
+        while (slot_num < max_entry_num*2) slot_num <<= 1;
+        return slot_num;
+    }
+
+    static size_t slotsSize(size_t slot_num)
+    {
+        return constAlign(slot_num * sizeof(Slot), SysConfig::instance().cache_line_size_);
+    }
 
-        TableHeader() = default;
+    static uint64_t hashTag(size_t hash) { return uint64_t(hash) & 0xFFFFFFFF00000000ULL; }
+    static uint64_t linkTag(uint64_t link) { return link & 0xFFFFFFFF00000000ULL; }
 
-        ~TableHeader()
-        {
-            ::free(allocted_buffer_);
-        };
+    T* entry(uint64_t link) const
+    {
+        return pool_.at(uint32_t((link & 0xFFFFFFFF) - 1));
+    }
 
-        BucketLinkList getBucketList(int64_t key)
+    ReadResult readSlot(const Slot& slot, uint64_t tag, const KeyType& key, T& value) const
+    {
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type copy;
+        while (true)
         {
-            return list = bucket_index_[key & entry_ix_mask_];
+            uint64_t version = slot.version_.load(std::memory_order_acquire);
+            if (version & 1)
+            {
+                pause();
+                continue;
+            }
+            uint64_t link = slot.link_.load(std::memory_order_relaxed);
+            bool matched = link!=EMPTY_LINK && link!=DELETED_LINK && linkTag(link)==tag;
+            if (matched)
+            {
+                std::memcpy(&copy, entry(link), sizeof(T));
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version_.load(std::memory_order_relaxed)!=version)
+            {
+                continue;
+            }
+            if (link==EMPTY_LINK)
+            {
+                return ReadResult::Empty;
+            }
+            if (matched && reinterpret_cast<const T&>(copy).key()==key)
+            {
+                std::memcpy(&value, &copy, sizeof(T));
+                return ReadResult::Found;
+            }
+            return ReadResult::NotMatch;
         }
+    }
 
-        void* allocBucket()
+    /// find the slot having the key, must be called with write lock
+    Slot* findSlot(const KeyType& key, size_t hash) const
+    {
+        const uint64_t tag = hashTag(hash);
+        Slot* slots = header_.slots();
+        size_t ix = hash & header_.slot_mask_;
+        for (size_t probe=0; probe < header_.slot_num_; ++probe, ix=(ix+1)&header_.slot_mask_)
         {
-            if (!free_entry_head_)
+            uint64_t link = slots[ix].link_.load(std::memory_order_relaxed);
+            if (link==EMPTY_LINK)
             {
                 return nullptr;
             }
-            FreeEntryHeader* expected_free_entry_head = free_entry_head_.load(std::memory_order_relaxed);
-            FreeEntryHeader* next_free_entry;
-            do
+            if (link!=DELETED_LINK && linkTag(link)==tag && entry(link)->key()==key)
             {
-                next_free_entry = expected_free_entry_head->next_free_entry_;
+                return &slots[ix];
             }
-            while (!free_entry_head_.compare_exchange_weak(expected_free_entry_head, next_free_entry,
-                        std::memory_order_release, std::memory_order_acquire));
-
-            return expected_free_entry_head;
+        }
+        return nullptr;
+    }
 
+    /// insert the value if the key is not found, must be called with write lock
+    bool insertLocked(const T& value)
+    {
+        const size_t hash = T::hash(value.key());
+        const uint64_t tag = hashTag(hash);
+        Slot* slots = header_.slots();
+        Slot* free_slot = nullptr;
+        size_t ix = hash & header_.slot_mask_;
+        for (size_t probe=0; probe < header_.slot_num_; ++probe, ix=(ix+1)&header_.slot_mask_)
+        {
+            uint64_t link = slots[ix].link_.load(std::memory_order_relaxed);
+            if (link==EMPTY_LINK)
+            {
+                if (!free_slot) free_slot = &slots[ix];
+                break;
+            }
+            if (link==DELETED_LINK)
+            {
+                if (!free_slot) free_slot = &slots[ix];
+                continue;
+            }
+            if (linkTag(link)==tag && entry(link)->key()==value.key())
+            {
+                return false;
+            }
+        }
+        void* p = free_slot ? pool_.allocate() : nullptr;
+        if (!p)
+        {
+            throw std::runtime_error(std::string("SharedHash full"));
         }
+        std::memcpy(p, &value, sizeof(T));
+        writeSlot(*free_slot, tag | (uint64_t(pool_.slotIndex(p))+1));
+        header_.size_.fetch_add(1, std::memory_order_release);
+        return true;
+    }
+
+    /// change the value of the slot under the sequence lock, must be called with write lock
+    void overwrite(Slot& slot, const T& value)
+    {
+        uint64_t version = slot.version_.load(std::memory_order_relaxed);
+        slot.version_.store(version+1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(entry(slot.link_.load(std::memory_order_relaxed)), &value, sizeof(T));
+        slot.version_.store(version+2, std::memory_order_release);
+    }
+
+    /// change the slot link under the sequence lock, must be called with write lock
+    static void writeSlot(Slot& slot, uint64_t link)
+    {
+        uint64_t version = slot.version_.load(std::memory_order_relaxed);
+        slot.version_.store(version+1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.link_.store(link, std::memory_order_relaxed);
+        slot.version_.store(version+2, std::memory_order_release);
     }
-    header_;
+
+    TableHeader         header_;
+    PoolType            pool_;
 };
 
 template<typename T> using SharedMemHash
     = SharedContainer<SharedMemory, SharedHash<T>>;
 
-}
\ No newline at end of file
+} // namespace alt
@@ -45,7 +45,7 @@ class SideBuckets
     explicit SideBuckets(size_t front_bucket_sz, size_t back_bucket_sz)
         : back_bucks_(back_bucket_sz)
     {
-        front_bucket_sz_ = power2Next<size_t>(front_bucket_sz);
+        front_bucket_sz_ = int(power2Next<size_t>(front_bucket_sz));
         front_bucket_mask_ = front_bucket_sz_ -1;
         front_bucks_.resize(front_bucket_sz_);
         top_ix_ = front_bucket_sz_ >> 2; // set top_ix at the 1/4th position
@@ -55,7 +55,7 @@ class SideBuckets
     class iterator
     {
       private:
-        SideBuckets&  parent_;
+        SideBuckets*  parent_;
         size_t        ix_;
         bool          in_front_ { true };
       public:
@@ -66,15 +66,15 @@ class SideBuckets
             {}
 
         iterator(SideBuckets & p, size_t ix, bool in_front):
-            parent_(p), ix_(ix), in_front_(in_front) {}
+            parent_(&p), ix_(ix), in_front_(in_front) {}
 
-        bool operator==(const iterator& oth)
+        bool operator==(const iterator& oth) const
         {
             return parent_==oth.parent_ && ix_==oth.ix_ &&
                    in_front_==oth.in_front_;
         }
 
-        bool operator!=(const iterator& oth)
+        bool operator!=(const iterator& oth) const
         {
             return !(*this==oth);
         }
@@ -83,7 +83,7 @@ class SideBuckets
         {
             parent_=oth.parent_;
             ix_=oth.ix_;
-            in_front_==oth.in_front_;
+            in_front_=oth.in_front_;
             return *this;
         }
 
@@ -91,22 +91,22 @@ class SideBuckets
         {
             if (in_front_)
             {
-                if (ix_ < parent_.bot_ix_)
+                if (ix_ < parent_->botIndex())
                 {
                     ++ix_;
                 }
-                if (ix_ >= parent_.bot_ix_)
+                if (ix_ >= parent_->botIndex())
                 {
-                    if (!parent_.back_bucks_.empty())
+                    if (!parent_->back_bucks_.empty())
                     {
-                        ix_= parent_.back_bucks_.head();
+                        ix_= parent_->back_bucks_.head();
                         in_front_ = false;
                     }
                 }
                 return *this;
             }
 
-            if (ix_<parent_.back_bucks_.tail()) ++ix_;
+            if (ix_<parent_->back_bucks_.tail()) ++ix_;
 
             return *this;
         }
@@ -115,36 +115,39 @@ class SideBuckets
         {
             if (in_front_)
             {
-                if (ix_ < parent_.bot_ix_)
+                if (ix_ < parent_->botIndex())
                 {
                     ++ix_;
-                    while (parent_.isFrontEntryEmpty(ix_))
+                    while (ix_ < parent_->botIndex() && parent_->isFrontEntryEmpty(int(ix_)))
                     {
                         ++ix_;
-                        if (ix_ >= parent_.bot_ix_)
-                        {
-                            break;
-                        }
                     }
                 }
-                if (ix_ == parent_.bot_ix_)
+                if (ix_ >= parent_->botIndex())
                 {
-                    if (!back_bucks_.empty())
+                    if (!parent_->back_bucks_.empty())
                     {
-                        ix_= parent_.back_bucks_.head();
+                        ix_= parent_->back_bucks_.head();
                         in_front_ = false;
                     }
                 }
                 return *this;
             }
-            if (ix_<parent_.back_bucks_.tail()) ++ix_;
+            if (ix_<parent_->back_bucks_.tail()) ++ix_;
             return *this;
         }
 
         value_type operator*() const
         {
-            return in_front_ ? parent_.getFrontEntry(ix_)
-                             : parent_.getBackEntry(ix_);
+            return in_front_ ? parent_->getFrontEntry(int(ix_))
+                             : parent_->getBackEntry(ix_);
+        }
+
+        /// \brief returns the pointer to the value in the bucket
+        T* value() const
+        {
+            return in_front_ ? &parent_->front_bucks_[ix_ & parent_->front_bucket_mask_]
+                             : &parent_->back_bucks_.at(ix_).second;
         }
     };
 
@@ -161,6 +164,9 @@ class SideBuckets
     }
 
     bool frontEmpty() const { return top_ix_==bot_ix_; }
+
+    /// \brief the end index of the front entries, which is never negative
+    size_t botIndex() const { return size_t(bot_ix_); }
     bool empty() const { return frontEmpty() && back_bucks_.empty(); }
     size_t size() const { return count_ + back_bucks_.size(); }
     iterator begin() 
@@ -340,7 +346,7 @@ class SideBuckets
             }
             return nullptr;
         }
-        back_bucks_.update(key, val);
+        return back_bucks_.update(key, val);
     }
 
   protected:
@@ -438,8 +444,8 @@ class SideBuckets
     Key     top_ {Compare::max()}; ///< the top key value
     size_t  count_ {0};            ///< number of non-empty entries in front_bucks_
 
-    size_t  front_bucket_sz_;      ///< size of front_bucks_
-    size_t  front_bucket_mask_;    ///< module mask of front_bucks_ bot_ix_
+    int     front_bucket_sz_;      ///< size of front_bucks_
+    int     front_bucket_mask_;    ///< module mask of front_bucks_ bot_ix_
 
 };
 
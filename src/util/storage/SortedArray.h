@@ -15,6 +15,7 @@
 
 #include <util/system/Platform.h>
 #include <util/numeric/Intrinsics.h> // For isel, power2Next
+#include "SortedSearch.h"            // for SortedSearch
 #include <stddef.h>
 #include <vector>
 #include <functional>
@@ -204,7 +205,7 @@ class SortedArray
 
     int find (T&& x) { return find(x); }
 
-    void insert (T&& x, bool unique=false) { insert(x, unique); }
+    bool insert (T&& x, bool unique=false) { return insert(x, unique); }
 
     bool erase (T&& x) { return erase(x); }
 
@@ -228,6 +229,12 @@ class SortedArray
 
     size_t lowBound(const_reference x)
     {
+        using Order = SortedCompareOrder<Compare>;
+        if constexpr (Order::KNOWN && std::is_arithmetic<T>::value)
+        {
+            return head_ + SortedSearch<T, Order::ASCENDING>::upBound(
+                array_.data() + head_, tail_ - head_, x);
+        }
         size_t start = head_;
         size_t end = tail_;
         size_t mid;
@@ -19,10 +19,11 @@
 
 #include <util/system/Platform.h>
 #include <util/numeric/Intrinsics.h> // For isel, power2Next
+#include "SortedSearch.h"            // for SortedSearch
 #include <stddef.h>
 #include <vector>
 #include <functional>
-#include <cstring>
+#include <algorithm>                 // for move, move_backward
 #include <type_traits>               // for is_trivially_destructible
 
 // for TEST_BUILD
@@ -33,6 +34,7 @@ namespace alt {
 template <typename Key>
 struct SortedBucketCompareInc
 {
+    constexpr static bool ASCENDING = true;
     static int threeway (Key x, Key y)
     {
         return x==y ? 0 : x<y ? 1 : -1;
@@ -45,6 +47,7 @@ struct SortedBucketCompareInc
 template <typename Key>
 struct SortedBucketCompareDec
 {
+    constexpr static bool ASCENDING = false;
     static int threeway (Key x, Key y)
     {
         return x==y ? 0 : x<y ? -1 : 1;
@@ -82,6 +85,13 @@ class SortedBuckets
 
     size_t lowBound(const Key& x)
     {
+        using Order = SortedCompareOrder<Compare>;
+        if constexpr (Order::KNOWN && std::is_arithmetic<Key>::value)
+        {
+            return head_ + SortedSearch<Key, Order::ASCENDING>::lowBound(
+                buckets_.data() + head_, tail_ - head_, x,
+                [](const value_type& bucket) { return bucket.first; });
+        }
         size_t start = head_;
         size_t end = tail_;
         size_t mid;
@@ -105,6 +115,9 @@ class SortedBuckets
         return end;
     }
 
+    /// the position of bucket ix in buckets_
+    typename std::vector<value_type>::iterator position(size_t ix) { return buckets_.begin() + ix; }
+
     void erase (size_t ix)
     {
         //  Compact memory from shorter end.
@@ -112,15 +125,15 @@ class SortedBuckets
         {
             if (ix>head_)
             {
-                std::memmove(&buckets_[head_+1], &buckets_[head_], sizeof(value_type)*(ix-head_));
+                std::move_backward(position(head_), position(ix), position(ix+1));
             }
             ++head_;
         }
         else
         {
-            if (tail_ > ix)
+            if (tail_ > ix+1)
             {
-                std::memmove(&buckets_[ix], &buckets_[ix+1], sizeof(value_type)*(tail_-ix));
+                std::move(position(ix+1), position(tail_), position(ix));
             }
             --tail_;
         } 
@@ -179,7 +192,7 @@ class SortedBuckets
                  buckets_.resize(buckets_.size()*2);
             }
             size_t dist = std::min(size_t(1), (buckets_.size() - tail_ + 1) / 2);
-            std::memmove(&buckets_[head_+dist], &buckets_[head_], sizeof(value_type)*(tail_-head_));
+            std::move_backward(position(head_), position(tail_), position(tail_+dist));
             head_ += dist;
             tail_ += dist;
         }
@@ -190,6 +203,7 @@ class SortedBuckets
     value_type& back () { return buckets_[tail_-1]; }
     const value_type& back () const { return buckets_[tail_-1]; }
     const value_type& operator[] (size_t ix) const { return buckets_[ix]; }
+    value_type& at (size_t ix) { return buckets_[ix]; }
 
     size_t size() const { return tail_ - head_; }
     bool empty() const { return tail_ == head_; }
@@ -253,15 +267,15 @@ class SortedBuckets
             // std::cout << "SortedBuckets resize to " << buckets_.size() << std::endl;
         }
 
-        if (ix - head_ < tail_ - ix && head_ > 0 || tail_>=buckets_.size())
+        if ((ix - head_ < tail_ - ix && head_ > 0) || tail_>=buckets_.size())
         {
-            std::memmove(&buckets_[head_-1], &buckets_[head_], sizeof(value_type)*(ix-head_));
+            std::move(position(head_), position(ix), position(head_-1));
             --head_;
             buckets_[ix-1] = std::make_pair(key, val);
             return &buckets_[ix-1].second;
         }
 
-        std::memmove(&buckets_[ix+1], &buckets_[ix], sizeof(value_type)*(tail_-ix));
+        std::move_backward(position(ix), position(tail_), position(tail_+1));
         ++tail_;
         buckets_[ix] = std::make_pair(key, val);
         return &buckets_[ix].second;
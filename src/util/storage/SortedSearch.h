@@ -0,0 +1,270 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file SortedSearch.h
+ * @library alt_util
+ * @brief Defines search kernels on sorted ranges of arithmetic keys used by
+ * SortedArray and SortedBuckets. A search counts the keys ordered before the
+ * searched key:
+ *    - ranges up to LINEAR_SEARCH_MAX keys are scanned with no branch on the
+ *      keys. Contiguous integral keys are compared 4 or 8 at a time with SSE or
+ *      AVX2 compares
+ *    - larger ranges are searched by a binary search in which the next position
+ *      is selected by a conditional move instead of a branch, and both possible
+ *      next middle keys are prefetched
+ * A search on a few hundred keys, such as price levels of an order book, then
+ * costs no branch misprediction.
+ */
+
+#include <util/system/Platform.h>       // for ALT_INLINE
+#include <util/numeric/Intrinsics.h>    // for bitsCount
+#include <stddef.h>
+#include <stdint.h>
+#include <type_traits>                  // for is_integral, is_arithmetic
+#include <limits>                       // for numeric_limits
+#include <functional>                   // for less, greater
+#if defined(__SSE2__)
+#include <immintrin.h>                  // for _mm_cmpgt_epi32, _mm256_cmpgt_epi64
+#endif
+
+namespace alt {
+
+/**
+ * \struct SortedSearch
+ * \ingroup StorageUtils
+ * \brief Search kernels on a sorted range of keys of an arithmetic type.
+ * \tparam Key the key type
+ * \tparam Ascending true if keys are in ascending order, false if descending
+ */
+template <typename Key, bool Ascending>
+struct SortedSearch
+{
+    static_assert(std::is_arithmetic<Key>::value, "SortedSearch requires arithmetic keys");
+
+    /// ranges up to this size are scanned linearly
+    constexpr static size_t LINEAR_SEARCH_MAX = 32;
+
+    /// \brief returns the number of leading keys ordered before x, i.e. the index
+    /// of the first key equal to or ordered after x (std::lower_bound)
+    /// \param data the elements in the range
+    /// \param key_of a callable returning the key of an element
+    template <typename Elem, typename KeyOf>
+    static size_t lowBound(const Elem* data, size_t num, Key x, KeyOf key_of)
+    {
+        return partition<false>(data, num, x, key_of);
+    }
+
+    /// \brief returns the number of leading keys ordered before or equal to x,
+    /// i.e. the index of the first key ordered after x (std::upper_bound)
+    template <typename Elem, typename KeyOf>
+    static size_t upBound(const Elem* data, size_t num, Key x, KeyOf key_of)
+    {
+        return partition<true>(data, num, x, key_of);
+    }
+
+    static size_t lowBound(const Key* keys, size_t num, Key x)
+    {
+        return lowBound(keys, num, x, KeySelf());
+    }
+
+    static size_t upBound(const Key* keys, size_t num, Key x)
+    {
+        return upBound(keys, num, x, KeySelf());
+    }
+
+  private:
+    struct KeySelf
+    {
+        Key operator()(Key key) const { return key; }
+    };
+
+    template <bool Inclusive>
+    static bool before(Key key, Key x)
+    {
+        if constexpr (Ascending)
+        {
+            return Inclusive ? key <= x : key < x;
+        }
+        else
+        {
+            return Inclusive ? key >= x : key > x;
+        }
+    }
+
+    template <bool Inclusive, typename Elem, typename KeyOf>
+    static size_t partition(const Elem* data, size_t num, Key x, KeyOf key_of)
+    {
+        if (num <= LINEAR_SEARCH_MAX)
+        {
+            if constexpr (std::is_same<Elem, Key>::value && std::is_same<KeyOf, KeySelf>::value)
+            {
+                return linearCount<Inclusive>(data, num, x);
+            }
+            size_t count = 0;
+            for (size_t ix = 0; ix < num; ++ix)
+            {
+                count += before<Inclusive>(key_of(data[ix]), x);
+            }
+            return count;
+        }
+        const Elem* base = data;
+        while (num > 1)
+        {
+            size_t half = num / 2;
+            size_t next_half = (num - half) / 2;
+            __builtin_prefetch(base + next_half);
+            __builtin_prefetch(base + half + next_half);
+            base = before<Inclusive>(key_of(base[half]), x) ? base + half : base;
+            num -= half;
+        }
+        return (base - data) + before<Inclusive>(key_of(*base), x);
+    }
+
+    /// \brief counts keys ordered before x on contiguous keys. Only integral keys
+    /// of 4 or 8 bytes are counted with SIMD compares
+    template <bool Inclusive>
+    static size_t linearCount(const Key* keys, size_t num, Key x)
+    {
+        if constexpr (std::is_integral<Key>::value && (sizeof(Key)==4 || sizeof(Key)==8))
+        {
+            // before(key) is key<x, key<=x, key>x or key>=x. The inclusive cases are
+            // counted as the complement of the opposite strict case
+            constexpr bool COUNT_GREATER = Ascending == Inclusive;
+            size_t count = simdCount<COUNT_GREATER>(keys, num, x);
+            return Inclusive ? num - count : count;
+        }
+        else
+        {
+            size_t count = 0;
+            for (size_t ix = 0; ix < num; ++ix)
+            {
+                count += before<Inclusive>(keys[ix], x);
+            }
+            return count;
+        }
+    }
+
+    /// \brief counts keys greater than x if Greater is true, or less than x
+    template <bool Greater>
+    static size_t simdCount(const Key* keys, size_t num, Key x)
+    {
+        size_t count = 0;
+        size_t ix = 0;
+#if defined(__AVX2__) || defined(__SSE2__)
+        using Signed = std::make_signed_t<Key>;
+        // unsigned keys are compared as signed after flipping the sign bit
+        constexpr Signed BIAS = std::is_signed<Key>::value ? Signed(0) : std::numeric_limits<Signed>::min();
+        Signed bx = Signed(x) ^ BIAS;
+#endif
+#if defined(__AVX2__)
+        constexpr size_t WIDTH = 32 / sizeof(Key);
+        __m256i vx = sizeof(Key)==8 ? _mm256_set1_epi64x(bx) : _mm256_set1_epi32(int32_t(bx));
+        __m256i vbias = sizeof(Key)==8 ? _mm256_set1_epi64x(BIAS) : _mm256_set1_epi32(int32_t(BIAS));
+        for (; ix + WIDTH <= num; ix += WIDTH)
+        {
+            __m256i v = _mm256_xor_si256(
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + ix)), vbias);
+            __m256i gt;
+            if constexpr (sizeof(Key)==8)
+            {
+                gt = Greater ? _mm256_cmpgt_epi64(v, vx) : _mm256_cmpgt_epi64(vx, v);
+            }
+            else
+            {
+                gt = Greater ? _mm256_cmpgt_epi32(v, vx) : _mm256_cmpgt_epi32(vx, v);
+            }
+            count += bitsCount(uint32_t(_mm256_movemask_epi8(gt))) / sizeof(Key);
+        }
+#elif defined(__SSE2__)
+        if constexpr (sizeof(Key)==4 || HAS_CMPGT_EPI64)
+        {
+            constexpr size_t WIDTH = 16 / sizeof(Key);
+            __m128i vx, vbias;
+            if constexpr (sizeof(Key)==8)
+            {
+                vx = _mm_set1_epi64x(bx);
+                vbias = _mm_set1_epi64x(BIAS);
+            }
+            else
+            {
+                vx = _mm_set1_epi32(int32_t(bx));
+                vbias = _mm_set1_epi32(int32_t(BIAS));
+            }
+            for (; ix + WIDTH <= num; ix += WIDTH)
+            {
+                __m128i v = _mm_xor_si128(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(keys + ix)), vbias);
+                count += bitsCount(uint32_t(_mm_movemask_epi8(cmpGreater(
+                            Greater ? v : vx, Greater ? vx : v)))) / sizeof(Key);
+            }
+        }
+#endif
+        for (; ix < num; ++ix)
+        {
+            count += Greater ? keys[ix] > x : keys[ix] < x;
+        }
+        return count;
+    }
+
+#if !defined(__AVX2__) && defined(__SSE2__)
+#if defined(__SSE4_2__)
+    constexpr static bool HAS_CMPGT_EPI64 = true;
+#else
+    constexpr static bool HAS_CMPGT_EPI64 = false;
+#endif
+
+    static __m128i cmpGreater(__m128i x, __m128i y)
+    {
+#if defined(__SSE4_2__)
+        if constexpr (sizeof(Key)==8)
+        {
+            return _mm_cmpgt_epi64(x, y);
+        }
+#endif
+        return _mm_cmpgt_epi32(x, y);
+    }
+#endif
+};
+
+/**
+ * \struct SortedCompareOrder
+ * \ingroup StorageUtils
+ * \brief Tells the order of a compare type used by a sorted container. The order is
+ * known for std::less, std::greater and a compare type defining a static constexpr
+ * bool ASCENDING. When the order is known and keys are arithmetic, the container
+ * searches with SortedSearch.
+ */
+template <class Compare, typename = void>
+struct SortedCompareOrder
+{
+    constexpr static bool KNOWN = false;
+    constexpr static bool ASCENDING = true;
+};
+
+template <typename T>
+struct SortedCompareOrder<std::less<T>>
+{
+    constexpr static bool KNOWN = true;
+    constexpr static bool ASCENDING = true;
+};
+
+template <typename T>
+struct SortedCompareOrder<std::greater<T>>
+{
+    constexpr static bool KNOWN = true;
+    constexpr static bool ASCENDING = false;
+};
+
+template <class Compare>
+struct SortedCompareOrder<Compare, std::void_t<decltype(Compare::ASCENDING)>>
+{
+    constexpr static bool KNOWN = true;
+    constexpr static bool ASCENDING = Compare::ASCENDING;
+};
+
+} // namespace alt
@@ -8,44 +8,103 @@
 /**
  * @file StringHashMap.h
  * @library alt_util
- * @brief Defines a string key hash using fixed pools to reduce heap allocation at
- * run time. The key is a char pointer that points to the position in a string pool
+ * @brief Defines a string key hash map on FlatHash with keys kept in a string
+ * pool. The hash and the length of a key are computed once and stored with the
+ * key, so that a lookup compares the hash and the length before any byte of the
+ * key, and compares the bytes with fixed-size or SSE comparisons
  */
 
-#include <util/Defs.h>              // for ALT_UTIL_PUBLIC
-#include "Allocator.h"
-#include "util/string/StrBuffer.h"
-#include "util/string/StrPool.h"
-#include <unordered_map>
+#include <util/Defs.h>                  // for ALT_UTIL_PUBLIC
+#include "FlatHash.h"                   // for FlatHash
+#include <util/string/StrBuffer.h>      // for strHash
+#include <util/string/StrUtils.h>       // for strEqual
+#include <util/string/StrPool.h>        // for StrPool
+#include <string>                       // for string
+#include <string_view>                  // for string_view
+#include <stdexcept>                    // for out_of_range
 
 namespace alt
 {
 
 /**
- * \brief Defines a string key hash using fixed pools. This is a wrapper of
- * std::unordered_map with a string pool to store the key.
- * TODO: consider to use PooledHash for more efficiency?
+ * \struct StrHashKey
+ * \ingroup ContainerUtils
+ * \brief A string key with its length and hash. A StrHashKey can be made from a
+ * string_view without copying the string, which allows lookups with any kind of
+ * string without allocation.
  */
-template <typename T, class Allocator = StdFixedPoolAllocator< std::pair<const StrRef, T> > >
+struct StrHashKey
+{
+    const char*     str_ {nullptr};
+    uint32_t        length_ {0};
+    uint32_t        hash_ {0};
+
+    StrHashKey() = default;
+    StrHashKey(const char* str, size_t length)
+        : str_(str)
+        , length_(uint32_t(length))
+        , hash_(uint32_t(strHash(str, length)))
+    {}
+    StrHashKey(std::string_view str) : StrHashKey(str.data(), str.length()) {}
+    StrHashKey(const char* str) : StrHashKey(str, std::strlen(str)) {}
+    StrHashKey(const std::string& str) : StrHashKey(str.c_str(), str.length()) {}
+
+    /// \brief returns the key string. Null-terminated for keys in a StringHashMap
+    const char* c_str() const { return str_; }
+    size_t length() const { return length_; }
+    std::string_view view() const { return std::string_view(str_, length_); }
+
+    bool operator==(const StrHashKey& oth) const
+    {
+        return hash_==oth.hash_ && length_==oth.length_ && strEqual(str_, oth.str_, length_);
+    }
+    bool operator!=(const StrHashKey& oth) const { return !(*this==oth); }
+
+    static size_t hashOf(const StrHashKey& key) { return key.hash_; }
+};
+
+/**
+ * \struct StringHashMapEntry
+ * \ingroup ContainerUtils
+ * \brief The value type of StringHashMap. Like std::pair, first is the key and
+ * second is the mapped value.
+ */
+template <typename T>
+struct StringHashMapEntry
+{
+    StrHashKey      first;
+    T               second;
+
+    template <typename... Args>
+    StringHashMapEntry(const StrHashKey& key, Args&&... args)
+        : first(key), second(std::forward<Args>(args)...)
+    {}
+
+    MAKE_POOLED_HASH_ENTRY(StrHashKey, first, StrHashKey::hashOf);
+};
+
+/**
+ * \class StringHashMap
+ * \ingroup ContainerUtils
+ * \brief Defines a string key hash map. Keys are copied into a string pool and
+ * entries are stored inline in a FlatHash.
+ * \tparam T the mapped type. Must be move constructible as entries are moved
+ * when the table grows.
+ * \note Iterators are invalidated by insertion. Key strings stay in the pool
+ * until the keys are erased, so key pointers stay valid across insertions.
+ */
+template <typename T>
 class ALT_UTIL_PUBLIC StringHashMap
 {
   public:
-    using key_type          = StrRef;
+    using key_type          = StrHashKey;
     using mapped_type       = T;
-    using value_type        = std::pair<const StrRef, T>;
+    using value_type        = StringHashMapEntry<T>;
     using size_type         = size_t;
 
-    using map_type    =
-          std::unordered_map<StrRef,
-                       T,
-                       std::hash<StrRef>,
-                       std::equal_to<StrRef>,
-                       Allocator
-                      >;
-
-    using iterator           = typename map_type::iterator;
-    using const_iterator     = typename map_type::const_iterator;
-    using insert_return_type = typename map_type::insert_return_type;
+    using map_type          = FlatHash<value_type>;
+    using iterator          = typename map_type::iterator;
+    using const_iterator    = typename map_type::const_iterator;
 
   protected:
     map_type                          hash_map_;
@@ -53,7 +112,7 @@ class ALT_UTIL_PUBLIC StringHashMap
 
   public:
     iterator begin() noexcept { return hash_map_.begin(); }
-    const_iterator begin() const noexcept  { return hash_map_.begin(); }
+    const_iterator begin() const noexcept { return hash_map_.begin(); }
     const_iterator cbegin() const noexcept  { return hash_map_.cbegin(); }
     iterator end() noexcept { return hash_map_.end(); }
     const_iterator end() const noexcept { return hash_map_.end(); }
@@ -61,86 +120,85 @@ class ALT_UTIL_PUBLIC StringHashMap
 
     bool empty() const noexcept { return hash_map_.empty(); }
     size_type size() const noexcept { return hash_map_.size(); }
-    size_type max_size() const noexcept { return hash_map_.max_size(); }
 
-    template <typename KeyT>
-    iterator find(const KeyT& key) { return hash_map_.find(StrRef(key)); }
+    /// \brief find the entry by a key of const char*, std::string, std::string_view
+    /// or StrHashKey. The key is not copied.
+    iterator find(const StrHashKey& key) { return hash_map_.find(key); }
+    const_iterator find(const StrHashKey& key) const { return hash_map_.find(key); }
 
-    template <typename KeyT>
-    const_iterator find(const KeyT& key) const { return hash_map_.find(StrRef(key)); }
-
-    std::pair<iterator, bool> insert(const value_type& value)
-    {
-        const auto [iter, inserted] = hash_map_.insert(value);
-        if (inserted)
-        {
-            // replace key with pointer in string pool
-            *const_cast<StrRef*>(&iter->first) = StrRef(string_pool_.insert(value.first.c_str()));
-        }
-        return std::make_pair(iter, inserted);
-    }
-
-    std::pair<iterator, bool> emplace(const char * key, mapped_type value)
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(const StrHashKey& key, Args&&... args)
     {
-        return insert(std::make_pair(StrRef(key), value));
+        return try_emplace(key, std::forward<Args>(args)...);
     }
 
+    /// \brief inserts an entry with the mapped value constructed from args if the
+    /// key is not in the map. Otherwise nothing is constructed
     template <typename... Args>
-    std::pair<iterator, bool> try_emplace(char const* key, Args&&... args)
+    std::pair<iterator, bool> try_emplace(const StrHashKey& key, Args&&... args)
     {
-        const auto [iter, inserted] =
-            hash_map_.try_emplace(StrRef(key), std::forward<Args>(args)...);
-        if (inserted)
+        auto res = hash_map_.try_emplace(key, std::forward<Args>(args)...);
+        if (res.second)
         {
-            // replace key with pointer in string pool
-            *const_cast<StrRef*>(&iter->first) = StrRef(string_pool_.insert(key));
+            // the entry is made with the key of the caller. Keep its bytes in the
+            // pool, which changes neither the hash nor the length
+            res.first->first.str_ = string_pool_.insert(key.str_, key.length_);
         }
-        return std::make_pair(iter, inserted);
+        return res;
     }
 
     iterator erase(const_iterator pos)
     {
-        string_pool_.erase(pos->first.c_str());
-        return hash_map_.erase(pos);
+        StrHashKey key = pos->first;
+        iterator next = hash_map_.erase(pos);
+        string_pool_.erase(key.str_, key.length_);
+        return next;
     }
 
     iterator erase(const_iterator first, const_iterator last)
     {
-        for (auto iter=first; iter!=last;)
+        for (auto iter=first; iter!=last; ++iter)
         {
-           iter = erase(iter);
+            string_pool_.erase(iter->first.str_, iter->first.length_);
         }
+        return hash_map_.erase(first, last);
     }
 
-    size_type erase(char const* key)
+    size_type erase(const StrHashKey& key)
     {
-        auto iter = hash_map_.find(StrRef(key));
+        auto iter = hash_map_.find(key);
         if (iter==hash_map_.end()) return 0;
         erase(iter);
         return 1;
     }
 
-    std::pair<iterator, bool> rename(const char* old_name, const char* new_name)
+    /// \brief changes the key of an entry
+    /// \return the iterator to the renamed entry and true. If old_name is not found,
+    /// returns end() and false; if new_name is already in the map, returns the
+    /// iterator to that entry and false, and the entry of old_name is unchanged
+    std::pair<iterator, bool> rename(const StrHashKey& old_name, const StrHashKey& new_name)
     {
-        auto pos = hash_map_.find(StrRef(old_name));
+        auto pos = hash_map_.find(old_name);
         if (pos==hash_map_.end())
         {
             return std::make_pair(pos, false);
         }
-        auto node = hash_map_.extract(pos);
-        string_pool_.erase(pos->first.c_str());
-        const char* new_pooled_str = string_pool_.insert(new_name);
-        node.key() = StrRef(new_pooled_str);
-        auto insert_status = hash_map_.insert(move(node));
-        return std::make_pair(insert_status.position, insert_status.inserted);
+        auto new_pos = hash_map_.find(new_name);
+        if (new_pos!=hash_map_.end())
+        {
+            return std::make_pair(new_pos, false);
+        }
+        T value(std::move(pos->second));
+        erase(pos);
+        return try_emplace(new_name, std::move(value));
     }
 
-    T& operator[](char const* key) { return hash_map_[StrRef(key)]; }
-    T& at(char const* key) { return hash_map_.at(StrRef(key)); }
-    const T& at(char const* key) const { return hash_map_.at(StrRef(key)); }
+    T& operator[](const StrHashKey& key) { return try_emplace(key).first->second; }
+
+    T& at(const StrHashKey& key) { return findExisting(hash_map_, key)->second; }
+    const T& at(const StrHashKey& key) const { return findExisting(hash_map_, key)->second; }
 
-    template <typename KeyT>
-    bool contains(const KeyT& key) const { return find(key)!=hash_map_.end(); }
+    bool contains(const StrHashKey& key) const { return hash_map_.contains(key); }
 
     void clear()
     {
@@ -148,18 +206,25 @@ class ALT_UTIL_PUBLIC StringHashMap
         string_pool_.clear();
     }
 
-    size_type bucket_count() const { return hash_map_.bucket_count(); }
-    size_type max_bucket_count() const { return hash_map_.max_bucket_count(); }
-    size_type bucket_size(size_type n) const { return hash_map_.bucket_size(n); }
-    size_type bucket(const char* key) const { return hash_map_.bucket(StrRef(key)); }
-    float load_factor() const { return hash_map_.load_factor(); }
-    float max_load_factor() const { return hash_map_.max_load_factor(); }
-    void max_load_factor(float ml) { hash_map_.max_load_factor(ml); }
-    void reserve(size_type count) { return hash_map_.reserve(count); }
-    void rehash(size_type count) { return hash_map_.rehash(count); }
+    size_type bucket_count() const { return hash_map_.capacity(); }
+    float load_factor() const { return float(hash_map_.size()) / hash_map_.capacity(); }
+    void reserve(size_type count) { hash_map_.reserve(count); }
+    void rehash(size_type count) { hash_map_.reserve(count); }
 
     StrPool & getStringPool() { return string_pool_; }
+
+  private:
+    template <typename Map>
+    static auto findExisting(Map& map, const StrHashKey& key)
+    {
+        auto iter = map.find(key);
+        if (iter==map.end())
+        {
+            throw std::out_of_range(std::string("StringHashMap key not found: ") +
+                                    std::string(key.view()));
+        }
+        return iter;
+    }
 };
 
 }
-
@@ -12,6 +12,8 @@
  * Strings are pointers that points to the position in a string pool
  * where the space is not freed for new string. Therefore, the map is suitable
  * for the usage where erase is not required.
+ * For one writer and many reader threads, use RcuTranslationMap in
+ * RcuStringHashMap.h.
  */
 
 #include "Allocator.h"
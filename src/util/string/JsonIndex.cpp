@@ -0,0 +1,174 @@
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+#include "JsonIndex.h"
+#include <util/numeric/Intrinsics.h>    // for ctz
+#include <cstring>                      // for memcpy, memset
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace alt
+{
+
+namespace
+{
+
+/// bit masks of character classes of a block of 64 bytes
+struct JsonBlockMasks
+{
+    uint64_t    quote_;
+    uint64_t    backslash_;
+    uint64_t    structural_;
+    uint64_t    whitespace_;
+};
+
+#if defined(__AVX2__)
+uint64_t mask32(__m256i v, char ch)
+{
+    return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(ch))));
+}
+
+void classify(const char* block, JsonBlockMasks& masks)
+{
+    masks = JsonBlockMasks{0, 0, 0, 0};
+    for (int half = 0; half < 2; ++half)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + half*32));
+        // '[' and ']' are '{' and '}' with the 0x20 bit cleared
+        __m256i lower = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+        int shift = half*32;
+        masks.quote_ |= mask32(v, '"') << shift;
+        masks.backslash_ |= mask32(v, '\\') << shift;
+        masks.structural_ |= (mask32(lower, '{') | mask32(lower, '}') |
+                              mask32(v, ':') | mask32(v, ',')) << shift;
+        masks.whitespace_ |= (mask32(v, ' ') | mask32(v, '\t') |
+                              mask32(v, '\n') | mask32(v, '\r')) << shift;
+    }
+}
+#elif defined(__SSE2__)
+uint64_t mask16(__m128i v, char ch)
+{
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(ch))));
+}
+
+void classify(const char* block, JsonBlockMasks& masks)
+{
+    masks = JsonBlockMasks{0, 0, 0, 0};
+    for (int quarter = 0; quarter < 4; ++quarter)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + quarter*16));
+        // '[' and ']' are '{' and '}' with the 0x20 bit cleared
+        __m128i lower = _mm_or_si128(v, _mm_set1_epi8(0x20));
+        int shift = quarter*16;
+        masks.quote_ |= mask16(v, '"') << shift;
+        masks.backslash_ |= mask16(v, '\\') << shift;
+        masks.structural_ |= (mask16(lower, '{') | mask16(lower, '}') |
+                              mask16(v, ':') | mask16(v, ',')) << shift;
+        masks.whitespace_ |= (mask16(v, ' ') | mask16(v, '\t') |
+                              mask16(v, '\n') | mask16(v, '\r')) << shift;
+    }
+}
+#else
+void classify(const char* block, JsonBlockMasks& masks)
+{
+    masks = JsonBlockMasks{0, 0, 0, 0};
+    for (int ix = 0; ix < 64; ++ix)
+    {
+        char ch = block[ix];
+        uint64_t bit = uint64_t(1) << ix;
+        if (ch == '"') masks.quote_ |= bit;
+        else if (ch == '\\') masks.backslash_ |= bit;
+        else if (ch=='{' || ch=='}' || ch=='[' || ch==']' || ch==':' || ch==',') masks.structural_ |= bit;
+        else if (ch==' ' || ch=='\t' || ch=='\n' || ch=='\r') masks.whitespace_ |= bit;
+    }
+}
+#endif
+
+/// \brief returns the bits of characters escaped by an odd length sequence of
+/// backslashes. A sequence starting at an even position ends escaping at an odd
+/// position after adding its start bit, and vice versa
+uint64_t findEscaped(uint64_t backslash, uint64_t& prev_ends_odd_backslash)
+{
+    constexpr uint64_t EVEN_BITS = 0x5555555555555555ULL;
+    constexpr uint64_t ODD_BITS = ~EVEN_BITS;
+    uint64_t start_edges = backslash & ~(backslash << 1);
+    // a sequence continued from the previous block flips the parity of its start
+    uint64_t even_start_mask = EVEN_BITS ^ prev_ends_odd_backslash;
+    uint64_t even_starts = start_edges & even_start_mask;
+    uint64_t odd_starts = start_edges & ~even_start_mask;
+    uint64_t even_carries = backslash + even_starts;
+    uint64_t odd_carries;
+    bool ends_odd_backslash = __builtin_add_overflow(backslash, odd_starts, &odd_carries);
+    odd_carries |= prev_ends_odd_backslash;
+    prev_ends_odd_backslash = ends_odd_backslash ? 1 : 0;
+    uint64_t even_carry_ends = even_carries & ~backslash;
+    uint64_t odd_carry_ends = odd_carries & ~backslash;
+    return (even_carry_ends & ODD_BITS) | (odd_carry_ends & EVEN_BITS);
+}
+
+/// \brief returns the xor of all bits at and below each bit
+uint64_t prefixXor(uint64_t bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+} // namespace
+
+bool JsonStructuralIndex::build(const char* json, size_t length)
+{
+    positions_.clear();
+    // about one token in 6 to 8 bytes in typical Json
+    positions_.reserve(length / 6 + 16);
+
+    uint64_t prev_ends_odd_backslash = 0;
+    uint64_t prev_in_string = 0;        // all ones if the previous block ends in a string
+    uint64_t prev_scalar = 0;           // 1 if the previous block ends in a scalar
+    JsonBlockMasks masks;
+    char tail[64];
+    for (size_t base = 0; base < length; base += 64)
+    {
+        const char* block = json + base;
+        if (base + 64 > length)
+        {
+            // pad the last block with spaces
+            std::memset(tail, ' ', sizeof(tail));
+            std::memcpy(tail, block, length - base);
+            block = tail;
+        }
+        classify(block, masks);
+
+        uint64_t escaped = findEscaped(masks.backslash_, prev_ends_odd_backslash);
+        uint64_t quote = masks.quote_ & ~escaped;
+        // in_string covers opening quotes and string contents, but not closing quotes
+        uint64_t in_string = prefixXor(quote) ^ prev_in_string;
+        prev_in_string = uint64_t(int64_t(in_string) >> 63);
+
+        uint64_t structural = masks.structural_ & ~in_string;
+        uint64_t string_start = quote & in_string;
+        uint64_t scalar = ~(masks.structural_ | masks.whitespace_ | quote | in_string);
+        uint64_t scalar_start = scalar & ~((scalar << 1) | prev_scalar);
+        prev_scalar = scalar >> 63;
+
+        flatten(structural | string_start | scalar_start, uint32_t(base));
+    }
+    return prev_in_string == 0;
+}
+
+void JsonStructuralIndex::flatten(uint64_t bits, uint32_t base)
+{
+    for (; bits; bits &= bits - 1)
+    {
+        positions_.push_back(base + uint32_t(ctz(bits)));
+    }
+}
+
+} // namespace alt
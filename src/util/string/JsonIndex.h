@@ -0,0 +1,59 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file JsonIndex.h
+ * @library alt_util
+ * @brief Defines the structural index of a Json text, the first stage of the
+ * two-stage Json parsing. The text is classified 64 bytes at a time with SSE2 or
+ * AVX2 compares into bit masks of quotes, backslashes, structural characters and
+ * whitespaces. Escaped quotes and the inside of strings are then found with bit
+ * operations on the masks, without a branch per character. The index lists the
+ * positions of:
+ *    - structural characters { } [ ] : , outside strings
+ *    - the opening quote of each string
+ *    - the first character of each number, true, false or null
+ * The second stage visits the positions in order to build the tree. See
+ * JsonParser::parseIndexed.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace alt
+{
+
+/**
+ * \class JsonStructuralIndex
+ * \ingroup StringUtils
+ * \brief Positions of Json tokens in a text in memory
+ * \note The text must be shorter than 4GB as positions are 32-bit.
+ */
+class JsonStructuralIndex
+{
+  public:
+    /// \brief builds the index of a Json text
+    /// \return false if the text ends inside a string
+    bool build(const char* json, size_t length);
+
+    /// \brief returns the number of positions in the index
+    size_t size() const { return positions_.size(); }
+
+    /// \brief returns the position of the nth token
+    uint32_t operator[](size_t n) const { return positions_[n]; }
+
+    const std::vector<uint32_t>& positions() const { return positions_; }
+
+  private:
+    /// \brief adds positions of a block of 64 bytes from the bit masks
+    void flatten(uint64_t bits, uint32_t base);
+
+    std::vector<uint32_t>   positions_;
+};
+
+} // namespace alt
@@ -7,6 +7,8 @@
 #include "JsonParser.h"
 #include "StrPrint.h"
 #include <util/types/TemplateHelper.h>    // for overloaded
+#include <cstring>                      // for memchr
+#include <limits>                       // for numeric_limits
 
 namespace alt
 {
@@ -88,7 +90,10 @@ bool JsonParser::parseArray (JsonArray* array)
         {
             return false;
         }
-        array->value_.push_back(value);
+        if (value != array)
+        {
+            array->value_.push_back(value);
+        }
         getToken();
         if (tk_ == JsonToken::RBracket)
         {
@@ -156,7 +161,12 @@ PooledNamedNode* JsonParser::parseValue(const std::string& value_name, PooledNam
         }
         else if (scanned<4>("null"))
         {
-            // null value, ignore
+            // null value is ignored, the parent is returned as no error
+            n = parent;
+        }
+        else
+        {
+            context_.registerError("Unknow json name");
         }
     }
     else
@@ -176,7 +186,7 @@ JsonParser::JsonToken JsonParser::getToken ()
     //           << " length=" << scan_buffer_.length()
     //           << " pos=" << scan_buffer_.pos_ << std::endl;
 
-    char ch = skipWhiteSpace();
+    char ch = index_ ? nextIndexed() : skipWhiteSpace();
 
     if (!ch)
     {
@@ -204,7 +214,10 @@ JsonParser::JsonToken JsonParser::getToken ()
             // used by StrScan::getString() is compatible to Json string, but is a super
             // set. It handles more control characters, especially, \U for unicode that 
             // requires more than 4 bytes.
-            StrScan::getString();
+            if (!index_ || !getIndexedString())
+            {
+                StrScan::getString();
+            }
             tk_ = JsonToken::Value_String;
             break;
 
@@ -218,13 +231,16 @@ JsonParser::JsonToken JsonParser::getToken ()
         case 'f':
         case 'n':
         {
+            tv_.start_pos_ = scan_buffer_.curPos();
             scan_buffer_.advance();
             ch = scan_buffer_.curChar();
             while ((ch>='a' && ch<='z') || (ch>='A' && ch<='Z'))
             {
                 ch = scan_buffer_.nextChar();
             }
+            tv_.end_pos_ = scan_buffer_.curPos();
             tk_ = JsonToken::Value_Name;
+            break;
         }
 
         default:
@@ -236,10 +252,71 @@ JsonParser::JsonToken JsonParser::getToken ()
     return tk_;
 }
 
+char JsonParser::nextIndexed ()
+{
+    if (index_pos_ >= index_->size())
+    {
+        scan_buffer_.resetPos(scan_buffer_.length());
+        return '\0';
+    }
+    scan_buffer_.resetPos((*index_)[index_pos_++]);
+    return scan_buffer_.curChar();
+}
+
+bool JsonParser::getIndexedString ()
+{
+    // The closing quote is before the next token in the index. A string without
+    // any escape is copied as is, otherwise it is left to StrScan::getString
+    const char* start = scan_buffer_.curPos() + 1;
+    size_t end_pos = index_pos_ < index_->size() ? (*index_)[index_pos_] : scan_buffer_.length();
+    const char* end = scan_buffer_.head() + end_pos;
+    auto quote = static_cast<const char*>(memchr(start, '"', size_t(end - start)));
+    if (!quote || memchr(start, '\\', size_t(quote - start)))
+    {
+        return false;
+    }
+    tv_.string_.assign(start, size_t(quote - start));
+    tv_.vt_ = STRING;
+    tv_.start_pos_ = start - 1;
+    tv_.end_pos_ = quote + 1;
+    scan_buffer_.resetPos(size_t(quote + 1 - scan_buffer_.head()));
+    return true;
+}
+
+JsonObject* JsonParser::parseIndexed()
+{
+    JsonStructuralIndex index;
+    if (!index.build(scan_buffer_.head(), scan_buffer_.length()))
+    {
+        context_.registerError("missing closing quote");
+        return nullptr;
+    }
+    index_ = &index;
+    index_pos_ = 0;
+    JsonObject* root = parse();
+    index_ = nullptr;
+    return root;
+}
+
+JsonObject* JsonParser::parseIndexed(const char* json, size_t length)
+{
+    ParserStreamContext context;
+    JsonParser parser(context, json, length);
+    return parser.parseIndexed();
+}
+
 JsonObject* JsonParser::parseFile(const char* file_path)
 {
     ParserStreamContext context;
     JsonParser parser(context);
+    if (context.pushMappedFileParser (&parser, file_path))
+    {
+        // the whole file is in memory: index it as a text in memory unless the
+        // positions do not fit in the index
+        return parser.scan_buffer_.length() <= std::numeric_limits<uint32_t>::max()
+            ? parser.parseIndexed() : parser.parse();
+    }
+    // not a regular file, read it by lines
     if (!context.pushFileParser (&parser, file_path))
     {
         return nullptr;
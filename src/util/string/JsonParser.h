@@ -15,6 +15,7 @@
  */
 
 #include "StreamParser.h"
+#include "JsonIndex.h"
 #include <util/storage/NamedTreeNode.h>
 #include <variant>
 
@@ -252,7 +253,10 @@ class JsonDouble: public PooledNamedNode
 /**
  * \class JsonParser
  * \ingroup StringUtils
- * \brief A Json string/file parser to convert Json text into a tree structure
+ * \brief A Json string/file parser to convert Json text into a tree structure.
+ * A Json text in memory can also be parsed in two stages by parseIndexed: a
+ * JsonStructuralIndex is built with SIMD first, and the tree is then built by
+ * jumping from token to token in the index instead of scanning each character.
  */ 
 class JsonParser: public StreamParser
 {
@@ -263,11 +267,18 @@ class JsonParser: public StreamParser
     /// calling this function. Text stream can be set i constructor. See StreamParser
     JsonObject* parse ();
 
-    /// \brief parse the json file. If there is a text stream already set, this will
-    /// push the existing stream into a stack and make this file stream for the current
-    /// stream if the file stream is created successfully.
+    /// \brief parse the json file. The file is memory mapped and parsed in place
+    /// in two stages as parseIndexed does. A file that cannot be mapped, such as a
+    /// pipe, is read line by line.
     static JsonObject* parseFile(const char* file_path);
 
+    /// \brief parse the json text in memory set in constructor in two stages. The
+    /// tree built is the same as built by parse
+    JsonObject* parseIndexed ();
+
+    /// \brief parse the json text in memory in two stages. See parseIndexed()
+    static JsonObject* parseIndexed(const char* json, size_t length);
+
   private:
 
     enum class JsonToken : uint16_t
@@ -287,11 +298,17 @@ class JsonParser: public StreamParser
     };
     
     JsonToken getToken ();
+    char nextIndexed ();
+    bool getIndexedString ();
     bool parseObject (PooledNamedNode* parent);
     bool parseArray (JsonArray* array);
     PooledNamedNode* parseValue(const std::string& value_name, PooledNamedNode* parent);
 
     JsonToken     tk_ {JsonToken::Unknown};
+
+    // the structural index used by parseIndexed, and the next position in it
+    const JsonStructuralIndex*  index_ {nullptr};
+    size_t                      index_pos_ {0};
 };
 
 } // namespace alt
@@ -0,0 +1,482 @@
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+#include "JsonPushParser.h"
+#include "StrUtils.h"                   // for wcharToUTF8
+#include <util/numeric/Intrinsics.h>    // for ctz
+#include <util/numeric/FastFloat.h>     // for parseDouble
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace alt
+{
+
+namespace
+{
+
+bool isJsonSpace(char ch) { return ch==' ' || ch=='\t' || ch=='\n' || ch=='\r'; }
+
+bool isNumberChar(char ch)
+{
+    return (ch>='0' && ch<='9') || ch=='-' || ch=='+' || ch=='.' || ch=='e' || ch=='E';
+}
+
+/// \return the first quote or backslash in [p, end), or end if none
+const char* findQuoteOrBackslash(const char* p, const char* end)
+{
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; p + 16 <= end; p += 16)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash))));
+        if (mask)
+        {
+            return p + ctz(mask);
+        }
+    }
+#endif
+    while (p < end && *p != '"' && *p != '\\')
+    {
+        ++p;
+    }
+    return p;
+}
+
+int hexValue(char ch)
+{
+    if (ch>='0' && ch<='9') return ch - '0';
+    if (ch>='a' && ch<='f') return ch - 'a' + 10;
+    if (ch>='A' && ch<='F') return ch - 'A' + 10;
+    return -1;
+}
+
+} // namespace
+
+JsonPushParser::JsonPushParser(JsonEventListener& listener, size_t max_depth)
+    : listener_(listener)
+    , max_depth_(max_depth)
+{
+}
+
+void JsonPushParser::reset()
+{
+    state_ = State::Value;
+    stack_.clear();
+    token_.clear();
+    error_.clear();
+    high_surrogate_ = 0;
+    position_ = 0;
+}
+
+void JsonPushParser::setError(const char* pos, const char* message)
+{
+    error_ = message;
+    error_ += " at ";
+    error_ += std::to_string(position_ + size_t(pos - chunk_));
+    state_ = State::Error;
+}
+
+std::string_view JsonPushParser::tokenView(const char* end)
+{
+    if (token_.empty())
+    {
+        return std::string_view(run_, size_t(end - run_));
+    }
+    token_.append(run_, size_t(end - run_));
+    return token_;
+}
+
+void JsonPushParser::valueDone()
+{
+    if (stack_.empty())
+    {
+        listener_.onEndDocument();
+        state_ = State::Value;
+    }
+    else
+    {
+        state_ = State::Next;
+    }
+}
+
+void JsonPushParser::closeContainer(const char* p)
+{
+    char open = *p == '}' ? '{' : '[';
+    if (stack_.empty() || stack_.back() != open)
+    {
+        setError(p, "unmatched closing bracket");
+        return;
+    }
+    stack_.pop_back();
+    if (open == '{')
+    {
+        listener_.onEndObject();
+    }
+    else
+    {
+        listener_.onEndArray();
+    }
+    valueDone();
+}
+
+const char* JsonPushParser::startValue(const char* p)
+{
+    switch (*p)
+    {
+        case '{':
+        case '[':
+            if (stack_.size() >= max_depth_)
+            {
+                setError(p, "too deep");
+                return p;
+            }
+            stack_.push_back(*p);
+            if (*p == '{')
+            {
+                listener_.onStartObject();
+                state_ = State::FirstKey;
+            }
+            else
+            {
+                listener_.onStartArray();
+                state_ = State::FirstElement;
+            }
+            return p + 1;
+        case '"':
+            is_key_ = false;
+            state_ = State::String;
+            run_ = p + 1;
+            return p + 1;
+        case 't': case 'f': case 'n':
+            state_ = State::Name;
+            run_ = p;
+            return p + 1;
+        default:
+            if ((*p>='0' && *p<='9') || *p=='-')
+            {
+                state_ = State::Number;
+                run_ = p;
+                return p + 1;
+            }
+            setError(p, "expect a value");
+            return p;
+    }
+}
+
+void JsonPushParser::endNumber(const char* p)
+{
+    std::string_view text = tokenView(p);
+    bool is_double = false;
+    bool neg = text[0] == '-';
+    uint64_t integer = 0;
+    for (size_t ix = neg ? 1 : 0; ix < text.length(); ++ix)
+    {
+        char ch = text[ix];
+        if (ch < '0' || ch > '9' || integer > (uint64_t(INT64_MAX) - 9) / 10)
+        {
+            is_double = true;
+            break;
+        }
+        integer = integer * 10 + uint64_t(ch - '0');
+    }
+    if (text.length() == size_t(neg))
+    {
+        setError(p, "invalid number");
+        return;
+    }
+    if (is_double)
+    {
+        double val;
+        const char* end = parseDouble(text.data(), text.data() + text.length(), val);
+        if (end != text.data() + text.length())
+        {
+            setError(p, "invalid number");
+            return;
+        }
+        listener_.onDouble(val);
+    }
+    else
+    {
+        listener_.onInteger(neg ? -int64_t(integer) : int64_t(integer));
+    }
+    token_.clear();
+    valueDone();
+}
+
+void JsonPushParser::endName(const char* p)
+{
+    std::string_view text = tokenView(p);
+    if (text == "true" || text == "false")
+    {
+        listener_.onBool(text[0] == 't');
+    }
+    else if (text == "null")
+    {
+        listener_.onNull();
+    }
+    else
+    {
+        setError(p, "invalid name");
+        return;
+    }
+    token_.clear();
+    valueDone();
+}
+
+void JsonPushParser::appendUnicode()
+{
+    uint32_t code = code_;
+    if (code >= 0xD800 && code <= 0xDBFF)
+    {
+        // the low surrogate follows in the next \u
+        high_surrogate_ = code;
+        return;
+    }
+    if (code >= 0xDC00 && code <= 0xDFFF && high_surrogate_)
+    {
+        code = 0x10000 + ((high_surrogate_ - 0xD800) << 10) + (code - 0xDC00);
+    }
+    high_surrogate_ = 0;
+    char utf8[8];
+    token_.append(utf8, wcharToUTF8(alt_char_t(code), utf8, sizeof(utf8)));
+}
+
+bool JsonPushParser::feed(const char* data, size_t length)
+{
+    if (state_ == State::Error)
+    {
+        return false;
+    }
+    chunk_ = data;
+    const char* p = data;
+    const char* end = data + length;
+    if (inToken())
+    {
+        run_ = p;
+    }
+    while (p < end && state_ != State::Error)
+    {
+        char ch = *p;
+        switch (state_)
+        {
+            case State::Value:
+            case State::FirstElement:
+                if (isJsonSpace(ch))
+                {
+                    ++p;
+                }
+                else if (ch == ']' && state_ == State::FirstElement)
+                {
+                    closeContainer(p++);
+                }
+                else
+                {
+                    p = startValue(p);
+                }
+                break;
+
+            case State::FirstKey:
+            case State::Key:
+                if (isJsonSpace(ch))
+                {
+                    ++p;
+                }
+                else if (ch == '"')
+                {
+                    is_key_ = true;
+                    state_ = State::String;
+                    run_ = ++p;
+                }
+                else if (ch == '}' && state_ == State::FirstKey)
+                {
+                    closeContainer(p++);
+                }
+                else
+                {
+                    setError(p, "expect a key");
+                }
+                break;
+
+            case State::Colon:
+                if (isJsonSpace(ch))
+                {
+                    ++p;
+                }
+                else if (ch == ':')
+                {
+                    state_ = State::Value;
+                    ++p;
+                }
+                else
+                {
+                    setError(p, "expect colon");
+                }
+                break;
+
+            case State::Next:
+                if (isJsonSpace(ch))
+                {
+                    ++p;
+                }
+                else if (ch == ',')
+                {
+                    state_ = stack_.back() == '{' ? State::Key : State::Value;
+                    ++p;
+                }
+                else if (ch == '}' || ch == ']')
+                {
+                    closeContainer(p++);
+                }
+                else
+                {
+                    setError(p, "expect comma or closing bracket");
+                }
+                break;
+
+            case State::String:
+            {
+                const char* q = findQuoteOrBackslash(p, end);
+                if (q == end)
+                {
+                    p = end;
+                }
+                else if (*q == '"')
+                {
+                    std::string_view text = tokenView(q);
+                    if (is_key_)
+                    {
+                        listener_.onKey(text);
+                        state_ = State::Colon;
+                    }
+                    else
+                    {
+                        listener_.onString(text);
+                        valueDone();
+                    }
+                    token_.clear();
+                    p = q + 1;
+                }
+                else
+                {
+                    token_.append(run_, size_t(q - run_));
+                    state_ = State::Escape;
+                    p = q + 1;
+                }
+                break;
+            }
+
+            case State::Escape:
+                state_ = State::String;
+                switch (ch)
+                {
+                    case '"': case '\\': case '/': token_.push_back(ch); break;
+                    case 'b': token_.push_back('\b'); break;
+                    case 'f': token_.push_back('\f'); break;
+                    case 'n': token_.push_back('\n'); break;
+                    case 'r': token_.push_back('\r'); break;
+                    case 't': token_.push_back('\t'); break;
+                    case 'u':
+                        state_ = State::Unicode;
+                        hex_digits_ = 0;
+                        code_ = 0;
+                        break;
+                    default:
+                        setError(p, "invalid escape");
+                }
+                run_ = ++p;
+                break;
+
+            case State::Unicode:
+            {
+                int digit = hexValue(ch);
+                if (digit < 0)
+                {
+                    setError(p, "invalid unicode escape");
+                    break;
+                }
+                code_ = (code_ << 4) | uint32_t(digit);
+                if (++hex_digits_ == 4)
+                {
+                    appendUnicode();
+                    state_ = State::String;
+                }
+                run_ = ++p;
+                break;
+            }
+
+            case State::Number:
+                if (isNumberChar(ch))
+                {
+                    ++p;
+                }
+                else
+                {
+                    endNumber(p);
+                }
+                break;
+
+            case State::Name:
+                if (ch >= 'a' && ch <= 'z')
+                {
+                    ++p;
+                }
+                else
+                {
+                    endName(p);
+                }
+                break;
+
+            case State::Error:
+                break;
+        }
+    }
+
+    if (inToken())
+    {
+        token_.append(run_, size_t(end - run_));
+    }
+    position_ += length;
+    return state_ != State::Error;
+}
+
+bool JsonPushParser::feed(const iovec* iov, int iovcnt)
+{
+    for (int ix = 0; ix < iovcnt; ++ix)
+    {
+        if (!feed(static_cast<const char*>(iov[ix].iov_base), iov[ix].iov_len))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JsonPushParser::finish()
+{
+    // a number or name at the end of the text is all in token_
+    const char* p = token_.data() + token_.length();
+    chunk_ = p;
+    if (state_ == State::Number)
+    {
+        run_ = p;
+        endNumber(p);
+    }
+    else if (state_ == State::Name)
+    {
+        run_ = p;
+        endName(p);
+    }
+    if (state_ != State::Error && (state_ != State::Value || !stack_.empty()))
+    {
+        setError(p, "incomplete json");
+    }
+    return state_ != State::Error;
+}
+
+} // namespace alt
@@ -0,0 +1,133 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file JsonPushParser.h
+ * @library alt_util
+ * @brief Implements an event based Json parser taking input in chunks of any
+ * size. Unlike JsonParser, no tree is built and the document is never held in
+ * memory: events are sent to a JsonEventListener as tokens complete, and the
+ * only state kept between chunks is the container stack and the token being
+ * scanned when a chunk ends. A sequence of Json values, such as newline
+ * delimited Json, is parsed as a stream of documents.
+ */
+
+#include <util/types/TemplateHelper.h>  // for NONCOPYABLE
+#include <sys/uio.h>                    // for iovec
+#include <string>
+#include <string_view>                  // for string_view
+#include <vector>
+
+namespace alt
+{
+
+/**
+ * \class JsonEventListener
+ * \ingroup StringUtils
+ * \brief Receives events from JsonPushParser. String views passed are valid only
+ * during the call.
+ */
+class JsonEventListener
+{
+  public:
+    virtual ~JsonEventListener() = default;
+    virtual void onStartObject() {}
+    virtual void onEndObject() {}
+    virtual void onStartArray() {}
+    virtual void onEndArray() {}
+    virtual void onKey(std::string_view) {}
+    virtual void onString(std::string_view) {}
+    virtual void onInteger(int64_t) {}
+    virtual void onDouble(double) {}
+    virtual void onBool(bool) {}
+    virtual void onNull() {}
+
+    /// \brief called when a top level value completes
+    virtual void onEndDocument() {}
+};
+
+/**
+ * \class JsonPushParser
+ * \ingroup StringUtils
+ * \brief Parses Json text pushed in chunks into events. A string, number or
+ * name completed within a chunk is passed to the listener without copying;
+ * only a token crossing chunks is copied into the parser.
+ */
+class JsonPushParser
+{
+  public:
+    /// \brief constructs a parser
+    /// \param listener the listener receiving events
+    /// \param max_depth the maximum nesting depth of objects and arrays
+    explicit JsonPushParser(JsonEventListener& listener, size_t max_depth = 1024);
+    NONCOPYABLE(JsonPushParser);
+
+    /// \brief parses the next chunk of the text
+    /// \return false if there is an error, in this or in a previous chunk
+    bool feed(const char* data, size_t length);
+
+    /// \brief parses the next chunks of the text, for instance, as fetched from
+    /// RingBuffer::fetchAll
+    bool feed(const iovec* iov, int iovcnt);
+
+    /// \brief ends the text. A number or name at the end of the text completes
+    /// here
+    /// \return false if there is an error or the text ends inside a value
+    bool finish();
+
+    /// \brief resets the parser to parse a new text
+    void reset();
+
+    bool hasError() const { return !error_.empty(); }
+    const std::string& error() const { return error_; }
+
+    /// \return the number of bytes parsed
+    size_t position() const { return position_; }
+
+  private:
+    enum class State : uint8_t
+    {
+        Value,          // expecting a value
+        FirstElement,   // after '[', expecting a value or ']'
+        FirstKey,       // after '{', expecting a key or '}'
+        Key,            // after ',' in an object, expecting a key
+        Colon,          // after a key
+        Next,           // after a value in a container
+        String,
+        Escape,         // after a backslash in a string
+        Unicode,        // in the hex digits of \u
+        Number,
+        Name,           // true, false or null
+        Error
+    };
+
+    bool inToken() const { return state_ == State::String || state_ == State::Number || state_ == State::Name; }
+    std::string_view tokenView(const char* end);
+    const char* startValue(const char* p);
+    void valueDone();
+    void closeContainer(const char* p);
+    void endNumber(const char* p);
+    void endName(const char* p);
+    void appendUnicode();
+    void setError(const char* pos, const char* message);
+
+    JsonEventListener&  listener_;
+    size_t              max_depth_;
+    State               state_ {State::Value};
+    bool                is_key_ {false};    ///< the string is a key
+    uint8_t             hex_digits_ {0};
+    uint32_t            code_ {0};          ///< code point of \u
+    uint32_t            high_surrogate_ {0};
+    std::vector<char>   stack_;             ///< '{' or '[' of open containers
+    const char*         run_ {nullptr};     ///< start of the token in the current chunk
+    std::string         token_;             ///< token copied from previous chunks
+    std::string         error_;
+    size_t              position_ {0};      ///< bytes before the current chunk
+    const char*         chunk_ {nullptr};   ///< the current chunk
+};
+
+} // namespace alt
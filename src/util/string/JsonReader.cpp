@@ -0,0 +1,259 @@
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+#include "JsonReader.h"
+#include "JsonParser.h"
+#include <cstring>                      // for memchr
+
+namespace alt
+{
+
+namespace
+{
+    bool isJsonSpace(char ch) { return ch==' ' || ch=='\t' || ch=='\n' || ch=='\r'; }
+}
+
+bool JsonReader::open(const char* json, size_t length)
+{
+    json_ = json;
+    length_ = length;
+    return index_.build(json, length);
+}
+
+size_t JsonReader::skipValue(size_t ix) const
+{
+    char ch = tokenChar(ix++);
+    if (ch != '{' && ch != '[')
+    {
+        return ix;
+    }
+    // only brackets change the depth, names and values in between are skipped
+    // token by token
+    size_t depth = 1;
+    while (depth && ix < index_.size())
+    {
+        ch = tokenChar(ix++);
+        if (ch == '{' || ch == '[')
+        {
+            ++depth;
+        }
+        else if (ch == '}' || ch == ']')
+        {
+            --depth;
+        }
+    }
+    return ix;
+}
+
+size_t JsonReader::valueEnd(size_t ix) const
+{
+    size_t start = tokenPos(ix);
+    size_t end = tokenPos(skipValue(ix));
+    while (end > start + 1 && isJsonSpace(json_[end - 1]))
+    {
+        --end;
+    }
+    return end;
+}
+
+char JsonView::firstChar() const
+{
+    return reader_ ? reader_->tokenChar(ix_) : '\0';
+}
+
+JsonViewType JsonView::type() const
+{
+    switch (firstChar())
+    {
+        case '{': return JsonViewType::Object;
+        case '[': return JsonViewType::Array;
+        case '"': return JsonViewType::String;
+        case 't':
+        case 'f': return JsonViewType::Bool;
+        case 'n': return JsonViewType::Null;
+        case '0': case '1': case '2': case '3': case '4': case '5':
+        case '6': case '7': case '8': case '9': case '-':
+        {
+            StrParser& scanner = reader_->scanner_;
+            scanner.reset(reader_->json_ + reader_->tokenPos(ix_), reader_->json_ + reader_->valueEnd(ix_));
+            scanner.getNumber();
+            return scanner.scannedValueType() == StrScan::DOUBLE ? JsonViewType::Double
+                 : scanner.scannedValueType() == StrScan::INT ? JsonViewType::Integer
+                 : JsonViewType::Invalid;
+        }
+        default: return JsonViewType::Invalid;
+    }
+}
+
+std::string_view JsonView::memberName(size_t ix) const
+{
+    const char* start = reader_->json_ + reader_->tokenPos(ix) + 1;
+    // the closing quote is the last non-space character before the colon
+    const char* end = reader_->json_ + reader_->tokenPos(ix + 1);
+    while (end > start && isJsonSpace(end[-1]))
+    {
+        --end;
+    }
+    return end > start ? std::string_view(start, size_t(end - start - 1)) : std::string_view();
+}
+
+JsonView JsonView::find(std::string_view name) const
+{
+    if (!isObject())
+    {
+        return JsonView();
+    }
+    size_t ix = ix_ + 1;
+    while (reader_->tokenChar(ix) == '"' && reader_->tokenChar(ix + 1) == ':')
+    {
+        if (memberName(ix) == name)
+        {
+            return JsonView(reader_, ix + 2);
+        }
+        ix = reader_->skipValue(ix + 2);
+        if (reader_->tokenChar(ix) != ',') break;
+        ++ix;
+    }
+    return JsonView();
+}
+
+JsonView JsonView::at(size_t n) const
+{
+    if (!isArray() || reader_->tokenChar(ix_ + 1) == ']')
+    {
+        return JsonView();
+    }
+    size_t ix = ix_ + 1;
+    for (; n; --n)
+    {
+        ix = reader_->skipValue(ix);
+        if (reader_->tokenChar(ix) != ',')
+        {
+            return JsonView();
+        }
+        ++ix;
+    }
+    return ix < reader_->index_.size() ? JsonView(reader_, ix) : JsonView();
+}
+
+size_t JsonView::size() const
+{
+    size_t count = 0;
+    if (isObject())
+    {
+        forEachMember([&count](std::string_view, JsonView) { ++count; });
+    }
+    else
+    {
+        forEachElement([&count](JsonView) { ++count; });
+    }
+    return count;
+}
+
+std::string_view JsonView::rawText() const
+{
+    if (!reader_)
+    {
+        return std::string_view();
+    }
+    size_t start = reader_->tokenPos(ix_);
+    return std::string_view(reader_->json_ + start, reader_->valueEnd(ix_) - start);
+}
+
+std::string_view JsonView::rawString() const
+{
+    if (!isString())
+    {
+        return std::string_view();
+    }
+    std::string_view text = rawText();
+    return text.length() >= 2 ? text.substr(1, text.length() - 2) : std::string_view();
+}
+
+bool JsonView::getString(std::string& val) const
+{
+    if (!isString())
+    {
+        return false;
+    }
+    std::string_view raw = rawString();
+    if (!memchr(raw.data(), '\\', raw.length()))
+    {
+        val.assign(raw.data(), raw.length());
+        return true;
+    }
+    std::string_view text = rawText();
+    StrParser& scanner = reader_->scanner_;
+    scanner.reset(text.data(), text.data() + text.length());
+    scanner.getString();
+    return scanner.fetchValue(val);
+}
+
+bool JsonView::getInteger(int64_t& val) const
+{
+    return type() == JsonViewType::Integer && reader_->scanner_.fetchValue(val);
+}
+
+bool JsonView::getDouble(double& val) const
+{
+    JsonViewType vt = type();
+    if (vt == JsonViewType::Integer)
+    {
+        int64_t integer;
+        reader_->scanner_.fetchValue(integer);
+        val = double(integer);
+        return true;
+    }
+    return vt == JsonViewType::Double && reader_->scanner_.fetchValue(val);
+}
+
+bool JsonView::getBool(bool& val) const
+{
+    std::string_view text = rawText();
+    if (text == "true" || text == "false")
+    {
+        val = text[0] == 't';
+        return true;
+    }
+    return false;
+}
+
+std::string_view JsonView::getStringValue(std::string_view name, std::string_view default_value) const
+{
+    JsonView value = find(name);
+    return value.isString() ? value.rawString() : default_value;
+}
+
+int64_t JsonView::getIntegerValue(std::string_view name, int64_t default_value) const
+{
+    int64_t val;
+    return find(name).getInteger(val) ? val : default_value;
+}
+
+double JsonView::getDoubleValue(std::string_view name, double default_value) const
+{
+    double val;
+    return find(name).getDouble(val) ? val : default_value;
+}
+
+bool JsonView::getBoolValue(std::string_view name, bool default_value) const
+{
+    bool val;
+    return find(name).getBool(val) ? val : default_value;
+}
+
+JsonObject* JsonView::toObject() const
+{
+    if (!isObject())
+    {
+        return nullptr;
+    }
+    std::string_view text = rawText();
+    ParserStreamContext context;
+    JsonParser parser(context, text.data(), text.length());
+    return parser.parseIndexed();
+}
+
+} // namespace alt
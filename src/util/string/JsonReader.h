@@ -0,0 +1,215 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file JsonReader.h
+ * @library alt_util
+ * @brief Implements an on-demand Json reader over a text in memory. Unlike
+ * JsonParser, no node is created: a JsonView refers to a value by its position
+ * in the JsonStructuralIndex of the text, and fields are found only when they
+ * are asked for. Strings are returned as std::string_view into the text and
+ * numbers are converted when read. Values not asked for are skipped by token
+ * in the index, not by character. A full JsonObject tree of an object value can
+ * still be built by JsonView::toObject.
+ * Classes defined in this file include:
+ *    - JsonReader: holds the text and its structural index
+ *    - JsonView: a lightweight reference to a value in the text
+ */
+
+#include "JsonIndex.h"
+#include "StrScan.h"                    // for StrParser
+#include <util/types/TemplateHelper.h>  // for NONCOPYABLE
+#include <string>
+#include <string_view>                  // for string_view
+
+namespace alt
+{
+
+class JsonObject;
+class JsonReader;
+
+enum class JsonViewType : uint8_t
+{
+    Invalid,
+    Object,
+    Array,
+    String,
+    Integer,
+    Double,
+    Bool,
+    Null
+};
+
+/**
+ * \class JsonView
+ * \ingroup StringUtils
+ * \brief A value in the text of a JsonReader. A view is valid as long as the
+ * reader and its text are. Lookup of a missing name or a value of a wrong type
+ * returns an invalid view, so lookups can be chained.
+ * \note Names are compared with the text as is, that is, escapes in names in
+ * the text are not converted.
+ */
+class JsonView
+{
+  public:
+    JsonView() = default;
+
+    /// \return true if the view refers to a value
+    bool valid() const { return reader_ != nullptr; }
+    explicit operator bool() const { return valid(); }
+
+    /// \return the type of the value. A number is scanned to tell integers
+    /// from doubles
+    JsonViewType type() const;
+
+    bool isObject() const { return firstChar() == '{'; }
+    bool isArray() const { return firstChar() == '['; }
+    bool isString() const { return firstChar() == '"'; }
+    bool isNull() const { return firstChar() == 'n'; }
+
+    /// \brief finds a member of an object
+    /// \return the member value, or an invalid view if this is not an object or
+    /// the member is not found
+    JsonView find(std::string_view name) const;
+    JsonView operator[](std::string_view name) const { return find(name); }
+
+    /// \brief finds the nth element of an array
+    /// \return the element, or an invalid view if this is not an array or n is
+    /// out of range
+    JsonView at(size_t n) const;
+
+    /// \return the number of members of an object or elements of an array, 0
+    /// for other values
+    size_t size() const;
+
+    /// \return the text between the quotes of a string value with escapes kept,
+    /// or an empty view for other values
+    std::string_view rawString() const;
+
+    /// \return the text of the value, including quotes or brackets
+    std::string_view rawText() const;
+
+    /// \brief gets a string value with escapes converted
+    /// \return true if the value is a string
+    bool getString(std::string& val) const;
+
+    /// \return true if the value is an integer
+    bool getInteger(int64_t& val) const;
+
+    /// \return true if the value is a number. An integer is converted to double
+    bool getDouble(double& val) const;
+
+    /// \return true if the value is true or false
+    bool getBool(bool& val) const;
+
+    /// \brief gets a member value of an object, or the default value if missing
+    /// or of a different type. A string is returned as rawString()
+    std::string_view getStringValue(std::string_view name, std::string_view default_value = {}) const;
+    int64_t getIntegerValue(std::string_view name, int64_t default_value = 0) const;
+    double getDoubleValue(std::string_view name, double default_value = 0) const;
+    bool getBoolValue(std::string_view name, bool default_value = false) const;
+
+    /// \brief calls func(std::string_view name, JsonView value) for each member
+    /// of an object
+    template <typename Func>
+    void forEachMember(Func&& func) const;
+
+    /// \brief calls func(JsonView value) for each element of an array
+    template <typename Func>
+    void forEachElement(Func&& func) const;
+
+    /// \brief builds the full JsonObject tree of an object value. The tree must
+    /// be released by PooledNamedNode::releaseNode
+    /// \return the root of the tree, or nullptr if this is not an object
+    JsonObject* toObject() const;
+
+  private:
+    friend class JsonReader;
+    JsonView(const JsonReader* reader, size_t ix) : reader_(reader), ix_(ix) {}
+
+    char firstChar() const;
+
+    /// \return the name of a member given the index of its quote
+    std::string_view memberName(size_t ix) const;
+
+    const JsonReader*   reader_ {nullptr};
+    size_t              ix_ {0};    ///< index of the first token of the value
+};
+
+/**
+ * \class JsonReader
+ * \ingroup StringUtils
+ * \brief Reads Json text in memory on demand. The text is indexed once by open,
+ * and values are then read through JsonView from root().
+ * \note The text is not copied and must outlive the reader. Reading numbers
+ * uses a scanner in the reader, so a reader must not be read by multiple
+ * threads at the same time.
+ */
+class JsonReader
+{
+  public:
+    JsonReader() = default;
+    NONCOPYABLE(JsonReader);
+
+    /// \brief indexes the Json text
+    /// \return false if the text ends inside a string
+    bool open(const char* json, size_t length);
+    bool open(const std::string& json) { return open(json.c_str(), json.length()); }
+
+    /// \return the root value, or an invalid view if the text is empty
+    JsonView root() const { return index_.size() ? JsonView(this, 0) : JsonView(); }
+
+  private:
+    friend class JsonView;
+
+    /// \return the first character of the nth token, or '\0' past the last token
+    char tokenChar(size_t ix) const { return ix < index_.size() ? json_[index_[ix]] : '\0'; }
+
+    /// \return the position of the nth token, or the text length past the last token
+    size_t tokenPos(size_t ix) const { return ix < index_.size() ? index_[ix] : length_; }
+
+    /// \return the index of the token after the value starting at the nth token
+    size_t skipValue(size_t ix) const;
+
+    /// \return the position after the value starting at the nth token
+    size_t valueEnd(size_t ix) const;
+
+    const char*             json_ {nullptr};
+    size_t                  length_ {0};
+    JsonStructuralIndex     index_;
+    mutable StrParser       scanner_ {"", size_t(0)};
+};
+
+template <typename Func>
+void JsonView::forEachMember(Func&& func) const
+{
+    if (!isObject()) return;
+    size_t ix = ix_ + 1;
+    while (reader_->tokenChar(ix) == '"' && reader_->tokenChar(ix + 1) == ':')
+    {
+        func(memberName(ix), JsonView(reader_, ix + 2));
+        ix = reader_->skipValue(ix + 2);
+        if (reader_->tokenChar(ix) != ',') break;
+        ++ix;
+    }
+}
+
+template <typename Func>
+void JsonView::forEachElement(Func&& func) const
+{
+    if (!isArray() || reader_->tokenChar(ix_ + 1) == ']') return;
+    size_t ix = ix_ + 1;
+    while (ix < reader_->index_.size())
+    {
+        func(JsonView(reader_, ix));
+        ix = reader_->skipValue(ix);
+        if (reader_->tokenChar(ix) != ',') break;
+        ++ix;
+    }
+}
+
+} // namespace alt
@@ -42,6 +42,14 @@ class StrBuf
     bool empty() const { return tail_==0; }
     bool overflowed() const { return tail_==capacity_; }
 
+    /// \brief the space left after the tail
+    size_t available() const { return capacity_ - tail_; }
+
+    /// \brief writes in place: write no more than available() chars at tail(),
+    /// then advance the tail by the chars written
+    char* tail() { return buffer_ + tail_; }
+    void advance(size_t n) { tail_ += n; }
+
     bool operator==(const StrBuf &other) const
     { return tail_==other.tail_ && ::strncmp(buffer_, other.buffer_, tail_); }
 
@@ -157,6 +165,11 @@ class StrFixed
         return buffer_;
     }
 
+    char* data()
+    {
+        return buffer_;
+    }
+
     const char* toString() const
     {
         return buffer_;
@@ -0,0 +1,427 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file StrFormat.h
+ * @library alt_util
+ * @brief Formats text with a format string parsed at compile time:
+ *    - ALT_FORMAT("...") makes a format string with {} fields, {:.N} for a
+ *      floating point value in N decimals, and {{ and }} for braces
+ *    - formatTo writes the text into a StrBuf, a std::string or a StrFixed
+ * The format string is parsed into a fixed sequence of appends, and the
+ * arguments are checked against the fields when compiling. An upper bound of
+ * the output length is computed before writing, so the capacity of the buffer
+ * is checked once and the text is written in place without further checks.
+ * No heap memory is allocated except by a std::string target.
+ *
+ * Example:
+ * @code
+ *   StrPrinter<256> msg;
+ *   msg.format(ALT_FORMAT("35=D|49={}|44={:.2}|38={}|"), sender, price, qty);
+ * @endcode
+ */
+
+#include "StrBuffer.h"
+#include <util/numeric/Intrinsics.h>   // for s_double_digits
+#include <util/numeric/FastFloat.h>    // for formatShortest, formatFixed
+#include <array>
+#include <cstring>                      // for memcpy, strlen
+#include <string>
+#include <string_view>                  // for string_view
+#include <tuple>
+#include <type_traits>
+#include <utility>                      // for index_sequence
+
+/// \brief makes a format string for formatTo from a string literal
+#define ALT_FORMAT(text)                                                     \
+    ([] {                                                                    \
+        struct FormatText                                                    \
+        {                                                                    \
+            static constexpr std::string_view value() { return text; }       \
+        };                                                                   \
+        return FormatText{};                                                 \
+    }())
+
+namespace alt
+{
+
+namespace detail
+{
+
+/// \brief a literal text or a field in a format string
+struct FormatPiece
+{
+    size_t  start_ {0};         ///< start of the literal in the format string
+    size_t  length_ {0};        ///< length of the literal, 0 for a field
+    int     arg_ {-1};          ///< argument of the field, -1 for a literal
+    int     precision_ {-1};    ///< decimals of {:.N}, -1 if not given
+};
+
+enum FormatError
+{
+    FORMAT_UNMATCHED_BRACE = -1,
+    FORMAT_BAD_FIELD = -2
+};
+
+/// \brief parses a format string into pieces. Pass null pieces to count
+/// \return the number of pieces, or a FormatError
+constexpr int parseFormat(std::string_view text, FormatPiece* pieces)
+{
+    int count = 0;
+    int args = 0;
+    size_t literal = 0;
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        char ch = text[pos];
+        if (ch != '{' && ch != '}')
+        {
+            ++pos;
+            continue;
+        }
+        if (pos > literal)
+        {
+            if (pieces) pieces[count] = FormatPiece{literal, pos - literal, -1, -1};
+            ++count;
+        }
+        if (pos + 1 < text.size() && text[pos + 1] == ch)
+        {
+            // {{ or }}, the second brace starts the next literal
+            literal = pos + 1;
+            pos += 2;
+            continue;
+        }
+        if (ch == '}')
+        {
+            return FORMAT_UNMATCHED_BRACE;
+        }
+        int precision = -1;
+        ++pos;
+        if (pos < text.size() && text[pos] == ':')
+        {
+            if (pos + 2 >= text.size() || text[pos + 1] != '.' ||
+                text[pos + 2] < '0' || text[pos + 2] > '9')
+            {
+                return FORMAT_BAD_FIELD;
+            }
+            pos += 2;
+            precision = 0;
+            while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9')
+            {
+                precision = precision * 10 + (text[pos++] - '0');
+            }
+        }
+        if (pos >= text.size() || text[pos] != '}')
+        {
+            return FORMAT_BAD_FIELD;
+        }
+        if (pieces) pieces[count] = FormatPiece{0, 0, args, precision};
+        ++count;
+        ++args;
+        literal = ++pos;
+    }
+    if (pos > literal)
+    {
+        if (pieces) pieces[count] = FormatPiece{literal, pos - literal, -1, -1};
+        ++count;
+    }
+    return count;
+}
+
+template <typename Format, size_t N>
+constexpr std::array<FormatPiece, N> parsePieces()
+{
+    std::array<FormatPiece, N> pieces {};
+    if (N) parseFormat(Format::value(), &pieces[0]);
+    return pieces;
+}
+
+template <size_t N>
+constexpr size_t countFields(const std::array<FormatPiece, N>& pieces)
+{
+    size_t count = 0;
+    for (size_t ix = 0; ix < N; ++ix) count += pieces[ix].arg_ >= 0;
+    return count;
+}
+
+template <size_t N>
+constexpr size_t literalLength(const std::array<FormatPiece, N>& pieces)
+{
+    size_t length = 0;
+    for (size_t ix = 0; ix < N; ++ix) length += pieces[ix].length_;
+    return length;
+}
+
+/// \brief the pieces of the format string of Format, made by ALT_FORMAT
+template <typename Format>
+struct FormatInfo
+{
+    static constexpr int status = parseFormat(Format::value(), nullptr);
+    static constexpr size_t piece_count = status > 0 ? size_t(status) : 0;
+    static constexpr std::array<FormatPiece, piece_count> pieces = parsePieces<Format, piece_count>();
+    static constexpr size_t field_count = countFields(pieces);
+    static constexpr size_t literal_length = literalLength(pieces);
+
+    /// \return the precision of the field of the argument
+    static constexpr int precision(size_t arg)
+    {
+        for (size_t ix = 0; ix < piece_count; ++ix)
+        {
+            if (pieces[ix].arg_ == int(arg)) return pieces[ix].precision_;
+        }
+        return -1;
+    }
+};
+
+/// \brief tells the kind of an argument
+template <typename T>
+struct FormatArg
+{
+    static constexpr bool is_char = std::is_same<T, char>::value;
+    static constexpr bool is_integer = std::is_integral<T>::value && !is_char && !std::is_same<T, bool>::value;
+    static constexpr bool is_floating = std::is_same<T, double>::value || std::is_same<T, float>::value;
+    static constexpr bool is_text = std::is_convertible<const T&, std::string_view>::value;
+    static constexpr bool supported = is_char || is_integer || is_floating || is_text;
+};
+
+/// \brief writes val at p without checking the space
+/// \return the end of the digits
+inline char* writeUnsigned(uint64_t val, char* p)
+{
+    char text[20];
+    char* start = text + sizeof(text);
+    while (val >= 100)
+    {
+        start -= 2;
+        ::memcpy(start, s_double_digits + (val % 100) * 2, 2);
+        val /= 100;
+    }
+    if (val >= 10)
+    {
+        start -= 2;
+        ::memcpy(start, s_double_digits + val * 2, 2);
+    }
+    else
+    {
+        *--start = char('0' + val);
+    }
+    size_t length = size_t(text + sizeof(text) - start);
+    ::memcpy(p, start, length);
+    return p + length;
+}
+
+/// \return the maximum length of the argument formatted
+template <typename T>
+inline size_t formatBound(const T& val, int precision)
+{
+    if constexpr (FormatArg<T>::is_char)
+    {
+        return 1;
+    }
+    else if constexpr (FormatArg<T>::is_integer)
+    {
+        return sizeof(T) <= 4 ? 11 : 20;
+    }
+    else if constexpr (FormatArg<T>::is_floating)
+    {
+        if (precision < 0)
+        {
+            return SHORTEST_DOUBLE_CHARS;
+        }
+        // sign, 19 digits, point and decimals for a value below 10^18, 309
+        // digits otherwise, and a char for the terminator snprintf may write
+        return size_t(precision) + (val < 1e18 && val > -1e18 ? 22 : 312);
+    }
+    else
+    {
+        return std::string_view(val).length();
+    }
+}
+
+/// \brief writes the argument at p without checking the space
+/// \return the end of the text written
+template <typename T>
+inline char* formatWrite(const T& val, int precision, char* p, size_t bound)
+{
+    if constexpr (FormatArg<T>::is_char)
+    {
+        *p = val;
+        return p + 1;
+    }
+    else if constexpr (FormatArg<T>::is_integer)
+    {
+        if constexpr (std::is_signed<T>::value)
+        {
+            if (val < 0)
+            {
+                *p++ = '-';
+                return writeUnsigned(uint64_t(0) - uint64_t(val), p);
+            }
+        }
+        return writeUnsigned(uint64_t(val), p);
+    }
+    else if constexpr (FormatArg<T>::is_floating)
+    {
+        return p + (precision < 0 ? formatShortest(val, p) : formatFixed(double(val), precision, p, bound));
+    }
+    else
+    {
+        std::string_view text(val);
+        ::memcpy(p, text.data(), text.length());
+        return p + text.length();
+    }
+}
+
+template <typename Format, size_t Ix, typename Tuple>
+inline char* formatPiece(char* p, const Tuple& args)
+{
+    constexpr FormatPiece piece = FormatInfo<Format>::pieces[Ix];
+    if constexpr (piece.arg_ < 0)
+    {
+        ::memcpy(p, Format::value().data() + piece.start_, piece.length_);
+        return p + piece.length_;
+    }
+    else
+    {
+        using T = std::decay_t<std::tuple_element_t<size_t(piece.arg_), Tuple>>;
+        static_assert(piece.precision_ < 0 || FormatArg<T>::is_floating,
+                      "precision is given to an argument not of floating point");
+        const T& val = std::get<size_t(piece.arg_)>(args);
+        return formatWrite(val, piece.precision_, p, formatBound(val, piece.precision_));
+    }
+}
+
+/// \brief writes all pieces at p, which has the space of the bound
+template <typename Format, typename Tuple, size_t... Ix>
+inline char* formatAll(char* p, const Tuple& args, std::index_sequence<Ix...>)
+{
+    ((p = formatPiece<Format, Ix>(p, args)), ...);
+    return p;
+}
+
+template <typename Format, typename Tuple, size_t... Ix>
+inline size_t formatBoundAll(const Tuple& args, std::index_sequence<Ix...>)
+{
+    return FormatInfo<Format>::literal_length +
+           (formatBound(std::get<Ix>(args), FormatInfo<Format>::precision(Ix)) + ... + 0);
+}
+
+/// \brief appends the piece to the buffer, with the space checked
+template <typename Format, size_t Ix, typename Tuple>
+inline void appendPiece(StrBuf& buffer, const Tuple& args)
+{
+    constexpr FormatPiece piece = FormatInfo<Format>::pieces[Ix];
+    if constexpr (piece.arg_ < 0)
+    {
+        buffer.append(Format::value().data() + piece.start_, piece.length_);
+    }
+    else
+    {
+        using T = std::decay_t<std::tuple_element_t<size_t(piece.arg_), Tuple>>;
+        const T& val = std::get<size_t(piece.arg_)>(args);
+        if constexpr (FormatArg<T>::is_text)
+        {
+            std::string_view text(val);
+            buffer.append(text.data(), text.length());
+        }
+        else
+        {
+            size_t bound = formatBound(val, piece.precision_);
+            char text[64];
+            if (bound <= sizeof(text))
+            {
+                buffer.append(text, size_t(formatWrite(val, piece.precision_, text, bound) - text));
+            }
+            else
+            {
+                // a large number in the fixed notation
+                std::string long_text(bound, '\0');
+                char* end = formatWrite(val, piece.precision_, &long_text[0], bound);
+                buffer.append(long_text.c_str(), size_t(end - long_text.c_str()));
+            }
+        }
+    }
+}
+
+template <typename Format, typename Tuple, size_t... Ix>
+inline void appendAll(StrBuf& buffer, const Tuple& args, std::index_sequence<Ix...>)
+{
+    (appendPiece<Format, Ix>(buffer, args), ...);
+}
+
+template <typename Format, typename... Args>
+constexpr void checkFormat()
+{
+    using Info = FormatInfo<Format>;
+    static_assert(Info::status != FORMAT_UNMATCHED_BRACE, "unmatched '}' in the format string");
+    static_assert(Info::status != FORMAT_BAD_FIELD, "bad field in the format string");
+    static_assert(Info::field_count == sizeof...(Args), "number of arguments does not match the fields");
+    static_assert((FormatArg<std::decay_t<Args>>::supported && ...), "type of an argument is not supported");
+}
+
+} // namespace detail
+
+/**
+ * \brief appends text formatted by the format string to a buffer. If the
+ * text may not fit, it is appended piece by piece and cut where the buffer is
+ * full as StrPrint does
+ * \param buffer the buffer
+ * \param format the format string made by ALT_FORMAT
+ * \param args arguments for the fields in the format string, which are char,
+ * integers, float, double and texts
+ * \return the number of chars appended
+ */
+template <typename Format, typename... Args>
+size_t formatTo(StrBuf& buffer, Format, const Args&... args)
+{
+    detail::checkFormat<Format, Args...>();
+    using Info = detail::FormatInfo<Format>;
+    auto arg_tuple = std::forward_as_tuple(args...);
+    size_t bound = detail::formatBoundAll<Format>(arg_tuple, std::index_sequence_for<Args...>{});
+    size_t length = buffer.length();
+    if (bound <= buffer.available())
+    {
+        char* tail = buffer.tail();
+        char* end = detail::formatAll<Format>(tail, arg_tuple, std::make_index_sequence<Info::piece_count>{});
+        buffer.advance(size_t(end - tail));
+    }
+    else
+    {
+        detail::appendAll<Format>(buffer, arg_tuple, std::make_index_sequence<Info::piece_count>{});
+    }
+    return buffer.length() - length;
+}
+
+/// \brief appends text formatted by the format string to a std::string
+template <typename Format, typename... Args>
+size_t formatTo(std::string& buffer, Format, const Args&... args)
+{
+    detail::checkFormat<Format, Args...>();
+    using Info = detail::FormatInfo<Format>;
+    auto arg_tuple = std::forward_as_tuple(args...);
+    size_t bound = detail::formatBoundAll<Format>(arg_tuple, std::index_sequence_for<Args...>{});
+    size_t length = buffer.length();
+    buffer.resize(length + bound);
+    char* tail = &buffer[length];
+    char* end = detail::formatAll<Format>(tail, arg_tuple, std::make_index_sequence<Info::piece_count>{});
+    buffer.resize(length + size_t(end - tail));
+    return size_t(end - tail);
+}
+
+/// \brief sets text formatted by the format string to a StrFixed. The text is
+/// cut if longer than the capacity
+template <size_t N, typename Format, typename... Args>
+size_t formatTo(StrFixed<N>& str, Format format, const Args&... args)
+{
+    StrBuf buffer(str.data(), N);
+    size_t length = formatTo(buffer, format, args...);
+    buffer.terminate();
+    str.data()[N] = '\0';
+    return length;
+}
+
+} // namespace alt
@@ -0,0 +1,120 @@
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+#include "StrInterner.h"
+#include <cstring>                      // for memcpy
+#include <stdexcept>                    // for length_error
+
+namespace alt
+{
+
+StrInternerBase::Index::Index(size_t capacity)
+    : mask_(capacity - 1)
+    , slots_(new std::atomic<uint64_t>[capacity])
+{
+    for (size_t ix = 0; ix < capacity; ++ix)
+    {
+        slots_[ix].store(0, std::memory_order_relaxed);
+    }
+}
+
+StrInternerBase::StrInternerBase(size_t page_size, size_t capacity)
+    : pool_(page_size)
+    , page_size_(page_size)
+{
+    // at most half of the slots are used
+    size_t slots = size_t(1) << log2Ceil(capacity < 8 ? size_t(16) : capacity * 2);
+    indexes_.emplace_back(new Index(slots));
+    index_.store(indexes_.back().get(), std::memory_order_release);
+}
+
+StrInternerBase::~StrInternerBase()
+{
+    for (StrHashKey* chunk: chunks_)
+    {
+        delete [] chunk;
+    }
+}
+
+SymbolId StrInternerBase::add(const StrHashKey& key)
+{
+    // search again as another thread may have added the string
+    SymbolId id = find(key);
+    if (id != NO_SYMBOL)
+    {
+        return id;
+    }
+    id = size_.load(std::memory_order_relaxed);
+    if (id == NO_SYMBOL)
+    {
+        throw std::length_error("StrInterner: too many strings");
+    }
+    Index* index = index_.load(std::memory_order_relaxed);
+    if ((size_t(id) + 1) * 2 > index->mask_ + 1)
+    {
+        grow();
+        index = index_.load(std::memory_order_relaxed);
+    }
+
+    const char* str;
+    if (key.length_ < page_size_)
+    {
+        str = pool_.push(key.str_, key.length_);
+    }
+    else
+    {
+        char* buffer = new char[key.length_ + 1];
+        ::memcpy(buffer, key.str_, key.length_);
+        buffer[key.length_] = '\0';
+        large_strings_.emplace_back(buffer);
+        str = buffer;
+    }
+
+    uint32_t chunk = uint32_t(log2Floor(uint32_t(id / FIRST_CHUNK + 1)));
+    if (!chunks_[chunk])
+    {
+        chunks_[chunk] = new StrHashKey[size_t(FIRST_CHUNK) << chunk];
+    }
+    StrHashKey& entry = chunks_[chunk][id - FIRST_CHUNK * ((1u << chunk) - 1)];
+    entry.str_ = str;
+    entry.length_ = key.length_;
+    entry.hash_ = key.hash_;
+
+    // the entry is visible to any reader seeing the size or the slot
+    size_.store(id + 1, std::memory_order_release);
+    size_t pos = slotOf(key.hash_);
+    while (index->slots_[pos & index->mask_].load(std::memory_order_relaxed))
+    {
+        ++pos;
+    }
+    index->slots_[pos & index->mask_].store(packSlot(key.hash_, id), std::memory_order_release);
+    return id;
+}
+
+void StrInternerBase::grow()
+{
+    const Index* old_index = index_.load(std::memory_order_relaxed);
+    size_t capacity = (old_index->mask_ + 1) * 2;
+    Index* index = new Index(capacity);
+    indexes_.emplace_back(index);
+    for (size_t ix = 0; ix <= old_index->mask_; ++ix)
+    {
+        uint64_t slot = old_index->slots_[ix].load(std::memory_order_relaxed);
+        if (!slot)
+        {
+            continue;
+        }
+        size_t pos = slotOf(uint32_t(slot >> 32));
+        while (index->slots_[pos & index->mask_].load(std::memory_order_relaxed))
+        {
+            ++pos;
+        }
+        index->slots_[pos & index->mask_].store(slot, std::memory_order_relaxed);
+    }
+    // readers still on the old index find all strings added before the growth
+    index_.store(index, std::memory_order_release);
+}
+
+} // namespace alt
@@ -0,0 +1,196 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file StrInterner.h
+ * @library alt_util
+ * @brief A string interner on top of StrPool giving each distinct string a
+ * dense 32-bit symbol id, so that symbols, venue names or keys compare as
+ * integers:
+ *    - StrInternerBase: the base class keeping strings, entries and the index
+ *    - StrInterner_T: template to choose the lock taken by interning
+ *    - StrInterner: an interner not thread safe
+ *    - StrInternerMutexLocked: an interner interning under a mutex
+ *    - StrInternerSpinLocked: an interner interning under a spin lock
+ * Each string is stored once. Lookups by string and by id never lock: the
+ * index is an open addressing table of atomic slots, and entries are kept in
+ * chunks that never move.
+ */
+
+#include <util/storage/StringHashMap.h>  // for StrHashKey
+#include <util/storage/DoubleHash.h>     // for fmix64
+#include <util/string/StrPool.h>         // for StrPool
+#include <util/string/StrBuffer.h>       // for StrRefInLength
+#include <util/numeric/Intrinsics.h>     // for log2Floor
+#include <util/ipc/Mutex.h>              // for MutexNone, SpinMutex
+#include <util/system/Platform.h>        // for ALT_INLINE
+#include <util/types/TemplateHelper.h>   // for NONCOPYABLE
+#include <assert.h>
+#include <atomic>                        // for atomic
+#include <memory>                        // for unique_ptr
+#include <mutex>                         // for scoped_lock
+#include <string_view>                   // for string_view
+#include <vector>                        // for vector
+
+namespace alt
+{
+
+using SymbolId = uint32_t;
+
+/// \brief the id of no symbol, returned by find for a string not interned
+constexpr SymbolId NO_SYMBOL = ~SymbolId(0);
+
+/**
+ * \class StrInternerBase
+ * \ingroup StringUtils
+ * \brief Keeps the interned strings and the index of them. This is the base
+ * class of template StrInterner_T, which serializes adding.
+ * \note Entry of id i is in chunk k = log2(i / FIRST_CHUNK + 1), which holds
+ * FIRST_CHUNK << k entries, so an id maps to its string in O(1) and an entry
+ * never moves once written. The index slots pack the 32-bit hash and id + 1
+ * into one 64-bit word; a slot is published by one release store after the
+ * entry is written, and a grown index is published by one pointer store. Old
+ * index tables are kept until the interner is destroyed, so a reader never
+ * sees a freed table.
+ */
+class StrInternerBase
+{
+  public:
+    NONCOPYABLE(StrInternerBase);
+
+    /// \brief looks up a string without locking. The key converts from a
+    /// string_view, a string or a C string
+    /// \return the symbol id, or NO_SYMBOL if the string is not interned
+    SymbolId find(const StrHashKey& key) const;
+
+    /// \return the string of id as interned, null terminated
+    ALT_INLINE const StrHashKey& entry(SymbolId id) const
+    {
+        assert(id < size());
+        uint32_t chunk = uint32_t(log2Floor(uint32_t(id / FIRST_CHUNK + 1)));
+        return chunks_[chunk][id - FIRST_CHUNK * ((1u << chunk) - 1)];
+    }
+
+    StrRefInLength strRef(SymbolId id) const
+    {
+        const StrHashKey& key = entry(id);
+        return StrRefInLength(key.str_, key.length_);
+    }
+    std::string_view view(SymbolId id) const { return entry(id).view(); }
+    const char* c_str(SymbolId id) const { return entry(id).str_; }
+
+    /// \return the number of strings interned. Ids are from 0 to size() - 1
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+  protected:
+    static constexpr uint32_t FIRST_CHUNK = 256;
+    static constexpr size_t MAX_CHUNKS = 25;    ///< enough for 2^32 - 1 ids
+
+    struct Index
+    {
+        explicit Index(size_t capacity);
+        size_t                                  mask_;
+        std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+    };
+
+    StrInternerBase(size_t page_size, size_t capacity);
+    ~StrInternerBase();
+
+    /// \brief finds or adds a string. Must be serialized with other adds
+    SymbolId add(const StrHashKey& key);
+
+    static ALT_INLINE size_t slotOf(uint32_t hash) { return size_t(fmix64(hash)); }
+    static ALT_INLINE uint64_t packSlot(uint32_t hash, SymbolId id)
+    {
+        return (uint64_t(hash) << 32) | (uint64_t(id) + 1);
+    }
+
+    void grow();
+
+    StrPool                             pool_;
+    std::vector<std::unique_ptr<char[]>> large_strings_;   ///< strings too long for a page
+    StrHashKey*                         chunks_[MAX_CHUNKS] {};
+    std::atomic<uint32_t>               size_ {0};
+    std::atomic<Index*>                 index_ {nullptr};
+    std::vector<std::unique_ptr<Index>> indexes_;           ///< the current and retired
+    size_t                              page_size_;
+};
+
+/**
+ * \class StrInterner_T
+ * \ingroup StringUtils
+ * \brief A string interner based on StrInternerBase. Interning takes MutexT,
+ * while find, strRef, view and c_str never lock. The default MutexNone provides
+ * no protection; for interning from more than one thread, use std::mutex or
+ * alt::SpinMutex.
+ *
+ * Example:
+ * @code
+ *   StrInternerSpinLocked symbols;
+ *   SymbolId ibm = symbols.intern("IBM");
+ *   ...
+ *   if (symbols.find(venue_symbol) == ibm) ...     // an integer compare
+ * @endcode
+ */
+template<class MutexT = MutexNone>
+class StrInterner_T: public StrInternerBase
+{
+  public:
+    /// \brief constructs an interner
+    /// \param page_size page size of the string pool. Longer strings are
+    /// allocated one by one
+    /// \param capacity the number of strings to index without growing
+    explicit StrInterner_T(size_t page_size = 8192, size_t capacity = 1024)
+      : StrInternerBase(page_size, capacity)
+    {}
+
+    /// \brief interns a string. The key converts from a string_view, a string
+    /// or a C string
+    /// \return the id of the string, the same for equal strings
+    SymbolId intern(const StrHashKey& key)
+    {
+        SymbolId id = find(key);
+        if (id != NO_SYMBOL)
+        {
+            return id;
+        }
+        std::scoped_lock scope_lock {mutex_};
+        return add(key);
+    }
+
+    SymbolId intern(const char* str, size_t length) { return intern(StrHashKey(str, length)); }
+
+  private:
+    MutexT    mutex_;
+};
+
+ALT_INLINE SymbolId StrInternerBase::find(const StrHashKey& key) const
+{
+    const Index* index = index_.load(std::memory_order_acquire);
+    for (size_t pos = slotOf(key.hash_);; ++pos)
+    {
+        uint64_t slot = index->slots_[pos & index->mask_].load(std::memory_order_acquire);
+        if (!slot)
+        {
+            return NO_SYMBOL;
+        }
+        if (uint32_t(slot >> 32) == key.hash_)
+        {
+            SymbolId id = SymbolId(slot) - 1;
+            if (entry(id) == key)
+            {
+                return id;
+            }
+        }
+    }
+}
+
+using StrInterner = StrInterner_T<MutexNone>;
+using StrInternerMutexLocked = StrInterner_T<std::mutex>;
+using StrInternerSpinLocked = StrInterner_T<SpinMutex>;
+
+} // namespace alt
@@ -13,11 +13,15 @@
  *      for the output
  *    - StrPrinter: a  template string printer with self-contained fixe length
  *      buffer
+ *    - StrPrint::format: appends text by a format string parsed at compile
+ *      time, see StrFormat.h
 */
 
 #include "StrBuffer.h"
+#include "StrFormat.h"
 
 #include <util/numeric/Intrinsics.h>   // for s_double_digits, s_exp10
+#include <util/numeric/FastFloat.h>    // for formatShortest, formatFixed
 
 #include <stddef.h>
 #include <string>
@@ -41,6 +45,13 @@ class StrPrint
     void clear() { buffer_.clear(); }
 
     void resize(size_t sz) { buffer_.resize(sz); }
+
+    BufferT& buffer() { return buffer_; }
+
+    /// \brief appends text formatted by a format string made by ALT_FORMAT.
+    /// See formatTo in StrFormat.h
+    template <typename Format, typename... Args>
+    StrPrint& format(Format fmt, const Args&... args) { formatTo(buffer_, fmt, args...); return *this; }
    
     // Append char, and string
     StrPrint& operator << (char val) { buffer_.push_back(val); return *this; }
@@ -62,9 +73,12 @@ class StrPrint
     StrPrint& operator << (uint8_t val) { return *this << uint32_t(val); }
     StrPrint& operator << (int8_t val) { return *this << int32_t(val); }
 
+    // A double or a float is printed in the shortest text that parses back to
+    // the same value, and with a tuple of the value and the number of decimals,
+    // in the fixed notation rounded exactly as printf "%.*f" does
     StrPrint& operator << (double val);
     StrPrint& operator << (std::tuple<double, int> val);
-    StrPrint& operator << (float val) { return *this << double(val); }
+    StrPrint& operator << (float val);
     StrPrint& operator << (std::tuple<float, int> val)
      { return *this << std::make_tuple(std::get<0>(val), std::get<1>(val)); }
 
@@ -218,28 +232,34 @@ StrPrint<BufferT>::operator << (llong val)
 template<typename BufferT>
 ALT_INLINE StrPrint<BufferT>& StrPrint<BufferT>::operator << (double val)
 {
-    return *this << std::make_tuple(val,6);
+    char text[SHORTEST_DOUBLE_CHARS];
+    buffer_.append(text, formatShortest(val, text));
+    return *this;
+}
+
+template<typename BufferT>
+ALT_INLINE StrPrint<BufferT>& StrPrint<BufferT>::operator << (float val)
+{
+    char text[SHORTEST_DOUBLE_CHARS];
+    buffer_.append(text, formatShortest(val, text));
+    return *this;
 }
 
 template<typename BufferT>
 ALT_INLINE StrPrint<BufferT>& StrPrint<BufferT>::operator << (std::tuple<double, int> val)
 {
-    size_t precision = std::get<1>(val);
-    double dval = std::get<0>(val);
-    if (dval < 0)
+    char text[64];
+    size_t length = formatFixed(std::get<0>(val), std::get<1>(val), text, sizeof(text));
+    if (length < sizeof(text))
     {
-        buffer_.push_back('-');
-        dval = -dval;
+        buffer_.append(text, length);
+        return *this;
     }
-    uint64_t exp = s_exp10[precision];
-    int64_t lval = int64_t(dval * exp + 0.5);
-    *this << int64_t(lval / exp) << '.';
-    int64_t fval = lval % exp;
-    for (int p = precision - 1; p > 0 && fval < s_exp10[p]; --p)
-    {
-       buffer_.push_back('0');
-    }
-    return *this << fval;
+    // a large number or many decimals
+    std::string long_text(length + 1, '\0');
+    formatFixed(std::get<0>(val), std::get<1>(val), &long_text[0], long_text.size());
+    buffer_.append(long_text.c_str(), length);
+    return *this;
 }
 
 template<typename BufferT> ALT_INLINE
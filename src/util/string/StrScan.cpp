@@ -1,5 +1,6 @@
 #include "StrScan.h"
 #include "StrUtils.h"
+#include <util/numeric/FastFloat.h>     // for parseDouble, parseEightDigits
 
 #include <assert.h>
 
@@ -34,6 +35,13 @@ uint64_t StrScan::getUnsignedFromDec ()
     uint64_t val = 0;
 	uint64_t diff;
     char const *start_p = scan_buffer_.curPos();
+    // 8 digits at a time while val * 10^8 + 99999999 cannot overflow
+    while (scan_buffer_.remaining() >= 8 && val < 184467440737 &&
+           isEightDigits(scan_buffer_.curPos()))
+    {
+        val = val * 100000000 + parseEightDigits(scan_buffer_.curPos());
+        scan_buffer_.advance(8);
+    }
     while (scan_buffer_.hasRemaining() && (diff = uint64_t(scan_buffer_.curChar() - '0')) < 10)
     {
       	uint64_t new_val = val * 10 + diff;
@@ -183,6 +191,9 @@ void StrScan::getNumber()
         isNeg = true;
     }
 
+    // a decimal number with a fraction or exponent is parsed again from here
+    const char* number_start = scan_buffer_.curPos();
+    bool is_decimal {true};
     if (ch>='0' && ch<='9')
     {
         bool scanned{false};
@@ -196,6 +207,7 @@ void StrScan::getNumber()
                 scan_buffer_.advance(2);
                 start_p = scan_buffer_.curPos();
                 scanned = true;
+                is_decimal = false;
                 tv_.integer_ = getUnsignedFromHex();
                 if (start_p == scan_buffer_.curPos()) setErrStatus(Err_MissingHexDigits);
             }
@@ -204,6 +216,7 @@ void StrScan::getNumber()
                 scan_buffer_.advance(2);
                 start_p = scan_buffer_.curPos();
                 scanned = true;
+                is_decimal = false;
                 tv_.integer_ = getUnsignedFromBinary();
                 if (start_p == scan_buffer_.curPos()) setErrStatus(Err_MissingBinaryDigits);
             }
@@ -249,73 +262,23 @@ void StrScan::getNumber()
         return;
     }
 
-    if (ch=='.')
+    tv_.vt_ = integerGot ? INT : NONE;
+    if (is_decimal && (ch=='.' || ch=='E' || ch=='e'))
     {
-        ch = scan_buffer_.nextChar();
-        if (ch>='0' && ch<='9')
+        // A fraction or an exponent makes a double, converted from all the digits
+        // and correctly rounded. A leading 0 scanned as octal is decimal here
+        double val;
+        const char* end = parseDouble(number_start, scan_buffer_.head() + scan_buffer_.length(), val);
+        if (end > scan_buffer_.curPos())
         {
-            const char* start_cp = scan_buffer_.curPos();
-            double decimal = double(getUnsignedFromDec());
-            size_t scanned_digits = size_t(tv_.end_pos_-start_cp);
-            tv_.double_ = double(tv_.integer_);
-            if (isNeg)
-            {
-                tv_.double_ -= decimal/s_exp10[scanned_digits];
-            }
-            else
-            {
-                tv_.double_ += decimal/s_exp10[scanned_digits];
-            }
+            tv_.double_ = isNeg ? -val : val;
             tv_.vt_ = DOUBLE;
+            scan_buffer_.resetPos(size_t(end - scan_buffer_.head()));
         }
-        else if (integerGot)
-        {
-            tv_.vt_ = DOUBLE;
-        }
-        else
-        {
-            tv_.vt_ = TOKEN;
-        }
-		ch = scan_buffer_.curChar();
-    }
-    else
-    {
-        tv_.vt_ = integerGot ? INT : NONE;
-    }
-
-    if (ch=='E' || ch=='e')
-    {
-        ch = scan_buffer_.nextChar();
-        bool isNegExp = ch=='-';
-        if (ch=='+' || ch=='-')
+        else if (ch=='.' && !integerGot)
         {
             scan_buffer_.advance();
-            uint64_t exp = getUnsignedFromDec();
-            if (isNegExp)
-            {
-                if (tv_.vt_==DOUBLE)
-                {
-                    tv_.double_ = exp<=18 ? tv_.double_/s_exp10[exp] : 0.0;
-                }
-                else if (tv_.vt_==INT)
-                {
-                    tv_.double_ = exp<=18 ? double(tv_.integer_)/s_exp10[exp] : 0.0;
-                    tv_.vt_==DOUBLE;
-                }
-            }
-            else
-            {
-                if (tv_.vt_==DOUBLE)
-                {
-                    tv_.double_ = exp<=18 ? tv_.double_*s_exp10[exp] :
-                        isNeg ? std::numeric_limits<double>::min() : std::numeric_limits<double>::max();
-                }
-                else if (tv_.vt_==INT)
-                {
-                    tv_.integer_ = exp<=18 ? tv_.integer_*s_exp10[exp] :
-                        isNeg ? std::numeric_limits<int64_t>::min() : std::numeric_limits<int64_t>::max();
-                }
-            }
+            tv_.vt_ = TOKEN;
         }
     }
     /*
@@ -376,7 +339,9 @@ void StrScan::getString()
                         setErrStatus(Err_CharHexDigitMissing);
                     }
                     tv_.string_.push_back(char(code));
-                    break;
+                    // the hex digits are consumed
+                    ch = scan_buffer_.curChar();
+                    continue;
                 }
                 case 'u':
                 case 'U':
@@ -415,13 +380,17 @@ void StrScan::getString()
                     {
                         setErrStatus(Err_UCodeInvlid);
                     }
-                    
-                    break;
+                    // the hex digits are consumed
+                    ch = scan_buffer_.curChar();
+                    continue;
                 }
                 default: tv_.string_.push_back(ch); break;
             }
         }
-        tv_.string_.push_back(ch);
+        else
+        {
+            tv_.string_.push_back(ch);
+        }
         ch = scan_buffer_.nextChar();
     }
     if (ch!='"')
@@ -729,45 +698,14 @@ void StrParser::releaseBlockParser(StrParser& block_parser)
 
 size_t StrParser::split (std::vector<std::string>& substrings)
 {
-	size_t scanned(0);
-	size_t start_pos(scan_buffer_.pos());
-	size_t end_pos(start_pos);
-	bool string_started (false);
-	while (scan_buffer_.hasRemaining() && scan_buffer_.curChar()!=terminator_)
-	{
-	    if (scan_buffer_.curChar()==splitSeparator_)
-		{
-			substrings.emplace_back(scan_buffer_.at(start_pos), end_pos-start_pos);
-			string_started = false;
-			++scanned;
-			start_pos = scan_buffer_.pos()+1;
-			end_pos = start_pos;
-		}
-		else if (isspace(scan_buffer_.curChar()))
-		{
-			if (skipLeadingSp_ && !string_started)
-			{
-				++start_pos;
-				++end_pos;
-			}
-			else if (!skipTrailingSp_  && string_started)
-			{
-				++end_pos;
-			}   
-		}
-		else
-		{
-			string_started = true;
-			++end_pos;
-		}
-		scan_buffer_.advance();
-  	}
-	if (end_pos>start_pos)
-	{
-	    substrings.emplace_back(scan_buffer_.at(start_pos), end_pos-start_pos);
-		++scanned;
-	}
-	return scanned;
+    if (!scan_buffer_.hasRemaining())
+    {
+        return 0;
+    }
+    size_t count = substrings.size();
+    scan_buffer_.advance(strSplit(scan_buffer_.curPos(), substrings, scan_buffer_.remaining(),
+        splitSeparator_, terminator_, skipLeadingSp_, skipTrailingSp_));
+    return substrings.size() - count;
 }
 
 inline bool StrParser::isSeparator(char ch) const
@@ -23,6 +23,7 @@
 #include <stddef.h>
 #include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <fstream>
 #include <functional>
@@ -286,6 +287,9 @@ public:
     bool scanned(const char *str) const { return tv_.scanned<N>(str); }
     size_t scannedLength() const { return tv_.scannedLength(); }
     const char* scannedStart() const { return tv_.scannedStart(); }
+    /// \brief view of the scanned text, pointing into the scanned line or, for a mapped
+    /// file stream, into the file
+    std::string_view scannedView() const { return std::string_view(tv_.scannedStart(), tv_.scannedLength()); }
     bool scanned(char ch) const { return tv_.scanned(ch); }
     size_t scannedStartPos() const { return  size_t(tv_.scannedStart()-scan_buffer_.head()); }
     size_t scannedEndPos() const { return  size_t(tv_.scannedEnd()-scan_buffer_.head()); }
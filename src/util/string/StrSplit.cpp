@@ -0,0 +1,139 @@
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+#include "StrSplit.h"
+#include <cstring>                      // for memcpy
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace alt
+{
+
+DelimiterSet::DelimiterSet(std::string_view delimiters)
+{
+    for (char ch: delimiters)
+    {
+        if (count_ == MAX_DELIMITERS || is_delimiter_[uint8_t(ch)])
+        {
+            continue;
+        }
+        uint8_t bit = uint8_t(1 << count_);
+        low_nibbles_[uint8_t(ch) & 0x0F] |= bit;
+        high_nibbles_[uint8_t(ch) >> 4] |= bit;
+        delimiters_[count_++] = ch;
+        is_delimiter_[uint8_t(ch)] = true;
+    }
+}
+
+#if defined(__AVX2__)
+uint64_t DelimiterSet::classify(const char* block) const
+{
+    const __m256i low_table = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(low_nibbles_)));
+    const __m256i high_table = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(high_nibbles_)));
+    const __m256i nibble = _mm256_set1_epi8(0x0F);
+    uint64_t mask = 0;
+    for (int half = 0; half < 2; ++half)
+    {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + half*32));
+        __m256i low = _mm256_shuffle_epi8(low_table, _mm256_and_si256(v, nibble));
+        __m256i high = _mm256_shuffle_epi8(high_table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+        __m256i none = _mm256_cmpeq_epi8(_mm256_and_si256(low, high), _mm256_setzero_si256());
+        mask |= uint64_t(~uint32_t(_mm256_movemask_epi8(none))) << (half*32);
+    }
+    return mask;
+}
+#elif defined(__SSSE3__)
+uint64_t DelimiterSet::classify(const char* block) const
+{
+    const __m128i low_table = _mm_load_si128(reinterpret_cast<const __m128i*>(low_nibbles_));
+    const __m128i high_table = _mm_load_si128(reinterpret_cast<const __m128i*>(high_nibbles_));
+    const __m128i nibble = _mm_set1_epi8(0x0F);
+    uint64_t mask = 0;
+    for (int quarter = 0; quarter < 4; ++quarter)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + quarter*16));
+        __m128i low = _mm_shuffle_epi8(low_table, _mm_and_si128(v, nibble));
+        __m128i high = _mm_shuffle_epi8(high_table, _mm_and_si128(_mm_srli_epi16(v, 4), nibble));
+        __m128i none = _mm_cmpeq_epi8(_mm_and_si128(low, high), _mm_setzero_si128());
+        mask |= uint64_t(~uint32_t(_mm_movemask_epi8(none)) & 0xFFFF) << (quarter*16);
+    }
+    return mask;
+}
+#elif defined(__SSE2__)
+uint64_t DelimiterSet::classify(const char* block) const
+{
+    uint64_t mask = 0;
+    for (int quarter = 0; quarter < 4; ++quarter)
+    {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + quarter*16));
+        __m128i found = _mm_setzero_si128();
+        for (size_t ix = 0; ix < count_; ++ix)
+        {
+            found = _mm_or_si128(found, _mm_cmpeq_epi8(v, _mm_set1_epi8(delimiters_[ix])));
+        }
+        mask |= uint64_t(uint32_t(_mm_movemask_epi8(found))) << (quarter*16);
+    }
+    return mask;
+}
+#else
+uint64_t DelimiterSet::classify(const char* block) const
+{
+    uint64_t mask = 0;
+    for (int ix = 0; ix < 64; ++ix)
+    {
+        mask |= uint64_t(is_delimiter_[uint8_t(block[ix])]) << ix;
+    }
+    return mask;
+}
+#endif
+
+uint64_t DelimiterSet::classify(const char* p, size_t length) const
+{
+    if (length >= 64)
+    {
+        return classify(p);
+    }
+    char block[64] = {};
+    ::memcpy(block, p, length);
+    // the padding may be taken as '\0' delimiters
+    return classify(block) & ((uint64_t(1) << length) - 1);
+}
+
+FieldSplitter::FieldSplitter(const DelimiterSet& delimiters, const char* text, size_t length)
+    : delimiters_(delimiters)
+    , end_(text + length)
+    , block_(text)
+    , next_block_(text)
+    , field_start_(text)
+{
+}
+
+bool FieldSplitter::refill()
+{
+    while (!mask_)
+    {
+        if (next_block_ >= end_)
+        {
+            return false;
+        }
+        size_t length = size_t(end_ - next_block_);
+        block_ = next_block_;
+        mask_ = delimiters_.classify(block_, length);
+        next_block_ = block_ + (length < 64 ? length : 64);
+    }
+    return true;
+}
+
+TagValueScanner::TagValueScanner(const char* text, size_t length, char separator)
+    : separator_(std::string_view(&separator, 1))
+    , splitter_(separator_, text, length)
+    , end_(text + length)
+{
+}
+
+} // namespace alt
@@ -0,0 +1,248 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file StrSplit.h
+ * @library alt_util
+ * @brief Vectorized splitting of text on delimiters:
+ *    - DelimiterSet: a set of up to 8 delimiter chars classifying 64 bytes at
+ *      a time into a bit mask of delimiter positions, by pshufb nibble tables
+ *      with SSSE3 or AVX2, by compares with SSE2, and by a table otherwise
+ *    - FieldSplitter: a zero-copy iterator of the fields between delimiters
+ *    - TagValueScanner: a scanner of FIX-like tag=value fields ended by SOH
+ *      or another delimiter, parsing integer tags with SWAR
+ */
+
+#include "StrBuffer.h"                  // for StrRefInLength
+#include <util/numeric/Intrinsics.h>   // for ctz
+#include <util/numeric/FastFloat.h>    // for isEightDigits, parseEightDigits
+#include <util/system/Platform.h>      // for ALT_INLINE
+#include <cstring>                      // for memcpy
+#include <stddef.h>
+#include <stdint.h>
+#include <string_view>                  // for string_view
+
+namespace alt
+{
+
+/**
+ * \class DelimiterSet
+ * \ingroup StringUtils
+ * \brief A set of delimiter chars. Each delimiter owns a bit in two tables
+ * indexed by the low and the high nibble of a byte, so a byte is a delimiter
+ * if the entries of its two nibbles have a bit in common
+ */
+class DelimiterSet
+{
+  public:
+    static constexpr size_t MAX_DELIMITERS = 8;
+
+    /// \brief constructs the set of the chars in delimiters. Chars after the
+    /// first MAX_DELIMITERS distinct ones are ignored
+    explicit DelimiterSet(std::string_view delimiters);
+
+    bool contains(char ch) const { return is_delimiter_[uint8_t(ch)]; }
+
+    /// \return the bit mask of delimiters in the 64 bytes at block, bit i for
+    /// block[i]
+    uint64_t classify(const char* block) const;
+
+    /// \return the bit mask of delimiters in the first length bytes at p, for
+    /// length up to 64. No byte after them is read
+    uint64_t classify(const char* p, size_t length) const;
+
+  private:
+    alignas(16) uint8_t low_nibbles_[16] {};    ///< delimiter bits by the low nibble
+    alignas(16) uint8_t high_nibbles_[16] {};   ///< delimiter bits by the high nibble
+    char                delimiters_[MAX_DELIMITERS] {};
+    size_t              count_ {0};
+    bool                is_delimiter_[256] {};
+};
+
+/**
+ * \class FieldSplitter
+ * \ingroup StringUtils
+ * \brief Iterates the fields of a text between delimiters without copying.
+ * Delimiters are found 64 bytes at a time into a bit mask, and each field is
+ * taken from the mask by counting trailing zeros.
+ *
+ * Example:
+ * @code
+ *   DelimiterSet csv(",\n");
+ *   FieldSplitter splitter(csv, text, length);
+ *   StrRefInLength field;
+ *   while (splitter.next(field))
+ *   {
+ *       if (splitter.delimiter() == '\n') ...  // the last field of a line
+ *   }
+ * @endcode
+ */
+class FieldSplitter
+{
+  public:
+    /// \brief constructs a splitter of text in [text, text + length). The
+    /// delimiter set must outlive the splitter
+    FieldSplitter(const DelimiterSet& delimiters, const char* text, size_t length);
+
+    /// \brief gets the next field. A text ending with a delimiter has no empty
+    /// field after it
+    /// \return false if there is no more field
+    bool next(StrRefInLength& field);
+
+    /// \return the delimiter ending the last field got, or '\0' at the end of
+    /// the text
+    char delimiter() const { return delimiter_; }
+
+    /// \return the position after the last field got and its delimiter
+    const char* position() const { return field_start_; }
+
+  private:
+    /// \brief classifies blocks until one has a delimiter
+    /// \return false at the end of the text
+    bool refill();
+
+    const DelimiterSet& delimiters_;
+    const char*         end_;
+    const char*         block_;         ///< start of the block of mask_
+    const char*         next_block_;    ///< start of the block to classify next
+    uint64_t            mask_ {0};      ///< delimiters not yet taken in the block
+    const char*         field_start_;
+    char                delimiter_ {'\0'};
+};
+
+/**
+ * \class TagValueScanner
+ * \ingroup StringUtils
+ * \brief Scans FIX-like tag=value fields, such as "8=FIX.4.2\x01" "35=D\x01".
+ * Tags of up to 7 digits are parsed with SWAR from a single 8-byte load, and
+ * longer tags are errors.
+ */
+class TagValueScanner
+{
+  public:
+    static constexpr char SOH = '\x01';
+
+    /// \brief constructs a scanner of text in [text, text + length)
+    /// \param separator the char ending each field
+    TagValueScanner(const char* text, size_t length, char separator = SOH);
+
+    /// \brief gets the next field
+    /// \return false at the end of the text, or if the field is not a number
+    /// followed by '='
+    bool next(uint32_t& tag, StrRefInLength& value);
+
+    /// \return true if scanning stopped on a field with no valid tag
+    bool hasError() const { return error_; }
+
+    /// \return the position after the last field got
+    const char* position() const { return splitter_.position(); }
+
+  private:
+    DelimiterSet    separator_;
+    FieldSplitter   splitter_;
+    const char*     end_;
+    bool            error_ {false};
+};
+
+/// \brief parses the tag of a tag=value field at field, which has at least 8
+/// bytes readable
+/// \return the length of the tag, or 0 if the field does not start with 1 to 7
+/// digits followed by '='
+ALT_INLINE size_t parseTagSWAR(const char* field, uint32_t& tag)
+{
+    uint64_t word;
+    ::memcpy(&word, field, sizeof(word));
+    // a zero byte in word ^ "========" is the first '=', as a false hit of this
+    // test only follows a true one
+    uint64_t eq = word ^ 0x3D3D3D3D3D3D3D3DULL;
+    uint64_t found = (eq - 0x0101010101010101ULL) & ~eq & 0x8080808080808080ULL;
+    if (!found)
+    {
+        return 0;
+    }
+    size_t length = size_t(ctz(found)) / 8;
+    if (length == 0)
+    {
+        return 0;
+    }
+    // move the digits to the end of 8 chars led by '0's
+    uint64_t digits = (word << (8 * (8 - length))) | (0x3030303030303030ULL >> (8 * length));
+    char text[8];
+    ::memcpy(text, &digits, sizeof(text));
+    if (!isEightDigits(text))
+    {
+        return 0;
+    }
+    tag = parseEightDigits(text);
+    return length;
+}
+
+ALT_INLINE bool FieldSplitter::next(StrRefInLength& field)
+{
+    if (field_start_ >= end_)
+    {
+        delimiter_ = '\0';
+        return false;
+    }
+    if (mask_ || refill())
+    {
+        const char* found = block_ + ctz(mask_);
+        mask_ &= mask_ - 1;
+        field = StrRefInLength(field_start_, size_t(found - field_start_));
+        delimiter_ = *found;
+        field_start_ = found + 1;
+    }
+    else
+    {
+        field = StrRefInLength(field_start_, size_t(end_ - field_start_));
+        delimiter_ = '\0';
+        field_start_ = end_;
+    }
+    return true;
+}
+
+ALT_INLINE bool TagValueScanner::next(uint32_t& tag, StrRefInLength& value)
+{
+    StrRefInLength field;
+    if (error_ || !splitter_.next(field))
+    {
+        return false;
+    }
+    const char* p = field.c_str();
+    size_t tag_length = 0;
+    if (end_ - p >= 8)
+    {
+        tag_length = parseTagSWAR(p, tag);
+    }
+    else
+    {
+        // near the end of the text, a char at a time
+        uint32_t val = 0;
+        while (tag_length < 7 && tag_length < field.length() && p[tag_length] >= '0' && p[tag_length] <= '9')
+        {
+            val = val * 10 + uint32_t(p[tag_length++] - '0');
+        }
+        if (tag_length < field.length() && p[tag_length] == '=')
+        {
+            tag = val;
+        }
+        else
+        {
+            tag_length = 0;
+        }
+    }
+    // the '=' found by SWAR may be in the next field
+    if (tag_length == 0 || tag_length >= field.length())
+    {
+        error_ = true;
+        return false;
+    }
+    value = StrRefInLength(p + tag_length + 1, field.length() - tag_length - 1);
+    return true;
+}
+
+} // namespace alt
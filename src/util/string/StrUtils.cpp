@@ -1,6 +1,7 @@
 
 #include "StrUtils.h"
 #include "StrPrint.h"
+#include "StrSplit.h"
 #include <iostream>
 #include <cstring>
 #include <cassert>
@@ -351,46 +352,35 @@ size_t strSplit (
         length = std::strlen(str); // fastStrLen(str);
     }
 
-    size_t scanned(0);
-    size_t pos = 0;
-    size_t start_pos(pos);
-    size_t end_pos(pos);
-    bool string_started (false);
-    while (pos < length && str[pos]!=terminator)
+    const char delimiters[2] = { separator, terminator };
+    DelimiterSet delimiter_set(std::string_view(delimiters, 2));
+    FieldSplitter splitter(delimiter_set, str, length);
+    StrRefInLength field;
+    while (splitter.next(field))
     {
-        if (str[pos]==separator)
+        const char* begin = field.c_str();
+        const char* end = begin + field.length();
+        if (skip_leading_sp)
         {
-            substrings.emplace_back(str+start_pos, end_pos-start_pos);
-            string_started = false;
-            ++scanned;
-            start_pos = pos+1;
-            end_pos = start_pos;
+            while (begin < end && isspace(*begin)) ++begin;
         }
-        else if (isspace(str[pos]))
+        if (skip_trailing_sp)
         {
-            if (skip_leading_sp && !string_started)
-            {
-                ++start_pos;
-                ++end_pos;
-            }
-            else if (!skip_trailing_sp  && string_started)
-            {
-                ++end_pos;
-            }   
+            while (end > begin && isspace(*(end-1))) --end;
         }
-        else
+        // the last substring is not taken if empty
+        bool last = splitter.delimiter()!=separator;
+        if (!last || end > begin)
         {
-            string_started = true;
-            ++end_pos;
+            substrings.emplace_back(begin, size_t(end-begin));
+        }
+        if (last)
+        {
+            // stop at the terminator, which is not scanned
+            return size_t(field.c_str()+field.length()-str);
         }
-        ++pos;
-      }
-    if (end_pos>start_pos)
-    {
-        substrings.emplace_back(str+start_pos, end_pos-start_pos);
-        ++scanned;
     }
-    return scanned;
+    return length;
 }
 
 size_t strSplitQuoted (
@@ -22,6 +22,9 @@
 #include <cstring>
 #include <vector>
 #include <ctype.h>
+#if defined(__SSE2__)
+#include <emmintrin.h>                 // for _mm_cmpeq_epi8
+#endif
 
 //----------------------------------------------------------------------------
 // string utils
@@ -35,7 +38,7 @@ template <> ALT_INLINE void strCpy<1> (char* d, const char* s)
 template <> ALT_INLINE void strCpy<2> (char* d, const char* s) 
 { *((int16_t*)d)=*((int16_t*)s); }
 template <> ALT_INLINE void strCpy<3> (char* d, const char* s)
-{ strCpy<2>(d+4,s+4); *(d+4)=*(s+4); }
+{ strCpy<2>(d,s); *(d+2)=*(s+2); }
 template <> ALT_INLINE void strCpy<4> (char* d, const char* s)
 { *((int32_t*)d)=*((int32_t*)s); }
 template <> ALT_INLINE void strCpy<5> (char* d, const char* s)
@@ -70,7 +73,7 @@ ALT_INLINE bool str3Equal (const char* x, const char* y)
 ALT_INLINE bool str4Equal (const char* x, const char* y)
 { return *((int32_t*)x)==*((int32_t*)y); }
 ALT_INLINE bool str5Equal (const char* x, const char* y)
-{ return str4Equal(x,y) && *(x+2)==*(y+2); }
+{ return str4Equal(x,y) && *(x+4)==*(y+4); }
 ALT_INLINE bool str6Equal (const char* x, const char* y)
 { return str4Equal(x,y) && str2Equal(x+4,y+4); }
 ALT_INLINE bool str7Equal (const char* x, const char* y)
@@ -93,7 +96,7 @@ template<> ALT_INLINE bool strEqual<3> (const char* x, const char* y)
 template<> ALT_INLINE bool strEqual<4> (const char* x, const char* y)
 { return *((int32_t*)x)==*((int32_t*)y); }
 template<> ALT_INLINE bool strEqual<5> (const char* x, const char* y)
-{ return str4Equal(x,y) && *(x+2)==*(y+2); }
+{ return str4Equal(x,y) && *(x+4)==*(y+4); }
 template<> ALT_INLINE bool strEqual<6> (const char* x, const char* y)
 { return str4Equal(x,y) && str2Equal(x+4,y+4); }
 template<> ALT_INLINE bool strEqual<7> (const char* x, const char* y)
@@ -117,6 +120,50 @@ template<> ALT_INLINE bool strEqual<15> (const char* x, const char* y)
 template<> ALT_INLINE bool strEqual<16> (const char* x, const char* y)
 { return str8Equal(x,y) && str8Equal(x+8,y+8); }
 
+/// \brief compares two strings of the same known length. Up to 16 bytes the
+/// comparison is done with the fixed-size versions above, longer strings are
+/// compared 16 bytes at a time with the last block overlapping the one before
+/// it, so no byte beyond length is read
+ALT_INLINE bool strEqual (const char* x, const char* y, size_t length)
+{
+    switch (length)
+    {
+        case 0: return true;
+        case 1: return strEqual<1>(x,y);
+        case 2: return strEqual<2>(x,y);
+        case 3: return strEqual<3>(x,y);
+        case 4: return strEqual<4>(x,y);
+        case 5: return strEqual<5>(x,y);
+        case 6: return strEqual<6>(x,y);
+        case 7: return strEqual<7>(x,y);
+        case 8: return strEqual<8>(x,y);
+        case 9: return strEqual<9>(x,y);
+        case 10: return strEqual<10>(x,y);
+        case 11: return strEqual<11>(x,y);
+        case 12: return strEqual<12>(x,y);
+        case 13: return strEqual<13>(x,y);
+        case 14: return strEqual<14>(x,y);
+        case 15: return strEqual<15>(x,y);
+        case 16: return strEqual<16>(x,y);
+        default: break;
+    }
+#if defined(__SSE2__)
+    auto block_equal = [x, y] (size_t pos)
+    {
+        __m128i xb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x+pos));
+        __m128i yb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y+pos));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(xb, yb)) == 0xFFFF;
+    };
+    for (size_t pos = 0; pos < length-16; pos += 16)
+    {
+        if (!block_equal(pos)) return false;
+    }
+    return block_equal(length-16);
+#else
+    return std::memcmp(x, y, length)==0;
+#endif
+}
+
 // Call these functions if you know the start buffer is already
 // aligned by 16. Otherwise, called the unaligned version
 const char* fastStrChrAligned(const char* s, char ch);
@@ -169,7 +216,8 @@ constexpr std::array<char,9> strFromNameId(uint64_t id)
 /// substring should be skipped
 /// \param skip_trailing_sp Flag to indicating whether the trailing spaces of the
 /// substring should be skipped
-/// \return the number of characters scanned in str
+/// \return the number of characters scanned in str before the terminator
+/// \note separators are found by FieldSplitter 64 characters at a time
 size_t strSplit (
     const char * str,
     std::vector<std::string>& substrings,
@@ -6,6 +6,11 @@
 #include "StreamParser.h"
 #include "StrUtils.h"
 #include <sstream>
+#include <cstring>          // for memchr
+#include <sys/mman.h>       // for mmap, madvise
+#include <sys/stat.h>       // for fstat
+#include <fcntl.h>          // for open
+#include <unistd.h>         // for close, sysconf
 
 using namespace alt;
 
@@ -28,6 +33,12 @@ ParserStream::~ParserStream()
         delete input_stream_;
         input_stream_ = nullptr;
     }
+    if (mapped_data_)
+    {
+        // unmaps the trailing zero page as well
+        ::munmap(const_cast<char*>(mapped_data_), mapped_size_ + 1);
+        mapped_data_ = nullptr;
+    }
 }
 
 ParserStream* ParserStream::createFileStream (const char* file_path)
@@ -44,12 +55,76 @@ ParserStream* ParserStream::createFileStream (const char* file_path)
     return nullptr;
 }
 
+ParserStream* ParserStream::createMappedStream (const char* file_path)
+{
+    int fd = ::open(file_path, O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    size_t file_size = size_t(st.st_size);
+
+    // Reserve the file size plus at least one byte of zero pages, then map the
+    // file over the head of it. Scanning stops at the '\0' after the content
+    // even if the file size is a multiple of the page size
+    size_t page_size = size_t(::sysconf(_SC_PAGESIZE));
+    size_t reserved_size = (file_size / page_size + 1) * page_size;
+    void* area = ::mmap(nullptr, reserved_size, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (area == MAP_FAILED)
+    {
+        ::close(fd);
+        return nullptr;
+    }
+    if (file_size > 0)
+    {
+        int flags = MAP_PRIVATE | MAP_FIXED;
+#ifdef MAP_POPULATE
+        flags |= MAP_POPULATE;
+#endif
+        if (::mmap(area, file_size, PROT_READ, flags, fd, 0) == MAP_FAILED)
+        {
+            ::munmap(area, reserved_size);
+            ::close(fd);
+            return nullptr;
+        }
+        ::madvise(area, file_size, MADV_SEQUENTIAL);
+    }
+    ::close(fd);
+
+    auto res = new ParserStream(static_cast<std::istream*>(nullptr));
+    res->file_path_   = file_path;
+    res->mapped_data_ = static_cast<const char*>(area);
+    res->mapped_size_ = file_size;
+    return res;
+}
+
 void ParserStream::registerError(ParseErrID err, const char* extra_into, size_t pos)
 {
-    errors_.emplace_back(ErrorInfo(err, extra_into, line_, pos));
+    size_t line = line_;
+    if (mapped_data_ && pos <= mapped_size_)
+    {
+        // the whole file is one scan buffer; find the line and the position in
+        // the line only when an error is reported
+        line = 1;
+        const char* line_start = mapped_data_;
+        const char* end = mapped_data_ + pos;
+        while (auto eol = static_cast<const char*>(::memchr(line_start, '\n', size_t(end - line_start))))
+        {
+            ++line;
+            line_start = eol + 1;
+        }
+        pos = size_t(end - line_start);
+    }
+    errors_.emplace_back(ErrorInfo(err, extra_into, line, pos));
     std::cerr << "Error (" << err << "): ";
     if (extra_into) std::cerr << extra_into;
-    std::cerr << " at line " << line_ << ", pos " << pos << std::endl;
+    std::cerr << " at line " << line << ", pos " << pos << std::endl;
 }
 
 //==============================================================================
@@ -310,7 +385,27 @@ bool ParserStreamContext::nextLine()
 {
     //std::cout << "nextline called" << std::endl;
 
-    if (!current_stream_ || !current_stream_->input_stream_ || current_stream_->at_stream_end_)
+    if (!current_stream_ || current_stream_->at_stream_end_)
+    {
+        return false;
+    }
+
+    if (current_stream_->mapped_data_)
+    {
+        // a mapped file is scanned as a single line, given to the first parser
+        // pushed if the stream is pushed before any parser
+        if (!current_parser_)
+        {
+            return false;
+        }
+        current_parser_->scan_buffer_.reset(
+            current_stream_->mapped_data_, current_stream_->mapped_size_);
+        current_stream_->at_stream_end_ = true;
+        current_stream_->line_ = 1;
+        return true;
+    }
+
+    if (!current_stream_->input_stream_)
     {
         return false;
     }
@@ -376,6 +471,11 @@ bool ParserStreamContext::pushStream (ParserStream * stream)
                 context.stream_line_buffer_saved_
             );
         }
+        else if (current_parser_ && current_stream_->mapped_data_)
+        {
+            // nothing to save as the mapping stays, only the position in it
+            context.scan_pos_ = current_parser_->scan_buffer_.pos();
+        }
         context.stream_ = current_stream_;
     }
     current_stream_ = stream;
@@ -404,6 +504,11 @@ bool ParserStreamContext::popStream ()
     }
     delete current_stream_;
     current_stream_ = context.stream_;
+    if (current_parser_ && current_stream_->mapped_data_)
+    {
+        current_parser_->scan_buffer_.reset(current_stream_->mapped_data_, current_stream_->mapped_size_);
+        current_parser_->scan_buffer_.resetPos(context.scan_pos_);
+    }
     stream_context_.pop_back();
     return true;
 }
@@ -419,6 +524,17 @@ bool ParserStreamContext::pushFileStream (const char* file_path)
     return false;
 }
 
+bool ParserStreamContext::pushMappedFileStream (const char* file_path)
+{
+    auto stream = ParserStream::createMappedStream(file_path);
+    if (stream)
+    {
+        stream->original_file_path_ = file_path;
+        return pushStream(stream);
+    }
+    return false;
+}
+
 bool ParserStreamContext::pushStream (std::istream * stream)
 {
     return pushStream(new ParserStream(stream));
@@ -485,6 +601,15 @@ bool ParserStreamContext::pushFileParser(StreamParser * parser, const char * fil
     return pushParser(parser);
 }
 
+bool ParserStreamContext::pushMappedFileParser(StreamParser * parser, const char * file_path)
+{
+    if (!pushMappedFileStream(file_path))
+    {
+        return false;
+    }
+    return pushParser(parser);
+}
+
 bool ParserStreamContext::pushParser(StreamParser * parser, const std::filesystem::path& path)
 {
     if (!pushStream(path))
@@ -67,12 +67,27 @@ public:
         return createFileStream(file_path.string().c_str());
     }
 
+    /// \brief create a ParserStream on a read-only memory mapping of the given file.
+    /// The whole file is scanned in place as a single buffer, so no line is copied and
+    /// scanned strings point into the file. The mapping is followed by a zero byte to
+    /// terminate the scan.
+    /// \return the ParserStream created or nullptr if the file cannot be mapped
+    static ParserStream* createMappedStream (const char* file_path);
+
+    /// \brief tells if the stream is a memory mapped file
+    bool isMapped() const { return mapped_data_ != nullptr; }
+
+    /// \brief returns the file content of a mapped stream, followed by a zero byte
+    const char* mappedData() const { return mapped_data_; }
+    size_t mappedSize() const { return mapped_size_; }
+
     /// \brief tells if the current parsing position reaches to end
     bool atEnd() { return at_stream_end_; }
 
     /// \brief register error in parsing
     /// \param err the error string
-    /// \param pos the postion in the current line buffer
+    /// \param pos the postion in the current line buffer, or in the file if the
+    /// stream is mapped
     void registerError(ParseErrID err, const char* extra_into, size_t pos);
 
     /// \brief returns regitered error list
@@ -88,6 +103,8 @@ protected:
     bool                   owns_stream_    {false};    // whether this object owns the input_stream_
                                                        // If true, input_stream_ needs to be released
     ErrorInfoVec           errors_;                    // registered erros for this stream during parsing
+    const char *           mapped_data_    {nullptr};  // the file content if it is a mapped stream
+    size_t                 mapped_size_    {0};        // size of the mapped file
 };
 
 
@@ -157,6 +174,7 @@ class  ParserStreamContext
         bool pushFileStream (const char* file_path);
         bool pushStream (const std::filesystem::path& path) { return pushFileStream(path.string().c_str()); }
         bool pushStream (const std::filesystem::path& path, const std::filesystem::path& original_path);
+        bool pushMappedFileStream (const char* file_path);
 
         bool popStream();
 
@@ -165,6 +183,7 @@ class  ParserStreamContext
         bool pushParser(StreamParser * parser, std::istream *);
         bool pushParser(StreamParser * parser, const char *);
         bool pushFileParser(StreamParser * parser, const char * file_path);
+        bool pushMappedFileParser(StreamParser * parser, const char * file_path);
         bool pushParser(StreamParser * parser, const std::filesystem::path& path);
         bool popParser ();
 
@@ -422,7 +422,7 @@ bool XmlParser::parseNode (PooledNamedNode* node)
 XmlNode* XmlParser::parseFile(const char* file_path)
 {
     ParserStreamContext context;
-    if (!context.pushFileStream (file_path))
+    if (!context.pushMappedFileStream (file_path) && !context.pushFileStream (file_path))
     {
         return nullptr;
     }
@@ -0,0 +1,502 @@
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+#include "XmlPushParser.h"
+#include "StrUtils.h"                   // for wcharToUTF8
+#include <cstring>                      // for memchr
+#include <cstdlib>                      // for strtoul
+
+namespace alt
+{
+
+namespace
+{
+
+bool isXmlSpace(char ch) { return ch==' ' || ch=='\t' || ch=='\n' || ch=='\r'; }
+
+bool isXmlNameStartChar(char ch)
+{
+    unsigned char uch = static_cast<unsigned char>(ch);
+    return (uch>='A' && uch<='Z') || (uch>='a' && uch<='z') || uch=='_' || uch==':' || uch>=128;
+}
+
+bool isXmlNameEnd(char ch) { return isXmlSpace(ch) || ch=='/' || ch=='>' || ch=='='; }
+
+std::string_view trim(std::string_view text)
+{
+    size_t start = 0;
+    while (start < text.length() && isXmlSpace(text[start])) ++start;
+    size_t end = text.length();
+    while (end > start && isXmlSpace(text[end - 1])) --end;
+    return text.substr(start, end - start);
+}
+
+/// \return the first '<' or '&' in [p, end), or end if none
+const char* findMarkup(const char* p, const char* end, char ch)
+{
+    auto lt = static_cast<const char*>(memchr(p, ch, size_t(end - p)));
+    if (!lt) lt = end;
+    auto amp = static_cast<const char*>(memchr(p, '&', size_t(lt - p)));
+    return amp ? amp : lt;
+}
+
+} // namespace
+
+XmlPushParser::XmlPushParser(XmlEventListener& listener, size_t max_depth)
+    : listener_(listener)
+    , max_depth_(max_depth)
+{
+}
+
+void XmlPushParser::reset()
+{
+    state_ = State::Text;
+    names_.clear();
+    name_starts_.clear();
+    token_.clear();
+    error_.clear();
+    position_ = 0;
+}
+
+bool XmlPushParser::inToken() const
+{
+    return state_ == State::Text || state_ == State::TagName || state_ == State::AttrName ||
+           state_ == State::AttrValue || state_ == State::EndTag || state_ == State::CData;
+}
+
+void XmlPushParser::setError(const char* pos, const char* message)
+{
+    error_ = message;
+    error_ += " at ";
+    error_ += std::to_string(position_ + size_t(pos - chunk_));
+    state_ = State::Error;
+}
+
+std::string_view XmlPushParser::tokenView(const char* end)
+{
+    if (token_.empty())
+    {
+        return std::string_view(run_, size_t(end - run_));
+    }
+    token_.append(run_, size_t(end - run_));
+    return token_;
+}
+
+void XmlPushParser::startText(const char* p)
+{
+    state_ = State::Text;
+    run_ = p;
+}
+
+void XmlPushParser::endText(const char* p)
+{
+    std::string_view text = trim(tokenView(p));
+    if (!text.empty())
+    {
+        if (name_starts_.empty())
+        {
+            setError(p, "text outside of the root element");
+            return;
+        }
+        listener_.onText(text);
+    }
+    token_.clear();
+}
+
+void XmlPushParser::startElement(const char* p)
+{
+    std::string_view name = tokenView(p);
+    if (name_starts_.size() >= max_depth_)
+    {
+        setError(p, "too deep");
+        return;
+    }
+    name_starts_.push_back(uint32_t(names_.length()));
+    names_.append(name);
+    token_.clear();
+    listener_.onStartElement(std::string_view(names_).substr(name_starts_.back()));
+    state_ = State::InTag;
+}
+
+void XmlPushParser::endElement(std::string_view name, const char* p)
+{
+    std::string_view open_name = name_starts_.empty()
+        ? std::string_view() : std::string_view(names_).substr(name_starts_.back());
+    if (name_starts_.empty() || name != open_name)
+    {
+        setError(p, "unmatched closing tag name");
+        return;
+    }
+    listener_.onEndElement(open_name);
+    names_.resize(name_starts_.back());
+    name_starts_.pop_back();
+    if (name_starts_.empty())
+    {
+        listener_.onEndDocument();
+    }
+    startText(p + 1);
+}
+
+void XmlPushParser::endEntity(const char* p)
+{
+    if (entity_ == "lt") token_.push_back('<');
+    else if (entity_ == "gt") token_.push_back('>');
+    else if (entity_ == "amp") token_.push_back('&');
+    else if (entity_ == "quot") token_.push_back('"');
+    else if (entity_ == "apos") token_.push_back('\'');
+    else if (entity_.length() > 1 && entity_[0] == '#')
+    {
+        bool hex = entity_[1] == 'x' || entity_[1] == 'X';
+        char* end;
+        unsigned long code = std::strtoul(entity_.c_str() + (hex ? 2 : 1), &end, hex ? 16 : 10);
+        if (*end || code > 0x10FFFF)
+        {
+            setError(p, "invalid character reference");
+            return;
+        }
+        char utf8[8];
+        token_.append(utf8, wcharToUTF8(alt_char_t(code), utf8, sizeof(utf8)));
+    }
+    else
+    {
+        setError(p, "unknown entity");
+        return;
+    }
+    state_ = entity_return_;
+    run_ = p + 1;
+}
+
+bool XmlPushParser::feed(const char* data, size_t length)
+{
+    if (state_ == State::Error)
+    {
+        return false;
+    }
+    chunk_ = data;
+    const char* p = data;
+    const char* end = data + length;
+    if (inToken())
+    {
+        run_ = p;
+    }
+    while (p < end && state_ != State::Error)
+    {
+        char ch = *p;
+        switch (state_)
+        {
+            case State::Text:
+            case State::AttrValue:
+            {
+                bool in_text = state_ == State::Text;
+                const char* q = findMarkup(p, end, in_text ? '<' : quote_);
+                if (q == end)
+                {
+                    p = end;
+                }
+                else if (*q == '&')
+                {
+                    token_.append(run_, size_t(q - run_));
+                    entity_.clear();
+                    entity_return_ = state_;
+                    state_ = State::Entity;
+                    p = q + 1;
+                }
+                else if (in_text)
+                {
+                    endText(q);
+                    if (state_ != State::Error)
+                    {
+                        state_ = State::TagOpen;
+                    }
+                    p = q + 1;
+                }
+                else
+                {
+                    listener_.onAttribute(attr_name_, tokenView(q));
+                    token_.clear();
+                    state_ = State::InTag;
+                    p = q + 1;
+                }
+                break;
+            }
+
+            case State::Entity:
+                if (ch == ';')
+                {
+                    endEntity(p);
+                }
+                else if (entity_.length() < 10)
+                {
+                    entity_.push_back(ch);
+                }
+                else
+                {
+                    setError(p, "entity is too long");
+                }
+                ++p;
+                break;
+
+            case State::TagOpen:
+                if (ch == '/')
+                {
+                    state_ = State::EndTag;
+                    run_ = ++p;
+                }
+                else if (ch == '!')
+                {
+                    state_ = State::Bang;
+                    entity_.clear();
+                    ++p;
+                }
+                else if (ch == '?')
+                {
+                    state_ = State::Instruction;
+                    count_ = 0;
+                    ++p;
+                }
+                else if (isXmlNameStartChar(ch))
+                {
+                    state_ = State::TagName;
+                    run_ = p++;
+                }
+                else
+                {
+                    setError(p, "XML name cannot start with any number or punctuation character");
+                }
+                break;
+
+            case State::TagName:
+                if (isXmlNameEnd(ch))
+                {
+                    startElement(p);
+                }
+                else
+                {
+                    ++p;
+                }
+                break;
+
+            case State::InTag:
+                if (isXmlSpace(ch))
+                {
+                    ++p;
+                }
+                else if (ch == '>')
+                {
+                    startText(++p);
+                }
+                else if (ch == '/')
+                {
+                    state_ = State::EmptyTag;
+                    ++p;
+                }
+                else if (isXmlNameStartChar(ch))
+                {
+                    state_ = State::AttrName;
+                    run_ = p++;
+                }
+                else
+                {
+                    setError(p, "invalid attribute name");
+                }
+                break;
+
+            case State::AttrName:
+                if (isXmlNameEnd(ch))
+                {
+                    attr_name_.assign(tokenView(p));
+                    token_.clear();
+                    state_ = State::AttrEqual;
+                }
+                else
+                {
+                    ++p;
+                }
+                break;
+
+            case State::AttrEqual:
+            case State::AttrQuote:
+                if (isXmlSpace(ch))
+                {
+                    ++p;
+                }
+                else if (state_ == State::AttrEqual && ch == '=')
+                {
+                    state_ = State::AttrQuote;
+                    ++p;
+                }
+                else if (state_ == State::AttrQuote && (ch == '"' || ch == '\''))
+                {
+                    quote_ = ch;
+                    state_ = State::AttrValue;
+                    run_ = ++p;
+                }
+                else
+                {
+                    setError(p, state_ == State::AttrEqual ? "missing '=' in attribute" : "missing quote in attribute");
+                }
+                break;
+
+            case State::EmptyTag:
+                if (ch == '>')
+                {
+                    endElement(std::string_view(names_).substr(name_starts_.back()), p);
+                    ++p;
+                }
+                else
+                {
+                    setError(p, "missing '>' in closing tag");
+                }
+                break;
+
+            case State::EndTag:
+            {
+                auto q = static_cast<const char*>(memchr(p, '>', size_t(end - p)));
+                if (!q)
+                {
+                    p = end;
+                    break;
+                }
+                std::string_view name = trim(tokenView(q));
+                // the name is compared before token_ is cleared
+                endElement(name, q);
+                token_.clear();
+                p = q + 1;
+                break;
+            }
+
+            case State::Bang:
+            {
+                entity_.push_back(ch);
+                std::string_view prefix = entity_;
+                if (prefix == "--")
+                {
+                    state_ = State::Comment;
+                    count_ = 0;
+                }
+                else if (prefix == "[CDATA[")
+                {
+                    state_ = State::CData;
+                    count_ = 0;
+                    run_ = p + 1;
+                }
+                else if (std::string_view("--").substr(0, prefix.length()) != prefix &&
+                         std::string_view("[CDATA[").substr(0, prefix.length()) != prefix)
+                {
+                    // a declaration such as <!DOCTYPE ...>, ch is scanned again
+                    state_ = State::Declaration;
+                    count_ = 0;
+                    break;
+                }
+                ++p;
+                break;
+            }
+
+            case State::Comment:
+                if (ch == '-')
+                {
+                    ++count_;
+                }
+                else if (ch == '>' && count_ >= 2)
+                {
+                    startText(p + 1);
+                }
+                else
+                {
+                    count_ = 0;
+                }
+                ++p;
+                break;
+
+            case State::CData:
+                if (ch == ']')
+                {
+                    ++count_;
+                }
+                else if (ch == '>' && count_ >= 2)
+                {
+                    std::string_view text = tokenView(p);
+                    text.remove_suffix(2);
+                    if (!text.empty())
+                    {
+                        listener_.onText(text);
+                    }
+                    token_.clear();
+                    startText(p + 1);
+                }
+                else
+                {
+                    count_ = 0;
+                }
+                ++p;
+                break;
+
+            case State::Declaration:
+                if (ch == '[')
+                {
+                    ++count_;
+                }
+                else if (ch == ']' && count_)
+                {
+                    --count_;
+                }
+                else if (ch == '>' && !count_)
+                {
+                    startText(p + 1);
+                }
+                ++p;
+                break;
+
+            case State::Instruction:
+                if (ch == '>' && count_)
+                {
+                    startText(p + 1);
+                }
+                count_ = ch == '?';
+                ++p;
+                break;
+
+            case State::Error:
+                break;
+        }
+    }
+
+    if (inToken())
+    {
+        token_.append(run_, size_t(end - run_));
+    }
+    position_ += length;
+    return state_ != State::Error;
+}
+
+bool XmlPushParser::feed(const iovec* iov, int iovcnt)
+{
+    for (int ix = 0; ix < iovcnt; ++ix)
+    {
+        if (!feed(static_cast<const char*>(iov[ix].iov_base), iov[ix].iov_len))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool XmlPushParser::finish()
+{
+    const char* p = token_.data() + token_.length();
+    chunk_ = p;
+    if (state_ == State::Text)
+    {
+        run_ = p;
+        endText(p);
+    }
+    if (state_ != State::Error && (state_ != State::Text || !name_starts_.empty()))
+    {
+        setError(p, "incomplete XML");
+    }
+    return state_ != State::Error;
+}
+
+} // namespace alt
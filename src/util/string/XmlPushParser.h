@@ -0,0 +1,138 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file XmlPushParser.h
+ * @library alt_util
+ * @brief Implements an event based XML parser taking input in chunks of any
+ * size. Unlike XmlParser, no tree is built and the document is never held in
+ * memory: events are sent to an XmlEventListener as tags and texts complete, and
+ * the only state kept between chunks is the stack of open element names and the
+ * token being scanned when a chunk ends.
+ * @note Like XmlParser, only UTF-8 is supported. Comments, declarations and
+ * processing instructions are skipped. Texts are trimmed as in XmlParser.
+ */
+
+#include <util/types/TemplateHelper.h>  // for NONCOPYABLE
+#include <sys/uio.h>                    // for iovec
+#include <string>
+#include <string_view>                  // for string_view
+#include <vector>
+
+namespace alt
+{
+
+/**
+ * \class XmlEventListener
+ * \ingroup StringUtils
+ * \brief Receives events from XmlPushParser. String views passed are valid only
+ * during the call.
+ */
+class XmlEventListener
+{
+  public:
+    virtual ~XmlEventListener() = default;
+
+    /// \brief called when the name of an opening tag is scanned. Attributes of
+    /// the element follow
+    virtual void onStartElement(std::string_view) {}
+    virtual void onAttribute(std::string_view /*name*/, std::string_view /*value*/) {}
+
+    /// \brief called for a text or a CDATA section in an element
+    virtual void onText(std::string_view) {}
+    virtual void onEndElement(std::string_view) {}
+
+    /// \brief called when the root element closes
+    virtual void onEndDocument() {}
+};
+
+/**
+ * \class XmlPushParser
+ * \ingroup StringUtils
+ * \brief Parses XML text pushed in chunks into events. A name, text or value
+ * completed within a chunk without entities is passed to the listener without
+ * copying; only a token crossing chunks is copied into the parser.
+ */
+class XmlPushParser
+{
+  public:
+    /// \brief constructs a parser
+    /// \param listener the listener receiving events
+    /// \param max_depth the maximum nesting depth of elements
+    explicit XmlPushParser(XmlEventListener& listener, size_t max_depth = 1024);
+    NONCOPYABLE(XmlPushParser);
+
+    /// \brief parses the next chunk of the text
+    /// \return false if there is an error, in this or in a previous chunk
+    bool feed(const char* data, size_t length);
+
+    /// \brief parses the next chunks of the text, for instance, as fetched from
+    /// RingBuffer::fetchAll
+    bool feed(const iovec* iov, int iovcnt);
+
+    /// \brief ends the text
+    /// \return false if there is an error or the text ends inside an element
+    bool finish();
+
+    /// \brief resets the parser to parse a new text
+    void reset();
+
+    bool hasError() const { return !error_.empty(); }
+    const std::string& error() const { return error_; }
+
+    /// \return the number of bytes parsed
+    size_t position() const { return position_; }
+
+  private:
+    enum class State : uint8_t
+    {
+        Text,
+        Entity,         // after '&' in a text or a value
+        TagOpen,        // after '<'
+        TagName,
+        InTag,          // between attributes
+        AttrName,
+        AttrEqual,      // after an attribute name
+        AttrQuote,      // after '='
+        AttrValue,
+        EmptyTag,       // after '/' in a tag
+        EndTag,         // in the name of a closing tag
+        Bang,           // after "<!"
+        Comment,
+        CData,
+        Declaration,    // <!DOCTYPE ...>
+        Instruction,    // <? ... ?>
+        Error
+    };
+
+    bool inToken() const;
+    std::string_view tokenView(const char* end);
+    void startText(const char* p);
+    void endText(const char* p);
+    void startElement(const char* p);
+    void endElement(std::string_view name, const char* p);
+    void endEntity(const char* p);
+    void setError(const char* pos, const char* message);
+
+    XmlEventListener&       listener_;
+    size_t                  max_depth_;
+    State                   state_ {State::Text};
+    State                   entity_return_ {State::Text};
+    char                    quote_ {'"'};
+    uint32_t                count_ {0};         ///< dashes, brackets or '?' seen
+    std::string             names_;             ///< names of open elements
+    std::vector<uint32_t>   name_starts_;       ///< start of each name in names_
+    std::string             attr_name_;
+    std::string             entity_;
+    const char*             run_ {nullptr};     ///< start of the token in the current chunk
+    std::string             token_;             ///< token copied from previous chunks
+    std::string             error_;
+    size_t                  position_ {0};      ///< bytes before the current chunk
+    const char*             chunk_ {nullptr};   ///< the current chunk
+};
+
+} // namespace alt
@@ -0,0 +1,559 @@
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+#include "XmlReader.h"
+#include <cstring>                      // for memchr, memcmp, memmove
+#include <limits>                       // for numeric_limits
+#include <new>                          // for placement new
+
+namespace alt
+{
+
+namespace
+{
+    inline bool isXmlSpace(char ch) { return ch==' ' || ch=='\t' || ch=='\n' || ch=='\r'; }
+
+    inline bool isNameEnd(char ch) { return isXmlSpace(ch) || ch=='/' || ch=='>' || ch=='='; }
+
+    inline bool isNameStart(unsigned char ch)
+    {
+        return (ch>='A' && ch<='Z') || (ch>='a' && ch<='z') || ch=='_' || ch==':' || ch>=128;
+    }
+
+    inline const char* skipSpace(const char* p, const char* end)
+    {
+        while (p < end && isXmlSpace(*p)) ++p;
+        return p;
+    }
+
+    inline bool startsWith(const char* p, const char* end, std::string_view prefix)
+    {
+        return size_t(end - p) >= prefix.length() && std::memcmp(p, prefix.data(), prefix.length()) == 0;
+    }
+
+    /// \return the start of seq in [p, end), or nullptr if not found
+    const char* findSeq(const char* p, const char* end, std::string_view seq)
+    {
+        size_t pos = std::string_view(p, size_t(end - p)).find(seq);
+        return pos == std::string_view::npos ? nullptr : p + pos;
+    }
+
+    /// \brief decodes the entity at src into out
+    /// \return the position after the entity
+    const char* decodeEntity(const char* src, const char* end, char*& out)
+    {
+        // the longest entity is "&#x10FFFF;"
+        size_t limit = size_t(end - src) < 11 ? size_t(end - src) : 11;
+        const char* semi = static_cast<const char*>(std::memchr(src, ';', limit));
+        if (!semi)
+        {
+            *out++ = '&';
+            return src + 1;
+        }
+        std::string_view name(src + 1, size_t(semi - src - 1));
+        char ch = '\0';
+        if (name == "amp") ch = '&';
+        else if (name == "lt") ch = '<';
+        else if (name == "gt") ch = '>';
+        else if (name == "apos") ch = '\'';
+        else if (name == "quot") ch = '"';
+        if (ch)
+        {
+            *out++ = ch;
+            return semi + 1;
+        }
+        if (name.length() < 2 || name[0] != '#')
+        {
+            *out++ = '&';
+            return src + 1;
+        }
+
+        // a character reference, written as UTF-8. The UTF-8 bytes are never
+        // more than the reference, so decoding in place is safe
+        bool hex = name[1] == 'x';
+        size_t ix = hex ? 2 : 1;
+        uint32_t code = 0;
+        for (; ix < name.length() && code <= 0x10FFFF; ++ix)
+        {
+            char digit = name[ix];
+            if (digit >= '0' && digit <= '9') code = code * (hex ? 16 : 10) + uint32_t(digit - '0');
+            else if (hex && digit >= 'a' && digit <= 'f') code = code * 16 + uint32_t(digit - 'a' + 10);
+            else if (hex && digit >= 'A' && digit <= 'F') code = code * 16 + uint32_t(digit - 'A' + 10);
+            else break;
+        }
+        if (ix != name.length() || code == 0 || code > 0x10FFFF)
+        {
+            *out++ = '&';
+            return src + 1;
+        }
+        if (code < 0x80)
+        {
+            *out++ = char(code);
+        }
+        else if (code < 0x800)
+        {
+            *out++ = char(0xC0 | (code >> 6));
+            *out++ = char(0x80 | (code & 0x3F));
+        }
+        else if (code < 0x10000)
+        {
+            *out++ = char(0xE0 | (code >> 12));
+            *out++ = char(0x80 | ((code >> 6) & 0x3F));
+            *out++ = char(0x80 | (code & 0x3F));
+        }
+        else
+        {
+            *out++ = char(0xF0 | (code >> 18));
+            *out++ = char(0x80 | ((code >> 12) & 0x3F));
+            *out++ = char(0x80 | ((code >> 6) & 0x3F));
+            *out++ = char(0x80 | (code & 0x3F));
+        }
+        return semi + 1;
+    }
+
+    /// \brief decodes entities and CDATA sections and drops comments and
+    /// instructions. The text is checked by the reader, so all markups end.
+    /// \param dst may be src to decode in place
+    /// \return the length of the decoded text
+    size_t decodeXml(const char* src, size_t length, char* dst)
+    {
+        const char* end = src + length;
+        char* out = dst;
+        while (src < end)
+        {
+            const char* special = src;
+            while (special < end && *special != '&' && *special != '<') ++special;
+            size_t run = size_t(special - src);
+            if (out != src)
+            {
+                std::memmove(out, src, run);
+            }
+            out += run;
+            src = special;
+            if (src >= end)
+            {
+                break;
+            }
+            if (*src == '&')
+            {
+                src = decodeEntity(src, end, out);
+            }
+            else if (startsWith(src, end, "<![CDATA["))
+            {
+                const char* close = findSeq(src + 9, end, "]]>");
+                std::memmove(out, src + 9, size_t(close - src - 9));
+                out += close - src - 9;
+                src = close + 3;
+            }
+            else if (startsWith(src, end, "<!--"))
+            {
+                src = findSeq(src + 4, end, "-->") + 3;
+            }
+            else if (startsWith(src, end, "<?"))
+            {
+                src = findSeq(src + 2, end, "?>") + 2;
+            }
+            else
+            {
+                *out++ = *src++;
+            }
+        }
+        return size_t(out - dst);
+    }
+}
+
+std::string_view XmlText::value(std::string& buffer) const
+{
+    if (!flags_)
+    {
+        return raw();
+    }
+    if (in_situ_)
+    {
+        length_ = uint32_t(decodeXml(data_, length_, const_cast<char*>(data_)));
+        flags_ = 0;
+        return raw();
+    }
+    buffer.resize(length_);
+    buffer.resize(decodeXml(data_, length_, &buffer[0]));
+    return buffer;
+}
+
+const XmlElementView* XmlElementView::child(std::string_view name) const
+{
+    for (const XmlElementView* child = first_child_; child; child = child->next_sibling_)
+    {
+        if (child->name() == name)
+        {
+            return child;
+        }
+    }
+    return nullptr;
+}
+
+const XmlElementView* XmlElementView::nextSibling(std::string_view name) const
+{
+    for (const XmlElementView* sibling = next_sibling_; sibling; sibling = sibling->next_sibling_)
+    {
+        if (sibling->name() == name)
+        {
+            return sibling;
+        }
+    }
+    return nullptr;
+}
+
+const XmlAttributeView* XmlElementView::attribute(std::string_view name) const
+{
+    for (const XmlAttributeView* attr = first_attribute_; attr; attr = attr->next())
+    {
+        if (attr->name() == name)
+        {
+            return attr;
+        }
+    }
+    return nullptr;
+}
+
+std::string_view XmlElementView::attributeValue(
+    std::string_view name,
+    std::string& buffer,
+    std::string_view default_value) const
+{
+    const XmlAttributeView* attr = attribute(name);
+    return attr ? attr->value(buffer) : default_value;
+}
+
+XmlReader::XmlReader(size_t block_size)
+    : block_size_(block_size < 1024 ? 1024 : block_size)
+{
+}
+
+bool XmlReader::open(const char* xml, size_t length)
+{
+    file_.reset();
+    return parse(xml, length, false);
+}
+
+bool XmlReader::openInSitu(char* xml, size_t length)
+{
+    file_.reset();
+    return parse(xml, length, true);
+}
+
+bool XmlReader::openFile(const char* file_path)
+{
+    file_.reset(ParserStream::createMappedStream(file_path));
+    if (!file_)
+    {
+        root_ = nullptr;
+        error_ = "cannot map the file";
+        error_position_ = 0;
+        return false;
+    }
+    return parse(file_->mappedData(), file_->mappedSize(), false);
+}
+
+void* XmlReader::allocate(size_t size)
+{
+    size = (size + 7) & ~size_t(7);
+    while (true)
+    {
+        if (block_ix_ == blocks_.size())
+        {
+            blocks_.emplace_back(new char[block_size_]);
+            block_pos_ = 0;
+        }
+        if (block_pos_ + size <= block_size_)
+        {
+            void* res = blocks_[block_ix_].get() + block_pos_;
+            block_pos_ += size;
+            return res;
+        }
+        ++block_ix_;
+        block_pos_ = 0;
+    }
+}
+
+bool XmlReader::setError(const char* pos, const char* message)
+{
+    root_ = nullptr;
+    error_ = message;
+    error_position_ = size_t(pos - text_);
+    return false;
+}
+
+bool XmlReader::parse(const char* xml, size_t length, bool in_situ)
+{
+    // reuse the arena blocks of the previous text
+    block_ix_ = 0;
+    block_pos_ = 0;
+    text_ = xml;
+    root_ = nullptr;
+    error_.clear();
+    error_position_ = 0;
+    if (length > std::numeric_limits<uint32_t>::max())
+    {
+        return setError(xml, "XML text too long");
+    }
+
+    const char* p = xml;
+    const char* end = xml + length;
+    XmlElementView* root = nullptr;
+    XmlElementView* current = nullptr;
+    const char* content = nullptr;      // the start of the content of current
+    while (p < end)
+    {
+        const char* lt = static_cast<const char*>(std::memchr(p, '<', size_t(end - p)));
+        const char* text_end = lt ? lt : end;
+        if (current)
+        {
+            if (!current->first_child_ && std::memchr(p, '&', size_t(text_end - p)))
+            {
+                current->text_.flags_ |= XmlText::HAS_ENTITIES;
+            }
+        }
+        else
+        {
+            for (const char* q = p; q < text_end; ++q)
+            {
+                if (!isXmlSpace(*q))
+                {
+                    return setError(q, "text outside the root element");
+                }
+            }
+        }
+        if (!lt)
+        {
+            break;
+        }
+
+        p = lt + 1;
+        if (p >= end)
+        {
+            return setError(lt, "unexpected end of XML tag");
+        }
+        char ch = *p;
+        if (ch == '?')
+        {
+            // an instruction or the declaration, such as <?xml version="1.0"?>
+            const char* close = findSeq(p + 1, end, "?>");
+            if (!close)
+            {
+                return setError(lt, "missing \"?>\" in XML instruction");
+            }
+            if (current) current->text_.flags_ |= XmlText::HAS_MARKUP;
+            p = close + 2;
+            continue;
+        }
+        if (ch == '!')
+        {
+            if (startsWith(p, end, "!--"))
+            {
+                const char* close = findSeq(p + 3, end, "-->");
+                if (!close)
+                {
+                    return setError(lt, "missing \"-->\" for comment ending");
+                }
+                if (current) current->text_.flags_ |= XmlText::HAS_MARKUP;
+                p = close + 3;
+            }
+            else if (startsWith(p, end, "![CDATA["))
+            {
+                if (!current)
+                {
+                    return setError(lt, "get CDATA section outside an XML element");
+                }
+                const char* close = findSeq(p + 8, end, "]]>");
+                if (!close)
+                {
+                    return setError(lt, "missing \"]]>\" in CData section");
+                }
+                current->text_.flags_ |= XmlText::HAS_MARKUP;
+                p = close + 3;
+            }
+            else
+            {
+                // a declaration such as <!DOCTYPE ...>, which may have an internal
+                // subset in brackets
+                if (current)
+                {
+                    return setError(lt, "not a valid XML segment");
+                }
+                bool in_subset = false;
+                while (p < end && (*p != '>' || in_subset))
+                {
+                    if (*p == '[') in_subset = true;
+                    else if (*p == ']') in_subset = false;
+                    ++p;
+                }
+                if (p >= end)
+                {
+                    return setError(lt, "missing right tag bracket '>' in XML declaration");
+                }
+                ++p;
+            }
+            continue;
+        }
+
+        if (ch == '/')
+        {
+            if (!current)
+            {
+                return setError(lt, "closing tag without matching opening tag");
+            }
+            const char* name = p + 1;
+            const char* name_end = name;
+            while (name_end < end && !isNameEnd(*name_end)) ++name_end;
+            if (size_t(name_end - name) != current->name_length_ ||
+                std::memcmp(name, current->name_, current->name_length_) != 0)
+            {
+                return setError(name, "unmatched closing tag name");
+            }
+            p = skipSpace(name_end, end);
+            if (p >= end || *p != '>')
+            {
+                return setError(p, "missing '>' in closing tag");
+            }
+            ++p;
+            if (!current->first_child_)
+            {
+                const char* text_start = content;
+                const char* text_stop = lt;
+                while (text_start < text_stop && isXmlSpace(*text_start)) ++text_start;
+                while (text_stop > text_start && isXmlSpace(text_stop[-1])) --text_stop;
+                current->text_.data_ = text_start;
+                current->text_.length_ = uint32_t(text_stop - text_start);
+            }
+            else
+            {
+                current->text_.flags_ = 0;
+            }
+            current = current->parent_;
+            continue;
+        }
+
+        // an opening tag
+        if (!current && root)
+        {
+            return setError(lt, "more than one root element");
+        }
+        if (!isNameStart(static_cast<unsigned char>(ch)))
+        {
+            return setError(p, "XML name cannot start with any number or punctuation character");
+        }
+        XmlElementView* element = create<XmlElementView>();
+        element->name_ = p;
+        while (p < end && !isNameEnd(*p)) ++p;
+        element->name_length_ = uint32_t(p - element->name_);
+        element->text_.in_situ_ = in_situ;
+        element->parent_ = current;
+        if (!current)
+        {
+            root = element;
+        }
+        else if (current->last_child_)
+        {
+            current->last_child_->next_sibling_ = element;
+            current->last_child_ = element;
+        }
+        else
+        {
+            current->first_child_ = current->last_child_ = element;
+        }
+
+        XmlAttributeView* last_attribute = nullptr;
+        bool empty = false;
+        while (true)
+        {
+            const char* attr_start = p;
+            p = skipSpace(p, end);
+            if (p >= end)
+            {
+                return setError(lt, "missing right tag bracket '>'");
+            }
+            if (*p == '>')
+            {
+                ++p;
+                break;
+            }
+            if (*p == '/')
+            {
+                if (p + 1 >= end || p[1] != '>')
+                {
+                    return setError(p, "missing '>' in closing tag");
+                }
+                p += 2;
+                empty = true;
+                break;
+            }
+            if (p == attr_start)
+            {
+                return setError(p, "missing a space before an attribute");
+            }
+            XmlAttributeView* attr = create<XmlAttributeView>();
+            attr->name_ = p;
+            while (p < end && !isNameEnd(*p)) ++p;
+            attr->name_length_ = uint32_t(p - attr->name_);
+            p = skipSpace(p, end);
+            if (!attr->name_length_ || p >= end || *p != '=')
+            {
+                return setError(p, "missing '=' in attribute");
+            }
+            p = skipSpace(p + 1, end);
+            if (p >= end || (*p != '"' && *p != '\''))
+            {
+                return setError(p, "missing an open quote for an attribute value");
+            }
+            char quote = *p++;
+            const char* close = static_cast<const char*>(std::memchr(p, quote, size_t(end - p)));
+            if (!close)
+            {
+                return setError(p, "missing closing quote for an attribute value");
+            }
+            if (const char* lt = static_cast<const char*>(std::memchr(p, '<', size_t(close - p))))
+            {
+                // a '<' is not allowed in an attribute value, which also keeps
+                // markups out of the decoded values
+                return setError(lt, "'<' in an attribute value");
+            }
+            attr->value_.data_ = p;
+            attr->value_.length_ = uint32_t(close - p);
+            attr->value_.in_situ_ = in_situ;
+            if (std::memchr(p, '&', size_t(close - p)))
+            {
+                attr->value_.flags_ = XmlText::HAS_ENTITIES;
+            }
+            if (last_attribute)
+            {
+                last_attribute->next_ = attr;
+            }
+            else
+            {
+                element->first_attribute_ = attr;
+            }
+            last_attribute = attr;
+            p = close + 1;
+        }
+        if (!empty)
+        {
+            current = element;
+            content = p;
+        }
+    }
+
+    if (current)
+    {
+        return setError(end, "missing closing tag at the end of XML text");
+    }
+    if (!root)
+    {
+        return setError(end, "no XML root element");
+    }
+    root_ = root;
+    return true;
+}
+
+} // namespace alt
@@ -0,0 +1,247 @@
+#pragma once
+
+//**************************************************************************
+// Copyright (c) 2020-present, Altrop Software Inc. and Contributors.
+// SPDX-License-Identifier: BSL-1.0
+//**************************************************************************
+
+/**
+ * @file XmlReader.h
+ * @library alt_util
+ * @brief Implements an in-situ XML reader over a text in memory. Unlike
+ * XmlParser, no name or value is copied and no PooledNamedNode is created:
+ * elements and attributes are small nodes allocated from an arena owned by the
+ * reader, and names, texts and attribute values are views into the text.
+ * Entities and CDATA sections are decoded only when a value is read, and in
+ * place if the text is mutable. The arena is kept when the reader is opened on
+ * the next text, so reading documents of similar sizes allocates no memory.
+ * Classes defined in this file include:
+ *    - XmlText: a text or an attribute value, decoded when read
+ *    - XmlAttributeView: an attribute of an element
+ *    - XmlElementView: an element with its attributes and child elements
+ *    - XmlReader: holds the text, the arena and the root element
+ * @note Like XmlParser, only UTF-8 is supported. Comments, declarations and
+ * processing instructions are skipped. The text of an element with child
+ * elements is not kept, and texts are trimmed as in XmlParser.
+ */
+
+#include "StreamParser.h"               // for ParserStream
+#include <util/types/TemplateHelper.h>  // for NONCOPYABLE
+#include <memory>                       // for unique_ptr
+#include <string>
+#include <string_view>                  // for string_view
+#include <vector>
+
+namespace alt
+{
+
+class XmlReader;
+
+/**
+ * \class XmlText
+ * \ingroup StringUtils
+ * \brief A text of an element or a value of an attribute as it is in the text
+ * of an XmlReader. The raw text is decoded only when value() is called: in
+ * the text itself if the reader is in-situ, or into a buffer otherwise.
+ * \note Decoding in place changes the text, so texts of an in-situ reader must
+ * not be read by multiple threads at the same time.
+ */
+class XmlText
+{
+  public:
+    /// \return the text as it is, with entities and CDATA sections undecoded
+    std::string_view raw() const { return std::string_view(data_, length_); }
+
+    /// \return true if the text has entities or CDATA sections to decode
+    bool needsDecoding() const { return flags_ != 0; }
+
+    bool empty() const { return length_ == 0; }
+
+    /// \brief decodes entities and CDATA sections, and drops comments and
+    /// processing instructions in the text
+    /// \param buffer the buffer for the decoded text if it is neither raw nor
+    /// decoded in place
+    /// \return the decoded text
+    std::string_view value(std::string& buffer) const;
+
+  private:
+    friend class XmlReader;
+    static constexpr uint8_t HAS_ENTITIES = 1;
+    static constexpr uint8_t HAS_MARKUP   = 2;  ///< CDATA, comments or instructions
+
+    mutable const char* data_ {nullptr};
+    mutable uint32_t    length_ {0};
+    mutable uint8_t     flags_ {0};
+    bool                in_situ_ {false};
+};
+
+/**
+ * \class XmlAttributeView
+ * \ingroup StringUtils
+ * \brief An attribute in the text of an XmlReader
+ */
+class XmlAttributeView
+{
+  public:
+    std::string_view name() const { return std::string_view(name_, name_length_); }
+    const XmlText& value() const { return value_; }
+    std::string_view value(std::string& buffer) const { return value_.value(buffer); }
+
+    /// \return the next attribute of the element, or nullptr
+    const XmlAttributeView* next() const { return next_; }
+
+  private:
+    friend class XmlReader;
+    const char*         name_;
+    uint32_t            name_length_;
+    XmlText             value_;
+    XmlAttributeView*   next_ {nullptr};
+};
+
+/**
+ * \class XmlElementView
+ * \ingroup StringUtils
+ * \brief An element in the text of an XmlReader. A view is valid as long as the
+ * reader is not opened again and its text is valid. Lookup of a missing child
+ * or attribute returns nullptr.
+ */
+class XmlElementView
+{
+  public:
+    std::string_view name() const { return std::string_view(name_, name_length_); }
+
+    /// \return the trimmed text of an element with no child element, or an
+    /// empty text otherwise
+    const XmlText& text() const { return text_; }
+    std::string_view text(std::string& buffer) const { return text_.value(buffer); }
+
+    const XmlElementView* parent() const { return parent_; }
+    const XmlElementView* firstChild() const { return first_child_; }
+    const XmlElementView* nextSibling() const { return next_sibling_; }
+    const XmlAttributeView* firstAttribute() const { return first_attribute_; }
+
+    /// \return the first child element of the given name, or nullptr
+    const XmlElementView* child(std::string_view name) const;
+
+    /// \return the next sibling element of the given name, or nullptr
+    const XmlElementView* nextSibling(std::string_view name) const;
+
+    /// \return the attribute of the given name, or nullptr
+    const XmlAttributeView* attribute(std::string_view name) const;
+
+    /// \brief gets the value of an attribute
+    /// \return the decoded value, or default_value if there is no such attribute
+    std::string_view attributeValue(
+        std::string_view name,
+        std::string& buffer,
+        std::string_view default_value = {}) const;
+
+    /// \brief calls func(const XmlElementView&) for each child element
+    template <typename Func>
+    void forEachChild(Func&& func) const
+    {
+        for (const XmlElementView* child = first_child_; child; child = child->next_sibling_)
+        {
+            func(*child);
+        }
+    }
+
+    /// \brief calls func(const XmlElementView&) for each child element of the
+    /// given name
+    template <typename Func>
+    void forEachChild(std::string_view name, Func&& func) const
+    {
+        for (const XmlElementView* child = this->child(name); child; child = child->nextSibling(name))
+        {
+            func(*child);
+        }
+    }
+
+  private:
+    friend class XmlReader;
+    const char*         name_;
+    uint32_t            name_length_;
+    XmlText             text_;
+    XmlElementView*     parent_;
+    XmlElementView*     first_child_ {nullptr};
+    XmlElementView*     last_child_ {nullptr};
+    XmlElementView*     next_sibling_ {nullptr};
+    XmlAttributeView*   first_attribute_ {nullptr};
+};
+
+/**
+ * \class XmlReader
+ * \ingroup StringUtils
+ * \brief Reads XML text in memory in one pass into element and attribute
+ * views allocated from an arena.
+ *
+ * Example:
+ * @code
+ *   XmlReader reader;
+ *   if (reader.openFile(path))
+ *   {
+ *       std::string buffer;
+ *       reader.root()->forEachChild("trade", [&](const XmlElementView& trade)
+ *       {
+ *           std::string_view id = trade.attributeValue("id", buffer);
+ *           ...
+ *       });
+ *   }
+ * @endcode
+ * \note The text is not copied and must outlive the reader. The text must be
+ * shorter than 4GB as lengths are 32-bit.
+ */
+class XmlReader
+{
+  public:
+    /// \brief constructs a reader
+    /// \param block_size size of each arena block
+    explicit XmlReader(size_t block_size = 64*1024);
+    NONCOPYABLE(XmlReader);
+
+    /// \brief reads a text that is not changed. Values with entities are
+    /// decoded into the buffer passed to XmlText::value
+    /// \return false if the text is not well formed
+    bool open(const char* xml, size_t length);
+    bool open(const std::string& xml) { return open(xml.c_str(), xml.length()); }
+
+    /// \brief reads a mutable text. Values with entities are decoded in place
+    /// when read, and the text is changed
+    /// \return false if the text is not well formed
+    bool openInSitu(char* xml, size_t length);
+
+    /// \brief reads a file on a read-only memory mapping of it
+    /// \return false if the file cannot be mapped or is not well formed
+    bool openFile(const char* file_path);
+
+    /// \return the root element, or nullptr if no text is read
+    const XmlElementView* root() const { return root_; }
+
+    const std::string& error() const { return error_; }
+
+    /// \return the position in the text of the error
+    size_t errorPosition() const { return error_position_; }
+
+  private:
+    bool parse(const char* xml, size_t length, bool in_situ);
+
+    /// \brief allocates from the arena. Blocks are kept for the next text
+    void* allocate(size_t size);
+
+    template <typename T>
+    T* create() { return new (allocate(sizeof(T))) T(); }
+
+    bool setError(const char* pos, const char* message);
+
+    size_t                              block_size_;
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    size_t                              block_ix_ {0};      ///< the block in use
+    size_t                              block_pos_ {0};     ///< the next position in the block
+    std::unique_ptr<ParserStream>       file_;              ///< the mapping of openFile
+    const char*                         text_ {nullptr};
+    XmlElementView*                     root_ {nullptr};
+    std::string                         error_;
+    size_t                              error_position_ {0};
+};
+
+} // namespace alt
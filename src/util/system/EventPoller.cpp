@@ -39,16 +39,26 @@ class FDEventPoller::Impl
   public:
 	Impl(bool busy_poller);
 	~Impl();
+
 	void book(FDEventHandler* handler, FDEventIdSet event_ids);
-	void remove(FDEventHandler* handler);
+	void remove(const FDEventHandler* handler);
 	//bool has(FDEventHandler* handler) const;
     bool empty() const { return event_cnt_==0; };
 	void clear();
 	void poll(Clock::tick_type tick, Clock::tick_type timeout);
 
   private:
+    // epoll events booked for a fd. epoll_event.data holds only the handler, so
+    // the booked events are kept here, indexed by fd
+    struct Booking
+    {
+        uint32_t    events_ {0};
+        bool        booked_ {false};
+    };
+
 	int                                 epoll_id_ {-1};
 	std::vector<struct epoll_event>     events_;
+    std::vector<Booking>                bookings_;
     size_t                              event_cnt_{0};
     bool                                busy_poller_;
 };
@@ -57,7 +67,7 @@ FDEventPoller::Impl::Impl(bool busy_poller)
     : events_ (1024)
     , busy_poller_(busy_poller)
 {
-    epoll_id_  = epoll_create(1);
+    epoll_id_  = epoll_create1(EPOLL_CLOEXEC);
     if (epoll_id_ < 0)
     {
         SYS_ERR_THROW(SysException);
@@ -80,105 +90,123 @@ void FDEventPoller::Impl::book(FDEventHandler* handler, FDEventIdSet event_ids)
     if (event_ids.has(FDEventId::EVENT_IN)) ev.events |= EPOLLIN;
     if (event_ids.has(FDEventId::EVENT_OUT)) ev.events |= EPOLLOUT;
     ev.data.ptr = handler;
-    // use ev.data.u32 to save original events
-    ev.data.u32 = ev.events;
 
-    int rs = epoll_ctl(epoll_id_, EPOLL_CTL_ADD, fd, &ev);
+    if (size_t(fd) >= bookings_.size())
+    {
+        bookings_.resize(size_t(fd) + 64);
+    }
+    Booking& booking = bookings_[fd];
 
-    bool is_mod {false};
-    if (rs=EEXIST )
+    // a closed fd leaves the epoll set by itself, so a booking may be stale
+    // when the fd number is reused
+    int rs = epoll_ctl(epoll_id_, booking.booked_ ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, fd, &ev);
+    if (rs!=0 && errno==ENOENT)
+    {
+        rs = epoll_ctl(epoll_id_, EPOLL_CTL_ADD, fd, &ev);
+    }
+    else if (rs!=0 && errno==EEXIST)
     {
         rs = epoll_ctl(epoll_id_, EPOLL_CTL_MOD, fd, &ev);
-        is_mod = true;
     }
-
     if (rs!=0)
     {
         SYS_ERR_THROW(SysException);
     }
-
-    if (!is_mod)
+    if (!booking.booked_)
     {
-        ++event_cnt;
+        booking.booked_ = true;
+        ++event_cnt_;
     }
+    booking.events_ = ev.events;
 }
 
-void FDEventPoller::Impl::remove(FDEventHandler* handler)
+void FDEventPoller::Impl::remove(const FDEventHandler* handler)
 {
-    struct epoll_event ev {0,0};
-    int err = epoll_ctl(epoll_id_, EPOLL_CTL_DEL, handler->fd(), &ev);
-    if (err)
+    FdId fd = handler->fd();
+    if (fd < 0 || size_t(fd) >= bookings_.size() || !bookings_[fd].booked_)
+    {
+        return;
+    }
+    struct epoll_event ev {0,{0}};
+    int err = epoll_ctl(epoll_id_, EPOLL_CTL_DEL, fd, &ev);
+    if (err && errno!=ENOENT && errno!=EBADF)
     {
         SYS_ERR_THROW(SysException);
     }
+    bookings_[fd] = Booking();
     --event_cnt_;
 }
 
 void FDEventPoller::Impl::clear()
 {
     ::close(epoll_id_);
-    epoll_id_ = epoll_create(1);
+    epoll_id_ = epoll_create1(EPOLL_CLOEXEC);
     if (epoll_id_ < 0)
     {
         SYS_ERR_THROW(SysException);
     }
+    bookings_.clear();
     event_cnt_ =0;
 }
 
 void FDEventPoller::Impl::poll(Clock::tick_type tick, Clock::tick_type timeout)
 {
-    int rc;
-#if 0
-    Clock::duration time_left(timeout);
-    while (true)
+    // epoll timeout is in milliseconds. Round a timeout up so that a non-busy
+    // poller does not spin on timeouts shorter than a millisecond
+    int timeout_ms = 0;
+    if (!busy_poller_ && timeout > 0)
     {
-        Clock::time_point start_poll_time;
-        rc = epoll_wait(epoll_id_, &events_[0], events_.size(), Clock::millisecs(time_left));
-        if (rc >= 0 || errno != EINTR)
-        {
-            break;
-        }
-        Clock::time_point now;
-        Clock::duration waited_time = now - start_poll_time;
-        time_left = waited_time < time_left ? time_left - waited_time : Clock::duration(0);
+        timeout_ms = int((timeout + Clock::one_millisec - 1) / Clock::one_millisec);
     }
-#endif
-
-    rc = epoll_wait(epoll_id_, &events_[0], events_.size(), Clock::millisecs(time_left));
-
-    if (rc < 0 && errno != EINTR)
+    int rc = epoll_wait(epoll_id_, &events_[0], int(events_.size()), timeout_ms);
+    if (rc < 0)
     {
+        if (errno == EINTR)
+        {
+            return;
+        }
         SYS_ERR_THROW(SysException);
     }
 
-    for (auto& e : events_)
+    for (int i = 0; i < rc; ++i)
     {
+        auto& e = events_[i];
         FDEventIdSet event_ids;
-        if (e.events & EPOLLIN) event_ids |= FDEventId::EVENT_IN;
+        // a hang up is read as the end of the stream
+        if (e.events & (EPOLLIN | EPOLLHUP | EPOLLRDHUP)) event_ids |= FDEventId::EVENT_IN;
         if (e.events & EPOLLOUT) event_ids |= FDEventId::EVENT_OUT;
         if (e.events & EPOLLERR) event_ids |= FDEventId::EVENT_ERROR;
-        if (!event_ids.empty())
+        if (event_ids.empty())
         {
-            FDEventIdSet done_set = reinterpret_cast<FDEventHandler*>(e.data.ptr)->
-                onEvent(tick, event_ids);
-            uint32_t interested_events = e.data.u32;
-            if (done_set.has(FDEventId::EVENT_IN)) interested_events &= ~EPOLLIN;
-            if (done_set.has(FDEventId::EVENT_OUT)) interested_events &= ~EPOLLOUT;
-            if (e.data.u32==0)
-            {
-                // the handler is no longer intersted in any event
-                remove(reinterpret_cast<FDEventHandler*>(e.data.ptr));
-            }
-            else if (interested_events!=e.data.u32)
-            {
-                // modify to intersted event set
-                e.events = interested_events;
-                e.data.u32 = interested_events;
-                epoll_ctl(epoll_id_,
-                    EPOLL_CTL_MOD,
-                    reinterpret_cast<FDEventHandler*>(e.data.ptr)->fd(),
-                    &e);
-            }
+            continue;
+        }
+        FDEventHandler* handler = static_cast<FDEventHandler*>(e.data.ptr);
+        FDEventIdSet done_set = handler->onEvent(tick, event_ids);
+        if (done_set.empty())
+        {
+            continue;
+        }
+        FdId fd = handler->fd();
+        if (fd < 0 || size_t(fd) >= bookings_.size() || !bookings_[fd].booked_)
+        {
+            continue;
+        }
+        uint32_t interested_events = bookings_[fd].events_;
+        if (done_set.has(FDEventId::EVENT_IN)) interested_events &= ~EPOLLIN;
+        if (done_set.has(FDEventId::EVENT_OUT)) interested_events &= ~EPOLLOUT;
+        if (interested_events==0)
+        {
+            // the handler is no longer intersted in any event
+            remove(handler);
+        }
+        else if (interested_events!=bookings_[fd].events_)
+        {
+            // modify to intersted event set
+            struct epoll_event ev;
+            ev.events = interested_events;
+            ev.data.ptr = handler;
+            epoll_ctl(epoll_id_, EPOLL_CTL_MOD, fd, &ev);
+            bookings_[fd].events_ = interested_events;
         }
     }
 }
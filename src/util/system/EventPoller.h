@@ -33,6 +33,7 @@ class EventPoller
 {
   public:
     virtual void poll(Clock::tick_type tick_realtime, Clock::tick_type poll_timeout) =0;
+    virtual ~EventPoller() {}
 };
 
 /**
@@ -28,6 +28,7 @@ class MessagePoller
 {
   public:
     virtual void poll(Clock::tick_type tick_realtime) =0;
+    virtual ~MessagePoller() {}
 };
 
 /**
@@ -69,6 +70,7 @@ class CoQueueMsgPoller: private MessagePoller
 
     CoQueueMsgPoller(CoQueueMsgHandler& msg_handler, int max_poll_num=5)
         : msg_handler_(msg_handler)
+        , max_poll_num_(max_poll_num)
     {}
 
     template <class MsgT,
@@ -85,13 +87,14 @@ class CoQueueMsgPoller: private MessagePoller
 
     void poll(Clock::tick_type tick_realtime) override
     {
-        CoQueueBase::EntryBase* entry = co_queue_.dequeue();
-        for (int i=0; i< max_poll_num_ && entry; ++i)
+        // Take the messages visible up to max_poll_num_ in one batch and mark
+        // them consumed once
+        auto entries = co_queue_.dequeueAll(max_poll_num_);
+        for (auto entry: entries)
         {
             msg_handler_.processMessage(tick_realtime, reinterpret_cast<CoQueueMsg*>(entry));
-            entry->consumed_.store(true, std::memory_order_release);
-            entry = co_queue_.dequeue();
         }
+        CoQueueBase::commit(entries);
     }
 
     CoQueueType           co_queue_;
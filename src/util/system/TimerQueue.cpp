@@ -132,10 +132,10 @@ int TimerQueue::resetInterval
 
 int TimerQueue::delTimer (int64_t timer_id)
 {
-    auto ev_iter = id_node_map_.find(timer_id);
-    if (ev_iter!=id_node_map_.end())
+    EventIdNode* n = id_node_map_.findValue(timer_id);
+    if (n)
     {
-        remove(ev_iter.getValue().event_node_);
+        remove(n->event_node_);
         return 0;
     }
     return -1;
@@ -23,7 +23,7 @@
 #include <util/Defs.h>                  // for ALT_UTIL_PUBLIC
 #include <util/types/Clock.h>           // for Clock
 #include <util/storage/LinkedList.h>    // for FixPooledLinkList
-#include <util/storage/PooledHash.h>    // for PooledHash
+#include <util/storage/FlatHash.h>      // for FlatHash
 
 #include <functional>                   // for function
 #include <vector>                       // for vector
@@ -158,7 +158,7 @@ class TimerQueue
         MAKE_POOLED_HASH_ENTRY(int64_t, timer_id_, size_t);
     };
 
-    using EventIdNodeMap = PooledHash<EventIdNode>;
+    using EventIdNodeMap = FlatHash<EventIdNode>;
 
     
     void add
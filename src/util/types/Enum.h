@@ -69,7 +69,7 @@ class NAME: public EnumType<NAME> \
     inline static int _name_indice[_enum_number] { -1 }; \
     inline static enum_type enum_values [] {__VA_ARGS__}; \
     constexpr bool operator == (enum_type oth) const { return value_ == oth; }; \
-    constexpr bool operator != (enum_type oth) const { return value_ == oth; }; \
+    constexpr bool operator != (enum_type oth) const { return value_ != oth; }; \
     constexpr static size_t count() { return _enum_number; } \
     constexpr static NAME max() { return NAME(_enum_number-1); } \
     constexpr static NAME invalid() { return NAME(_enum_number); } \
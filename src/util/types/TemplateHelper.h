@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cstddef>   // for size_t
+#include <cstdint>   // for uint8_t
 #include <array>
+#include <functional>
 
 namespace alt
 {
@@ -0,0 +1,110 @@
+#include <util/ipc/AtomicData.h>
+#include <catch2/catch.hpp>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+    // a 200-byte top of book snapshot
+    struct BookTop
+    {
+        int64_t     seq_;
+        int64_t     px_[12];
+        int64_t     qty_[12];
+
+        void set(int64_t seq)
+        {
+            seq_ = seq;
+            for (int i=0; i<12; ++i) { px_[i] = seq+i; qty_[i] = seq*2+i; }
+        }
+        bool isConsistent() const
+        {
+            for (int i=0; i<12; ++i)
+            {
+                if (px_[i]!=seq_+i || qty_[i]!=seq_*2+i) return false;
+            }
+            return true;
+        }
+    };
+
+    template <bool DoubleBuffered>
+    void concurrentReadTest()
+    {
+        alt::AtomicData<BookTop, DoubleBuffered> data;
+        BookTop top;
+        top.set(0);
+        data.write(top);
+
+        constexpr int64_t WRITE_NUM = 100000;
+        std::atomic<int> inconsistent {0};
+        std::vector<std::thread> readers;
+        for (int r=0; r<2; ++r)
+        {
+            readers.emplace_back([&]()
+            {
+                BookTop read_top;
+                int64_t last_seq = 0;
+                do
+                {
+                    data.read(read_top);
+                    if (!read_top.isConsistent() || read_top.seq_ < last_seq) ++inconsistent;
+                    last_seq = read_top.seq_;
+                }
+                while (last_seq < WRITE_NUM);
+            });
+        }
+        for (int64_t seq=1; seq<=WRITE_NUM; ++seq)
+        {
+            top.set(seq);
+            data.write(top);
+        }
+        for (auto& t: readers) t.join();
+        REQUIRE(inconsistent==0);
+        REQUIRE(data.getUpdateCount()==WRITE_NUM+1);
+    }
+}
+
+TEST_CASE( "AtomicDataTest", "[AtomicData]" )
+{
+    alt::AtomicData<BookTop> data;
+    BookTop top;
+    top.set(5);
+    data.write(top);
+    BookTop read_top;
+    REQUIRE(data.tryRead(read_top));
+    REQUIRE(read_top.seq_==5);
+    REQUIRE(read_top.isConsistent());
+
+    alt::AtomicData<BookTop, true> dbuf_data;
+    dbuf_data.write(top);
+    dbuf_data.update([](BookTop& t) { t.set(t.seq_+1); });
+    dbuf_data.read(read_top);
+    REQUIRE(read_top.seq_==6);
+    REQUIRE(read_top.isConsistent());
+    REQUIRE(dbuf_data.getData().seq_==6);
+
+    concurrentReadTest<false>();
+    concurrentReadTest<true>();
+}
+
+TEST_CASE( "SharedAtomicDataTest", "[AtomicData]" )
+{
+    std::string name = "SharedAtomicDataTest" + std::to_string(::getpid());
+    alt::SharedAtomicData<BookTop, true> writer(name, true);
+    REQUIRE(writer.init()==0);
+    BookTop top;
+    top.set(42);
+    writer.getContainer()->write(top);
+
+    alt::SharedAtomicData<BookTop, true> reader(name, false);
+    REQUIRE(reader.init()==0);
+    BookTop read_top;
+    reader.getContainer()->read(read_top);
+    REQUIRE(read_top.seq_==42);
+    REQUIRE(read_top.isConsistent());
+    ::shm_unlink(("/" + name).c_str());
+}
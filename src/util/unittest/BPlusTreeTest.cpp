@@ -0,0 +1,177 @@
+#include <util/storage/BPlusTree.h>
+#include <catch2/catch.hpp>
+#include <set>
+#include <random>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <functional>
+
+namespace
+{
+    // small nodes to have a deep tree with many splits and merges
+    template <typename Key, class Compare>
+    using SmallTree = alt::BPlusTree<Key, Compare, 2>;
+
+    template <typename Tree, typename Ref>
+    void checkSame(const Tree& tree, const Ref& ref)
+    {
+        REQUIRE(tree.size()==ref.size());
+        REQUIRE(std::equal(tree.begin(), tree.end(), ref.begin(), ref.end()));
+        // backward iteration
+        REQUIRE(std::equal(std::make_reverse_iterator(tree.end()),
+                           std::make_reverse_iterator(tree.begin()),
+                           ref.rbegin(), ref.rend()));
+    }
+
+    template <typename Key, class Compare>
+    void randomTest(uint64_t seed)
+    {
+        SmallTree<Key, Compare> tree;
+        std::multiset<Key, Compare> ref;
+        std::mt19937_64 rng(seed);
+        for (int step = 0; step < 20000; ++step)
+        {
+            Key key = Key(rng() % 3000);
+            int op = rng() % 10;
+            if (op < 5)
+            {
+                tree.insert(key);
+                ref.insert(key);
+            }
+            else if (op < 7)
+            {
+                bool inserted = tree.insert(key, true);
+                REQUIRE(inserted==(ref.find(key)==ref.end()));
+                if (inserted) ref.insert(key);
+            }
+            else if (op < 9)
+            {
+                REQUIRE(tree.erase(key)==ref.erase(key));
+            }
+            else
+            {
+                auto low = tree.lowBound(key);
+                auto ref_low = ref.lower_bound(key);
+                REQUIRE((low==tree.end())==(ref_low==ref.end()));
+                if (ref_low!=ref.end()) REQUIRE(*low==*ref_low);
+                auto up = tree.upBound(key);
+                auto ref_up = ref.upper_bound(key);
+                REQUIRE((up==tree.end())==(ref_up==ref.end()));
+                if (ref_up!=ref.end()) REQUIRE(*up==*ref_up);
+                REQUIRE(std::distance(low, up)==std::distance(ref_low, ref_up));
+                REQUIRE(tree.contains(key)==(ref.count(key)>0));
+            }
+            if (step % 1000 == 0) checkSame(tree, ref);
+        }
+        checkSame(tree, ref);
+
+        // erase everything down to an empty tree
+        while (!ref.empty())
+        {
+            Key key = *ref.begin();
+            REQUIRE(tree.erase(key)==ref.erase(key));
+        }
+        REQUIRE(tree.empty());
+        REQUIRE(tree.height()==0);
+        REQUIRE(tree.begin()==tree.end());
+    }
+
+    struct PairKey
+    {
+        int32_t first_;
+        int32_t second_;
+        PairKey(uint64_t x = 0) : first_(int32_t(x / 100)), second_(int32_t(x % 100)) {}
+        bool operator==(const PairKey& oth) const { return first_==oth.first_ && second_==oth.second_; }
+        bool operator<(const PairKey& oth) const
+        {
+            return first_ < oth.first_ || (first_==oth.first_ && second_ < oth.second_);
+        }
+    };
+}
+
+TEST_CASE("BPlusTreeTest", "[BPlusTree]")
+{
+    alt::BPlusTree<int64_t> tree;
+    REQUIRE(tree.empty());
+    REQUIRE(tree.lowBound(1)==tree.end());
+    REQUIRE(!tree.contains(1));
+    REQUIRE(tree.erase(1)==0);
+
+    for (int64_t x = 1000; x > 0; --x)
+    {
+        REQUIRE(tree.insert(x * 2, true));
+    }
+    REQUIRE(!tree.insert(100, true));
+    REQUIRE(tree.insert(100));
+    REQUIRE(tree.size()==1001);
+    REQUIRE(tree.height()>=2);
+    REQUIRE(*tree.begin()==2);
+    REQUIRE(*--tree.end()==2000);
+    REQUIRE(*tree.lowBound(99)==100);
+    REQUIRE(*tree.upBound(100)==102);
+    REQUIRE(std::distance(tree.lowBound(100), tree.upBound(100))==2);
+    REQUIRE(tree.find(101)==tree.end());
+    REQUIRE(tree.upBound(2000)==tree.end());
+    REQUIRE(tree.erase(100)==2);
+    REQUIRE(!tree.contains(100));
+    REQUIRE(tree.size()==999);
+
+    // range iteration
+    int64_t sum = 0;
+    for (auto iter = tree.lowBound(1001); iter != tree.upBound(1010); ++iter)
+    {
+        sum += *iter;
+    }
+    REQUIRE(sum==1002+1004+1006+1008+1010);
+
+    tree.clear();
+    REQUIRE(tree.empty());
+    REQUIRE(tree.insert(5));
+    REQUIRE(*tree.begin()==5);
+}
+
+TEST_CASE("BPlusTreeAssignTest", "[BPlusTree]")
+{
+    std::vector<uint32_t> keys;
+    for (uint32_t x = 0; x < 100000; ++x)
+    {
+        keys.push_back(x / 3);
+    }
+    alt::BPlusTree<uint32_t> tree(keys.begin(), keys.end());
+    REQUIRE(tree.size()==keys.size());
+    REQUIRE(std::equal(tree.begin(), tree.end(), keys.begin(), keys.end()));
+    REQUIRE(std::distance(tree.lowBound(777), tree.upBound(777))==3);
+    // a bulk loaded tree is updated as usual
+    REQUIRE(tree.erase(777)==3);
+    REQUIRE(tree.insert(777, true));
+    REQUIRE(tree.erase(5000)==3);
+    REQUIRE(tree.size()==keys.size()-5);
+
+    std::vector<uint32_t> unsorted {1, 3, 2};
+    REQUIRE_THROWS_AS(tree.assign(unsorted.begin(), unsorted.end()), std::runtime_error);
+    REQUIRE(tree.empty());
+
+    SmallTree<int64_t, std::less<int64_t>> small;
+    for (size_t num = 0; num < 300; ++num)
+    {
+        std::vector<int64_t> sorted(num);
+        std::iota(sorted.begin(), sorted.end(), 0);
+        small.assign(sorted.begin(), sorted.end());
+        REQUIRE(std::equal(small.begin(), small.end(), sorted.begin(), sorted.end()));
+        for (int64_t x = 0; x < int64_t(num); x += 7)
+        {
+            REQUIRE(small.erase(x)==1);
+        }
+        REQUIRE(small.insert(-1));
+        REQUIRE(*small.begin()==-1);
+    }
+}
+
+TEST_CASE("BPlusTreeRandomTest", "[BPlusTree]")
+{
+    randomTest<int64_t, std::less<int64_t>>(1);
+    randomTest<uint32_t, std::greater<uint32_t>>(2);
+    randomTest<double, std::less<double>>(3);
+    randomTest<PairKey, std::less<PairKey>>(4);
+}
@@ -3,6 +3,8 @@
 #include <iostream>
 #include <assert.h>
 #include <vector>
+#include <thread>
+#include <set>
 
 namespace alt
 {
@@ -41,3 +43,74 @@ TEST_CASE( "QueueTest", "[Queue]" )
 }
 
 
+
+TEST_CASE( "QueueBatchTest", "[Queue]" )
+{
+    {
+        alt::CoQueue<>  testQueue;
+        for (int i=0; i<10; ++i)
+        {
+            testQueue.enqueue<alt::MyQueueEntry>(i);
+        }
+        REQUIRE(alt::MyQueueEntry::instanceCount()==10);
+
+        std::set<alt::CoQueueBase::EntryBase*> blocks;
+        auto entries = testQueue.dequeueAll(4);
+        REQUIRE(entries.size()==4);
+        int expected = 0;
+        for (auto entry: entries)
+        {
+            REQUIRE(static_cast<alt::MyQueueEntry*>(entry)->getValue()==expected++);
+            blocks.insert(entry);
+        }
+        alt::CoQueueBase::commit(entries);
+
+        entries = testQueue.dequeueAll();
+        REQUIRE(entries.size()==6);
+        for (auto entry: entries)
+        {
+            REQUIRE(static_cast<alt::MyQueueEntry*>(entry)->getValue()==expected++);
+            blocks.insert(entry);
+        }
+        REQUIRE(expected==10);
+        alt::CoQueueBase::commit(entries);
+        REQUIRE(testQueue.dequeueAll().empty());
+
+        // consumed entries are recycled except the last one the consumer is on,
+        // and the new entry reuses a recycled block
+        auto last = entries.last();
+        auto entry = testQueue.acquire<alt::MyQueueEntry>(10);
+        REQUIRE(alt::MyQueueEntry::instanceCount()==2);
+        REQUIRE(entry != last);
+        REQUIRE(blocks.count(entry)==1);
+        testQueue.enqueue(entry);
+        REQUIRE(testQueue.dequeue()==entry);
+        alt::CoQueueBase::commit(entry);
+    }
+    REQUIRE(alt::MyQueueEntry::instanceCount()==0);
+}
+
+TEST_CASE( "QueueConcurrentTest", "[Queue]" )
+{
+    constexpr int MSG_NUM = 100000;
+    alt::CoQueue<>  testQueue;
+    std::thread consumer([&testQueue]()
+    {
+        int expected = 0;
+        while (expected < MSG_NUM)
+        {
+            auto entries = testQueue.dequeueAll(64);
+            for (auto entry: entries)
+            {
+                REQUIRE(static_cast<alt::MyQueueEntry*>(entry)->getValue()==expected++);
+            }
+            alt::CoQueueBase::commit(entries);
+        }
+    });
+    for (int i=0; i<MSG_NUM; ++i)
+    {
+        testQueue.enqueue<alt::MyQueueEntry>(i);
+    }
+    consumer.join();
+    REQUIRE(alt::MyQueueEntry::instanceCount() < MSG_NUM);
+}
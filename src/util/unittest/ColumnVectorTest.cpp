@@ -0,0 +1,140 @@
+#include <util/storage/ColumnVector.h>
+#include <catch2/catch.hpp>
+#include <random>
+#include <vector>
+#include <map>
+
+namespace
+{
+    enum PositionField { QTY, PRICE, ACCOUNT, FLAGS };
+    using Positions = alt::ColumnVector<int64_t, double, int32_t, uint32_t>;
+
+    struct RefPosition
+    {
+        int64_t     qty_;
+        double      price_;
+        int32_t     account_;
+        uint32_t    flags_;
+    };
+
+    template <size_t I, typename T, typename Get>
+    void checkKernels(const Positions& positions, const std::map<size_t, RefPosition>& ref, T x, Get get)
+    {
+        T min_value = 0, max_value = 0;
+        REQUIRE(positions.min<I>(min_value)==!ref.empty());
+        REQUIRE(positions.max<I>(max_value)==!ref.empty());
+        typename alt::ColumnKernel<T>::SumType total = 0;
+        for (auto& [row, pos]: ref)
+        {
+            total += get(pos);
+            REQUIRE(min_value <= get(pos));
+            REQUIRE(max_value >= get(pos));
+        }
+        REQUIRE(positions.sum<I>()==total);
+
+        using Cmp = alt::ColumnCompare;
+        for (Cmp cmp: {Cmp::Less, Cmp::LessEqual, Cmp::Greater, Cmp::GreaterEqual, Cmp::Equal, Cmp::NotEqual})
+        {
+            std::vector<size_t> expected;
+            for (auto& [row, pos]: ref)
+            {
+                T v = get(pos);
+                bool match = cmp==Cmp::Less ? v < x : cmp==Cmp::LessEqual ? v <= x :
+                             cmp==Cmp::Greater ? v > x : cmp==Cmp::GreaterEqual ? v >= x :
+                             cmp==Cmp::Equal ? v == x : v != x;
+                if (match) expected.push_back(row);
+            }
+            std::vector<size_t> rows;
+            REQUIRE(positions.filter<I>(cmp, x, rows)==expected.size());
+            REQUIRE(rows==expected);
+        }
+    }
+}
+
+TEST_CASE("ColumnVectorTest", "[ColumnVector]")
+{
+    Positions positions(10);
+    REQUIRE(positions.size()==0);
+    int64_t qty;
+    REQUIRE(!positions.min<QTY>(qty));
+    REQUIRE(positions.sum<PRICE>()==0);
+
+    size_t r0 = positions.add(100, 1.5, 7, 0);
+    size_t r1 = positions.add(-50, 2.5, 8, 1);
+    size_t r2 = positions.add(30, 0.5, 7, 0);
+    REQUIRE(r0==0);
+    REQUIRE(r2==2);
+    REQUIRE(positions.row(r1).get<QTY>()==-50);
+    REQUIRE(positions.row(r1).get<PRICE>()==2.5);
+    positions.row(r1).set<ACCOUNT>(9);
+    positions.row(r1).get<QTY>() += 10;
+    REQUIRE(positions.column<ACCOUNT>()[r1]==9);
+    REQUIRE(positions.sum<QTY>()==90);
+
+    REQUIRE(positions.erase(r0));
+    REQUIRE(!positions.erase(r0));
+    REQUIRE(!positions.isLive(r0));
+    REQUIRE(positions.liveSize()==2);
+    REQUIRE(positions.sum<QTY>()==-10);
+    REQUIRE(positions.column<PRICE>()[r0]==0);
+    double min_price;
+    REQUIRE(positions.min<PRICE>(min_price));
+    REQUIRE(min_price==0.5);
+
+    // the removed slot is reused
+    REQUIRE(positions.add(5, 3.0, 1, 0)==r0);
+    REQUIRE(positions.size()==3);
+    double max_price;
+    REQUIRE(positions.max<PRICE>(max_price));
+    REQUIRE(max_price==3.0);
+
+    std::vector<size_t> rows;
+    REQUIRE(positions.filter<ACCOUNT>(alt::ColumnCompare::GreaterEqual, 7, rows)==2);
+    REQUIRE(rows==std::vector<size_t>{r1, r2});
+
+    size_t visited = 0;
+    positions.forEach([&](Positions::Row row) { visited += row.index(); });
+    REQUIRE(visited==r0+r1+r2);
+
+    positions.clear();
+    REQUIRE(positions.size()==0);
+    REQUIRE(positions.liveSize()==0);
+    REQUIRE(positions.sum<QTY>()==0);
+}
+
+TEST_CASE("ColumnVectorRandomTest", "[ColumnVector]")
+{
+    Positions positions;
+    std::map<size_t, RefPosition> ref;
+    std::mt19937_64 rng(5);
+    for (int step = 0; step < 20000; ++step)
+    {
+        if (rng() % 3 != 0 || ref.empty())
+        {
+            RefPosition pos {int64_t(rng() % 2001) - 1000, double(rng() % 1000) / 4,
+                             int32_t(rng() % 200) - 100, uint32_t(rng() % 16)};
+            size_t row = positions.add(pos.qty_, pos.price_, pos.account_, pos.flags_);
+            REQUIRE(ref.find(row)==ref.end());
+            ref[row] = pos;
+        }
+        else
+        {
+            auto iter = ref.begin();
+            std::advance(iter, rng() % ref.size());
+            REQUIRE(positions.erase(iter->first));
+            ref.erase(iter);
+        }
+        if (step % 2000 == 0 || step == 19999)
+        {
+            REQUIRE(positions.liveSize()==ref.size());
+            checkKernels<QTY>(positions, ref, int64_t(rng() % 2001) - 1000,
+                              [](const RefPosition& pos) { return pos.qty_; });
+            checkKernels<PRICE>(positions, ref, double(rng() % 1000) / 4,
+                                [](const RefPosition& pos) { return pos.price_; });
+            checkKernels<ACCOUNT>(positions, ref, int32_t(rng() % 200) - 100,
+                                  [](const RefPosition& pos) { return pos.account_; });
+            checkKernels<FLAGS>(positions, ref, uint32_t(rng() % 16),
+                                [](const RefPosition& pos) { return pos.flags_; });
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#include <util/net/DatagramConnection.h>
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+class DatagramCollector: public alt::DatagramListener
+{
+  public:
+    void onDatagrams(alt::Clock::tick_type, const alt::Datagram* datagrams, size_t num) override
+    {
+        ++batch_num_;
+        for (size_t i = 0; i < num; ++i)
+        {
+            received_.emplace_back(datagrams[i].data_, datagrams[i].length_);
+            truncated_num_ += datagrams[i].truncated_;
+        }
+    }
+
+    std::vector<std::string>    received_;
+    size_t                      batch_num_ {0};
+    size_t                      truncated_num_ {0};
+};
+
+void pollUntil(alt::FDEventPoller& poller, DatagramCollector& collector, size_t num)
+{
+    for (int i = 0; i < 1000 && collector.received_.size() < num; ++i)
+    {
+        poller.poll(0, alt::Clock::one_millisec);
+    }
+}
+
+}
+
+TEST_CASE( "DatagramConnectionTest", "[DatagramConnectionTest]" )
+{
+    alt::FDEventPoller poller;
+    DatagramCollector collector;
+    alt::DatagramConnection::Config config;
+    config.batch_size_ = 16;
+    config.max_datagram_size_ = 64;
+    config.recv_buffer_size_ = 1024*1024;
+
+    alt::DatagramConnection receiver(&collector, config, &poller);
+    receiver.bind(alt::SocketAddress(alt::IPAddress("127.0.0.1"), 0));
+    alt::PortId port = receiver.socket().address().port();
+    REQUIRE(port != alt::WILDCARD_PORT_ID);
+
+    alt::DatagramConnection sender(nullptr, config, nullptr);
+    sender.setDestination(alt::SocketAddress(alt::IPAddress("127.0.0.1"), port));
+
+    SECTION("posted datagrams are received in batches")
+    {
+        constexpr size_t NUM = 100;
+        for (size_t i = 0; i < NUM; ++i)
+        {
+            std::string text = "packet " + std::to_string(i);
+            REQUIRE(sender.post(text.data(), text.length()));
+        }
+        REQUIRE(sender.pending() == NUM % config.batch_size_);
+        REQUIRE(sender.flush() == NUM % config.batch_size_);
+        REQUIRE(sender.pending() == 0);
+
+        pollUntil(poller, collector, NUM);
+        REQUIRE(collector.received_.size() == NUM);
+        for (size_t i = 0; i < NUM; ++i)
+        {
+            REQUIRE(collector.received_[i] == "packet " + std::to_string(i));
+        }
+        // recvmmsg takes more than one datagram a call
+        REQUIRE(collector.batch_num_ < NUM);
+    }
+
+    SECTION("send one and many, truncate long datagrams")
+    {
+        REQUIRE(sender.send("single", 6));
+        std::string long_text(100, 'x');
+        std::vector<iovec> iov(3);
+        iov[0].iov_base = const_cast<char*>("first");
+        iov[0].iov_len = 5;
+        iov[1].iov_base = const_cast<char*>("second");
+        iov[1].iov_len = 6;
+        iov[2].iov_base = &long_text[0];
+        iov[2].iov_len = long_text.length();
+        REQUIRE(sender.send(iov.data(), iov.size()) == 3);
+
+        pollUntil(poller, collector, 4);
+        REQUIRE(collector.received_.size() == 4);
+        REQUIRE(collector.received_[0] == "single");
+        REQUIRE(collector.received_[1] == "first");
+        REQUIRE(collector.received_[2] == "second");
+        REQUIRE(collector.received_[3] == long_text.substr(0, config.max_datagram_size_));
+        REQUIRE(collector.truncated_num_ == 1);
+    }
+
+    receiver.close();
+    REQUIRE(poller.empty());
+}
@@ -0,0 +1,89 @@
+#include <util/storage/DoubleHash.h>
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct RefData
+    {
+        uint32_t    instrument_id_;
+        int32_t     lot_size_;
+    };
+
+    template <class Hasher, typename KeyGen>
+    void doubleHashTest(uint32_t key_num, KeyGen key_gen)
+    {
+        alt::DoubleHashBuilder<Hasher, RefData> builder;
+        for (uint32_t ix=0; ix < key_num; ++ix)
+        {
+            builder.add(key_gen(ix), RefData{ix, int32_t(ix%100)});
+        }
+        std::vector<char> blob = builder.build();
+
+        // a copy of the blob works as well as the blob mapped from a file
+        std::vector<char> copied(blob);
+        alt::DoubleHash<Hasher, RefData> table(copied.data(), copied.size());
+        REQUIRE(table.size()==key_num);
+        for (uint32_t ix=0; ix < key_num; ++ix)
+        {
+            auto value = table.find(key_gen(ix));
+            REQUIRE(value);
+            REQUIRE(value->instrument_id_==ix);
+            REQUIRE(value->lot_size_==int32_t(ix%100));
+        }
+        for (uint32_t ix=key_num; ix < key_num*2; ++ix)
+        {
+            REQUIRE(!table.contains(key_gen(ix)));
+        }
+    }
+}
+
+TEST_CASE( "DoubleHashTest", "[DoubleHash]" )
+{
+    doubleHashTest<alt::UInt32DoubleHasher>(1, [](uint32_t ix) { return ix*7; });
+    doubleHashTest<alt::UInt32DoubleHasher>(10000, [](uint32_t ix) { return ix*7; });
+    doubleHashTest<alt::UInt64DoubleHasher>(100000,
+        [](uint32_t ix) { return (uint64_t(ix) << 32) + ix; });
+    std::vector<std::string> symbols;
+    for (uint32_t ix=0; ix < 100000; ++ix)
+    {
+        symbols.push_back("SYM" + std::to_string(ix) + ".X");
+    }
+    doubleHashTest<alt::StringDoubleHasher>(50000,
+        [&symbols](uint32_t ix) { return std::string_view(symbols[ix]); });
+
+    alt::DoubleHash<alt::UInt32DoubleHasher, RefData> empty_table(
+        alt::DoubleHashBuilder<alt::UInt32DoubleHasher, RefData>().build());
+    REQUIRE(empty_table.empty());
+    REQUIRE(!empty_table.contains(0));
+
+    alt::DoubleHashBuilder<alt::StringDoubleHasher, RefData> builder;
+    builder.add("IBM", RefData{1, 100});
+    builder.add("IBM", RefData{2, 100});
+    REQUIRE_THROWS(builder.build());
+
+    std::vector<char> blob(sizeof(uint64_t)*8, 0);
+    REQUIRE_THROWS((alt::DoubleHash<alt::UInt32DoubleHasher, RefData>(blob.data(), blob.size())));
+
+    // the tables a corrupt header points to must be in the blob
+    using Table = alt::DoubleHash<alt::UInt32DoubleHasher, RefData>;
+    alt::DoubleHashBuilder<alt::UInt32DoubleHasher, RefData> ref_builder;
+    for (uint32_t ix=0; ix < 100; ++ix) ref_builder.add(ix, RefData{ix, 1});
+    const std::vector<char> good = ref_builder.build();
+    auto corrupt = [&good](auto change)
+    {
+        std::vector<char> bad(good);
+        change(*reinterpret_cast<Table::Header*>(bad.data()));
+        return Table(bad.data(), bad.size()).size();
+    };
+    REQUIRE(corrupt([](Table::Header&) {})==100);
+    REQUIRE_THROWS(corrupt([](Table::Header& h) { h.slot_offset_ = h.blob_size_; }));
+    REQUIRE_THROWS(corrupt([](Table::Header& h) { h.displacement_offset_ = ~uint64_t(0) - 7; }));
+    REQUIRE_THROWS(corrupt([](Table::Header& h) { h.string_offset_ = h.blob_size_ + 8; }));
+    REQUIRE_THROWS(corrupt([](Table::Header& h) { h.bucket_num_ = h.slot_num_ * 64; }));
+    REQUIRE_THROWS(corrupt([](Table::Header& h) { h.slot_num_ *= 2; h.key_num_ *= 2; }));
+    REQUIRE_THROWS(corrupt([](Table::Header& h) { h.slot_offset_ += 1; }));
+    // a truncated blob
+    REQUIRE_THROWS(Table(good.data(), good.size()/2));
+}
@@ -0,0 +1,328 @@
+#include <util/numeric/FastFloat.h>
+#include <util/string/StrScan.h>
+#include <util/string/StrPrint.h>
+#include <catch2/catch.hpp>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // parses the text with parseDouble and strtod, which is correctly rounded
+    bool sameAsStrtod(const std::string& text)
+    {
+        double val;
+        const char* end = alt::parseDouble(text.c_str(), text.c_str() + text.size(), val);
+        char* expected_end;
+        double expected = std::strtod(text.c_str(), &expected_end);
+        return end == expected_end && std::memcmp(&val, &expected, sizeof(val)) == 0;
+    }
+
+    std::string shortest(double val)
+    {
+        char text[alt::SHORTEST_DOUBLE_CHARS];
+        return std::string(text, alt::formatShortest(val, text));
+    }
+
+    // formats the value with formatFixed and snprintf
+    bool sameAsPrintf(double val, int precision)
+    {
+        char text[64], expected[512];
+        size_t length = alt::formatFixed(val, precision, text, sizeof(text));
+        int expected_length = std::snprintf(expected, sizeof(expected), "%.*f", precision, val);
+        return length == size_t(expected_length) &&
+               (length >= sizeof(text) || std::memcmp(text, expected, length) == 0);
+    }
+
+    // calls fn on every input and returns the nanoseconds per call
+    template <typename Input, typename Fn>
+    double nanosPerCall(const std::vector<Input>& inputs, Fn fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (const Input& input: inputs)
+        {
+            fn(input);
+        }
+        std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / double(inputs.size());
+    }
+
+    // prices with 2 decimals and random finite doubles in full precision
+    std::vector<std::string> benchmarkTexts(bool prices, size_t num)
+    {
+        std::mt19937_64 gen(3);
+        std::vector<std::string> texts;
+        char buffer[64];
+        while (texts.size() < num)
+        {
+            if (prices)
+            {
+                std::snprintf(buffer, sizeof(buffer), "%.2f", double(gen() % 10000000) / 100.0);
+            }
+            else
+            {
+                uint64_t bits = gen() & 0x7FEFFFFFFFFFFFFF;
+                double val;
+                std::memcpy(&val, &bits, sizeof(val));
+                std::snprintf(buffer, sizeof(buffer), "%.17g", val);
+            }
+            texts.emplace_back(buffer);
+        }
+        return texts;
+    }
+
+    // prices with 2 decimals or random finite doubles
+    std::vector<double> benchmarkValues(bool prices, size_t num)
+    {
+        std::mt19937_64 gen(5);
+        std::vector<double> values;
+        while (values.size() < num)
+        {
+            if (prices)
+            {
+                values.push_back(double(gen() % 10000000) / 100.0);
+                continue;
+            }
+            uint64_t bits = gen() & 0x7FEFFFFFFFFFFFFF;
+            double val;
+            std::memcpy(&val, &bits, sizeof(val));
+            values.push_back(val);
+        }
+        return values;
+    }
+}
+
+TEST_CASE("FastFloatTest", "[FastFloat]")
+{
+    REQUIRE(alt::isEightDigits("01234567"));
+    REQUIRE(!alt::isEightDigits("0123456."));
+    REQUIRE(!alt::isEightDigits("/1234567"));
+    REQUIRE(!alt::isEightDigits(":1234567"));
+    REQUIRE(alt::parseEightDigits("12345678") == 12345678);
+    REQUIRE(alt::parseEightDigits("00000009") == 9);
+
+    for (const char* text: {
+            "0", "-0", "0.1", "-12.625", "1e23", "9007199254740993", "1.7976931348623157e308",
+            "1.7976931348623159e308", "1e400", "1e-400", "2.2250738585072011e-308",
+            "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324",
+            "123456789012345678901234567890", "0.000000000000000000000000001234567890123456789012",
+            "1.00000000000000011102230246251565404236316680908203125",
+            "1.00000000000000011102230246251565404236316680908203124",
+            "1.", ".5", "1e", "1e+", "2E-3x", "-"})
+    {
+        INFO(text);
+        REQUIRE(sameAsStrtod(text));
+    }
+
+    // the shortest and the full representations of random doubles
+    std::mt19937_64 gen(11);
+    char buffer[64];
+    for (size_t round = 0; round < 100000; ++round)
+    {
+        uint64_t bits = gen() & 0x7FEFFFFFFFFFFFFF;
+        double val;
+        std::memcpy(&val, &bits, sizeof(val));
+        std::snprintf(buffer, sizeof(buffer), "%.17g", val);
+        INFO(buffer);
+        REQUIRE(sameAsStrtod(buffer));
+        std::snprintf(buffer, sizeof(buffer), "%.*g", int(gen() % 17) + 1, val);
+        REQUIRE(sameAsStrtod(buffer));
+    }
+}
+
+TEST_CASE("FastFloatParseBenchmark", "[.][benchmark]")
+{
+    for (bool prices: {true, false})
+    {
+        const std::vector<std::string> texts = benchmarkTexts(prices, 1000000);
+        double sum = 0, expected_sum = 0;
+        double parse_ns = nanosPerCall(texts, [&sum](const std::string& text)
+        {
+            double val;
+            alt::parseDouble(text.data(), text.data() + text.size(), val);
+            sum += val;
+        });
+        double strtod_ns = nanosPerCall(texts, [&expected_sum](const std::string& text)
+        {
+            expected_sum += std::strtod(text.c_str(), nullptr);
+        });
+        std::cout << (prices ? "prices \"%.2f\":   " : "\"%.17g\" doubles:")
+                  << " parseDouble " << parse_ns << " ns, strtod " << strtod_ns << " ns";
+#if defined(__cpp_lib_to_chars)
+        double chars_sum = 0;
+        double from_chars_ns = nanosPerCall(texts, [&chars_sum](const std::string& text)
+        {
+            double val;
+            std::from_chars(text.data(), text.data() + text.size(), val);
+            chars_sum += val;
+        });
+        std::cout << ", from_chars " << from_chars_ns << " ns";
+        REQUIRE(chars_sum == expected_sum);
+#endif
+        std::cout << std::endl;
+        REQUIRE(sum == expected_sum);
+    }
+}
+
+TEST_CASE("StrScanDoubleTest", "[FastFloat]")
+{
+    // prices and a leading 0 not taken as octal
+    alt::StrParser parser("0.1 1234.56 012.5 -0.0000123 1e3 7");
+    REQUIRE(parser.toDouble() == 0.1);
+    parser.skipWhiteSpace();
+    REQUIRE(parser.toDouble() == 1234.56);
+    parser.skipWhiteSpace();
+    REQUIRE(parser.toDouble() == 12.5);
+    parser.skipWhiteSpace();
+    REQUIRE(parser.toDouble() == -0.0000123);
+    parser.skipWhiteSpace();
+    parser.getNumber();
+    REQUIRE(parser.scannedValueType() == alt::StrScan::DOUBLE);
+    REQUIRE(parser.getScannedDouble() == 1000.0);
+    parser.skipWhiteSpace();
+    parser.getNumber();
+    int64_t integer;
+    REQUIRE(parser.fetchValue(integer));
+    REQUIRE(integer == 7);
+
+    // 8 digits at a time up to the largest uint64_t
+    alt::StrParser long_int("18446744073709551615");
+    long_int.getNumber();
+    REQUIRE(long_int.fetchValue(integer));
+    REQUIRE(uint64_t(integer) == 18446744073709551615ull);
+}
+
+TEST_CASE("FastFloatFormatBenchmark", "[.][benchmark]")
+{
+    for (bool prices: {true, false})
+    {
+        const std::vector<double> values = benchmarkValues(prices, 1000000);
+        char text[512];
+        size_t length = 0, printf_length = 0;
+        double shortest_ns = nanosPerCall(values, [&](double val)
+        {
+            length += alt::formatShortest(val, text);
+        });
+        double printf_shortest_ns = nanosPerCall(values, [&](double val)
+        {
+            printf_length += std::snprintf(text, sizeof(text), "%.17g", val);
+        });
+        alt::StrPrinter<64> spr;
+        double printer_ns = nanosPerCall(values, [&](double val)
+        {
+            spr.clear();
+            spr << val;
+            length += spr.length();
+        });
+        std::cout << (prices ? "prices:      " : "random bits: ")
+                  << " shortest " << shortest_ns << " ns, StrPrinter " << printer_ns
+                  << " ns, snprintf \"%.17g\" " << printf_shortest_ns << " ns";
+#if defined(__cpp_lib_to_chars)
+        double to_chars_ns = nanosPerCall(values, [&](double val)
+        {
+            printf_length += std::to_chars(text, text + sizeof(text), val).ptr - text;
+        });
+        std::cout << ", to_chars " << to_chars_ns << " ns";
+#endif
+        std::cout << std::endl;
+
+        size_t fixed_length = 0, printf_fixed_length = 0;
+        double fixed_ns = nanosPerCall(values, [&](double val)
+        {
+            fixed_length += alt::formatFixed(val, 2, text, sizeof(text));
+        });
+        double printf_fixed_ns = nanosPerCall(values, [&](double val)
+        {
+            printf_fixed_length += std::snprintf(text, sizeof(text), "%.2f", val);
+        });
+        std::cout << "              fixed(2) " << fixed_ns << " ns, snprintf \"%.2f\" "
+                  << printf_fixed_ns << " ns";
+#if defined(__cpp_lib_to_chars)
+        size_t to_chars_fixed_length = 0;
+        double to_chars_fixed_ns = nanosPerCall(values, [&](double val)
+        {
+            to_chars_fixed_length += std::to_chars(text, text + sizeof(text), val,
+                                                   std::chars_format::fixed, 2).ptr - text;
+        });
+        std::cout << ", to_chars " << to_chars_fixed_ns << " ns";
+        REQUIRE(to_chars_fixed_length == printf_fixed_length);
+#endif
+        std::cout << std::endl;
+        REQUIRE(fixed_length == printf_fixed_length);
+        REQUIRE(length > 0);
+        REQUIRE(printf_length > 0);
+    }
+}
+
+TEST_CASE("FastFloatFormatTest", "[FastFloat]")
+{
+    REQUIRE(shortest(0.0) == "0");
+    REQUIRE(shortest(-0.0) == "-0");
+    REQUIRE(shortest(100) == "100");
+    REQUIRE(shortest(0.1) == "0.1");
+    REQUIRE(shortest(0.1 + 0.2) == "0.30000000000000004");
+    REQUIRE(shortest(-12.5) == "-12.5");
+    REQUIRE(shortest(1e21) == "1e+21");
+    REQUIRE(shortest(123456789012345680000.0) == "123456789012345680000");
+    REQUIRE(shortest(0.000001) == "0.000001");
+    REQUIRE(shortest(1.5e-7) == "1.5e-7");
+    REQUIRE(shortest(5e-324) == "5e-324");
+    REQUIRE(shortest(1.7976931348623157e308) == "1.7976931348623157e+308");
+    REQUIRE(shortest(9007199254740993.0) == "9007199254740992");
+    REQUIRE(shortest(std::numeric_limits<double>::infinity()) == "inf");
+    char text[alt::SHORTEST_DOUBLE_CHARS];
+    REQUIRE(std::string(text, alt::formatShortest(0.1f, text)) == "0.1");
+    REQUIRE(std::string(text, alt::formatShortest(16777216.0f, text)) == "16777216");
+    REQUIRE(std::string(text, alt::formatShortest(3.4028235e38f, text)) == "3.4028235e+38");
+
+    // the shortest text parses back to the same double
+    std::mt19937_64 gen(42);
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint64_t bits = gen();
+        double val;
+        std::memcpy(&val, &bits, sizeof(val));
+        if (!std::isfinite(val))
+        {
+            continue;
+        }
+        std::string text = shortest(val);
+        double back = std::strtod(text.c_str(), nullptr);
+        INFO(text);
+        REQUIRE(std::memcmp(&back, &val, sizeof(val)) == 0);
+        REQUIRE(text.size() <= alt::SHORTEST_DOUBLE_CHARS);
+    }
+
+    for (double val: {0.0, -0.0, 0.5, 1.5, 2.5, -0.125, 0.045, 1.005, 123456.789, 1e-300, 1e15, 1.8e19, 1e22, 1e300})
+    {
+        for (int precision = 0; precision <= 25; ++precision)
+        {
+            INFO(val << " " << precision);
+            REQUIRE(sameAsPrintf(val, precision));
+        }
+    }
+    for (int i = 0; i < 100000; ++i)
+    {
+        double val = double(int64_t(gen() % 2000000000) - 1000000000) / double(1 << (gen() % 30));
+        int precision = int(gen() % 23);
+        INFO(val << " " << precision);
+        REQUIRE(sameAsPrintf(val, precision));
+    }
+
+    alt::StrPrinter<64> spr;
+    spr << 0.1 << ' ' << 1.5f << ' ' << std::make_tuple(2.675, 2) << ' ' << std::make_tuple(-0.5, 0)
+        << ' ' << std::make_tuple(1e30, 1);
+    REQUIRE(std::string(spr.c_str()) == "0.1 1.5 2.67 -0 1000000000000000019884624838656.0");
+    std::string str;
+    alt::StrPrint<std::string> sprs(str);
+    sprs << std::make_tuple(1e300, 2);
+    REQUIRE(str.size() == 304);
+}
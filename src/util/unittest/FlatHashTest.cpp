@@ -0,0 +1,94 @@
+#include <util/storage/FlatHash.h>
+#include <catch2/catch.hpp>
+#include <unordered_map>
+#include <string>
+#include <random>
+
+namespace
+{
+    struct Order
+    {
+        uint64_t        id_;
+        std::string     account_;
+        int64_t         qty_;
+
+        Order(uint64_t id, int64_t qty) : id_(id), account_("ACC" + std::to_string(id)), qty_(qty) {}
+
+        MAKE_POOLED_HASH_ENTRY(uint64_t, id_, size_t)
+    };
+
+    template <bool StablePointer>
+    void flatHashTest()
+    {
+        alt::FlatHash<Order, StablePointer> table;
+        std::unordered_map<uint64_t, int64_t> expected;
+        std::mt19937_64 rand(7);
+        for (int i=0; i<200000; ++i)
+        {
+            uint64_t id = rand() % 20000;
+            if (rand() % 3 == 0)
+            {
+                REQUIRE(table.erase(id)==(expected.erase(id)==1));
+            }
+            else
+            {
+                auto res = table.emplace(id, int64_t(i));
+                REQUIRE(res.is_new_==expected.emplace(id, i).second);
+                REQUIRE(res.value_->id_==id);
+            }
+        }
+        REQUIRE(table.size()==expected.size());
+        for (auto& [id, qty]: expected)
+        {
+            Order* order = table.findValue(id);
+            REQUIRE(order);
+            REQUIRE(order->qty_==qty);
+            REQUIRE(order->account_=="ACC" + std::to_string(id));
+        }
+        size_t count = 0;
+        for (auto& order: table)
+        {
+            REQUIRE(expected.count(order.id_)==1);
+            ++count;
+        }
+        REQUIRE(count==expected.size());
+        table.clear();
+        REQUIRE(table.empty());
+        REQUIRE(table.begin()==table.end());
+        REQUIRE(!table.contains(expected.begin()->first));
+    }
+}
+
+TEST_CASE( "FlatHashTest", "[FlatHash]" )
+{
+    alt::FlatHash<Order> table;
+    REQUIRE(table.capacity()==alt::FlatHash<Order>::MIN_CAPACITY);
+    REQUIRE(table.insert(Order(1, 10)).is_new_);
+    REQUIRE(!table.insert(Order(1, 20)).is_new_);
+    REQUIRE(table.findValue(1)->qty_==10);
+    for (uint64_t id=2; id<=100; ++id)
+    {
+        REQUIRE(table.emplace(id, int64_t(id*10)).is_new_);
+    }
+    REQUIRE(table.size()==100);
+    REQUIRE(table.capacity()>=128);
+    REQUIRE(table.findValue(77)->qty_==770);
+    REQUIRE(table.erase(77));
+    REQUIRE(!table.erase(77));
+    REQUIRE(table.findValue(77)==nullptr);
+    auto [iter, inserted] = table.try_emplace(77, int64_t(7));
+    REQUIRE(inserted);
+    REQUIRE(iter->qty_==7);
+    REQUIRE(iter->account_=="ACC77");
+    REQUIRE(!table.try_emplace(77, int64_t(8)).second);
+    REQUIRE(table.findValue(77)->qty_==7);
+
+    // values in the stable pointer variant do not move when the table grows
+    alt::NodeFlatHash<Order> node_table;
+    Order* first = node_table.emplace(1, 10).value_;
+    for (uint64_t id=2; id<=1000; ++id) node_table.emplace(id, int64_t(id));
+    REQUIRE(node_table.findValue(1)==first);
+
+    flatHashTest<false>();
+    flatHashTest<true>();
+}
@@ -0,0 +1,172 @@
+#include <util/storage/IntrusiveList.h>
+#include <util/storage/IntrusiveTree.h>
+#include <catch2/catch.hpp>
+#include <vector>
+#include <memory>
+
+namespace
+{
+    // an object in two lists and a tree at once
+    struct Session
+    {
+        int                     id_;
+        alt::IntrusiveListHook  active_hook_;
+        alt::IntrusiveListHook  timer_hook_;
+        alt::IntrusiveTreeHook  tree_hook_;
+        explicit Session(int id) : id_(id) {}
+    };
+
+    using ActiveList = alt::IntrusiveList<Session, &Session::active_hook_>;
+    using TimerList = alt::IntrusiveList<Session, &Session::timer_hook_>;
+    using SessionTree = alt::IntrusiveTree<Session, &Session::tree_hook_>;
+
+    template <typename List>
+    std::vector<int> ids(const List& list)
+    {
+        std::vector<int> res;
+        for (const Session& session: list) res.push_back(session.id_);
+        return res;
+    }
+
+    std::vector<int> childIds(const Session* parent)
+    {
+        std::vector<int> res;
+        for (Session* child = SessionTree::firstChild(parent); child; child = SessionTree::nextSibling(child))
+        {
+            res.push_back(child->id_);
+        }
+        return res;
+    }
+}
+
+TEST_CASE("IntrusiveListTest", "[IntrusiveList]")
+{
+    Session s1(1), s2(2), s3(3), s4(4);
+    ActiveList active;
+    TimerList timers;
+    REQUIRE(active.empty());
+    REQUIRE(active.begin()==active.end());
+    REQUIRE(active.extractFront()==nullptr);
+
+    active.pushBack(s1);
+    active.pushBack(s2);
+    active.pushFront(s3);
+    timers.pushBack(s2);
+    timers.pushBack(s1);
+    REQUIRE(ids(active)==std::vector<int>{3, 1, 2});
+    REQUIRE(ids(timers)==std::vector<int>{2, 1});
+    REQUIRE(active.size()==3);
+    REQUIRE(active.front().id_==3);
+    REQUIRE(active.back().id_==2);
+    REQUIRE(ActiveList::isLinked(s1));
+    REQUIRE(!ActiveList::isLinked(s4));
+    REQUIRE(!TimerList::isLinked(s3));
+
+    // unlink from one list does not touch the other
+    ActiveList::extract(s1);
+    REQUIRE(ids(active)==std::vector<int>{3, 2});
+    REQUIRE(ids(timers)==std::vector<int>{2, 1});
+
+    active.insert(ActiveList::iteratorTo(s2), s4);
+    active.append(ActiveList::iteratorTo(s2), s1);
+    REQUIRE(ids(active)==std::vector<int>{3, 4, 2, 1});
+    auto iter = active.end();
+    --iter;
+    REQUIRE(iter->id_==1);
+
+    REQUIRE(active.extractBack()==&s1);
+    REQUIRE(active.extractFront()==&s3);
+    REQUIRE(ids(active)==std::vector<int>{4, 2});
+
+    ActiveList other;
+    other.pushBack(s3);
+    other.splice(other.begin(), active);
+    REQUIRE(active.empty());
+    REQUIRE(ids(other)==std::vector<int>{4, 2, 3});
+    active.swap(other);
+    REQUIRE(other.empty());
+    REQUIRE(ids(active)==std::vector<int>{4, 2, 3});
+    ActiveList moved(std::move(active));
+    REQUIRE(active.empty());
+    REQUIRE(ids(moved)==std::vector<int>{4, 2, 3});
+
+    // a destroyed object unlinks itself
+    {
+        Session temp(5);
+        moved.pushBack(temp);
+        timers.pushFront(temp);
+        REQUIRE(moved.size()==4);
+    }
+    REQUIRE(ids(moved)==std::vector<int>{4, 2, 3});
+    REQUIRE(ids(timers)==std::vector<int>{2, 1});
+
+    // a copied object is not linked
+    Session copy(s2);
+    REQUIRE(!ActiveList::isLinked(copy));
+
+    moved.clear();
+    REQUIRE(moved.empty());
+    REQUIRE(!ActiveList::isLinked(s2));
+    REQUIRE(TimerList::isLinked(s2));
+}
+
+TEST_CASE("IntrusiveTreeTest", "[IntrusiveList]")
+{
+    std::vector<std::unique_ptr<Session>> nodes;
+    for (int id = 0; id < 8; ++id)
+    {
+        nodes.emplace_back(new Session(id));
+    }
+    Session* root = nodes[0].get();
+    SessionTree::appendChild(root, nodes[1].get());
+    SessionTree::appendChild(root, nodes[2].get());
+    SessionTree::insertChild(root, nodes[3].get());
+    SessionTree::appendChild(root, nodes[3].get(), nodes[4].get());
+    SessionTree::insertChild(root, nodes[2].get(), nodes[5].get());
+    REQUIRE(childIds(root)==std::vector<int>{3, 4, 1, 5, 2});
+    REQUIRE(SessionTree::childrenNum(root)==5);
+    REQUIRE(SessionTree::lastChild(root)->id_==2);
+    REQUIRE(SessionTree::prevSibling(nodes[2].get())->id_==5);
+    REQUIRE(SessionTree::prevSibling(nodes[3].get())==nullptr);
+    REQUIRE(SessionTree::nextSibling(nodes[2].get())==nullptr);
+
+    SessionTree::appendChild(nodes[1].get(), nodes[6].get());
+    SessionTree::appendChild(nodes[6].get(), nodes[7].get());
+    REQUIRE(SessionTree::root(nodes[7].get())==root);
+    REQUIRE(SessionTree::isAncestorOf(root, nodes[7].get()));
+    REQUIRE(!SessionTree::isAncestorOf(nodes[2].get(), nodes[7].get()));
+    REQUIRE(SessionTree::isLeaf(nodes[7].get()));
+    REQUIRE(!SessionTree::isLeaf(nodes[1].get()));
+
+    std::vector<int> order;
+    SessionTree::upDown(root, [&](Session* node) { order.push_back(node->id_); return 0; });
+    REQUIRE(order==std::vector<int>{0, 3, 4, 1, 6, 7, 5, 2});
+    order.clear();
+    SessionTree::bottomUp(root, [&](Session* node) { order.push_back(node->id_); return 0; });
+    REQUIRE(order==std::vector<int>{3, 4, 7, 6, 1, 5, 2, 0});
+    order.clear();
+    REQUIRE(SessionTree::upDown(root, [&](Session* node)
+    {
+        order.push_back(node->id_);
+        return node->id_==6 ? -1 : 0;
+    })==-1);
+    REQUIRE(order==std::vector<int>{0, 3, 4, 1, 6});
+
+    // reparenting moves the subtree
+    SessionTree::appendChild(nodes[2].get(), nodes[1].get());
+    REQUIRE(childIds(root)==std::vector<int>{3, 4, 5, 2});
+    REQUIRE(SessionTree::parent(nodes[7].get())==nodes[6].get());
+    REQUIRE(SessionTree::root(nodes[7].get())==root);
+
+    SessionTree::detach(nodes[2].get());
+    REQUIRE(SessionTree::isRoot(nodes[2].get()));
+    REQUIRE(SessionTree::root(nodes[7].get())==nodes[2].get());
+
+    // a destroyed node is detached and its children become roots
+    nodes[6].reset();
+    REQUIRE(SessionTree::isRoot(nodes[7].get()));
+    REQUIRE(SessionTree::isLeaf(nodes[1].get()));
+    nodes[0].reset();
+    REQUIRE(SessionTree::isRoot(nodes[3].get()));
+    REQUIRE(SessionTree::nextSibling(nodes[3].get())==nullptr);
+}
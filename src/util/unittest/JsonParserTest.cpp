@@ -0,0 +1,213 @@
+#include <util/string/JsonParser.h>
+#include <util/string/JsonIndex.h>
+#include <catch2/catch.hpp>
+#include <string>
+#include <random>
+#include <fstream>
+#include <filesystem>
+#include <unistd.h>
+
+namespace
+{
+    const char* json_text = R"({
+        "name": "order \"A\" {1}",
+        "id": 1234,
+        "price": -12.5,
+        "active": true,
+        "closed": false,
+        "note": null,
+        "tags": ["a", "b,c", "[d]"],
+        "qty": [1, 2, 3],
+        "legs": [{"side": "buy", "qty": 10}, {"side": "sell", "qty": 20}],
+        "account": {"id": "ACC1", "limits": {"max": 1000, "enabled": true}},
+        "path": "c:\\temp\\",
+        "empty": {},
+        "none": []
+    })";
+
+    // positions of the same tokens found by scanning character by character.
+    // Like the index, a backslash escapes a quote outside a string as well
+    std::vector<uint32_t> scalarIndex(const std::string& text, bool& closed)
+    {
+        std::vector<uint32_t> res;
+        bool in_string = false;
+        bool in_scalar = false;
+        bool escaped = false;
+        for (size_t ix = 0; ix < text.size(); ++ix)
+        {
+            char ch = text[ix];
+            if (in_string)
+            {
+                if (ch == '\\') ++ix;
+                else if (ch == '"') in_string = false;
+                continue;
+            }
+            bool quote = ch == '"' && !escaped;
+            escaped = ch == '\\' && !escaped;
+            bool scalar = false;
+            switch (quote ? '"' : ch=='"' ? 'a' : ch)
+            {
+                case '"': in_string = true; res.push_back(uint32_t(ix)); break;
+                case '{': case '}': case '[': case ']': case ':': case ',':
+                    res.push_back(uint32_t(ix)); break;
+                case ' ': case '\t': case '\n': case '\r': break;
+                default:
+                    scalar = true;
+                    if (!in_scalar) res.push_back(uint32_t(ix));
+            }
+            in_scalar = scalar;
+        }
+        closed = !in_string;
+        return res;
+    }
+
+    bool sameTree(const alt::PooledNamedNode* n1, const alt::PooledNamedNode* n2)
+    {
+        using namespace alt;
+        if (n1->subCategory() != n2->subCategory()) return false;
+        if ((n1->name()==nullptr) != (n2->name()==nullptr)) return false;
+        if (n1->name() && strcmp(n1->name(), n2->name())) return false;
+        switch (n1->subCategory())
+        {
+            case JSON_NODE_STRING:
+                return strcmp(static_cast<const JsonString*>(n1)->getValue(),
+                              static_cast<const JsonString*>(n2)->getValue())==0;
+            case JSON_NODE_INTEGER:
+                return static_cast<const JsonInteger*>(n1)->getValue()==static_cast<const JsonInteger*>(n2)->getValue();
+            case JSON_NODE_DOUBLE:
+                return static_cast<const JsonDouble*>(n1)->getValue()==static_cast<const JsonDouble*>(n2)->getValue();
+            case JSON_NODE_BOOL:
+                return static_cast<const JsonBool*>(n1)->getValue()==static_cast<const JsonBool*>(n2)->getValue();
+        }
+        auto c1 = n1->children().begin(), c2 = n2->children().begin();
+        for (; c1 != n1->children().end() && c2 != n2->children().end(); ++c1, ++c2)
+        {
+            if (!sameTree(static_cast<const PooledNamedNode*>(*c1), static_cast<const PooledNamedNode*>(*c2)))
+            {
+                return false;
+            }
+        }
+        return !(c1 != n1->children().end()) && !(c2 != n2->children().end());
+    }
+}
+
+TEST_CASE("JsonParserTest", "[JsonParser]")
+{
+    using namespace alt;
+    for (bool indexed: {false, true})
+    {
+        ParserStreamContext context;
+        JsonParser parser(context, json_text, strlen(json_text));
+        JsonObject* root = indexed ? parser.parseIndexed() : parser.parse();
+        REQUIRE(root);
+        REQUIRE(root->getStringValue("name")=="order \"A\" {1}");
+        REQUIRE(root->getStringValue("path")=="c:\\temp\\");
+        REQUIRE(root->getIntegerValue("id")==1234);
+        REQUIRE(root->getDoubleValue("price")==-12.5);
+        REQUIRE(root->getBoolValue("active"));
+        REQUIRE(!root->getBoolValue("closed", true));
+        std::vector<std::string> tags;
+        root->getStringArray("tags", tags);
+        REQUIRE(tags==std::vector<std::string>{"a", "b,c", "[d]"});
+        REQUIRE(root->getIntegerArray("qty")==std::vector<int64_t>{1, 2, 3});
+        auto legs = root->getObjectArray("legs");
+        REQUIRE(legs.size()==2);
+        REQUIRE(legs[1]->getStringValue("side")=="sell");
+        REQUIRE(legs[1]->getIntegerValue("qty")==20);
+        auto account = root->getChildObject("account");
+        REQUIRE(account);
+        REQUIRE(account->getStringValue("id")=="ACC1");
+        REQUIRE(account->getChildObject("limits")->getIntegerValue("max")==1000);
+        REQUIRE(account->getChildObject("limits")->getBoolValue("enabled"));
+        REQUIRE(root->getChildObject("empty"));
+        REQUIRE(root->getArray("none").empty());
+        PooledNamedNode::releaseNode(root);
+    }
+
+    JsonObject* root1 = JsonParser::parseIndexed(json_text, strlen(json_text));
+    ParserStreamContext context;
+    JsonParser parser(context, json_text, strlen(json_text));
+    JsonObject* root2 = parser.parse();
+    REQUIRE(sameTree(root1, root2));
+    PooledNamedNode::releaseNode(root1);
+    PooledNamedNode::releaseNode(root2);
+
+    std::string unclosed = R"({"a": "b})";
+    REQUIRE(JsonParser::parseIndexed(unclosed.c_str(), unclosed.size())==nullptr);
+}
+
+TEST_CASE("JsonParserFileTest", "[JsonParser]")
+{
+    using namespace alt;
+    auto path = std::filesystem::temp_directory_path() / ("json_parser_test_" + std::to_string(::getpid()));
+    auto writeFile = [&path](const std::string& text)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << text;
+    };
+
+    // the mapped file is parsed in place, including a file filling whole pages
+    // where the terminating zero comes from the page reserved after the file
+    std::string text = json_text;
+    JsonObject* expected = JsonParser::parseIndexed(text.c_str(), text.size());
+    size_t page_size = size_t(::sysconf(_SC_PAGESIZE));
+    for (size_t size: {text.size(), page_size})
+    {
+        text.resize(size, ' ');
+        writeFile(text);
+        JsonObject* root = JsonParser::parseFile(path.c_str());
+        REQUIRE(root);
+        REQUIRE(sameTree(root, expected));
+        PooledNamedNode::releaseNode(root);
+    }
+    PooledNamedNode::releaseNode(expected);
+
+    // scanned strings are views into the file, and errors report the line in the file
+    writeFile("{\n  \"key\": 12.5,\n  \"bad\": tru\n}");
+    ParserStreamContext context;
+    StreamParser scanner(context);
+    REQUIRE(context.pushMappedFileParser(&scanner, path.c_str()));
+    REQUIRE(context.stream()->isMapped());
+    REQUIRE(scanner.skipToChar(':') == ':');
+    scanner.nextChar(false);
+    REQUIRE(scanner.skipWhiteSpace() == '1');
+    scanner.getNumber();
+    REQUIRE(scanner.scannedView() == "12.5");
+    REQUIRE(scanner.scannedStartPos() == 11);
+
+    ParserStreamContext json_context;
+    JsonParser parser(json_context);
+    REQUIRE(json_context.pushMappedFileParser(&parser, path.c_str()));
+    JsonObject* root = parser.parse();
+    REQUIRE(parser.hasError());
+    PooledNamedNode::releaseNode(root);
+    REQUIRE(parser.getErrors().front().line_ == 3);
+
+    std::filesystem::remove(path);
+    REQUIRE(JsonParser::parseFile(path.c_str()) == nullptr);
+}
+
+TEST_CASE("JsonIndexTest", "[JsonParser]")
+{
+    alt::JsonStructuralIndex index;
+    std::string text = json_text;
+    bool closed;
+    REQUIRE(index.build(text.c_str(), text.size()));
+    REQUIRE(index.positions()==scalarIndex(text, closed));
+
+    // random texts with quotes, escapes and tokens crossing 64-byte blocks
+    const char chars[] = "\"\\\\{}[]:, \tab12";
+    std::mt19937 gen(17);
+    std::uniform_int_distribution<size_t> pick(0, sizeof(chars) - 2);
+    for (size_t round = 0; round < 2000; ++round)
+    {
+        text.resize(round % 300);
+        for (char& ch: text) ch = chars[pick(gen)];
+        bool closed = index.build(text.c_str(), text.size());
+        bool expected_closed;
+        auto expected = scalarIndex(text, expected_closed);
+        INFO(text);
+        REQUIRE(index.positions()==expected);
+        REQUIRE(closed==expected_closed);
+    }
+}
@@ -0,0 +1,93 @@
+#include <util/string/JsonReader.h>
+#include <util/string/JsonParser.h>
+#include <catch2/catch.hpp>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* json_text = R"({
+        "name": "order \"A\"",
+        "id": 1234,
+        "price": -12.5,
+        "active": true,
+        "note": null,
+        "tags": ["a", "b,c", "[d]"],
+        "legs": [{"side": "buy", "qty": 10}, {"side": "sell", "qty": 20, "fills": [[1, 2], []]}],
+        "account": {"id": "ACC1", "limits": {"max": 1000, "enabled": false}},
+        "empty": {},
+        "last": 7
+    })";
+}
+
+TEST_CASE("JsonReaderTest", "[JsonReader]")
+{
+    using namespace alt;
+    JsonReader reader;
+    REQUIRE(reader.open(json_text, strlen(json_text)));
+    JsonView root = reader.root();
+    REQUIRE(root.type()==JsonViewType::Object);
+    REQUIRE(root.size()==10);
+
+    REQUIRE(root["name"].rawString()=="order \\\"A\\\"");
+    std::string name;
+    REQUIRE(root["name"].getString(name));
+    REQUIRE(name=="order \"A\"");
+    REQUIRE(root.getIntegerValue("id")==1234);
+    REQUIRE(root["id"].type()==JsonViewType::Integer);
+    REQUIRE(root.getDoubleValue("id")==1234.0);
+    REQUIRE(root.getDoubleValue("price")==-12.5);
+    REQUIRE(root["price"].type()==JsonViewType::Double);
+    REQUIRE(root.getBoolValue("active"));
+    REQUIRE(root["note"].isNull());
+    REQUIRE(root["note"].type()==JsonViewType::Null);
+    REQUIRE(root.getIntegerValue("last")==7);
+    REQUIRE(root["last"].rawText()=="7");
+
+    // missing names and wrong types give invalid views and default values
+    REQUIRE(!root["missing"]);
+    REQUIRE(!root["missing"]["deeper"].valid());
+    REQUIRE(root.getIntegerValue("name", -1)==-1);
+    REQUIRE(root.getStringValue("id", "none")=="none");
+    REQUIRE(!root["tags"]["a"]);
+    REQUIRE(!root["id"].at(0));
+
+    JsonView tags = root["tags"];
+    REQUIRE(tags.isArray());
+    REQUIRE(tags.size()==3);
+    REQUIRE(tags.at(1).rawString()=="b,c");
+    REQUIRE(tags.at(2).rawString()=="[d]");
+    REQUIRE(!tags.at(3));
+    std::vector<std::string_view> tag_vec;
+    tags.forEachElement([&tag_vec](JsonView tag) { tag_vec.push_back(tag.rawString()); });
+    REQUIRE(tag_vec==std::vector<std::string_view>{"a", "b,c", "[d]"});
+
+    JsonView legs = root["legs"];
+    REQUIRE(legs.size()==2);
+    REQUIRE(legs.at(1).getStringValue("side")=="sell");
+    REQUIRE(legs.at(1).getIntegerValue("qty")==20);
+    REQUIRE(legs.at(1)["fills"].at(0).at(1).rawText()=="2");
+    REQUIRE(legs.at(1)["fills"].at(1).size()==0);
+    REQUIRE(legs.at(1)["fills"].rawText()=="[[1, 2], []]");
+    REQUIRE(root["account"]["limits"].getIntegerValue("max")==1000);
+    REQUIRE(!root["account"]["limits"].getBoolValue("enabled", true));
+    REQUIRE(root["empty"].isObject());
+    REQUIRE(root["empty"].size()==0);
+    REQUIRE(!root["empty"]["a"]);
+
+    std::vector<std::string_view> names;
+    root["account"].forEachMember([&names](std::string_view name, JsonView) { names.push_back(name); });
+    REQUIRE(names==std::vector<std::string_view>{"id", "limits"});
+
+    // full tree of a sub-object
+    JsonObject* account = root["account"].toObject();
+    REQUIRE(account);
+    REQUIRE(account->getStringValue("id")=="ACC1");
+    REQUIRE(account->getChildObject("limits")->getIntegerValue("max")==1000);
+    PooledNamedNode::releaseNode(account);
+    REQUIRE(root["tags"].toObject()==nullptr);
+
+    JsonReader empty;
+    REQUIRE(empty.open("  ", 2));
+    REQUIRE(!empty.root());
+}
@@ -0,0 +1,183 @@
+#include <util/storage/OrderBook.h>
+#include <catch2/catch.hpp>
+#include <map>
+#include <list>
+#include <random>
+#include <vector>
+#include <algorithm>
+
+namespace
+{
+    // reference book: FIFO of order ids for each price of each side
+    struct RefBook
+    {
+        struct RefOrder { bool is_bid_; int64_t price_; int64_t qty_; };
+        std::map<int64_t, std::list<uint64_t>>  sides_[2];
+        std::map<uint64_t, RefOrder>            orders_;
+
+        void add(uint64_t id, bool is_bid, int64_t price, int64_t qty)
+        {
+            orders_[id] = RefOrder{is_bid, price, qty};
+            sides_[is_bid][price].push_back(id);
+        }
+        void remove(uint64_t id)
+        {
+            auto& order = orders_[id];
+            auto& fifo = sides_[order.is_bid_][order.price_];
+            fifo.remove(id);
+            if (fifo.empty()) sides_[order.is_bid_].erase(order.price_);
+            orders_.erase(id);
+        }
+        void modify(uint64_t id, int64_t qty)
+        {
+            auto& order = orders_[id];
+            if (qty > order.qty_)
+            {
+                auto& fifo = sides_[order.is_bid_][order.price_];
+                fifo.remove(id);
+                fifo.push_back(id);
+            }
+            order.qty_ = qty;
+        }
+    };
+
+    void checkSame(alt::OrderBook<>& book, RefBook& ref)
+    {
+        REQUIRE(book.orderNumber()==ref.orders_.size());
+        for (bool is_bid: {true, false})
+        {
+            std::vector<int64_t> prices;
+            for (auto& [price, fifo]: ref.sides_[is_bid]) prices.push_back(price);
+            if (is_bid) std::reverse(prices.begin(), prices.end());
+            size_t ix = 0;
+            book.forEachLevel(is_bid, [&](int64_t price, const alt::OrderBook<>::Level& level)
+            {
+                REQUIRE(ix < prices.size());
+                REQUIRE(price==prices[ix]);
+                auto& fifo = ref.sides_[is_bid][price];
+                int64_t qty = 0;
+                auto order = level.front();
+                for (uint64_t id: fifo)
+                {
+                    REQUIRE(order);
+                    REQUIRE(order->id_==id);
+                    qty += order->qty_;
+                    order = order->nextOrder();
+                }
+                REQUIRE(!order);
+                REQUIRE(level.order_cnt_==int64_t(fifo.size()));
+                REQUIRE(level.qty_==qty);
+                ++ix;
+            });
+            REQUIRE(ix==prices.size());
+        }
+    }
+}
+
+TEST_CASE( "OrderBookTest", "[OrderBook]" )
+{
+    alt::OrderBook<> book(8, 4, 16, true);
+    REQUIRE(book.add(1, true, 100, 10));
+    REQUIRE(book.add(2, true, 100, 20));
+    REQUIRE(book.add(3, false, 102, 5));
+    REQUIRE(!book.add(3, false, 103, 5));
+    REQUIRE(book.find(2)->qty_==20);
+
+    int64_t price = 0;
+    auto top = book.top(true, price);
+    REQUIRE(price==100);
+    REQUIRE(top->qty_==30);
+    REQUIRE(top->front()->id_==1);
+
+    // increasing quantity loses time priority
+    REQUIRE(book.modify(1, 15));
+    REQUIRE(book.top(true, price)->front()->id_==2);
+    REQUIRE(book.execute(2, 20));
+    REQUIRE(!book.find(2));
+    REQUIRE(book.replace(3, 101, 7)->price_==101);
+    REQUIRE(book.top(false, price)->qty_==7);
+    REQUIRE(price==101);
+    REQUIRE(book.cancel(1));
+    REQUIRE(!book.cancel(1));
+    REQUIRE(!book.top(true, price));
+
+    auto& deltas = book.takeDeltas();
+    REQUIRE(deltas.size()==8);
+    REQUIRE(deltas[4].order_cnt_==1);        // execute order 2
+    REQUIRE(deltas[5].order_cnt_==0);        // replace removes 102
+    REQUIRE(deltas[5].price_==102);
+    REQUIRE(deltas.back().order_cnt_==0);    // bid level 100 removed
+    REQUIRE(book.takeDeltas().empty());
+
+    std::vector<alt::OrderBook<>::LevelInfo> snapshot;
+    book.snapshot(snapshot);
+    REQUIRE(snapshot.size()==1);
+    REQUIRE(!snapshot[0].is_bid_);
+    REQUIRE(snapshot[0].qty_==7);
+}
+
+TEST_CASE( "OrderBookRandomTest", "[OrderBook]" )
+{
+    // a small front range so that levels move between front and back buckets
+    alt::OrderBook<> book(16, 8, 16, true);
+    RefBook ref;
+    std::mt19937_64 rng(3);
+    std::map<int64_t, alt::OrderBook<>::LevelInfo> replayed[2];
+    uint64_t next_id = 1;
+    for (int step = 0; step < 20000; ++step)
+    {
+        int op = rng() % 10;
+        if (op < 4 || ref.orders_.empty())
+        {
+            bool is_bid = rng() % 2;
+            // mostly near the top with some far away levels
+            int64_t dist = rng() % 8 == 0 ? rng() % 100 : rng() % 10;
+            int64_t price = is_bid ? 1000 - dist : 1001 + dist;
+            int64_t qty = 1 + rng() % 100;
+            REQUIRE(book.add(next_id, is_bid, price, qty));
+            ref.add(next_id++, is_bid, price, qty);
+        }
+        else
+        {
+            auto iter = ref.orders_.begin();
+            std::advance(iter, rng() % ref.orders_.size());
+            uint64_t id = iter->first;
+            if (op < 7)
+            {
+                REQUIRE(book.cancel(id));
+                ref.remove(id);
+            }
+            else if (op < 9)
+            {
+                int64_t qty = 1 + rng() % 100;
+                REQUIRE(book.modify(id, qty));
+                ref.modify(id, qty);
+            }
+            else
+            {
+                int64_t qty = 1 + rng() % 100;
+                REQUIRE(book.execute(id, qty));
+                if (qty >= iter->second.qty_) ref.remove(id);
+                else ref.modify(id, iter->second.qty_ - qty);
+            }
+        }
+        for (auto& delta: book.takeDeltas())
+        {
+            if (delta.order_cnt_==0) replayed[delta.is_bid_].erase(delta.price_);
+            else replayed[delta.is_bid_][delta.price_] = delta;
+        }
+        if (step % 100 == 0) checkSame(book, ref);
+    }
+    checkSame(book, ref);
+
+    // the levels rebuilt from deltas are the same as the snapshot
+    std::vector<alt::OrderBook<>::LevelInfo> snapshot;
+    book.snapshot(snapshot);
+    REQUIRE(snapshot.size()==replayed[0].size()+replayed[1].size());
+    for (auto& level: snapshot)
+    {
+        auto& delta = replayed[level.is_bid_][level.price_];
+        REQUIRE(delta.qty_==level.qty_);
+        REQUIRE(delta.order_cnt_==level.order_cnt_);
+    }
+}
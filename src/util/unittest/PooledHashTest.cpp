@@ -3,32 +3,93 @@
 #include <iostream>
 #include <assert.h>
 #include <vector>
+#include <set>
 
 namespace alt
 {
-    class PooledHashNode: public PooledHashEntryBase
+    inline size_t orderIdHash(uint64_t id) { return id * 0x9E3779B97F4A7C15ULL; }
+
+    struct PooledHashNode
     {
         static int s_instance_cnt_;
-        public:
-            PooledHashNode( int val) : value_(val)
-            {
-                ++s_instance_cnt_;
-            }
-            ~PooledHashNode()
-            {
-                --s_instance_cnt_;
-            }
-            int getValue() const { return value_; }
-            static int instanceCount() { return s_instance_cnt_; }
-        private:
-            int value_ { 0 };
+
+        uint64_t    id_;
+        int         value_ { 0 };
+
+        PooledHashNode(uint64_t id, int val) : id_(id), value_(val) { ++s_instance_cnt_; }
+        PooledHashNode(const PooledHashNode& oth) : id_(oth.id_), value_(oth.value_) { ++s_instance_cnt_; }
+        ~PooledHashNode() { --s_instance_cnt_; }
+        static int instanceCount() { return s_instance_cnt_; }
+
+        MAKE_POOLED_HASH_ENTRY(uint64_t, id_, orderIdHash)
     };
     int PooledHashNode::s_instance_cnt_ = 0;
 }
+
 TEST_CASE( "PooledHashTest", "[PooledHashTest]" )
 {
-    alt::PooledHash  testhash;
-    alt::PooledHashNode* node = testhash.emplace<alt::PooledHashNode>(1);
+    {
+        alt::PooledHash<alt::PooledHashNode, true> testhash(nullptr, 16);
+        REQUIRE(testhash.emplace(1, 10).is_new_);
+        REQUIRE(!testhash.emplace(1, 11).is_new_);
+        REQUIRE(testhash.insert(alt::PooledHashNode(2, 20)).is_new_);
+        REQUIRE(testhash.size()==2);
+        REQUIRE(testhash.findValue(1)->value_==10);
+        REQUIRE(testhash.findValue(3)==nullptr);
+
+        auto res = testhash.replaceKey(2, 3);
+        REQUIRE(res.is_new_);
+        REQUIRE(testhash.findValue(2)==nullptr);
+        REQUIRE(testhash.findValue(3)->value_==20);
+
+        auto iter = testhash.find(1);
+        REQUIRE(iter!=testhash.end());
+        testhash.erase(iter);
+        REQUIRE(testhash.find(1)==testhash.end());
+        REQUIRE(testhash.size()==1);
+        REQUIRE(alt::PooledHashNode::instanceCount()==1);
+    }
+    REQUIRE(alt::PooledHashNode::instanceCount()==0);
 }
 
+TEST_CASE( "PooledHashRehashTest", "[PooledHashTest]" )
+{
+    constexpr uint64_t NUM = 100000;
+    alt::PooledHash<alt::PooledHashNode, true> testhash(nullptr, 16);
+    bool rehash_seen = false;
+    for (uint64_t id=0; id<NUM; ++id)
+    {
+        REQUIRE(testhash.emplace(id, int(id)).is_new_);
+        if (testhash.isRehashing())
+        {
+            rehash_seen = true;
+            // entries are found in both old and new buckets during rehashing
+            REQUIRE(testhash.findValue(id/2)->value_==int(id/2));
+            REQUIRE(testhash.findValue(id)->value_==int(id));
+        }
+    }
+    REQUIRE(rehash_seen);
+    REQUIRE(testhash.size()==NUM);
+    REQUIRE(testhash.bucketNumber()>=NUM);
+
+    for (uint64_t id=0; id<NUM; id+=2)
+    {
+        REQUIRE(testhash.erase(id));
+    }
+    REQUIRE(testhash.size()==NUM/2);
 
+    std::set<uint64_t> ids;
+    for (auto entry: testhash)
+    {
+        REQUIRE(entry->value_.id_%2==1);
+        ids.insert(entry->value_.id_);
+    }
+    REQUIRE(ids.size()==NUM/2);
+
+    for (auto iter=testhash.begin(); iter!=testhash.end(); )
+    {
+        iter = testhash.erase(iter);
+    }
+    REQUIRE(testhash.empty());
+    REQUIRE(testhash.begin()==testhash.end());
+}
@@ -0,0 +1,133 @@
+#include <util/string/JsonPushParser.h>
+#include <util/string/XmlPushParser.h>
+#include <catch2/catch.hpp>
+#include <string>
+#include <array>
+
+namespace
+{
+    // records events in a line each
+    struct JsonLog: public alt::JsonEventListener
+    {
+        std::string log_;
+        void onStartObject() override { log_ += "{\n"; }
+        void onEndObject() override { log_ += "}\n"; }
+        void onStartArray() override { log_ += "[\n"; }
+        void onEndArray() override { log_ += "]\n"; }
+        void onKey(std::string_view key) override { log_ += "key:"; log_ += key; log_ += '\n'; }
+        void onString(std::string_view val) override { log_ += "str:"; log_ += val; log_ += '\n'; }
+        void onInteger(int64_t val) override { log_ += "int:" + std::to_string(val) + '\n'; }
+        void onDouble(double val) override { log_ += "dbl:" + std::to_string(val) + '\n'; }
+        void onBool(bool val) override { log_ += val ? "true\n" : "false\n"; }
+        void onNull() override { log_ += "null\n"; }
+        void onEndDocument() override { log_ += "--\n"; }
+    };
+
+    struct XmlLog: public alt::XmlEventListener
+    {
+        std::string log_;
+        void onStartElement(std::string_view name) override { log_ += "<"; log_ += name; log_ += '\n'; }
+        void onAttribute(std::string_view name, std::string_view value) override
+        {
+            log_ += "@"; log_ += name; log_ += '='; log_ += value; log_ += '\n';
+        }
+        void onText(std::string_view text) override { log_ += "text:"; log_ += text; log_ += '\n'; }
+        void onEndElement(std::string_view name) override { log_ += "/"; log_ += name; log_ += '\n'; }
+        void onEndDocument() override { log_ += "--\n"; }
+    };
+
+    // parses the text in chunks of the given size
+    template <typename Parser, typename Log>
+    std::string parseInChunks(const std::string& text, size_t chunk_size, bool& ok)
+    {
+        Log log;
+        Parser parser(log);
+        ok = true;
+        for (size_t pos = 0; pos < text.size() && ok; pos += chunk_size)
+        {
+            ok = parser.feed(text.c_str() + pos, std::min(chunk_size, text.size() - pos));
+        }
+        ok = ok && parser.finish();
+        return log.log_;
+    }
+}
+
+TEST_CASE("JsonPushParserTest", "[PushParser]")
+{
+    // newline delimited documents
+    std::string text =
+        "{\"name\": \"order \\\"A\\\"\", \"id\": 1234, \"px\": -12.5, \"ok\": true, \"none\": null,\n"
+        " \"tags\": [\"a\", [], {}], \"u\": \"\\u00e9\\ud83d\\ude00\", \"exp\": 1e3}\n"
+        "[1, false]\n"
+        "42";
+    std::string expected =
+        "{\nkey:name\nstr:order \"A\"\nkey:id\nint:1234\nkey:px\ndbl:-12.500000\nkey:ok\ntrue\n"
+        "key:none\nnull\nkey:tags\n[\nstr:a\n[\n]\n{\n}\n]\nkey:u\nstr:\xC3\xA9\xF0\x9F\x98\x80\n"
+        "key:exp\ndbl:1000.000000\n}\n--\n"
+        "[\nint:1\nfalse\n]\n--\n"
+        "int:42\n--\n";
+    for (size_t chunk_size = 1; chunk_size <= text.size(); ++chunk_size)
+    {
+        bool ok;
+        std::string log = parseInChunks<alt::JsonPushParser, JsonLog>(text, chunk_size, ok);
+        INFO(chunk_size);
+        REQUIRE(ok);
+        REQUIRE(log == expected);
+    }
+
+    // chunks fetched from a ring buffer as iovec
+    JsonLog log;
+    alt::JsonPushParser parser(log);
+    std::string first = "{\"key\": \"val", second = "ue\"}";
+    std::array<iovec, 2> iov {{ {first.data(), first.size()}, {second.data(), second.size()} }};
+    REQUIRE(parser.feed(iov.data(), 2));
+    REQUIRE(parser.finish());
+    REQUIRE(log.log_ == "{\nkey:key\nstr:value\n}\n--\n");
+    REQUIRE(parser.position() == first.size() + second.size());
+
+    for (const char* bad: {"{\"a\" 1}", "[1, 2}", "{\"a\": tru}", "[1,", "{\"a\": \"\\q\"}", "]", "-"})
+    {
+        bool ok;
+        parseInChunks<alt::JsonPushParser, JsonLog>(bad, 2, ok);
+        INFO(bad);
+        REQUIRE(!ok);
+    }
+    parser.reset();
+    REQUIRE(parser.feed("[[[", 3));
+    REQUIRE(!parser.finish());
+    alt::JsonPushParser shallow(log, 2);
+    REQUIRE(!shallow.feed("[[[", 3));
+    REQUIRE(shallow.hasError());
+}
+
+TEST_CASE("XmlPushParserTest", "[PushParser]")
+{
+    std::string text =
+        "<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE book [<!ENTITY x \"y\">]>\n"
+        "<book id=\"1\" title='A &amp; B'>\n"
+        "  <!-- a comment -- here -->\n"
+        "  <chapter n=\"1\">  Text &lt;one&gt; &#65;&#x42; </chapter>\n"
+        "  <empty/>\n"
+        "  <code><![CDATA[a < b ]] > c]]></code>\n"
+        "</book>\n";
+    std::string expected =
+        "<book\n@id=1\n@title=A & B\n<chapter\n@n=1\ntext:Text <one> AB\n/chapter\n"
+        "<empty\n/empty\n<code\ntext:a < b ]] > c\n/code\n/book\n--\n";
+    for (size_t chunk_size = 1; chunk_size <= text.size(); ++chunk_size)
+    {
+        bool ok;
+        std::string log = parseInChunks<alt::XmlPushParser, XmlLog>(text, chunk_size, ok);
+        INFO(chunk_size);
+        REQUIRE(ok);
+        REQUIRE(log == expected);
+    }
+
+    for (const char* bad: {"<a></b>", "<a>", "<a x=1/>", "<a>&unknown;</a>", "text", "<1a/>"})
+    {
+        bool ok;
+        parseInChunks<alt::XmlPushParser, XmlLog>(bad, 3, ok);
+        INFO(bad);
+        REQUIRE(!ok);
+    }
+}
@@ -0,0 +1,102 @@
+#include <util/storage/RcuStringHashMap.h>
+#include <catch2/catch.hpp>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+
+TEST_CASE( "RcuStringHashMapTest", "[RcuStringHashMap]" )
+{
+    alt::RcuStringHashMap<int> map;
+    REQUIRE(map.add("one", 1));
+    REQUIRE(!map.add("one", 2));
+    map.set("two", 2);
+    map.update([](alt::RcuStringHashMap<int>::Updater& updater)
+    {
+        for (int i=3; i<100; ++i) updater.add(std::to_string(i), i);
+        updater.set("one", 11);
+    });
+    REQUIRE(map.size()==99);
+    int value = 0;
+    REQUIRE(map.find("one", value));
+    REQUIRE(value==11);
+    REQUIRE(map.find(std::string_view("42x", 2), value));
+    REQUIRE(value==42);
+    REQUIRE(map.erase("42"));
+    REQUIRE(!map.contains("42"));
+    {
+        alt::RcuStringHashMap<int>::Reader reader(map);
+        REQUIRE(*reader.find("two")==2);
+        // the version read stays unchanged and alive while the reader is reading
+        map.clear();
+        REQUIRE(reader.size()==98);
+        REQUIRE(*reader.find("99")==99);
+        REQUIRE(map.reclaim()>0);
+    }
+    REQUIRE(map.reclaim()==0);
+    REQUIRE(map.size()==0);
+
+    alt::RcuTranslationMap translation;
+    REQUIRE(translation.add("USD", "US Dollar"));
+    REQUIRE(!translation.add("USD", "Dollar"));
+    translation.update([](alt::RcuTranslationMap::Updater& updater)
+    {
+        alt::RcuTranslationMap::add(updater, "EUR", "Euro");
+    });
+    const char* usd = translation.translate("USD");
+    REQUIRE(std::string(usd)=="US Dollar");
+    REQUIRE(std::string(translation.translate("EUR"))=="Euro");
+    REQUIRE(translation.translate("JPY")==nullptr);
+    translation.clear();
+    // translated strings stay in the pool after the keys are removed
+    REQUIRE(std::string(usd)=="US Dollar");
+}
+
+TEST_CASE( "RcuStringHashMapConcurrentTest", "[RcuStringHashMap]" )
+{
+    constexpr int KEY_NUM = 64;
+    constexpr int VERSION_NUM = 2000;
+    alt::RcuStringHashMap<int> map;
+    map.update([](alt::RcuStringHashMap<int>::Updater& updater)
+    {
+        for (int i=0; i<KEY_NUM; ++i) updater.add(std::to_string(i), 0);
+    });
+
+    std::atomic<bool> done {false};
+    std::atomic<int> inconsistent {0};
+    std::vector<std::thread> readers;
+    for (int r=0; r<3; ++r)
+    {
+        readers.emplace_back([&]()
+        {
+            int last_version = 0;
+            while (!done.load(std::memory_order_acquire))
+            {
+                alt::RcuStringHashMap<int>::Reader reader(map);
+                // every version has all keys set to the same value
+                int version = *reader.find("0");
+                for (int i=1; i<KEY_NUM; ++i)
+                {
+                    const int* value = reader.find(std::to_string(i));
+                    if (!value || *value!=version) ++inconsistent;
+                }
+                if (version < last_version) ++inconsistent;
+                last_version = version;
+            }
+        });
+    }
+    for (int version=1; version<=VERSION_NUM; ++version)
+    {
+        map.update([version](alt::RcuStringHashMap<int>::Updater& updater)
+        {
+            for (int i=0; i<KEY_NUM; ++i) *updater.find(std::to_string(i)) = version;
+        });
+    }
+    done = true;
+    for (auto& t: readers) t.join();
+    REQUIRE(inconsistent==0);
+    REQUIRE(map.reclaim()==0);
+    int value = 0;
+    REQUIRE(map.find("7", value));
+    REQUIRE(value==VERSION_NUM);
+}
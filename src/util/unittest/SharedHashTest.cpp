@@ -0,0 +1,141 @@
+#include <util/storage/SharedPooledHash.h>
+#include <catch2/catch.hpp>
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace
+{
+    inline size_t instrumentIdHash(uint64_t id) { return id * 0x9E3779B97F4A7C15ULL; }
+
+    struct Instrument
+    {
+        uint64_t    id_;
+        char        symbol_[16];
+        int64_t     bid_;
+        int64_t     ask_;
+        int64_t     check_sum_;
+
+        Instrument() = default;
+        Instrument(uint64_t id, int64_t px) : id_(id), bid_(px), ask_(px+1), check_sum_(id+2*px+1)
+        {
+            snprintf(symbol_, sizeof(symbol_), "SYM%lu", id);
+        }
+        bool isConsistent() const { return check_sum_==int64_t(id_)+bid_+ask_; }
+
+        MAKE_POOLED_HASH_ENTRY(uint64_t, id_, instrumentIdHash)
+    };
+}
+
+TEST_CASE( "SharedHashTest", "[SharedHash]" )
+{
+    alt::SharedHash<Instrument> table(100);
+    REQUIRE(table.capacity()==100);
+    for (uint64_t id=1; id<=100; ++id)
+    {
+        REQUIRE(table.insert(Instrument(id, id*10)));
+    }
+    REQUIRE(table.size()==100);
+    REQUIRE(!table.insert(Instrument(1, 0)));
+    REQUIRE_THROWS(table.insert(Instrument(101, 0)));
+
+    Instrument inst;
+    REQUIRE(table.find(50, inst));
+    REQUIRE(inst.bid_==500);
+    REQUIRE(std::string(inst.symbol_)=="SYM50");
+    REQUIRE(!table.find(200, inst));
+
+    REQUIRE(table.update(Instrument(50, 7)));
+    REQUIRE(table.find(50, inst));
+    REQUIRE(inst.bid_==7);
+    REQUIRE(!table.update(Instrument(200, 7)));
+
+    for (uint64_t id=1; id<=100; id+=2)
+    {
+        REQUIRE(table.erase(id));
+    }
+    REQUIRE(!table.erase(1));
+    REQUIRE(table.size()==50);
+    for (uint64_t id=1; id<=100; ++id)
+    {
+        REQUIRE(table.contains(id)==(id%2==0));
+    }
+    for (uint64_t id=101; id<=150; ++id)
+    {
+        REQUIRE(table.upsert(Instrument(id, id)));
+    }
+    REQUIRE(table.size()==100);
+    REQUIRE(table.find(150, inst));
+    REQUIRE(inst.isConsistent());
+    REQUIRE(!table.upsert(Instrument(150, 3)));
+    REQUIRE(table.size()==100);
+    REQUIRE(table.find(150, inst));
+    REQUIRE(inst.bid_==3);
+}
+
+TEST_CASE( "SharedHashConcurrentRead", "[SharedHash]" )
+{
+    alt::SharedHash<Instrument> table(64);
+    for (uint64_t id=1; id<=32; ++id)
+    {
+        table.insert(Instrument(id, 0));
+    }
+
+    std::atomic<bool> done {false};
+    std::atomic<int> inconsistent {0};
+    std::vector<std::thread> readers;
+    for (int r=0; r<2; ++r)
+    {
+        readers.emplace_back([&]()
+        {
+            Instrument inst;
+            while (!done.load(std::memory_order_relaxed))
+            {
+                for (uint64_t id=1; id<=32; ++id)
+                {
+                    if (table.find(id, inst) && (!inst.isConsistent() || inst.id_!=id))
+                    {
+                        ++inconsistent;
+                    }
+                }
+            }
+        });
+    }
+    for (int64_t px=1; px<20000; ++px)
+    {
+        uint64_t id = px%32+1;
+        if (px%7==0)
+        {
+            table.erase(id);
+            table.insert(Instrument(id, px));
+        }
+        else
+        {
+            table.update(Instrument(id, px));
+        }
+    }
+    done = true;
+    for (auto& t: readers) t.join();
+    REQUIRE(inconsistent==0);
+    REQUIRE(table.size()==32);
+}
+
+TEST_CASE( "SharedMemHashTest", "[SharedHash]" )
+{
+    std::string name = "SharedMemHashTest" + std::to_string(::getpid());
+    alt::SharedMemHash<Instrument> master(name, true);
+    REQUIRE(master.init(size_t(16))==0);
+    REQUIRE(master.getContainer()->insert(Instrument(8, 80)));
+
+    alt::SharedMemHash<Instrument> client(name, false);
+    REQUIRE(client.init(size_t(16))==0);
+    Instrument inst;
+    REQUIRE(client.getContainer()->find(8, inst));
+    REQUIRE(inst.bid_==80);
+    REQUIRE(client.getContainer()->size()==1);
+    ::shm_unlink(("/" + name).c_str());
+}
@@ -1,8 +1,12 @@
 #include <util/storage/SideBuckets.h>
 #include <util/storage/SortedArray.h>
+#include <util/storage/SortedSearch.h>
 #include <catch2/catch.hpp>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <random>
+#include <vector>
 
 TEST_CASE( "SortedArray", "[SortedArray]" )
 {
@@ -25,6 +29,62 @@ TEST_CASE( "SortedArray", "[SortedArray]" )
     // sorted_array.print();
 }
 
+namespace
+{
+    template <typename Key, bool Ascending>
+    void checkSortedSearch(std::mt19937_64& rng)
+    {
+        using Search = alt::SortedSearch<Key, Ascending>;
+        auto before = [](Key x, Key y) { return Ascending ? x < y : y < x; };
+        std::uniform_int_distribution<int> dist(-50, 50);
+        for (size_t num = 0; num < 300; num += (num < 40 ? 1 : 37))
+        {
+            std::vector<Key> keys(num);
+            for (auto& key: keys) key = Key(dist(rng));
+            std::sort(keys.begin(), keys.end(), before);
+            for (int x = -52; x <= 52; ++x)
+            {
+                Key key = Key(x);
+                size_t low = std::lower_bound(keys.begin(), keys.end(), key, before) - keys.begin();
+                size_t up = std::upper_bound(keys.begin(), keys.end(), key, before) - keys.begin();
+                REQUIRE(Search::lowBound(keys.data(), num, key)==low);
+                REQUIRE(Search::upBound(keys.data(), num, key)==up);
+                auto key_of = [](const std::pair<Key, int>& p) { return p.first; };
+                std::vector<std::pair<Key, int>> pairs(num);
+                for (size_t i=0; i<num; ++i) pairs[i] = std::make_pair(keys[i], int(i));
+                REQUIRE(Search::lowBound(pairs.data(), num, key, key_of)==low);
+            }
+        }
+    }
+}
+
+TEST_CASE( "SortedSearch", "[SortedArray]" )
+{
+    std::mt19937_64 rng(7);
+    checkSortedSearch<int32_t, true>(rng);
+    checkSortedSearch<int32_t, false>(rng);
+    checkSortedSearch<int64_t, true>(rng);
+    checkSortedSearch<int64_t, false>(rng);
+    checkSortedSearch<uint32_t, true>(rng);
+    checkSortedSearch<uint64_t, false>(rng);
+    checkSortedSearch<double, true>(rng);
+
+    alt::SortedArray<int64_t, std::greater<int64_t>> sorted_array;
+    for (int64_t x = 0; x < 200; ++x)
+    {
+        REQUIRE(sorted_array.insert((x*37) % 200, true));
+    }
+    REQUIRE(!sorted_array.insert(100, true));
+    REQUIRE(sorted_array.size()==200);
+    for (size_t ix = 0; ix < sorted_array.size(); ++ix)
+    {
+        REQUIRE(sorted_array[ix]==int64_t(199-ix));
+    }
+    int64_t erased = 100;
+    REQUIRE(sorted_array.erase(erased)>=0);
+    REQUIRE(sorted_array.find(100)==-1);
+}
+
 TEST_CASE( "SideBuckets", "[SideBuckets]" )
 {
     using Price_t = int64_t;     // in number of ticks
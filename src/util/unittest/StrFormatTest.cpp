@@ -0,0 +1,54 @@
+#include <util/string/StrFormat.h>
+#include <util/string/StrPrint.h>
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+TEST_CASE("StrFormatTest", "[StrFormat]")
+{
+    // the format string is parsed when compiling
+    auto format = ALT_FORMAT("a{}b{{c}}{:.2}");
+    using Info = alt::detail::FormatInfo<decltype(format)>;
+    static_assert(Info::field_count == 2);
+    static_assert(Info::literal_length == 5);
+    static_assert(Info::precision(1) == 2);
+    static_assert(alt::detail::parseFormat("a}b", nullptr) == alt::detail::FORMAT_UNMATCHED_BRACE);
+    static_assert(alt::detail::parseFormat("{:x}", nullptr) == alt::detail::FORMAT_BAD_FIELD);
+    static_assert(alt::detail::parseFormat("{", nullptr) == alt::detail::FORMAT_BAD_FIELD);
+
+    std::string str;
+    alt::formatTo(str, ALT_FORMAT("{}|{}|{}|{}|{}|{}"), int8_t(-128), uint16_t(65535), INT32_MIN,
+                  UINT64_MAX, INT64_MIN, 'c');
+    REQUIRE(str == "-128|65535|-2147483648|18446744073709551615|-9223372036854775808|c");
+
+    str.clear();
+    std::string name = "A";
+    std::string_view view = "B";
+    alt::formatTo(str, ALT_FORMAT("{{{}}} {} {} {} {:.3} {:.0} {}"), name, view, "C", 0.1, 2.0005, 1e30, 1.5f);
+    REQUIRE(str == "{A} B C 0.1 2.001 1000000000000000019884624838656 1.5");
+
+    // a FIX message in a fixed buffer, written in place
+    alt::StrPrinter<64> msg;
+    msg.format(ALT_FORMAT("35=D|49={}|44={:.2}|38={}|"), "SENDER", 101.125, 300) << "10=000|";
+    REQUIRE(std::string(msg.c_str()) == "35=D|49=SENDER|44=101.12|38=300|10=000|");
+
+    // the text is cut at the end of the buffer as StrPrint does
+    char text[16];
+    alt::StrBuf buf(text, sizeof(text) - 1);
+    REQUIRE(alt::formatTo(buf, ALT_FORMAT("id={} px={}"), 123456789, 1.25) == 15);
+    buf.terminate();
+    REQUIRE(std::string(text) == "id=123456789 px");
+    REQUIRE(buf.overflowed());
+
+    alt::StrFixed<8> fixed;
+    alt::formatTo(fixed, ALT_FORMAT("{}-{}"), 12, 34);
+    REQUIRE(std::string(fixed.c_str()) == "12-34");
+    alt::formatTo(fixed, ALT_FORMAT("{}{}"), 12345, 67890);
+    REQUIRE(std::string(fixed.c_str()) == "12345678");
+
+    // a large number in the fixed notation on a small buffer
+    alt::StrPrinter<32> small;
+    small.format(ALT_FORMAT("{:.1}"), -1e30);
+    REQUIRE(std::string(small.c_str()) == "-1000000000000000019884624838656");
+}
@@ -0,0 +1,79 @@
+#include <util/string/StrInterner.h>
+#include <catch2/catch.hpp>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <string>
+
+TEST_CASE( "StrInternerTest", "[StrInterner]" )
+{
+    alt::StrInterner symbols(64, 4);
+    REQUIRE(symbols.find("IBM")==alt::NO_SYMBOL);
+    alt::SymbolId ibm = symbols.intern("IBM");
+    alt::SymbolId msft = symbols.intern(std::string_view("MSFTX", 4));
+    REQUIRE(ibm==0);
+    REQUIRE(msft==1);
+    REQUIRE(symbols.intern(std::string("IBM"))==ibm);
+    REQUIRE(symbols.find("MSFT")==msft);
+    REQUIRE(symbols.view(msft)=="MSFT");
+    REQUIRE(std::string(symbols.c_str(msft))=="MSFT");
+    REQUIRE(symbols.strRef(ibm).length()==3);
+    REQUIRE(symbols.intern("")==2);
+    REQUIRE(symbols.find("")==2);
+
+    // ids stay dense and strings stay put while the index grows
+    const char* ibm_str = symbols.c_str(ibm);
+    for (int i=0; i<5000; ++i)
+    {
+        REQUIRE(symbols.intern(std::to_string(i))==alt::SymbolId(i+3));
+    }
+    REQUIRE(symbols.size()==5003);
+    REQUIRE(symbols.c_str(ibm)==ibm_str);
+    for (int i=0; i<5000; ++i)
+    {
+        REQUIRE(symbols.find(std::to_string(i))==alt::SymbolId(i+3));
+        REQUIRE(symbols.view(i+3)==std::to_string(i));
+    }
+
+    // strings longer than a page are allocated apart
+    std::string long_name(200, 'x');
+    alt::SymbolId long_id = symbols.intern(long_name);
+    REQUIRE(symbols.view(long_id)==long_name);
+    REQUIRE(symbols.intern(long_name)==long_id);
+}
+
+TEST_CASE( "StrInternerConcurrentTest", "[StrInterner]" )
+{
+    constexpr int THREAD_NUM = 4;
+    constexpr int KEY_NUM = 16384;
+    alt::StrInternerSpinLocked symbols;
+    std::vector<alt::SymbolId> ids[THREAD_NUM];
+    std::atomic<int> errors {0};
+    std::vector<std::thread> threads;
+    for (int t=0; t<THREAD_NUM; ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (int i=0; i<KEY_NUM; ++i)
+            {
+                // every thread interns the same keys in a different order
+                int key = (i * (2*t+1)) % KEY_NUM;
+                alt::SymbolId id = symbols.intern(std::to_string(key));
+                ids[t].push_back(id);
+                if (symbols.view(id)!=std::to_string(key)) ++errors;
+                // a lock-free lookup sees any string interned before
+                if (symbols.find(std::to_string(key))!=id) ++errors;
+            }
+        });
+    }
+    for (auto& thread: threads) thread.join();
+    REQUIRE(errors==0);
+    REQUIRE(symbols.size()==KEY_NUM);
+    for (int t=0; t<THREAD_NUM; ++t)
+    {
+        for (int i=0; i<KEY_NUM; ++i)
+        {
+            REQUIRE(ids[t][i]==symbols.find(std::to_string((i * (2*t+1)) % KEY_NUM)));
+        }
+    }
+}
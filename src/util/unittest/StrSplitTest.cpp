@@ -0,0 +1,122 @@
+#include <util/string/StrSplit.h>
+#include <util/string/StrUtils.h>
+#include <util/string/StrScan.h>
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+    // splits a char at a time
+    std::vector<std::string> naiveSplit(const std::string& text, const std::string& delimiters)
+    {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        for (size_t pos = 0; pos < text.size(); ++pos)
+        {
+            if (delimiters.find(text[pos]) != std::string::npos)
+            {
+                fields.push_back(text.substr(start, pos - start));
+                start = pos + 1;
+            }
+        }
+        if (start < text.size())
+        {
+            fields.push_back(text.substr(start));
+        }
+        return fields;
+    }
+}
+
+TEST_CASE("FieldSplitterTest", "[StrSplit]")
+{
+    std::mt19937 gen(7);
+    const std::string alphabet("ab,;|\n\t \x01\x80\xFF=", 13);
+    for (const std::string& delimiters: {std::string(","), std::string(",;|\n"),
+                                        std::string("\x01\x80\xFF", 3), std::string("\0=", 2),
+                                        std::string(",;|\n\t =\x01\x80")})
+    {
+        alt::DelimiterSet set(delimiters);
+        for (int round = 0; round < 200; ++round)
+        {
+            std::string text;
+            size_t length = gen() % 300;
+            for (size_t ix = 0; ix < length; ++ix)
+            {
+                text.push_back(gen() % 20 == 0 ? '\0' : alphabet[gen() % alphabet.size()]);
+            }
+            std::string used = delimiters.substr(0, alt::DelimiterSet::MAX_DELIMITERS);
+            std::vector<std::string> expected = naiveSplit(text, used);
+            std::vector<std::string> fields;
+            alt::FieldSplitter splitter(set, text.data(), text.size());
+            alt::StrRefInLength field;
+            while (splitter.next(field))
+            {
+                fields.emplace_back(field.c_str(), field.length());
+                if (field.c_str() + field.length() < text.data() + text.size())
+                {
+                    REQUIRE(splitter.delimiter() == field.c_str()[field.length()]);
+                }
+            }
+            REQUIRE(fields == expected);
+        }
+    }
+
+    std::vector<std::string> substrings;
+    REQUIRE(alt::strSplit(" a b , c,,d ;rest", substrings, 0, ',', ';') == 12);
+    REQUIRE(substrings == std::vector<std::string>{"a b", "c", "", "d"});
+    substrings.clear();
+    REQUIRE(alt::strSplitQuoted("{A, B}", substrings) == 6);
+    REQUIRE(substrings == std::vector<std::string>{"A", "B"});
+
+    // StrParser keeps spaces unless told to skip them
+    alt::StrParser parser("x, y ,z");
+    substrings.clear();
+    REQUIRE(parser.split(substrings) == 3);
+    REQUIRE(substrings == std::vector<std::string>{"x", " y ", "z"});
+}
+
+TEST_CASE("TagValueScannerTest", "[StrSplit]")
+{
+    uint32_t tag = 0;
+    REQUIRE(alt::parseTagSWAR("35=D\x01..", tag) == 2);
+    REQUIRE(tag == 35);
+    REQUIRE(alt::parseTagSWAR("1234567=", tag) == 7);
+    REQUIRE(tag == 1234567);
+    REQUIRE(alt::parseTagSWAR("12345678", tag) == 0);
+    REQUIRE(alt::parseTagSWAR("=1......", tag) == 0);
+    REQUIRE(alt::parseTagSWAR("3a=D....", tag) == 0);
+
+    std::string msg = "8=FIX.4.2\x01" "9=65\x01" "35=A\x01" "49=SERVER\x01" "56=CLIENT\x01"
+                      "34=177\x01" "52=20090107-18:15:16\x01" "98=0\x01" "108=30\x01" "10=062\x01";
+    std::vector<std::pair<uint32_t, std::string>> expected {
+        {8, "FIX.4.2"}, {9, "65"}, {35, "A"}, {49, "SERVER"}, {56, "CLIENT"}, {34, "177"},
+        {52, "20090107-18:15:16"}, {98, "0"}, {108, "30"}, {10, "062"}};
+    std::vector<std::pair<uint32_t, std::string>> fields;
+    alt::TagValueScanner scanner(msg.data(), msg.size());
+    alt::StrRefInLength value;
+    while (scanner.next(tag, value))
+    {
+        fields.emplace_back(tag, std::string(value.c_str(), value.length()));
+    }
+    REQUIRE(!scanner.hasError());
+    REQUIRE(fields == expected);
+
+    // the '=' of a short field must not be taken from the next one
+    for (std::string bad: {std::string("1\x01" "2=x"), std::string("12x=1"), std::string("=1"),
+                           std::string("12345678=1\x01")})
+    {
+        alt::TagValueScanner bad_scanner(bad.data(), bad.size());
+        while (bad_scanner.next(tag, value)) {}
+        INFO(bad);
+        REQUIRE(bad_scanner.hasError());
+    }
+    alt::TagValueScanner pipes("1=a|22=|", 8, '|');
+    REQUIRE(pipes.next(tag, value));
+    REQUIRE((tag == 1 && value.length() == 1));
+    REQUIRE(pipes.next(tag, value));
+    REQUIRE((tag == 22 && value.length() == 0));
+    REQUIRE(!pipes.next(tag, value));
+    REQUIRE(!pipes.hasError());
+}
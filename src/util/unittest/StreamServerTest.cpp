@@ -0,0 +1,161 @@
+#include <util/net/StreamServer.h>
+#include <catch2/catch.hpp>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// echoes the data received on each connection
+class EchoHandler: public alt::StreamServerHandler
+{
+  public:
+    struct Echo: alt::StreamListener
+    {
+        alt::StreamConnection* connection_ {nullptr};
+        void onStreamData(alt::Clock::tick_type, alt::RingBuffer& data) override
+        {
+            std::array<iovec,2> iov;
+            data.fetchAll(iov);
+            connection_->send(iov.data(), iov[1].iov_len ? 2 : 1);
+            data.commitRead(0);
+        }
+    };
+
+    alt::StreamListener& onConnect(alt::StreamConnection& connection) override
+    {
+        std::scoped_lock lock(mutex_);
+        ++connect_num_;
+        auto& echo = echos_[&connection];
+        if (!echo)
+        {
+            echo.reset(new Echo());
+        }
+        echo->connection_ = &connection;
+        return *echo;
+    }
+
+    void onDisconnect(alt::StreamConnection&) override
+    {
+        std::scoped_lock lock(mutex_);
+        ++disconnect_num_;
+    }
+
+    size_t connectNum() { std::scoped_lock lock(mutex_); return connect_num_; }
+    size_t disconnectNum() { std::scoped_lock lock(mutex_); return disconnect_num_; }
+
+  private:
+    std::mutex                                                  mutex_;
+    std::map<alt::StreamConnection*, std::unique_ptr<Echo>>     echos_;
+    size_t                                                      connect_num_ {0};
+    size_t                                                      disconnect_num_ {0};
+};
+
+int connectLoopback(alt::PortId port)
+{
+    int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+std::string echo(int fd, const std::string& text)
+{
+    ::send(fd, text.data(), text.length(), 0);
+    std::string reply;
+    char buffer[256];
+    while (reply.length() < text.length())
+    {
+        ssize_t n = ::recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0)
+        {
+            break;
+        }
+        reply.append(buffer, size_t(n));
+    }
+    return reply;
+}
+
+template <typename Pred>
+bool waitFor(Pred pred)
+{
+    for (int i = 0; i < 2000 && !pred(); ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return pred();
+}
+
+void testEchoServer(bool reuse_port, size_t worker_num)
+{
+    // the reactors of the workers read the clock
+    alt::Clock::init(alt::ClockType::RealTime);
+
+    EchoHandler handler;
+    alt::StreamServer::Config config;
+    config.address_ = alt::SocketAddress::fromString(std::string("127.0.0.1"));
+    config.worker_num_ = worker_num;
+    config.reuse_port_ = reuse_port;
+    config.pool_size_ = 2;
+    alt::StreamServer server(config, handler);
+    server.start();
+    REQUIRE(server.port() != alt::WILDCARD_PORT_ID);
+
+    constexpr size_t CLIENT_NUM = 8;
+    std::vector<int> clients;
+    for (size_t i = 0; i < CLIENT_NUM; ++i)
+    {
+        int fd = connectLoopback(server.port());
+        REQUIRE(fd >= 0);
+        clients.push_back(fd);
+    }
+    for (size_t i = 0; i < CLIENT_NUM; ++i)
+    {
+        std::string text = "hello " + std::to_string(i);
+        REQUIRE(echo(clients[i], text) == text);
+    }
+    REQUIRE(waitFor([&]() { return server.connectionNum() == CLIENT_NUM; }));
+    REQUIRE(handler.connectNum() == CLIENT_NUM);
+
+    for (int fd: clients)
+    {
+        ::close(fd);
+    }
+    REQUIRE(waitFor([&]() { return handler.disconnectNum() == CLIENT_NUM; }));
+    REQUIRE(waitFor([&]() { return server.connectionNum() == 0; }));
+
+    // closed connections are reused
+    int fd = connectLoopback(server.port());
+    REQUIRE(fd >= 0);
+    REQUIRE(echo(fd, "again") == "again");
+    ::close(fd);
+    server.stop();
+}
+
+}
+
+TEST_CASE( "StreamServerReusePortTest", "[StreamServerTest]" )
+{
+    testEchoServer(true, 2);
+}
+
+TEST_CASE( "StreamServerHandOffTest", "[StreamServerTest]" )
+{
+    testEchoServer(false, 3);
+}
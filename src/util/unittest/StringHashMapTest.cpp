@@ -3,6 +3,8 @@
 #include <iostream>
 #include <assert.h>
 #include <vector>
+#include <string>
+#include <string_view>
 
 TEST_CASE( "StringHashMapTest", "[StringHashMapTest]" )
 {
@@ -31,6 +33,69 @@ TEST_CASE( "StringHashMapTest", "[StringHashMapTest]" )
     REQUIRE(2==testhash.size());
     //std::cout << "testhash end" << std::endl;
 }
+TEST_CASE( "StringHashMapLookupTest", "[StringHashMapTest]" )
+{
+    alt::StringHashMap<int>  testhash;
+    std::vector<std::string> keys;
+    for (int i=0; i<1000; ++i)
+    {
+        // long keys share a 20-byte prefix and differ only in the last bytes
+        keys.push_back(i%2 ? "key" + std::to_string(i)
+                           : "a_long_common_prefix_" + std::to_string(i));
+        REQUIRE(testhash.emplace(keys.back(), i).second);
+    }
+    REQUIRE(!testhash.emplace(keys[10], -1).second);
+    REQUIRE(testhash.size()==1000);
+    for (int i=0; i<1000; ++i)
+    {
+        std::string buffer = keys[i] + "#trailing";
+        std::string_view key(buffer.data(), keys[i].length());
+        auto iter = testhash.find(key);
+        REQUIRE(iter!=testhash.end());
+        REQUIRE(iter->second==i);
+        REQUIRE(iter->first.view()==keys[i]);
+        REQUIRE(iter->first.c_str()[keys[i].length()]=='\0');
+    }
+    REQUIRE(testhash.find("a_long_common_prefix_1000")==testhash.end());
+    REQUIRE(!testhash.contains("key"));
+
+    auto [iter, renamed] = testhash.rename("key1", "renamed");
+    REQUIRE(renamed);
+    REQUIRE(iter->second==1);
+    REQUIRE(!testhash.contains("key1"));
+    REQUIRE(!testhash.rename("key3", "renamed").second);
+    REQUIRE(testhash.at("key3")==3);
+    REQUIRE_THROWS_AS(testhash.at("key1"), std::out_of_range);
+
+    testhash["new_key"] = 2000;
+    REQUIRE(testhash.at("new_key")==2000);
+    const auto& const_hash = testhash;
+    static_assert(std::is_same<decltype(const_hash.at("new_key")), const int&>::value);
+    REQUIRE(const_hash.at("new_key")==2000);
+    static_assert(std::is_same<decltype((const_hash.find("new_key")->second)), const int&>::value);
+    static_assert(std::is_same<decltype(*const_hash.begin()), const alt::StringHashMapEntry<int>&>::value);
+    REQUIRE(const_hash.find("new_key")->second==2000);
+    REQUIRE(!testhash.try_emplace("new_key", 1).second);
+    std::string probe("emplaced_key");
+    REQUIRE(testhash.try_emplace(probe, 3000).second);
+    probe.assign(probe.length(), 'x');
+    REQUIRE(testhash.at("emplaced_key")==3000);
+    REQUIRE(testhash.erase("emplaced_key")==1);
+    REQUIRE(testhash.erase("new_key")==1);
+    REQUIRE(testhash.erase("new_key")==0);
+
+    size_t num = 0;
+    for (auto iter=testhash.begin(); iter!=testhash.end(); )
+    {
+        iter = iter->second%2 ? testhash.erase(iter) : (++iter);
+        ++num;
+    }
+    REQUIRE(num==1000);
+    REQUIRE(testhash.size()==500);
+    REQUIRE(testhash.erase(testhash.cbegin(), testhash.cend())==testhash.end());
+    REQUIRE(testhash.empty());
+}
+
 /*
 ALLOCATE n=1 hint=0 Tsz=24 rebind_size=0
 FixedMemPool::newSlab: malloc size=28800 entry_size=32
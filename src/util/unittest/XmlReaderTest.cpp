@@ -0,0 +1,156 @@
+#include <util/string/XmlReader.h>
+#include <catch2/catch.hpp>
+#include <cstdlib>                        // for mkstemp
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+    const char* xml_text = R"(<?xml version="1.0" encoding="UTF-8"?>
+<!DOCTYPE book [ <!ENTITY x "y"> ]>
+<!-- trades -->
+<trades source="FpML &amp; FIXML" count='2'>
+    <trade id="T1" side="buy">
+        <product>IRS</product>
+        <notional> 1000000 </notional>
+        <note>A &lt; B &#x41;&#66; &#x20AC;</note>
+    </trade>
+    <trade id="T2" side="sell">
+        <product><![CDATA[<FX> & more]]></product>
+        <note>x<!-- skipped -->y</note>
+        <empty/>
+    </trade>
+</trades>
+)";
+}
+
+TEST_CASE("XmlReaderTest", "[XmlReader]")
+{
+    using namespace alt;
+    XmlReader reader;
+    REQUIRE(reader.open(xml_text, strlen(xml_text)));
+    const XmlElementView* root = reader.root();
+    REQUIRE(root);
+    REQUIRE(root->name()=="trades");
+    REQUIRE(root->text().empty());
+
+    std::string buffer;
+    REQUIRE(root->attribute("source")->value().raw()=="FpML &amp; FIXML");
+    REQUIRE(root->attribute("source")->value().needsDecoding());
+    REQUIRE(root->attributeValue("source", buffer)=="FpML & FIXML");
+    REQUIRE(root->attributeValue("count", buffer)=="2");
+    REQUIRE(root->attributeValue("missing", buffer, "none")=="none");
+
+    std::vector<std::string> ids;
+    root->forEachChild("trade", [&](const XmlElementView& trade)
+    {
+        ids.emplace_back(trade.attributeValue("id", buffer));
+    });
+    REQUIRE(ids==std::vector<std::string>{"T1", "T2"});
+
+    const XmlElementView* trade = root->child("trade");
+    REQUIRE(trade->parent()==root);
+    REQUIRE(trade->firstAttribute()->name()=="id");
+    REQUIRE(trade->firstAttribute()->next()->name()=="side");
+    REQUIRE(trade->firstAttribute()->next()->next()==nullptr);
+    REQUIRE(trade->child("product")->text().raw()=="IRS");
+    REQUIRE(!trade->child("product")->text().needsDecoding());
+    REQUIRE(trade->child("notional")->text().raw()=="1000000");
+    REQUIRE(trade->child("note")->text(buffer)=="A < B AB \xE2\x82\xAC");
+    REQUIRE(trade->child("missing")==nullptr);
+
+    trade = trade->nextSibling("trade");
+    REQUIRE(trade);
+    REQUIRE(trade->nextSibling()==nullptr);
+    REQUIRE(trade->child("product")->text(buffer)=="<FX> & more");
+    REQUIRE(trade->child("note")->text(buffer)=="xy");
+    REQUIRE(trade->child("empty")->text().empty());
+    REQUIRE(trade->child("empty")->firstChild()==nullptr);
+
+    // the raw text is kept as names and values are views into it
+    REQUIRE(root->name().data() > xml_text);
+    REQUIRE(root->name().data() < xml_text + strlen(xml_text));
+}
+
+TEST_CASE("XmlReaderInSituTest", "[XmlReader]")
+{
+    using namespace alt;
+    std::string text = "<a x='1 &gt; 0'><b>&quot;q&quot; &unknown; &#0;</b></a>";
+    XmlReader reader(1024);
+    REQUIRE(reader.openInSitu(&text[0], text.length()));
+    std::string buffer;
+    const XmlElementView* b = reader.root()->child("b");
+    REQUIRE(b->text(buffer)=="\"q\" &unknown; &#0;");
+    REQUIRE(buffer.empty());
+    // decoded in place, and not decoded again
+    REQUIRE(!b->text().needsDecoding());
+    REQUIRE(b->text().raw()=="\"q\" &unknown; &#0;");
+    REQUIRE(reader.root()->attributeValue("x", buffer)=="1 > 0");
+    REQUIRE(text.find("1 > 0")!=std::string::npos);
+
+    // the arena is reused by the next text
+    for (int i=0; i<3; ++i)
+    {
+        std::string many = "<r>";
+        for (int j=0; j<1000; ++j) many += "<e k=\"v\">t</e>";
+        many += "</r>";
+        REQUIRE(reader.open(many));
+        size_t count = 0;
+        reader.root()->forEachChild([&](const XmlElementView& e)
+        {
+            if (e.text().raw()=="t" && e.attribute("k")) ++count;
+        });
+        REQUIRE(count==1000);
+    }
+}
+
+TEST_CASE("XmlReaderErrorTest", "[XmlReader]")
+{
+    using namespace alt;
+    XmlReader reader;
+    const char* bad[] = {
+        "",
+        "<a>",
+        "<a></b>",
+        "<a x=1></a>",
+        "<a x='1'y='2'></a>",
+        "<a></a><b></b>",
+        "text<a></a>",
+        "<a><!-- x </a>",
+        "<1a></1a>",
+        "</a>",
+        "<a x='1></a>",
+        "<a v=\"&amp; <!--x\"/>",
+        "<a v='<![CDATA[x'></a>",
+    };
+    for (const char* text: bad)
+    {
+        INFO(text);
+        REQUIRE(!reader.open(text, strlen(text)));
+        REQUIRE(reader.root()==nullptr);
+        REQUIRE(!reader.error().empty());
+    }
+    REQUIRE(reader.open("<a x='1'></b>", 13)==false);
+    REQUIRE(reader.errorPosition()==11);
+    REQUIRE(reader.open("  <a/>  "));
+    REQUIRE(reader.error().empty());
+}
+
+TEST_CASE("XmlReaderFileTest", "[XmlReader]")
+{
+    using namespace alt;
+    char path[] = "/tmp/XmlReaderTestXXXXXX";
+    int fd = ::mkstemp(path);
+    REQUIRE(fd>=0);
+    std::string text = "<a><b v=\"&amp;\">1</b></a>";
+    REQUIRE(::write(fd, text.c_str(), text.length())==ssize_t(text.length()));
+    ::close(fd);
+    XmlReader reader;
+    REQUIRE(reader.openFile(path));
+    std::string buffer;
+    REQUIRE(reader.root()->child("b")->text().raw()=="1");
+    REQUIRE(reader.root()->child("b")->attributeValue("v", buffer)=="&");
+    ::unlink(path);
+    REQUIRE(!reader.openFile(path));
+}